@@ -10,7 +10,9 @@
 #include "common/type.h"
 #include "runtime/module.h"
 #include "utils/wasm.h"
+#include <limits>
 #include <stack>
+#include <type_traits>
 #include <vector>
 
 #ifdef ZEN_ENABLE_CHECKED_ARITHMETIC
@@ -21,6 +23,7 @@ namespace zen::action {
 
 using common::BinaryOperator;
 using common::CompareOperator;
+using common::FCOpcode;
 using common::ErrorCode;
 using common::getErrorWithExtraMessage;
 using common::getWASMBlockTypeFromOpcode;
@@ -86,6 +89,7 @@ public:
     bool Ret = decode();
     Builder.finalizeFunctionBase();
     ZEN_ASSERT(Stack.getSize() == 0);
+    ZEN_ASSERT(PendingConsts.empty());
     return Ret;
   }
 
@@ -108,9 +112,9 @@ private:
   bool decode() {
     const uint8_t *Ip = CurFunc->CodePtr;
     const uint8_t *IpEnd = Ip + CurFunc->CodeSize;
+    uint32_t U32;
     int32_t I32;
     int64_t I64;
-    uint32_t U32;
     float F32;
     double F64;
 
@@ -118,6 +122,15 @@ private:
       auto &CurBlock = Builder.getCurrentBlockInfo();
       uint8_t Opcode = *Ip++;
 
+      // Integer constants are deferred until an instruction which can't be
+      // evaluated at compile time consumes them
+      if constexpr (IRBuilder::FoldConstants) {
+        if (foldConstInstruction(Opcode, Ip, IpEnd)) {
+          continue;
+        }
+        flushPendingConsts();
+      }
+
       switch (Opcode) {
       case Opcode::UNREACHABLE:
         handleUnreachable();
@@ -169,7 +182,16 @@ private:
 
       case Opcode::BR_TABLE:
         Ip = readSafeLEBNumber(Ip, U32);
-        Ip = handleBranchTable(Ip, IpEnd, U32);
+        Ip = handleBranchTable(Ip, IpEnd, U32, nullptr);
+        Ip = skipCurrentBlock(Ip, IpEnd);
+        CurBlock.setReachable(false);
+        break;
+
+      case Opcode::BR_TABLE_DECODED:
+        Ip = readSafeLEBNumber(Ip, U32);
+        Ip = handleBranchTable(Ip, IpEnd, U32,
+                               CurFunc->BrTableTargets +
+                                   utils::readDecodedBrTableOffset(Ip));
         Ip = skipCurrentBlock(Ip, IpEnd);
         CurBlock.setReachable(false);
         break;
@@ -191,12 +213,7 @@ private:
         HANDLE_CHECKED_ARITHMETIC_CALL(CurMod, U32)
 #undef HANDLE_CHECKED_ARITHMETIC_CALL_POSTHOOK
 #endif // ZEN_ENABLE_CHECKED_ARITHMETIC
-        runtime::CodeEntry *CalleeFunc = CurMod->getCodeEntry(U32);
-        uint32_t CalleeOffset = CalleeFunc ? CalleeFunc->CodeOffset : 0;
-        uint32_t CallSiteOffset = Ip - CurFunc->CodePtr + CurFunc->CodeOffset;
-        uint32_t CallOffset = std::abs(int32_t(CallSiteOffset - CalleeOffset));
-
-        handleCall(U32, CallOffset);
+        handleCall(U32, getCallOffset(U32, Ip));
         break;
       }
 
@@ -206,6 +223,23 @@ private:
         handleCallIndirect(U32, 0);
         break;
 
+      case Opcode::RETURN_CALL: {
+        Ip = readSafeLEBNumber(Ip, U32);
+        uint32_t CallOffset = getCallOffset(U32, Ip);
+        Ip = skipCurrentBlock(Ip, IpEnd);
+        handleReturnCall(U32, CallOffset);
+        CurBlock.setReachable(false);
+        break;
+      }
+
+      case Opcode::RETURN_CALL_INDIRECT:
+        Ip = readSafeLEBNumber(Ip, U32);
+        Ip++; // Skip table index(0)
+        Ip = skipCurrentBlock(Ip, IpEnd);
+        handleReturnCallIndirect(U32, 0);
+        CurBlock.setReachable(false);
+        break;
+
       case Opcode::DROP:
       case Opcode::DROP_64:
         handleDrop();
@@ -324,6 +358,7 @@ private:
         handleMemoryGrow();
         break;
 
+      // Only reached if the builder doesn't fold constants
       case Opcode::I32_CONST:
         Ip = readSafeLEBNumber(Ip, I32);
         handleConst<WASMType::I32>(I32);
@@ -743,6 +778,10 @@ private:
         handleIntExtend<WASMType::I64, WASMType::I32, true>();
         break;
 
+      case Opcode::PREFIX_FC:
+        Ip = decodeFCInstruction(Ip);
+        break;
+
       default:
         throw getErrorWithExtraMessage(ErrorCode::UnsupportedOpcode,
                                        std::to_string(Opcode));
@@ -756,6 +795,63 @@ private:
     return true;
   }
 
+  const uint8_t *decodeFCInstruction(const uint8_t *Ip) {
+    uint32_t SubOpcode;
+    uint32_t DataSegIdx;
+    Ip = readSafeLEBNumber(Ip, SubOpcode);
+    switch (SubOpcode) {
+    case FCOpcode::I32_TRUNC_SAT_S_F32:
+      handleFloatToIntSat<WASMType::I32, WASMType::F32, true>();
+      break;
+    case FCOpcode::I32_TRUNC_SAT_U_F32:
+      handleFloatToIntSat<WASMType::I32, WASMType::F32, false>();
+      break;
+    case FCOpcode::I32_TRUNC_SAT_S_F64:
+      handleFloatToIntSat<WASMType::I32, WASMType::F64, true>();
+      break;
+    case FCOpcode::I32_TRUNC_SAT_U_F64:
+      handleFloatToIntSat<WASMType::I32, WASMType::F64, false>();
+      break;
+    case FCOpcode::I64_TRUNC_SAT_S_F32:
+      handleFloatToIntSat<WASMType::I64, WASMType::F32, true>();
+      break;
+    case FCOpcode::I64_TRUNC_SAT_U_F32:
+      handleFloatToIntSat<WASMType::I64, WASMType::F32, false>();
+      break;
+    case FCOpcode::I64_TRUNC_SAT_S_F64:
+      handleFloatToIntSat<WASMType::I64, WASMType::F64, true>();
+      break;
+    case FCOpcode::I64_TRUNC_SAT_U_F64:
+      handleFloatToIntSat<WASMType::I64, WASMType::F64, false>();
+      break;
+    case FCOpcode::MEMORY_INIT:
+      Ip = readSafeLEBNumber(Ip, DataSegIdx);
+      // Skip the memory index(0)
+      ++Ip;
+      handleMemoryInit(DataSegIdx);
+      break;
+    case FCOpcode::DATA_DROP:
+      Ip = readSafeLEBNumber(Ip, DataSegIdx);
+      Builder.handleDataDrop(DataSegIdx);
+      break;
+    case FCOpcode::MEMORY_COPY:
+      // Skip the memory indexes(0, 0)
+      Ip += 2;
+      handleMemoryCopy();
+      break;
+    case FCOpcode::MEMORY_FILL:
+      // Skip the memory index(0)
+      ++Ip;
+      handleMemoryFill();
+      break;
+    default:
+      throw getErrorWithExtraMessage(ErrorCode::UnsupportedOpcode,
+                                     std::to_string(Opcode::PREFIX_FC) + ' ' +
+                                         std::to_string(SubOpcode));
+    }
+    return Ip;
+  }
+
   // ==================== Control Instruction Handlers ====================
 
   void handleUnreachable() { Builder.handleUnreachable(); }
@@ -834,8 +930,10 @@ private:
     Builder.handleBranchIf(Opnd, Level, Info);
   }
 
+  // `DecodedLevels` is the targets pre-decoded by the loader if not null
   const uint8_t *handleBranchTable(const uint8_t *Ip, const uint8_t *End,
-                                   uint32_t Count) {
+                                   uint32_t Count,
+                                   const uint32_t *DecodedLevels) {
     std::vector<uint32_t> Levels;
     Levels.reserve(Count + 1); // includes last default target
     WASMType Type = WASMType::VOID;
@@ -845,6 +943,9 @@ private:
       if (Ip >= End) {
         break;
       }
+      if (DecodedLevels) {
+        TargetLevel = DecodedLevels[I];
+      }
       const auto &Info = Builder.getBlockInfo(TargetLevel);
       WASMType BlockType = (Info.getKind() == CtrlBlockKind::LOOP)
                                ? WASMType::VOID
@@ -872,6 +973,15 @@ private:
     }
   }
 
+  // Distance between the call site and the callee in the bytecode, which
+  // estimates the distance in the generated code
+  uint32_t getCallOffset(uint32_t FuncIdx, const uint8_t *Ip) {
+    runtime::CodeEntry *CalleeFunc = CurMod->getCodeEntry(FuncIdx);
+    uint32_t CalleeOffset = CalleeFunc ? CalleeFunc->CodeOffset : 0;
+    uint32_t CallSiteOffset = Ip - CurFunc->CodePtr + CurFunc->CodeOffset;
+    return std::abs(int32_t(CallSiteOffset - CalleeOffset));
+  }
+
   void handleCall(uint32_t FuncIdx, uint32_t CallOffset) {
     uint32_t NumFunctions = CurMod->getNumTotalFunctions();
     ZEN_ASSERT(FuncIdx < NumFunctions);
@@ -898,6 +1008,30 @@ private:
     }
   }
 
+  void handleReturnCall(uint32_t FuncIdx, uint32_t CallOffset) {
+    if (FuncIdx == CurMod->getGasFuncIdx()) {
+      handleGasCall();
+      handleReturn();
+      return;
+    }
+    ZEN_ASSERT(FuncIdx < CurMod->getNumTotalFunctions());
+    TypeEntry *Type = CurMod->getFunctionType(FuncIdx);
+    ZEN_ASSERT(Type);
+    uintptr_t Target = 0;
+    bool IsImport = FuncIdx < CurMod->getNumImportFunctions();
+    bool FarCall = !IsImport && CallOffset > (1 << 24);
+    if (IsImport) {
+      const auto &ImportFunc = CurMod->getImportFunction(FuncIdx);
+      Target = (uintptr_t)ImportFunc.FuncPtr;
+      ZEN_ASSERT(Target != 0);
+    }
+    ArgumentInfo ArgInfo(Type);
+    std::vector<Operand> Args;
+    Args.resize(Type->NumParams);
+    collectCallParams(Type, Args);
+    Builder.handleReturnCall(FuncIdx, Target, IsImport, FarCall, ArgInfo, Args);
+  }
+
   void handleCallIndirect(uint32_t TypeIdx, uint32_t TableIdx) {
     ZEN_ASSERT(CurMod->isValidType(TypeIdx));
     ZEN_ASSERT(TableIdx < CurMod->getNumTotalTables());
@@ -918,6 +1052,21 @@ private:
     }
   }
 
+  void handleReturnCallIndirect(uint32_t TypeIdx, uint32_t TableIdx) {
+    ZEN_ASSERT(CurMod->isValidType(TypeIdx));
+    ZEN_ASSERT(TableIdx < CurMod->getNumTotalTables());
+    Operand IndirectFuncIdx = pop();
+    TypeEntry *Type = CurMod->getDeclaredType(TypeIdx);
+    ZEN_ASSERT(Type);
+    ArgumentInfo ArgInfo(Type);
+    std::vector<Operand> Args;
+    Args.resize(Type->NumParams);
+    collectCallParams(Type, Args);
+    TypeIdx = Type->SmallestTypeIdx;
+    Builder.handleReturnCallIndirect(TypeIdx, IndirectFuncIdx, TableIdx,
+                                     ArgInfo, Args);
+  }
+
   // ==================== Parametric Instruction Handlers ====================
 
   void handleDrop() { pop(); }
@@ -1000,6 +1149,27 @@ private:
     push(Result);
   }
 
+  void handleMemoryInit(uint32_t DataSegIdx) {
+    Operand Size = pop();
+    Operand SrcOffset = pop();
+    Operand DestOffset = pop();
+    Builder.handleMemoryInit(DataSegIdx, DestOffset, SrcOffset, Size);
+  }
+
+  void handleMemoryCopy() {
+    Operand Size = pop();
+    Operand SrcOffset = pop();
+    Operand DestOffset = pop();
+    Builder.handleMemoryCopy(DestOffset, SrcOffset, Size);
+  }
+
+  void handleMemoryFill() {
+    Operand Size = pop();
+    Operand Value = pop();
+    Operand DestOffset = pop();
+    Builder.handleMemoryFill(DestOffset, Value, Size);
+  }
+
   // ==================== Numeric Instruction Handlers ====================
 
   template <WASMType Ty> void handleConst(typename WASMTypeAttr<Ty>::Type Val) {
@@ -1152,6 +1322,19 @@ private:
     push(Result);
   }
 
+  // Convert float to integer, saturating instead of trapping
+  template <WASMType DestType, WASMType SrcType, bool Sext>
+  void handleFloatToIntSat() {
+    ZEN_STATIC_ASSERT(isWASMTypeInteger<DestType>() &&
+                      isWASMTypeFloat<SrcType>());
+    Operand Opnd = pop();
+    ZEN_ASSERT(Opnd.getType() == SrcType);
+    Operand Result =
+        Builder.template handleFloatToIntSat<DestType, SrcType, Sext>(Opnd);
+    ZEN_ASSERT(Result.getType() == DestType);
+    push(Result);
+  }
+
   // Extend from SrcType to DestType (only for integer)
   template <WASMType DestType, WASMType SrcType, bool Sext>
   void handleIntExtend() {
@@ -1181,6 +1364,393 @@ private:
     push(Result);
   }
 
+  // ==================== Constant Folding Methods ====================
+
+  // Returns true if the instruction is evaluated over the pending constants,
+  // otherwise the caller must flush them and emit the instruction
+  bool foldConstInstruction(uint8_t Opcode, const uint8_t *&Ip,
+                            const uint8_t *End) {
+    int32_t I32;
+    int64_t I64;
+    switch (Opcode) {
+    case Opcode::I32_CONST:
+      Ip = readSafeLEBNumber(Ip, I32);
+      pushPendingConst<WASMType::I32>(I32);
+      return true;
+    case Opcode::I64_CONST:
+      Ip = readSafeLEBNumber(Ip, I64);
+      pushPendingConst<WASMType::I64>(I64);
+      return true;
+
+    case Opcode::I32_EQZ:
+      return foldCompareConst<WASMType::I32, CompareOperator::CO_EQZ>(Ip, End);
+    case Opcode::I32_EQ:
+      return foldCompareConst<WASMType::I32, CompareOperator::CO_EQ>(Ip, End);
+    case Opcode::I32_NE:
+      return foldCompareConst<WASMType::I32, CompareOperator::CO_NE>(Ip, End);
+    case Opcode::I32_LT_S:
+      return foldCompareConst<WASMType::I32, CompareOperator::CO_LT_S>(Ip, End);
+    case Opcode::I32_LT_U:
+      return foldCompareConst<WASMType::I32, CompareOperator::CO_LT_U>(Ip, End);
+    case Opcode::I32_GT_S:
+      return foldCompareConst<WASMType::I32, CompareOperator::CO_GT_S>(Ip, End);
+    case Opcode::I32_GT_U:
+      return foldCompareConst<WASMType::I32, CompareOperator::CO_GT_U>(Ip, End);
+    case Opcode::I32_LE_S:
+      return foldCompareConst<WASMType::I32, CompareOperator::CO_LE_S>(Ip, End);
+    case Opcode::I32_LE_U:
+      return foldCompareConst<WASMType::I32, CompareOperator::CO_LE_U>(Ip, End);
+    case Opcode::I32_GE_S:
+      return foldCompareConst<WASMType::I32, CompareOperator::CO_GE_S>(Ip, End);
+    case Opcode::I32_GE_U:
+      return foldCompareConst<WASMType::I32, CompareOperator::CO_GE_U>(Ip, End);
+
+    case Opcode::I64_EQZ:
+      return foldCompareConst<WASMType::I64, CompareOperator::CO_EQZ>(Ip, End);
+    case Opcode::I64_EQ:
+      return foldCompareConst<WASMType::I64, CompareOperator::CO_EQ>(Ip, End);
+    case Opcode::I64_NE:
+      return foldCompareConst<WASMType::I64, CompareOperator::CO_NE>(Ip, End);
+    case Opcode::I64_LT_S:
+      return foldCompareConst<WASMType::I64, CompareOperator::CO_LT_S>(Ip, End);
+    case Opcode::I64_LT_U:
+      return foldCompareConst<WASMType::I64, CompareOperator::CO_LT_U>(Ip, End);
+    case Opcode::I64_GT_S:
+      return foldCompareConst<WASMType::I64, CompareOperator::CO_GT_S>(Ip, End);
+    case Opcode::I64_GT_U:
+      return foldCompareConst<WASMType::I64, CompareOperator::CO_GT_U>(Ip, End);
+    case Opcode::I64_LE_S:
+      return foldCompareConst<WASMType::I64, CompareOperator::CO_LE_S>(Ip, End);
+    case Opcode::I64_LE_U:
+      return foldCompareConst<WASMType::I64, CompareOperator::CO_LE_U>(Ip, End);
+    case Opcode::I64_GE_S:
+      return foldCompareConst<WASMType::I64, CompareOperator::CO_GE_S>(Ip, End);
+    case Opcode::I64_GE_U:
+      return foldCompareConst<WASMType::I64, CompareOperator::CO_GE_U>(Ip, End);
+
+    case Opcode::I32_CLZ:
+      return foldBitCountConst<WASMType::I32, UnaryOperator::UO_CLZ>();
+    case Opcode::I32_CTZ:
+      return foldBitCountConst<WASMType::I32, UnaryOperator::UO_CTZ>();
+    case Opcode::I32_POPCNT:
+      return foldBitCountConst<WASMType::I32, UnaryOperator::UO_POPCNT>();
+    case Opcode::I64_CLZ:
+      return foldBitCountConst<WASMType::I64, UnaryOperator::UO_CLZ>();
+    case Opcode::I64_CTZ:
+      return foldBitCountConst<WASMType::I64, UnaryOperator::UO_CTZ>();
+    case Opcode::I64_POPCNT:
+      return foldBitCountConst<WASMType::I64, UnaryOperator::UO_POPCNT>();
+
+    case Opcode::I32_ADD:
+      return foldBinaryConst<WASMType::I32, BinaryOperator::BO_ADD>();
+    case Opcode::I32_SUB:
+      return foldBinaryConst<WASMType::I32, BinaryOperator::BO_SUB>();
+    case Opcode::I32_MUL:
+      return foldBinaryConst<WASMType::I32, BinaryOperator::BO_MUL>();
+    case Opcode::I32_DIV_S:
+      return foldBinaryConst<WASMType::I32, BinaryOperator::BO_DIV_S>();
+    case Opcode::I32_DIV_U:
+      return foldBinaryConst<WASMType::I32, BinaryOperator::BO_DIV_U>();
+    case Opcode::I32_REM_S:
+      return foldBinaryConst<WASMType::I32, BinaryOperator::BO_REM_S>();
+    case Opcode::I32_REM_U:
+      return foldBinaryConst<WASMType::I32, BinaryOperator::BO_REM_U>();
+    case Opcode::I32_AND:
+      return foldBinaryConst<WASMType::I32, BinaryOperator::BO_AND>();
+    case Opcode::I32_OR:
+      return foldBinaryConst<WASMType::I32, BinaryOperator::BO_OR>();
+    case Opcode::I32_XOR:
+      return foldBinaryConst<WASMType::I32, BinaryOperator::BO_XOR>();
+    case Opcode::I32_SHL:
+      return foldBinaryConst<WASMType::I32, BinaryOperator::BO_SHL>();
+    case Opcode::I32_SHR_S:
+      return foldBinaryConst<WASMType::I32, BinaryOperator::BO_SHR_S>();
+    case Opcode::I32_SHR_U:
+      return foldBinaryConst<WASMType::I32, BinaryOperator::BO_SHR_U>();
+    case Opcode::I32_ROTL:
+      return foldBinaryConst<WASMType::I32, BinaryOperator::BO_ROTL>();
+    case Opcode::I32_ROTR:
+      return foldBinaryConst<WASMType::I32, BinaryOperator::BO_ROTR>();
+
+    case Opcode::I64_ADD:
+      return foldBinaryConst<WASMType::I64, BinaryOperator::BO_ADD>();
+    case Opcode::I64_SUB:
+      return foldBinaryConst<WASMType::I64, BinaryOperator::BO_SUB>();
+    case Opcode::I64_MUL:
+      return foldBinaryConst<WASMType::I64, BinaryOperator::BO_MUL>();
+    case Opcode::I64_DIV_S:
+      return foldBinaryConst<WASMType::I64, BinaryOperator::BO_DIV_S>();
+    case Opcode::I64_DIV_U:
+      return foldBinaryConst<WASMType::I64, BinaryOperator::BO_DIV_U>();
+    case Opcode::I64_REM_S:
+      return foldBinaryConst<WASMType::I64, BinaryOperator::BO_REM_S>();
+    case Opcode::I64_REM_U:
+      return foldBinaryConst<WASMType::I64, BinaryOperator::BO_REM_U>();
+    case Opcode::I64_AND:
+      return foldBinaryConst<WASMType::I64, BinaryOperator::BO_AND>();
+    case Opcode::I64_OR:
+      return foldBinaryConst<WASMType::I64, BinaryOperator::BO_OR>();
+    case Opcode::I64_XOR:
+      return foldBinaryConst<WASMType::I64, BinaryOperator::BO_XOR>();
+    case Opcode::I64_SHL:
+      return foldBinaryConst<WASMType::I64, BinaryOperator::BO_SHL>();
+    case Opcode::I64_SHR_S:
+      return foldBinaryConst<WASMType::I64, BinaryOperator::BO_SHR_S>();
+    case Opcode::I64_SHR_U:
+      return foldBinaryConst<WASMType::I64, BinaryOperator::BO_SHR_U>();
+    case Opcode::I64_ROTL:
+      return foldBinaryConst<WASMType::I64, BinaryOperator::BO_ROTL>();
+    case Opcode::I64_ROTR:
+      return foldBinaryConst<WASMType::I64, BinaryOperator::BO_ROTR>();
+
+    case Opcode::I32_WRAP_I64:
+      return foldIntExtendConst<WASMType::I32, WASMType::I64, WASMType::I32,
+                                false>();
+    case Opcode::I64_EXTEND_S_I32:
+      return foldIntExtendConst<WASMType::I64, WASMType::I32, WASMType::I32,
+                                true>();
+    case Opcode::I64_EXTEND_U_I32:
+      return foldIntExtendConst<WASMType::I64, WASMType::I32, WASMType::I32,
+                                false>();
+    case Opcode::I32_EXTEND8_S:
+      return foldIntExtendConst<WASMType::I32, WASMType::I32, WASMType::I8,
+                                true>();
+    case Opcode::I32_EXTEND16_S:
+      return foldIntExtendConst<WASMType::I32, WASMType::I32, WASMType::I16,
+                                true>();
+    case Opcode::I64_EXTEND8_S:
+      return foldIntExtendConst<WASMType::I64, WASMType::I64, WASMType::I8,
+                                true>();
+    case Opcode::I64_EXTEND16_S:
+      return foldIntExtendConst<WASMType::I64, WASMType::I64, WASMType::I16,
+                                true>();
+    case Opcode::I64_EXTEND32_S:
+      return foldIntExtendConst<WASMType::I64, WASMType::I64, WASMType::I32,
+                                true>();
+
+    default:
+      return false;
+    }
+  }
+
+  // Emit the pending constants in order, as if they were never deferred
+  void flushPendingConsts() {
+    for (const PendingConst &Const : PendingConsts) {
+      if (Const.Type == WASMType::I32) {
+        handleConst<WASMType::I32>(static_cast<int32_t>(Const.Val));
+      } else {
+        ZEN_ASSERT(Const.Type == WASMType::I64);
+        handleConst<WASMType::I64>(Const.Val);
+      }
+    }
+    PendingConsts.clear();
+  }
+
+  template <WASMType Ty>
+  void pushPendingConst(typename WASMTypeAttr<Ty>::Type Val) {
+    PendingConsts.push_back({Ty, static_cast<int64_t>(Val)});
+  }
+
+  template <WASMType Ty> typename WASMTypeAttr<Ty>::Type popPendingConst() {
+    ZEN_ASSERT(!PendingConsts.empty());
+    ZEN_ASSERT(PendingConsts.back().Type == Ty);
+    int64_t Val = PendingConsts.back().Val;
+    PendingConsts.pop_back();
+    return static_cast<typename WASMTypeAttr<Ty>::Type>(Val);
+  }
+
+  template <WASMType Ty, CompareOperator Opr>
+  bool foldCompareConst(const uint8_t *Ip, const uint8_t *End) {
+    constexpr uint32_t NumOperands = (Opr == CompareOperator::CO_EQZ) ? 1 : 2;
+    if (PendingConsts.size() < NumOperands) {
+      return false;
+    }
+    // Keep the macro-fusion with the consumer of the condition
+    if (Ip < End && (*Ip == Opcode::IF || *Ip == Opcode::BR_IF ||
+                     *Ip == Opcode::SELECT || *Ip == Opcode::SELECT_64)) {
+      return false;
+    }
+
+    typedef typename WASMTypeAttr<Ty>::Type T;
+    typedef std::make_unsigned_t<T> UT;
+    T RHS = (Opr != CompareOperator::CO_EQZ) ? popPendingConst<Ty>() : 0;
+    T LHS = popPendingConst<Ty>();
+    UT URHS = static_cast<UT>(RHS);
+    UT ULHS = static_cast<UT>(LHS);
+    bool Result;
+    switch (Opr) {
+    case CompareOperator::CO_EQZ:
+      Result = LHS == 0;
+      break;
+    case CompareOperator::CO_EQ:
+      Result = LHS == RHS;
+      break;
+    case CompareOperator::CO_NE:
+      Result = LHS != RHS;
+      break;
+    case CompareOperator::CO_LT_S:
+      Result = LHS < RHS;
+      break;
+    case CompareOperator::CO_LT_U:
+      Result = ULHS < URHS;
+      break;
+    case CompareOperator::CO_GT_S:
+      Result = LHS > RHS;
+      break;
+    case CompareOperator::CO_GT_U:
+      Result = ULHS > URHS;
+      break;
+    case CompareOperator::CO_LE_S:
+      Result = LHS <= RHS;
+      break;
+    case CompareOperator::CO_LE_U:
+      Result = ULHS <= URHS;
+      break;
+    case CompareOperator::CO_GE_S:
+      Result = LHS >= RHS;
+      break;
+    case CompareOperator::CO_GE_U:
+      Result = ULHS >= URHS;
+      break;
+    default:
+      ZEN_UNREACHABLE();
+    }
+    pushPendingConst<WASMType::I32>(Result ? 1 : 0);
+    return true;
+  }
+
+  template <WASMType Ty, UnaryOperator Opr> bool foldBitCountConst() {
+    if (PendingConsts.empty()) {
+      return false;
+    }
+    typedef typename WASMTypeAttr<Ty>::Type T;
+    constexpr uint32_t NumBits = sizeof(T) * 8;
+    uint64_t Val = static_cast<std::make_unsigned_t<T>>(popPendingConst<Ty>());
+    uint32_t Result;
+    switch (Opr) {
+    case UnaryOperator::UO_CLZ:
+      Result = Val ? __builtin_clzll(Val) - (64 - NumBits) : NumBits;
+      break;
+    case UnaryOperator::UO_CTZ:
+      Result = Val ? __builtin_ctzll(Val) : NumBits;
+      break;
+    case UnaryOperator::UO_POPCNT:
+      Result = __builtin_popcountll(Val);
+      break;
+    default:
+      ZEN_UNREACHABLE();
+    }
+    pushPendingConst<Ty>(static_cast<T>(Result));
+    return true;
+  }
+
+  // Operations which trap at runtime are never folded
+  template <WASMType Ty, BinaryOperator Opr> bool foldBinaryConst() {
+    if (PendingConsts.size() < 2) {
+      return false;
+    }
+    typedef typename WASMTypeAttr<Ty>::Type T;
+    typedef std::make_unsigned_t<T> UT;
+    constexpr UT ShiftMask = sizeof(T) * 8 - 1;
+    size_t NumConsts = PendingConsts.size();
+    T RHS = static_cast<T>(PendingConsts[NumConsts - 1].Val);
+    T LHS = static_cast<T>(PendingConsts[NumConsts - 2].Val);
+    UT URHS = static_cast<UT>(RHS);
+    UT ULHS = static_cast<UT>(LHS);
+    UT Result;
+    switch (Opr) {
+    case BinaryOperator::BO_ADD:
+      Result = ULHS + URHS;
+      break;
+    case BinaryOperator::BO_SUB:
+      Result = ULHS - URHS;
+      break;
+    case BinaryOperator::BO_MUL:
+      Result = ULHS * URHS;
+      break;
+    case BinaryOperator::BO_DIV_S:
+      if (RHS == 0 ||
+          (LHS == std::numeric_limits<T>::min() && RHS == -1)) {
+        return false;
+      }
+      Result = static_cast<UT>(LHS / RHS);
+      break;
+    case BinaryOperator::BO_DIV_U:
+      if (URHS == 0) {
+        return false;
+      }
+      Result = ULHS / URHS;
+      break;
+    case BinaryOperator::BO_REM_S:
+      if (RHS == 0) {
+        return false;
+      }
+      // INT_MIN % -1 overflows in C++, but is 0 in WASM
+      Result = (RHS == -1) ? 0 : static_cast<UT>(LHS % RHS);
+      break;
+    case BinaryOperator::BO_REM_U:
+      if (URHS == 0) {
+        return false;
+      }
+      Result = ULHS % URHS;
+      break;
+    case BinaryOperator::BO_AND:
+      Result = ULHS & URHS;
+      break;
+    case BinaryOperator::BO_OR:
+      Result = ULHS | URHS;
+      break;
+    case BinaryOperator::BO_XOR:
+      Result = ULHS ^ URHS;
+      break;
+    case BinaryOperator::BO_SHL:
+      Result = ULHS << (URHS & ShiftMask);
+      break;
+    case BinaryOperator::BO_SHR_S:
+      Result = static_cast<UT>(LHS >> (URHS & ShiftMask));
+      break;
+    case BinaryOperator::BO_SHR_U:
+      Result = ULHS >> (URHS & ShiftMask);
+      break;
+    case BinaryOperator::BO_ROTL: {
+      UT Count = URHS & ShiftMask;
+      Result = Count ? (ULHS << Count) | (ULHS >> (ShiftMask + 1 - Count))
+                     : ULHS;
+      break;
+    }
+    case BinaryOperator::BO_ROTR: {
+      UT Count = URHS & ShiftMask;
+      Result = Count ? (ULHS >> Count) | (ULHS << (ShiftMask + 1 - Count))
+                     : ULHS;
+      break;
+    }
+    default:
+      ZEN_UNREACHABLE();
+    }
+    PendingConsts.pop_back();
+    PendingConsts.pop_back();
+    pushPendingConst<Ty>(static_cast<T>(Result));
+    return true;
+  }
+
+  // Truncate the constant of `SrcType` to `NarrowType`, then extend it to
+  // `DestType`, covers wrap, extend and the sign-extension operators
+  template <WASMType DestType, WASMType SrcType, WASMType NarrowType,
+            bool Sext>
+  bool foldIntExtendConst() {
+    if (PendingConsts.empty()) {
+      return false;
+    }
+    typedef typename WASMTypeAttr<NarrowType>::Type NarrowT;
+    NarrowT Val = static_cast<NarrowT>(popPendingConst<SrcType>());
+    typedef typename WASMTypeAttr<DestType>::Type DestT;
+    DestT Result = Sext ? static_cast<DestT>(Val)
+                        : static_cast<DestT>(
+                              static_cast<std::make_unsigned_t<NarrowT>>(Val));
+    pushPendingConst<DestType>(Result);
+    return true;
+  }
+
   // ==================== Util Methods ====================
 
   // Verify consistency between control block and eval block
@@ -1237,8 +1807,15 @@ private:
     push(Result);
   }
 
+  // Integer constant which is not emitted yet, logically above `Stack`
+  struct PendingConst {
+    WASMType Type;
+    int64_t Val;
+  };
+
   IRBuilder &Builder;   // ir builder
   EvalStack Stack;      // byte code evaluation stack
+  std::vector<PendingConst> PendingConsts;
   CompilerContext *Ctx; // context
   const runtime::Module *CurMod;
   const runtime::CodeEntry *CurFunc;
@@ -38,4 +38,47 @@ void performJITCompile(runtime::Module &Mod) {
   }
 }
 
+StreamingJITCompiler::StreamingJITCompiler(runtime::Module &Mod) : Mod(Mod) {}
+
+StreamingJITCompiler::~StreamingJITCompiler() = default;
+
+bool StreamingJITCompiler::isSupported(const runtime::Module &Mod) {
+#ifdef ZEN_ENABLE_MULTIPASS_JIT
+  const auto &Config = Mod.getRuntime()->getConfig();
+  return Config.Mode == common::RunMode::MultipassMode &&
+         !Config.EnableMultipassLazy;
+#else
+  return false;
+#endif
+}
+
+void StreamingJITCompiler::onCodeSectionStart() {
+#ifdef ZEN_ENABLE_MULTIPASS_JIT
+  ZEN_ASSERT(!Compiler);
+  Compiler = std::make_unique<COMPILER::EagerJITCompiler>(&Mod);
+  Compiler->beginCompile();
+#endif
+}
+
+void StreamingJITCompiler::onFunctionLoaded(uint32_t FuncIdx) {
+#ifdef ZEN_ENABLE_MULTIPASS_JIT
+  ZEN_ASSERT(Compiler);
+  Compiler->dispatchCompileTask(FuncIdx);
+#endif
+}
+
+void StreamingJITCompiler::finish() {
+#ifdef ZEN_ENABLE_MULTIPASS_JIT
+  // No code section, nothing to compile
+  if (Compiler) {
+    // The functions dispatched before finding v128 values or multi-value
+    // blocks are useless if the whole module is executed by the interpreter
+    if (!Mod.isInterpOnly()) {
+      Compiler->finishCompile();
+    }
+    Compiler.reset();
+  }
+#endif
+}
+
 } // namespace zen::action
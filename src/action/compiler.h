@@ -4,12 +4,44 @@
 #ifndef ZEN_ACTION_COMPILER_H
 #define ZEN_ACTION_COMPILER_H
 
+#include "action/module_loader.h"
 #include "runtime/module.h"
 
+#ifdef ZEN_ENABLE_MULTIPASS_JIT
+namespace COMPILER {
+class EagerJITCompiler;
+} // namespace COMPILER
+#endif
+
 namespace zen::action {
 
 void performJITCompile(runtime::Module &Mod);
 
+// Compile functions while the module is being loaded, each function is
+// dispatched to the multipass JIT thread pool as soon as it is validated
+class StreamingJITCompiler final : public FunctionLoadListener {
+public:
+  explicit StreamingJITCompiler(runtime::Module &Mod);
+
+  ~StreamingJITCompiler() override;
+
+  // Only multipass eager mode compiles functions independently
+  static bool isSupported(const runtime::Module &Mod);
+
+  void onCodeSectionStart() override;
+
+  void onFunctionLoaded(uint32_t FuncIdx) override;
+
+  // Wait for all dispatched functions and link them
+  void finish();
+
+private:
+  runtime::Module &Mod;
+#ifdef ZEN_ENABLE_MULTIPASS_JIT
+  std::unique_ptr<COMPILER::EagerJITCompiler> Compiler;
+#endif
+};
+
 } // namespace zen::action
 
 #endif // ZEN_ACTION_COMPILER_H
@@ -4,6 +4,7 @@
 #include "action/function_loader.h"
 #include "utils/others.h"
 #include "utils/wasm.h"
+#include <algorithm>
 
 namespace zen::action {
 
@@ -20,7 +21,7 @@ bool FunctionLoader::ControlBlockType::isBalanced() const {
   uint32_t NumParamTypes = Type->NumParams;
   uint32_t NumReturnTypes = Type->NumReturns;
   const WASMType *ParamTypes = Type->getParamTypes();
-  const WASMType *ReturnTypes = Type->ReturnTypes;
+  const WASMType *ReturnTypes = Type->getReturnTypes();
   return NumParamTypes == NumReturnTypes &&
          std::memcmp(ParamTypes, ReturnTypes,
                      NumParamTypes * sizeof(WASMType)) == 0;
@@ -48,7 +49,7 @@ FunctionLoader::ControlBlockType::getReturnTypes() const {
   const TypeEntry *Type = std::get<const TypeEntry *>(TypeVariant);
   return {
       static_cast<uint32_t>(Type->NumReturns),
-      Type->ReturnTypes,
+      Type->getReturnTypes(),
   };
 }
 
@@ -206,6 +207,38 @@ void FunctionLoader::checkTargetBlockStack(uint32_t NumTypes,
   }
 }
 
+void FunctionLoader::checkTailCallReturns(const TypeEntry &CalleeType) {
+  if (CalleeType.NumReturns != FuncTypeEntry.NumReturns) {
+    throw getErrorWithExtraMessage(ErrorCode::TypeMismatch,
+                                   "tail call result count");
+  }
+  const WASMType *CalleeReturnTypes = CalleeType.getReturnTypes();
+  const WASMType *ReturnTypes = FuncTypeEntry.getReturnTypes();
+  for (uint32_t I = 0; I < CalleeType.NumReturns; ++I) {
+    if (CalleeReturnTypes[I] != ReturnTypes[I]) {
+      throw getErrorWithExtraMessage(
+          ErrorCode::TypeMismatch,
+          getTypeErrorMsg(ReturnTypes[I], CalleeReturnTypes[I]));
+    }
+  }
+  resetStack();
+  setStackPolymorphic(true);
+}
+
+void FunctionLoader::markInterpOnlyType(const TypeEntry &Type) {
+  if (Type.NumReturns > 1) {
+    FuncCodeEntry.Stats |= Module::SF_multi_value;
+  }
+  const WASMType *ParamTypes = Type.getParamTypes();
+  const WASMType *ReturnTypes = Type.getReturnTypes();
+  if (std::find(ParamTypes, ParamTypes + Type.NumParams, WASMType::V128) !=
+          ParamTypes + Type.NumParams ||
+      std::find(ReturnTypes, ReturnTypes + Type.NumReturns, WASMType::V128) !=
+          ReturnTypes + Type.NumReturns) {
+    FuncCodeEntry.Stats |= Module::SF_simd;
+  }
+}
+
 void FunctionLoader::checkBlockStack() {
   ZEN_ASSERT(!ControlBlocks.empty());
   ControlBlock &Block = ControlBlocks.back();
@@ -214,6 +247,30 @@ void FunctionLoader::checkBlockStack() {
   checkTopTypes(Block, NumReturnTypes, ReturnTypes, false);
 }
 
+FunctionLoader::ControlBlockType FunctionLoader::readControlBlockType() {
+  if (Ptr >= End) {
+    throw getError(ErrorCode::UnexpectedEnd);
+  }
+  WASMType Type = getWASMBlockTypeFromOpcode(to_underlying(*Ptr));
+  if (Type != WASMType::ERROR_TYPE) {
+    ++Ptr;
+    if (Type == WASMType::V128) {
+      FuncCodeEntry.Stats |= Module::SF_simd;
+    }
+    return Type;
+  }
+
+  // Type index encoded as a positive s33
+  int64_t TypeIdx = readI64();
+  if (TypeIdx < 0 || TypeIdx > UINT32_MAX ||
+      !Mod.isValidType(static_cast<uint32_t>(TypeIdx))) {
+    throw getError(ErrorCode::UnknownTypeIdx);
+  }
+  FuncCodeEntry.Stats |= Module::SF_multi_value;
+  return static_cast<const TypeEntry *>(
+      Mod.getDeclaredType(static_cast<uint32_t>(TypeIdx)));
+}
+
 const FunctionLoader::ControlBlock &FunctionLoader::checkBranch() {
   uint32_t Depth = readU32();
   if (ControlBlocks.size() <= Depth) {
@@ -263,8 +320,453 @@ WASMType FunctionLoader::readLocal() {
   return FuncCodeEntry.LocalTypes[LocalIdx - NumParams];
 }
 
+void FunctionLoader::checkDataSegmentIdx(uint32_t DataSegIdx) {
+  // Function bodies are loaded before the data section, so the data count
+  // section is required to validate the data segment index
+  if (Mod.DataCount == -1u) {
+    throw getError(ErrorCode::DataCountSectionRequired);
+  }
+  if (DataSegIdx >= Mod.DataCount) {
+    throw getError(ErrorCode::UnknownDataSegment);
+  }
+}
+
+void FunctionLoader::checkFCInstruction() {
+  uint32_t FCOpcode = readU32();
+  switch (FCOpcode) {
+  case I32_TRUNC_SAT_S_F32:
+  case I32_TRUNC_SAT_U_F32:
+    popAndPushValueType(1, WASMType::F32, WASMType::I32);
+    break;
+  case I32_TRUNC_SAT_S_F64:
+  case I32_TRUNC_SAT_U_F64:
+    popAndPushValueType(1, WASMType::F64, WASMType::I32);
+    break;
+  case I64_TRUNC_SAT_S_F32:
+  case I64_TRUNC_SAT_U_F32:
+    popAndPushValueType(1, WASMType::F32, WASMType::I64);
+    break;
+  case I64_TRUNC_SAT_S_F64:
+  case I64_TRUNC_SAT_U_F64:
+    popAndPushValueType(1, WASMType::F64, WASMType::I64);
+    break;
+  case MEMORY_INIT: {
+    uint32_t DataSegIdx = readU32();
+    if (!hasMemory()) {
+      throw getError(ErrorCode::UnknownMemory);
+    }
+    if (to_underlying(readByte()) != 0x00) {
+      throw getError(ErrorCode::ZeroFlagExpected);
+    }
+    checkDataSegmentIdx(DataSegIdx);
+    // (dest, src, size)
+    popValueType(WASMType::I32);
+    popValueType(WASMType::I32);
+    popValueType(WASMType::I32);
+    FuncCodeEntry.Stats |= Module::SF_memory;
+    break;
+  }
+  case DATA_DROP:
+    checkDataSegmentIdx(readU32());
+    break;
+  case MEMORY_COPY:
+  case MEMORY_FILL: {
+    if (!hasMemory()) {
+      throw getError(ErrorCode::UnknownMemory);
+    }
+    // memory.copy has both the destination and source memory index
+    uint32_t NumMemIdxs = FCOpcode == MEMORY_COPY ? 2 : 1;
+    for (uint32_t I = 0; I < NumMemIdxs; ++I) {
+      if (to_underlying(readByte()) != 0x00) {
+        throw getError(ErrorCode::ZeroFlagExpected);
+      }
+    }
+    // (dest, src, size) or (dest, value, size)
+    popValueType(WASMType::I32);
+    popValueType(WASMType::I32);
+    popValueType(WASMType::I32);
+    FuncCodeEntry.Stats |= Module::SF_memory;
+    break;
+  }
+  default:
+    throw getErrorWithExtraMessage(ErrorCode::UnsupportedOpcode,
+                                   getOpcodeHexString(PREFIX_FC) + ' ' +
+                                       std::to_string(FCOpcode));
+  }
+}
+
+void FunctionLoader::readSIMDMemArg(uint32_t MaxAlign) {
+  if (!hasMemory()) {
+    throw getError(ErrorCode::UnknownMemory);
+  }
+  uint32_t Align = readU32();
+  [[maybe_unused]] uint32_t Offset = readU32();
+  if (Align > MaxAlign) {
+    throw getError(ErrorCode::AlignMustLargerThanNatural);
+  }
+  FuncCodeEntry.Stats |= Module::SF_memory;
+}
+
+void FunctionLoader::readLaneIdx(uint32_t NumLanes) {
+  if (to_underlying(readByte()) >= NumLanes) {
+    throw getError(ErrorCode::InvalidLaneIndex);
+  }
+}
+
+void FunctionLoader::checkFDInstruction() {
+  uint32_t FDOpcode = readU32();
+  switch (FDOpcode) {
+  case V128_LOAD:
+    readSIMDMemArg(4);
+    popAndPushValueType(1, WASMType::I32, WASMType::V128);
+    break;
+  case V128_LOAD8X8_S:
+  case V128_LOAD8X8_U:
+  case V128_LOAD16X4_S:
+  case V128_LOAD16X4_U:
+  case V128_LOAD32X2_S:
+  case V128_LOAD32X2_U:
+  case V128_LOAD64_SPLAT:
+  case V128_LOAD64_ZERO:
+    readSIMDMemArg(3);
+    popAndPushValueType(1, WASMType::I32, WASMType::V128);
+    break;
+  case V128_LOAD8_SPLAT:
+    readSIMDMemArg(0);
+    popAndPushValueType(1, WASMType::I32, WASMType::V128);
+    break;
+  case V128_LOAD16_SPLAT:
+    readSIMDMemArg(1);
+    popAndPushValueType(1, WASMType::I32, WASMType::V128);
+    break;
+  case V128_LOAD32_SPLAT:
+  case V128_LOAD32_ZERO:
+    readSIMDMemArg(2);
+    popAndPushValueType(1, WASMType::I32, WASMType::V128);
+    break;
+  case V128_STORE:
+    readSIMDMemArg(4);
+    popValueType(WASMType::V128);
+    popValueType(WASMType::I32);
+    break;
+  case V128_LOAD8_LANE:
+  case V128_LOAD16_LANE:
+  case V128_LOAD32_LANE:
+  case V128_LOAD64_LANE:
+  case V128_STORE8_LANE:
+  case V128_STORE16_LANE:
+  case V128_STORE32_LANE:
+  case V128_STORE64_LANE: {
+    // log2 of the lane size
+    uint32_t LaneShift = (FDOpcode - V128_LOAD8_LANE) & 3;
+    readSIMDMemArg(LaneShift);
+    readLaneIdx(16 >> LaneShift);
+    popValueType(WASMType::V128);
+    popValueType(WASMType::I32);
+    if (FDOpcode <= V128_LOAD64_LANE) {
+      pushValueType(WASMType::V128);
+    }
+    break;
+  }
+  case V128_CONST:
+    readBytes(16);
+    pushValueType(WASMType::V128);
+    break;
+  case I8X16_SHUFFLE:
+    for (uint32_t I = 0; I < 16; ++I) {
+      readLaneIdx(32);
+    }
+    popAndPushValueType(2, WASMType::V128, WASMType::V128);
+    break;
+  case I8X16_SPLAT:
+  case I16X8_SPLAT:
+  case I32X4_SPLAT:
+    popAndPushValueType(1, WASMType::I32, WASMType::V128);
+    break;
+  case I64X2_SPLAT:
+    popAndPushValueType(1, WASMType::I64, WASMType::V128);
+    break;
+  case F32X4_SPLAT:
+    popAndPushValueType(1, WASMType::F32, WASMType::V128);
+    break;
+  case F64X2_SPLAT:
+    popAndPushValueType(1, WASMType::F64, WASMType::V128);
+    break;
+  case I8X16_EXTRACT_LANE_S:
+  case I8X16_EXTRACT_LANE_U:
+    readLaneIdx(16);
+    popAndPushValueType(1, WASMType::V128, WASMType::I32);
+    break;
+  case I16X8_EXTRACT_LANE_S:
+  case I16X8_EXTRACT_LANE_U:
+    readLaneIdx(8);
+    popAndPushValueType(1, WASMType::V128, WASMType::I32);
+    break;
+  case I32X4_EXTRACT_LANE:
+    readLaneIdx(4);
+    popAndPushValueType(1, WASMType::V128, WASMType::I32);
+    break;
+  case I64X2_EXTRACT_LANE:
+    readLaneIdx(2);
+    popAndPushValueType(1, WASMType::V128, WASMType::I64);
+    break;
+  case F32X4_EXTRACT_LANE:
+    readLaneIdx(4);
+    popAndPushValueType(1, WASMType::V128, WASMType::F32);
+    break;
+  case F64X2_EXTRACT_LANE:
+    readLaneIdx(2);
+    popAndPushValueType(1, WASMType::V128, WASMType::F64);
+    break;
+  case I8X16_REPLACE_LANE:
+    readLaneIdx(16);
+    popValueType(WASMType::I32);
+    popAndPushValueType(1, WASMType::V128, WASMType::V128);
+    break;
+  case I16X8_REPLACE_LANE:
+    readLaneIdx(8);
+    popValueType(WASMType::I32);
+    popAndPushValueType(1, WASMType::V128, WASMType::V128);
+    break;
+  case I32X4_REPLACE_LANE:
+    readLaneIdx(4);
+    popValueType(WASMType::I32);
+    popAndPushValueType(1, WASMType::V128, WASMType::V128);
+    break;
+  case I64X2_REPLACE_LANE:
+    readLaneIdx(2);
+    popValueType(WASMType::I64);
+    popAndPushValueType(1, WASMType::V128, WASMType::V128);
+    break;
+  case F32X4_REPLACE_LANE:
+    readLaneIdx(4);
+    popValueType(WASMType::F32);
+    popAndPushValueType(1, WASMType::V128, WASMType::V128);
+    break;
+  case F64X2_REPLACE_LANE:
+    readLaneIdx(2);
+    popValueType(WASMType::F64);
+    popAndPushValueType(1, WASMType::V128, WASMType::V128);
+    break;
+  case V128_BITSELECT:
+    popAndPushValueType(3, WASMType::V128, WASMType::V128);
+    break;
+  case V128_ANY_TRUE:
+  case I8X16_ALL_TRUE:
+  case I8X16_BITMASK:
+  case I16X8_ALL_TRUE:
+  case I16X8_BITMASK:
+  case I32X4_ALL_TRUE:
+  case I32X4_BITMASK:
+  case I64X2_ALL_TRUE:
+  case I64X2_BITMASK:
+    popAndPushValueType(1, WASMType::V128, WASMType::I32);
+    break;
+  case I8X16_SHL:
+  case I8X16_SHR_S:
+  case I8X16_SHR_U:
+  case I16X8_SHL:
+  case I16X8_SHR_S:
+  case I16X8_SHR_U:
+  case I32X4_SHL:
+  case I32X4_SHR_S:
+  case I32X4_SHR_U:
+  case I64X2_SHL:
+  case I64X2_SHR_S:
+  case I64X2_SHR_U:
+    popValueType(WASMType::I32);
+    popAndPushValueType(1, WASMType::V128, WASMType::V128);
+    break;
+  case V128_NOT:
+  case I8X16_ABS:
+  case I8X16_NEG:
+  case I8X16_POPCNT:
+  case I16X8_EXTADD_PAIRWISE_I8X16_S:
+  case I16X8_EXTADD_PAIRWISE_I8X16_U:
+  case I32X4_EXTADD_PAIRWISE_I16X8_S:
+  case I32X4_EXTADD_PAIRWISE_I16X8_U:
+  case I16X8_ABS:
+  case I16X8_NEG:
+  case I16X8_EXTEND_LOW_I8X16_S:
+  case I16X8_EXTEND_HIGH_I8X16_S:
+  case I16X8_EXTEND_LOW_I8X16_U:
+  case I16X8_EXTEND_HIGH_I8X16_U:
+  case I32X4_ABS:
+  case I32X4_NEG:
+  case I32X4_EXTEND_LOW_I16X8_S:
+  case I32X4_EXTEND_HIGH_I16X8_S:
+  case I32X4_EXTEND_LOW_I16X8_U:
+  case I32X4_EXTEND_HIGH_I16X8_U:
+  case I64X2_ABS:
+  case I64X2_NEG:
+  case I64X2_EXTEND_LOW_I32X4_S:
+  case I64X2_EXTEND_HIGH_I32X4_S:
+  case I64X2_EXTEND_LOW_I32X4_U:
+  case I64X2_EXTEND_HIGH_I32X4_U:
+  case F32X4_DEMOTE_F64X2_ZERO:
+  case F64X2_PROMOTE_LOW_F32X4:
+  case F32X4_CEIL:
+  case F32X4_FLOOR:
+  case F32X4_TRUNC:
+  case F32X4_NEAREST:
+  case F64X2_CEIL:
+  case F64X2_FLOOR:
+  case F64X2_TRUNC:
+  case F64X2_NEAREST:
+  case F32X4_ABS:
+  case F32X4_NEG:
+  case F32X4_SQRT:
+  case F64X2_ABS:
+  case F64X2_NEG:
+  case F64X2_SQRT:
+  case I32X4_TRUNC_SAT_F32X4_S:
+  case I32X4_TRUNC_SAT_F32X4_U:
+  case F32X4_CONVERT_I32X4_S:
+  case F32X4_CONVERT_I32X4_U:
+  case I32X4_TRUNC_SAT_F64X2_S_ZERO:
+  case I32X4_TRUNC_SAT_F64X2_U_ZERO:
+  case F64X2_CONVERT_LOW_I32X4_S:
+  case F64X2_CONVERT_LOW_I32X4_U:
+    popAndPushValueType(1, WASMType::V128, WASMType::V128);
+    break;
+  case I8X16_SWIZZLE:
+  case I8X16_EQ:
+  case I8X16_NE:
+  case I8X16_LT_S:
+  case I8X16_LT_U:
+  case I8X16_GT_S:
+  case I8X16_GT_U:
+  case I8X16_LE_S:
+  case I8X16_LE_U:
+  case I8X16_GE_S:
+  case I8X16_GE_U:
+  case I16X8_EQ:
+  case I16X8_NE:
+  case I16X8_LT_S:
+  case I16X8_LT_U:
+  case I16X8_GT_S:
+  case I16X8_GT_U:
+  case I16X8_LE_S:
+  case I16X8_LE_U:
+  case I16X8_GE_S:
+  case I16X8_GE_U:
+  case I32X4_EQ:
+  case I32X4_NE:
+  case I32X4_LT_S:
+  case I32X4_LT_U:
+  case I32X4_GT_S:
+  case I32X4_GT_U:
+  case I32X4_LE_S:
+  case I32X4_LE_U:
+  case I32X4_GE_S:
+  case I32X4_GE_U:
+  case I64X2_EQ:
+  case I64X2_NE:
+  case I64X2_LT_S:
+  case I64X2_GT_S:
+  case I64X2_LE_S:
+  case I64X2_GE_S:
+  case V128_AND:
+  case V128_ANDNOT:
+  case V128_OR:
+  case V128_XOR:
+  case I8X16_NARROW_I16X8_S:
+  case I8X16_NARROW_I16X8_U:
+  case I8X16_ADD:
+  case I8X16_ADD_SAT_S:
+  case I8X16_ADD_SAT_U:
+  case I8X16_SUB:
+  case I8X16_SUB_SAT_S:
+  case I8X16_SUB_SAT_U:
+  case I8X16_MIN_S:
+  case I8X16_MIN_U:
+  case I8X16_MAX_S:
+  case I8X16_MAX_U:
+  case I8X16_AVGR_U:
+  case I16X8_Q15MULR_SAT_S:
+  case I16X8_NARROW_I32X4_S:
+  case I16X8_NARROW_I32X4_U:
+  case I16X8_ADD:
+  case I16X8_ADD_SAT_S:
+  case I16X8_ADD_SAT_U:
+  case I16X8_SUB:
+  case I16X8_SUB_SAT_S:
+  case I16X8_SUB_SAT_U:
+  case I16X8_MUL:
+  case I16X8_MIN_S:
+  case I16X8_MIN_U:
+  case I16X8_MAX_S:
+  case I16X8_MAX_U:
+  case I16X8_AVGR_U:
+  case I16X8_EXTMUL_LOW_I8X16_S:
+  case I16X8_EXTMUL_HIGH_I8X16_S:
+  case I16X8_EXTMUL_LOW_I8X16_U:
+  case I16X8_EXTMUL_HIGH_I8X16_U:
+  case I32X4_ADD:
+  case I32X4_SUB:
+  case I32X4_MUL:
+  case I32X4_MIN_S:
+  case I32X4_MIN_U:
+  case I32X4_MAX_S:
+  case I32X4_MAX_U:
+  case I32X4_DOT_I16X8_S:
+  case I32X4_EXTMUL_LOW_I16X8_S:
+  case I32X4_EXTMUL_HIGH_I16X8_S:
+  case I32X4_EXTMUL_LOW_I16X8_U:
+  case I32X4_EXTMUL_HIGH_I16X8_U:
+  case I64X2_ADD:
+  case I64X2_SUB:
+  case I64X2_MUL:
+  case I64X2_EXTMUL_LOW_I32X4_S:
+  case I64X2_EXTMUL_HIGH_I32X4_S:
+  case I64X2_EXTMUL_LOW_I32X4_U:
+  case I64X2_EXTMUL_HIGH_I32X4_U:
+  case F32X4_EQ:
+  case F32X4_NE:
+  case F32X4_LT:
+  case F32X4_GT:
+  case F32X4_LE:
+  case F32X4_GE:
+  case F64X2_EQ:
+  case F64X2_NE:
+  case F64X2_LT:
+  case F64X2_GT:
+  case F64X2_LE:
+  case F64X2_GE:
+  case F32X4_ADD:
+  case F32X4_SUB:
+  case F32X4_MUL:
+  case F32X4_DIV:
+  case F32X4_MIN:
+  case F32X4_MAX:
+  case F32X4_PMIN:
+  case F32X4_PMAX:
+  case F64X2_ADD:
+  case F64X2_SUB:
+  case F64X2_MUL:
+  case F64X2_DIV:
+  case F64X2_MIN:
+  case F64X2_MAX:
+  case F64X2_PMIN:
+  case F64X2_PMAX:
+    popAndPushValueType(2, WASMType::V128, WASMType::V128);
+    break;
+  default:
+    throw getErrorWithExtraMessage(ErrorCode::UnsupportedOpcode,
+                                   getOpcodeHexString(PREFIX_FD) + ' ' +
+                                       std::to_string(FDOpcode));
+  }
+  FuncCodeEntry.Stats |= Module::SF_simd;
+}
+
 void FunctionLoader::load() {
   pushBlock(LABEL_FUNCTION, ControlBlockType(&FuncTypeEntry), Ptr);
+  markInterpOnlyType(FuncTypeEntry);
+  const WASMType *LocalTypes = FuncCodeEntry.LocalTypes;
+  if (std::find(LocalTypes, LocalTypes + FuncCodeEntry.NumLocals,
+                WASMType::V128) != LocalTypes + FuncCodeEntry.NumLocals) {
+    FuncCodeEntry.Stats |= Module::SF_simd;
+  }
 #ifdef ZEN_ENABLE_DWASM
   uint32_t NumOpcodes = 0;
 #endif
@@ -287,8 +789,12 @@ void FunctionLoader::load() {
       [[fallthrough]];
     case BLOCK:
     case LOOP: {
-      WASMType Type = readBlockType();
-      ControlBlockType BlockType = Type;
+      ControlBlockType BlockType = readControlBlockType();
+      // The params are moved from the enclosing block into the new block
+      const auto [NumParamTypes, ParamTypes] = BlockType.getParamTypes();
+      for (int32_t I = static_cast<int32_t>(NumParamTypes) - 1; I >= 0; --I) {
+        popValueType(ParamTypes[I]);
+      }
       auto BlockLabelTy = static_cast<LabelType>(LABEL_BLOCK + Opcode - BLOCK);
       pushBlock(BlockLabelTy, BlockType, Ptr);
 
@@ -317,7 +823,9 @@ void FunctionLoader::load() {
       checkBranch();
       break;
     case BR_TABLE: {
+      Byte *OpcodePtr = const_cast<Byte *>(Ptr - 1);
       uint32_t NumTargets = readU32();
+      const Byte *TargetsPtr = Ptr;
 
       popValueType(WASMType::I32);
 
@@ -346,6 +854,7 @@ void FunctionLoader::load() {
           }
         }
       }
+      decodeBrTable(OpcodePtr, TargetsPtr, NumTargets);
 
       resetStack();
       setStackPolymorphic(true);
@@ -404,6 +913,9 @@ void FunctionLoader::load() {
       WASMType GlobalType = Mod.getGlobalType(GlobalIdx);
       pushValueType(GlobalType);
       FuncCodeEntry.Stats |= Module::SF_global;
+      if (GlobalType == WASMType::V128) {
+        FuncCodeEntry.Stats |= Module::SF_simd;
+      }
       break;
     }
     case SET_GLOBAL: {
@@ -422,6 +934,9 @@ void FunctionLoader::load() {
       }
       popValueType(Global.Type);
       FuncCodeEntry.Stats |= Module::SF_global;
+      if (Global.Type == WASMType::V128) {
+        FuncCodeEntry.Stats |= Module::SF_simd;
+      }
       break;
     }
     case MEMORY_SIZE: {
@@ -754,6 +1269,9 @@ void FunctionLoader::load() {
       if (Type == WASMType::I64 || Type == WASMType::F64) {
         Byte *OpcodePtr = const_cast<Byte *>(Ptr - 1);
         *OpcodePtr = Byte(DROP_64);
+      } else if (Type == WASMType::V128) {
+        Byte *OpcodePtr = const_cast<Byte *>(Ptr - 1);
+        *OpcodePtr = Byte(DROP_128);
       }
       break;
     }
@@ -771,6 +1289,9 @@ void FunctionLoader::load() {
       if (Type == WASMType::I64 || Type == WASMType::F64) {
         Byte *OpcodePtr = const_cast<Byte *>(Ptr - 1);
         *OpcodePtr = Byte(SELECT_64);
+      } else if (Type == WASMType::V128) {
+        Byte *OpcodePtr = const_cast<Byte *>(Ptr - 1);
+        *OpcodePtr = Byte(SELECT_128);
       }
       pushValueType(Type);
 
@@ -778,27 +1299,35 @@ void FunctionLoader::load() {
     }
     case RETURN: {
       int32_t NumReturns = static_cast<int32_t>(FuncTypeEntry.NumReturns);
+      const WASMType *ReturnTypes = FuncTypeEntry.getReturnTypes();
       for (int32_t I = NumReturns - 1; I >= 0; --I) {
-        popValueType(FuncTypeEntry.ReturnTypes[I]);
+        popValueType(ReturnTypes[I]);
       }
       resetStack();
       setStackPolymorphic(true);
       break;
     }
-    case CALL: {
+    case CALL:
+    case RETURN_CALL: {
       uint32_t CalleeIdx = readU32();
       if (!Mod.isValidFunc(CalleeIdx)) {
         throw getErrorWithExtraMessage(ErrorCode::UnknownFunction,
                                        '#' + std::to_string(CalleeIdx));
       }
       const TypeEntry *CalleeFuncType = Mod.getFunctionType(CalleeIdx);
+      markInterpOnlyType(*CalleeFuncType);
       int32_t NumParams = static_cast<int32_t>(CalleeFuncType->NumParams);
       for (int32_t I = NumParams; I > 0; --I) {
         const WASMType *ParamTypes = CalleeFuncType->getParamTypes();
         popValueType(ParamTypes[I - 1]);
       }
-      for (uint32_t I = 0; I < CalleeFuncType->NumReturns; ++I) {
-        pushValueType(CalleeFuncType->ReturnTypes[I]);
+      if (Opcode == RETURN_CALL) {
+        checkTailCallReturns(*CalleeFuncType);
+      } else {
+        const WASMType *ReturnTypes = CalleeFuncType->getReturnTypes();
+        for (uint32_t I = 0; I < CalleeFuncType->NumReturns; ++I) {
+          pushValueType(ReturnTypes[I]);
+        }
       }
 #ifdef ZEN_ENABLE_MULTIPASS_JIT
       if (!CalleeIdxBitset[CalleeIdx]) {
@@ -808,7 +1337,8 @@ void FunctionLoader::load() {
 #endif
       break;
     }
-    case CALL_INDIRECT: {
+    case CALL_INDIRECT:
+    case RETURN_CALL_INDIRECT: {
       uint32_t TypeIdx = readU32();
       if (!Mod.isValidType(TypeIdx)) {
         throw getError(ErrorCode::UnknownTypeIdx);
@@ -825,6 +1355,7 @@ void FunctionLoader::load() {
       popValueType(WASMType::I32);
 
       TypeEntry *CalleeFuncType = Mod.getDeclaredType(TypeIdx);
+      markInterpOnlyType(*CalleeFuncType);
 
       int32_t NumParams = static_cast<int32_t>(CalleeFuncType->NumParams);
       for (int32_t I = NumParams; I > 0; --I) {
@@ -832,21 +1363,36 @@ void FunctionLoader::load() {
         popValueType(ParamTypes[I - 1]);
       }
 
-      for (uint32_t I = 0; I < CalleeFuncType->NumReturns; ++I) {
-        pushValueType(CalleeFuncType->ReturnTypes[I]);
+      if (Opcode == RETURN_CALL_INDIRECT) {
+        checkTailCallReturns(*CalleeFuncType);
+      } else {
+        const WASMType *ReturnTypes = CalleeFuncType->getReturnTypes();
+        for (uint32_t I = 0; I < CalleeFuncType->NumReturns; ++I) {
+          pushValueType(ReturnTypes[I]);
+        }
       }
 #ifdef ZEN_ENABLE_MULTIPASS_JIT
-      const auto &LikelyCalleeIdxs = Mod.TypedFuncRefs[TypeIdx];
-      for (uint32_t CalleeIdx : LikelyCalleeIdxs) {
-        if (!CalleeIdxBitset[CalleeIdx]) {
-          CalleeIdxBitset[CalleeIdx] = true;
-          CalleeIdxSeq.push_back(CalleeIdx);
+      // Function bodies may be loaded in parallel, so never insert into the
+      // module maps here
+      auto It = Mod.TypedFuncRefs.find(TypeIdx);
+      if (It != Mod.TypedFuncRefs.end()) {
+        for (uint32_t CalleeIdx : It->second) {
+          if (!CalleeIdxBitset[CalleeIdx]) {
+            CalleeIdxBitset[CalleeIdx] = true;
+            CalleeIdxSeq.push_back(CalleeIdx);
+          }
         }
       }
 #endif
       FuncCodeEntry.Stats |= Module::SF_table;
       break;
     }
+    case PREFIX_FC:
+      checkFCInstruction();
+      break;
+    case PREFIX_FD:
+      checkFDInstruction();
+      break;
     default:
       throw getErrorWithExtraMessage(ErrorCode::UnsupportedOpcode,
                                      getOpcodeHexString(Opcode));
@@ -886,11 +1432,39 @@ void FunctionLoader::load() {
   }
 
 #ifdef ZEN_ENABLE_MULTIPASS_JIT
-  Mod.CallSeqMap[FuncIdx] = std::move(CalleeIdxSeq);
+  Mod.CallSeqMap.at(FuncIdx) = std::move(CalleeIdxSeq);
 #endif
 
   FuncCodeEntry.MaxStackSize = MaxStackSize;
   FuncCodeEntry.MaxBlockDepth = MaxBlockDepth;
 }
 
+void FunctionLoader::decodeBrTable(Byte *OpcodePtr, const Byte *TargetsPtr,
+                                   uint32_t NumTargets) {
+  if (NumTargets < MinDecodedBrTableTargets) {
+    return;
+  }
+  auto *Targets = reinterpret_cast<uint8_t *>(const_cast<Byte *>(TargetsPtr));
+  // The offset overwrites the first targets, which must take one byte each
+  for (uint32_t I = 0; I < DecodedBrTableOffsetBytes; ++I) {
+    if (Targets[I] & 0x80) {
+      return;
+    }
+  }
+
+  // Each target takes at least one byte, so the offset fits in uint32_t
+  uint32_t Offset = static_cast<uint32_t>(BrTableTargets.size());
+  const uint8_t *TargetPtr = Targets;
+  for (uint32_t I = 0; I <= NumTargets; ++I) {
+    uint32_t Depth;
+    TargetPtr = readSafeLEBNumber(TargetPtr, Depth);
+    BrTableTargets.push_back(Depth);
+  }
+
+  for (uint32_t I = 0; I < DecodedBrTableOffsetBytes; ++I) {
+    Targets[I] = (Offset >> (7 * I)) & 0x7f;
+  }
+  *OpcodePtr = Byte(BR_TABLE_DECODED);
+}
+
 } // namespace zen::action
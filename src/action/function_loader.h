@@ -61,6 +61,12 @@ public:
 
   void load();
 
+  // The module allocator isn't thread-safe, so the loading thread copies the
+  // decoded targets into the module after `load`
+  std::vector<uint32_t> takeBrTableTargets() {
+    return std::move(BrTableTargets);
+  }
+
 private:
   static bool checkMemoryAlign(uint8_t Opcode, uint32_t Align);
 
@@ -116,10 +122,40 @@ private:
 
   void checkBlockStack();
 
+  // The results of a tail callee must match the current function's, then the
+  // rest of the block is unreachable like after `return`
+  void checkTailCallReturns(const runtime::TypeEntry &CalleeType);
+
+  // Mark the function as executed by the interpreter if values of `Type` are
+  // passed or returned, which the JIT compilers can't do yet
+  void markInterpOnlyType(const runtime::TypeEntry &Type);
+
+  // Read a value type, or a type index of the block params and results
+  ControlBlockType readControlBlockType();
+
   const ControlBlock &checkBranch();
 
   WASMType readLocal();
 
+  // Validate the instruction following PREFIX_FC
+  void checkFCInstruction();
+
+  // Validate the instruction following PREFIX_FD
+  void checkFDInstruction();
+
+  // Read the memarg of a SIMD load/store whose natural alignment is
+  // `2^MaxAlign` bytes
+  void readSIMDMemArg(uint32_t MaxAlign);
+
+  void readLaneIdx(uint32_t NumLanes);
+
+  void checkDataSegmentIdx(uint32_t DataSegIdx);
+
+  // Rewrite a validated br_table to BR_TABLE_DECODED if it's large enough,
+  // see utils::MinDecodedBrTableTargets
+  void decodeBrTable(Byte *OpcodePtr, const Byte *TargetsPtr,
+                     uint32_t NumTargets);
+
   uint32_t FuncIdx;
   const runtime::TypeEntry &FuncTypeEntry;
   runtime::CodeEntry &FuncCodeEntry;
@@ -129,6 +165,7 @@ private:
   uint32_t MaxBlockDepth = 0;
   std::vector<ControlBlock> ControlBlocks;
   std::vector<WASMType> ValueTypes;
+  std::vector<uint32_t> BrTableTargets;
 };
 
 } // namespace zen::action
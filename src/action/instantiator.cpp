@@ -106,8 +106,7 @@ void Instantiator::instantiateFunctions(Instance &Inst) {
     FuncInst.NumParamCells = Type.NumParamCells;
     FuncInst.NumReturns = Type.NumReturns;
     FuncInst.NumReturnCells = Type.NumReturnCells;
-    std::memcpy(FuncInst.ReturnTypes, Type.ReturnTypes,
-                sizeof(FuncInst.ReturnTypes));
+    FuncInst.ReturnTypes = Type.ReturnTypes;
     FuncInst.ParamTypes = Type.ParamTypes;
     FuncInst.FuncType = &Type;
 
@@ -123,6 +122,7 @@ void Instantiator::instantiateFunctions(Instance &Inst) {
       FuncInst.NumLocalCells = Code.NumLocalCells;
       FuncInst.LocalTypes = Code.LocalTypes;
       FuncInst.LocalOffsets = Code.LocalOffsets;
+      FuncInst.BrTableTargets = Code.BrTableTargets;
       FuncInst.MaxStackSize = Code.MaxStackSize;
       FuncInst.MaxBlockDepth = Code.MaxBlockDepth;
       FuncInst.CodePtr = Code.CodePtr;
@@ -209,6 +209,9 @@ void Instantiator::initMemoryByDataSegments(Instance &Inst) {
   const Module *Mod = Inst.Mod;
   for (uint32_t I = 0; I < Mod->NumDataSegments; ++I) {
     const auto &DataSeg = Mod->DataTable[I];
+    if (DataSeg.Passive) {
+      continue;
+    }
     uint32_t MemIdx = DataSeg.MemIdx;
     // should checked if MemIndex is valid in loader
     MemoryInstance &MemInst = Inst.Memories[MemIdx];
@@ -308,6 +311,12 @@ void Instantiator::instantiateMemories(Instance &Inst) {
   }
 
   initMemoryByDataSegments(Inst);
+
+  // Active data segments behave as dropped once copied into the memory
+  Inst.DroppedDataSegs.resize(Mod.NumDataSegments);
+  for (uint32_t I = 0; I < Mod.NumDataSegments; ++I) {
+    Inst.DroppedDataSegs[I] = !Mod.DataTable[I].Passive;
+  }
 }
 
 #ifdef ZEN_ENABLE_BUILTIN_WASI
@@ -85,6 +85,23 @@ void InterpreterExecContext::freeFrame(FunctionInstance *FuncInst,
 #endif // ZEN_ENABLE_DWASM
 }
 
+InterpFrame *
+InterpreterExecContext::replaceFrame(FunctionInstance *FuncInst,
+                                     InterpFrame *Frame,
+                                     FunctionInstance *Callee) {
+  uint32_t *LocalPtr = Frame->LocalPtr;
+  InterpFrame *PrevFrame = Frame->PrevFrame;
+  freeFrame(FuncInst, Frame);
+  // The locals of `Callee` start right after its arguments
+  Stack->Top = reinterpret_cast<uint8_t *>(LocalPtr + Callee->NumParamCells);
+  setCurFrame(PrevFrame);
+  // The caller finds the results by the number of arguments it passed
+  if (PrevFrame && PrevFrame->Ip) {
+    PrevFrame->ValueStackPtr = LocalPtr + Callee->NumParamCells;
+  }
+  return allocFrame(Callee, LocalPtr);
+}
+
 enum BinaryOperator {
   BO_ADD,
   BO_SUB,
@@ -308,6 +325,228 @@ DECL_COMPARE_IMPL(LE, <=)
 DECL_COMPARE_IMPL(GE, >=)
 #undef DECL_COMPARE_IMPL
 
+// Lanes are accessed by memcpy because the same V128 is viewed as lanes of
+// different widths, lane 0 is the lowest address as in wasm
+template <typename LaneT> LaneT getLane(const V128 &V, uint32_t Idx) {
+  LaneT Lane;
+  std::memcpy(&Lane, reinterpret_cast<const uint8_t *>(&V) + Idx * sizeof(LaneT),
+              sizeof(LaneT));
+  return Lane;
+}
+
+template <typename LaneT> void setLane(V128 &V, uint32_t Idx, LaneT Lane) {
+  std::memcpy(reinterpret_cast<uint8_t *>(&V) + Idx * sizeof(LaneT), &Lane,
+              sizeof(LaneT));
+}
+
+template <typename LaneT> constexpr uint32_t getNumLanes() {
+  return sizeof(V128) / sizeof(LaneT);
+}
+
+template <typename T> T saturateLane(int64_t Val) {
+  return static_cast<T>(
+      std::clamp<int64_t>(Val, std::numeric_limits<T>::min(),
+                          std::numeric_limits<T>::max()));
+}
+
+template <typename LaneT> V128 simdSplat(LaneT Val) {
+  V128 Res;
+  for (uint32_t I = 0; I < getNumLanes<LaneT>(); ++I) {
+    setLane<LaneT>(Res, I, Val);
+  }
+  return Res;
+}
+
+template <typename LaneT, typename OpT>
+V128 simdUnaryOp(const V128 &V, OpT Op) {
+  V128 Res;
+  for (uint32_t I = 0; I < getNumLanes<LaneT>(); ++I) {
+    setLane<LaneT>(Res, I, static_cast<LaneT>(Op(getLane<LaneT>(V, I))));
+  }
+  return Res;
+}
+
+template <typename LaneT, typename OpT>
+V128 simdBinaryOp(const V128 &LHS, const V128 &RHS, OpT Op) {
+  V128 Res;
+  for (uint32_t I = 0; I < getNumLanes<LaneT>(); ++I) {
+    setLane<LaneT>(Res, I,
+                   static_cast<LaneT>(
+                       Op(getLane<LaneT>(LHS, I), getLane<LaneT>(RHS, I))));
+  }
+  return Res;
+}
+
+// Unsigned integer of the same width as a lane
+template <typename LaneT> struct LaneMask {
+  using Type = std::make_unsigned_t<LaneT>;
+};
+template <> struct LaneMask<float> {
+  using Type = uint32_t;
+};
+template <> struct LaneMask<double> {
+  using Type = uint64_t;
+};
+
+// Set all bits of the result lane if the comparison is true
+template <typename LaneT, typename OpT>
+V128 simdCompare(const V128 &LHS, const V128 &RHS, OpT Op) {
+  using MaskT = typename LaneMask<LaneT>::Type;
+  V128 Res;
+  for (uint32_t I = 0; I < getNumLanes<LaneT>(); ++I) {
+    bool Cond = Op(getLane<LaneT>(LHS, I), getLane<LaneT>(RHS, I));
+    setLane<MaskT>(Res, I, Cond ? static_cast<MaskT>(-1) : MaskT(0));
+  }
+  return Res;
+}
+
+// Shift counts are taken modulo the lane width
+template <typename LaneT, BinaryOperator Op>
+V128 simdShift(const V128 &V, uint32_t Count) {
+  Count &= (sizeof(LaneT) << 3) - 1;
+  V128 Res;
+  for (uint32_t I = 0; I < getNumLanes<LaneT>(); ++I) {
+    LaneT Lane = getLane<LaneT>(V, I);
+    if constexpr (Op == BO_SHL) {
+      using UnsignedT = std::make_unsigned_t<LaneT>;
+      Lane = static_cast<LaneT>(static_cast<UnsignedT>(Lane) << Count);
+    } else {
+      Lane = static_cast<LaneT>(Lane >> Count);
+    }
+    setLane<LaneT>(Res, I, Lane);
+  }
+  return Res;
+}
+
+// Extend the half of the lanes starting at `FirstLane`
+template <typename WideT, typename NarrowT>
+V128 simdExtend(const V128 &V, uint32_t FirstLane) {
+  V128 Res;
+  for (uint32_t I = 0; I < getNumLanes<WideT>(); ++I) {
+    setLane<WideT>(Res, I, getLane<NarrowT>(V, FirstLane + I));
+  }
+  return Res;
+}
+
+template <typename WideT, typename NarrowT>
+V128 simdExtMul(const V128 &LHS, const V128 &RHS, uint32_t FirstLane) {
+  V128 Res;
+  for (uint32_t I = 0; I < getNumLanes<WideT>(); ++I) {
+    // The products of the narrow lanes always fit in the wide lanes, multiply
+    // in 64 bits to avoid the promotion to int
+    using MulT = std::conditional_t<std::is_signed_v<WideT>, int64_t, uint64_t>;
+    MulT Product = static_cast<MulT>(getLane<NarrowT>(LHS, FirstLane + I)) *
+                   static_cast<MulT>(getLane<NarrowT>(RHS, FirstLane + I));
+    setLane<WideT>(Res, I, static_cast<WideT>(Product));
+  }
+  return Res;
+}
+
+template <typename WideT, typename NarrowT>
+V128 simdExtAddPairwise(const V128 &V) {
+  V128 Res;
+  for (uint32_t I = 0; I < getNumLanes<WideT>(); ++I) {
+    WideT Sum = static_cast<WideT>(getLane<NarrowT>(V, 2 * I)) +
+                static_cast<WideT>(getLane<NarrowT>(V, 2 * I + 1));
+    setLane<WideT>(Res, I, Sum);
+  }
+  return Res;
+}
+
+// Narrow the signed lanes of `LHS` and then `RHS` with saturation
+template <typename NarrowT, typename WideT>
+V128 simdNarrow(const V128 &LHS, const V128 &RHS) {
+  constexpr uint32_t NumWideLanes = getNumLanes<WideT>();
+  V128 Res;
+  for (uint32_t I = 0; I < NumWideLanes; ++I) {
+    setLane<NarrowT>(Res, I, saturateLane<NarrowT>(getLane<WideT>(LHS, I)));
+    setLane<NarrowT>(Res, NumWideLanes + I,
+                     saturateLane<NarrowT>(getLane<WideT>(RHS, I)));
+  }
+  return Res;
+}
+
+// Convert the low lanes of `V` which fit in the result, the remaining lanes of
+// the result are zero
+template <typename DstT, typename SrcT, typename OpT>
+V128 simdConvert(const V128 &V, OpT Op) {
+  constexpr uint32_t NumLanes =
+      std::min(getNumLanes<DstT>(), getNumLanes<SrcT>());
+  V128 Res{};
+  for (uint32_t I = 0; I < NumLanes; ++I) {
+    setLane<DstT>(Res, I, Op(getLane<SrcT>(V, I)));
+  }
+  return Res;
+}
+
+template <typename LaneT> int32_t simdAllTrue(const V128 &V) {
+  for (uint32_t I = 0; I < getNumLanes<LaneT>(); ++I) {
+    if (getLane<LaneT>(V, I) == 0) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+template <typename LaneT> int32_t simdBitmask(const V128 &V) {
+  static_assert(std::is_signed_v<LaneT>);
+  int32_t Mask = 0;
+  for (uint32_t I = 0; I < getNumLanes<LaneT>(); ++I) {
+    if (getLane<LaneT>(V, I) < 0) {
+      Mask |= 1 << I;
+    }
+  }
+  return Mask;
+}
+
+// Wrapping arithmetic of lanes, computed in 64 bits to avoid the overflow of
+// the promoted int
+const auto SIMDAdd = [](auto LHS, auto RHS) {
+  return static_cast<uint64_t>(LHS) + static_cast<uint64_t>(RHS);
+};
+const auto SIMDSub = [](auto LHS, auto RHS) {
+  return static_cast<uint64_t>(LHS) - static_cast<uint64_t>(RHS);
+};
+const auto SIMDMul = [](auto LHS, auto RHS) {
+  return static_cast<uint64_t>(LHS) * static_cast<uint64_t>(RHS);
+};
+const auto SIMDNeg = [](auto Val) { return 0 - static_cast<uint64_t>(Val); };
+const auto SIMDAbs = [](auto Val) {
+  return Val < 0 ? 0 - static_cast<uint64_t>(Val) : static_cast<uint64_t>(Val);
+};
+const auto SIMDMin = [](auto LHS, auto RHS) { return std::min(LHS, RHS); };
+const auto SIMDMax = [](auto LHS, auto RHS) { return std::max(LHS, RHS); };
+const auto SIMDAddSat = [](auto LHS, auto RHS) {
+  return saturateLane<decltype(LHS)>(static_cast<int64_t>(LHS) + RHS);
+};
+const auto SIMDSubSat = [](auto LHS, auto RHS) {
+  return saturateLane<decltype(LHS)>(static_cast<int64_t>(LHS) - RHS);
+};
+const auto SIMDAvgr = [](auto LHS, auto RHS) {
+  return (static_cast<uint32_t>(LHS) + RHS + 1) >> 1;
+};
+const auto SIMDEq = [](auto LHS, auto RHS) { return LHS == RHS; };
+const auto SIMDNe = [](auto LHS, auto RHS) { return LHS != RHS; };
+const auto SIMDLt = [](auto LHS, auto RHS) { return LHS < RHS; };
+const auto SIMDGt = [](auto LHS, auto RHS) { return LHS > RHS; };
+const auto SIMDLe = [](auto LHS, auto RHS) { return LHS <= RHS; };
+const auto SIMDGe = [](auto LHS, auto RHS) { return LHS >= RHS; };
+
+// Float lane arithmetic shares the helpers of the scalar instructions, which
+// canonicalize NaN results
+template <BinaryOperator Op>
+const auto SIMDFloatOp = [](auto LHS, auto RHS) {
+  return BinaryOpHelper<decltype(LHS), Op>()(LHS, RHS);
+};
+const auto SIMDSqrt = [](auto Val) { return CanonNaN(std::sqrt(Val)); };
+const auto SIMDCeil = [](auto Val) { return CanonNaN(std::ceil(Val)); };
+const auto SIMDFloor = [](auto Val) { return CanonNaN(std::floor(Val)); };
+const auto SIMDTrunc = [](auto Val) { return CanonNaN(std::trunc(Val)); };
+const auto SIMDNearest = [](auto Val) { return CanonNaN(std::rint(Val)); };
+// pmin/pmax are a comparison and a select, an operand is returned as is
+const auto SIMDPMin = [](auto LHS, auto RHS) { return RHS < LHS ? RHS : LHS; };
+const auto SIMDPMax = [](auto LHS, auto RHS) { return LHS < RHS ? RHS : LHS; };
+
 class BaseInterpreterImpl {
 private:
   InterpreterExecContext &Context;
@@ -323,6 +562,25 @@ private:
   };
   std::unordered_map<const uint8_t *, CacheValue> BlockAddrCache;
 
+  // Read the block type at `Ip` and return the address following it. Block
+  // types given by a type index may take params and return several values.
+  static const uint8_t *readBlockCells(const uint8_t *Ip, const Module *Mod,
+                                       uint32_t &ParamCells,
+                                       uint32_t &ResultCells) {
+    WASMType Type = getWASMBlockTypeFromOpcode(*Ip);
+    if (Type != WASMType::ERROR_TYPE) {
+      ParamCells = 0;
+      ResultCells = getWASMTypeCellNum(Type);
+      return Ip + 1;
+    }
+    int64_t TypeIdx;
+    Ip = readSafeLEBNumber(Ip, TypeIdx);
+    const TypeEntry *BlockType = Mod->getDeclaredType(TypeIdx);
+    ParamCells = BlockType->NumParamCells;
+    ResultCells = BlockType->NumReturnCells;
+    return Ip;
+  }
+
   void findBlockAddr(const uint8_t *Start, const uint8_t *End,
                      const uint8_t *&ElseAddr, const uint8_t *&EndAddr) {
     auto It = BlockAddrCache.find(Start);
@@ -362,7 +620,8 @@ private:
       case BR_IF:
         Ptr = skipLEBNumber<int32_t>(Ptr, End);
         break;
-      case BR_TABLE: {
+      case BR_TABLE:
+      case BR_TABLE_DECODED: {
         uint32_t NumTargets = 0;
         Ptr = readSafeLEBNumber(Ptr, NumTargets);
         for (uint32_t I = 0; I <= NumTargets; ++I) {
@@ -382,8 +641,10 @@ private:
       }
       case DROP:
       case DROP_64:
+      case DROP_128:
       case SELECT:
       case SELECT_64:
+      case SELECT_128:
         break;
       case GET_GLOBAL_64:
       case SET_GLOBAL_64: {
@@ -570,15 +831,23 @@ private:
         break;
       case RETURN:
         break;
-      case CALL: {
+      case CALL:
+      case RETURN_CALL: {
         Ptr = skipLEBNumber<uint32_t>(Ptr, End);
         break;
       }
-      case CALL_INDIRECT: {
+      case CALL_INDIRECT:
+      case RETURN_CALL_INDIRECT: {
         Ptr = skipLEBNumber<uint32_t>(Ptr, End);
         Ptr++;
         break;
       }
+      case PREFIX_FC:
+        Ptr = skipFCInstruction(Ptr, End);
+        break;
+      case PREFIX_FD:
+        Ptr = skipFDInstruction(Ptr, End);
+        break;
       default:
         ZEN_LOG_ERROR("unimplemented opcode : {%d}", Opcode);
         ZEN_ASSERT_TODO();
@@ -603,6 +872,29 @@ private:
                     uint32_t *&ValStackPtr, BlockInfo *&ControlStackPtr,
                     uint32_t *&LocalPtr, FunctionInstance *&FuncInst);
 
+  // Replace the current frame with the frame of `Callee`. Returns false if the
+  // interpretation is finished, which happens when a host function is tail
+  // called by the outermost frame.
+  bool tailCallFuncInst(FunctionInstance *FuncInstCallee,
+                        InterpreterExecContext &Context, const uint8_t *&Ip,
+                        const uint8_t *&IpEnd, InterpFrame *&Frame,
+                        uint32_t *&ValStackPtr, BlockInfo *&ControlStackPtr,
+                        uint32_t *&LocalPtr, FunctionInstance *&FuncInst);
+
+  // Pass the results to the previous frame and resume it. Returns false if
+  // there is no previous frame to interpret.
+  bool returnToCaller(InterpreterExecContext &Context, const uint8_t *&Ip,
+                      const uint8_t *&IpEnd, InterpFrame *&Frame,
+                      uint32_t *&ValStackPtr, BlockInfo *&ControlStackPtr,
+                      uint32_t *&LocalPtr, FunctionInstance *&FuncInst);
+
+  // Execute the instruction following PREFIX_FD, returns the address of the
+  // next instruction
+  const uint8_t *executeFDInstruction(const uint8_t *Ip, InterpFrame *Frame,
+                                      uint32_t *&ValStackPtr,
+                                      MemoryInstance *Memory,
+                                      uint64_t LinearMemSize);
+
   template <bool Sign, BinaryOperator Opr, typename SignedT, typename UnsignedT,
             typename WasmReturnType>
   WasmReturnType handleCheckedArithmeticImpl(WasmReturnType LHS,
@@ -939,6 +1231,13 @@ private:
     Frame->valuePush<DestType>(ValStackPtr, *(SrcType *)Start);
   }
 
+  template <typename TargetType, typename SrcType>
+  void convertSat(InterpFrame *Frame, uint32_t *&ValStackPtr) {
+    auto Src = Frame->valuePop<SrcType>(ValStackPtr);
+    Frame->valuePush<TargetType>(ValStackPtr,
+                                 saturatingFloatToInt<TargetType>(Src));
+  }
+
   template <typename TargetType, typename SrcType, bool IsSigned>
   void truncate(InterpFrame *Frame, uint32_t *&ValStackPtr) {
     static_assert(sizeof(TargetType) == 4 || sizeof(TargetType) == 8);
@@ -1035,7 +1334,7 @@ void BaseInterpreterImpl::callFuncInst(
     size_t ReturnCount = Callee->NumReturns;
     std::vector<TypedValue> Result(ReturnCount);
     for (size_t I = 0; I < ReturnCount; ++I) {
-      Result[I].Type = Callee->ReturnTypes[I];
+      Result[I].Type = Callee->getReturnTypes()[I];
     }
 
     Instance *Instance = Context.getInstance();
@@ -1105,6 +1404,814 @@ void BaseInterpreterImpl::callFuncInst(
   }
 }
 
+bool BaseInterpreterImpl::tailCallFuncInst(
+    FunctionInstance *Callee, InterpreterExecContext &Context,
+    const uint8_t *&Ip, const uint8_t *&IpEnd, InterpFrame *&Frame,
+    uint32_t *&ValStackPtr, BlockInfo *&ControlStackPtr, uint32_t *&LocalPtr,
+    FunctionInstance *&FuncInst) {
+  ZEN_ASSERT(Callee != nullptr);
+  if (Callee->Kind != FunctionKind::ByteCode) {
+    // Host functions have no interpreter frame to replace
+    callFuncInst(Callee, Context, Ip, IpEnd, Frame, ValStackPtr,
+                 ControlStackPtr, LocalPtr, FuncInst);
+    return returnToCaller(Context, Ip, IpEnd, Frame, ValStackPtr,
+                          ControlStackPtr, LocalPtr, FuncInst);
+  }
+
+  // The arguments may overlap the locals, so use memmove
+  ValStackPtr -= Callee->NumParamCells;
+  std::memmove(LocalPtr, ValStackPtr, Callee->NumParamCells << 2);
+
+  Frame = Context.replaceFrame(FuncInst, Frame, Callee);
+  if (Frame == nullptr) {
+    throw getError(ErrorCode::CallStackExhausted);
+  }
+  // update frame
+  updateFrame(Ip, IpEnd, Frame, ValStackPtr, ControlStackPtr, LocalPtr,
+              FuncInst, false);
+
+  // init local vars
+  std::memset(LocalPtr + FuncInst->NumParamCells, 0,
+              ((uint32_t)FuncInst->NumLocalCells) << 2);
+
+  Frame->blockPush(ControlStackPtr, IpEnd - 1, ValStackPtr,
+                   FuncInst->NumReturnCells, LABEL_FUNCTION);
+  return true;
+}
+
+bool BaseInterpreterImpl::returnToCaller(
+    InterpreterExecContext &Context, const uint8_t *&Ip, const uint8_t *&IpEnd,
+    InterpFrame *&Frame, uint32_t *&ValStackPtr, BlockInfo *&ControlStackPtr,
+    uint32_t *&LocalPtr, FunctionInstance *&FuncInst) {
+  Context.freeFrame(FuncInst, Frame);
+  InterpFrame *PrevFrame = Frame->PrevFrame;
+  ValStackPtr -= (FuncInst->NumReturnCells);
+  // Many results may overlap with the callee locals
+  std::memmove(LocalPtr, ValStackPtr, FuncInst->NumReturnCells << 2);
+  if (PrevFrame == nullptr || !PrevFrame->Ip) {
+    return false;
+  }
+  Frame = PrevFrame;
+  Context.setCurFrame(Frame);
+  // update frame
+  updateFrame(Ip, IpEnd, Frame, ValStackPtr, ControlStackPtr, LocalPtr,
+              FuncInst, true);
+  return true;
+}
+
+// Read the memarg and pop the address of a SIMD load/store
+static uint8_t *getSIMDMemAddr(const uint8_t *&Ip, InterpFrame *Frame,
+                               uint32_t *&ValStackPtr, MemoryInstance *Memory,
+                               uint64_t LinearMemSize, uint32_t Size) {
+  uint32_t Align, Offset;
+  Ip = readSafeLEBNumber(Ip, Align);
+  Ip = readSafeLEBNumber(Ip, Offset);
+  uint32_t Addr = Frame->valuePop<uint32_t>(ValStackPtr);
+  if ((uint64_t)Offset + Size + Addr > LinearMemSize) {
+    throw getError(ErrorCode::OutOfBoundsMemory);
+  }
+  return Memory->MemBase + Offset + Addr;
+}
+
+const uint8_t *BaseInterpreterImpl::executeFDInstruction(
+    const uint8_t *Ip, InterpFrame *Frame, uint32_t *&ValStackPtr,
+    MemoryInstance *Memory, uint64_t LinearMemSize) {
+  uint32_t FDOpcode = 0;
+  Ip = readSafeLEBNumber(Ip, FDOpcode);
+
+#define SIMD_POP_BINARY_OPERANDS                                               \
+  V128 RHS = Frame->valuePop<V128>(ValStackPtr);                               \
+  V128 LHS = Frame->valuePop<V128>(ValStackPtr)
+#define SIMD_BINARY_OP(LANE_TYPE, OP)                                          \
+  {                                                                            \
+    SIMD_POP_BINARY_OPERANDS;                                                  \
+    Frame->valuePush(ValStackPtr, simdBinaryOp<LANE_TYPE>(LHS, RHS, OP));      \
+    break;                                                                     \
+  }
+#define SIMD_COMPARE(LANE_TYPE, OP)                                            \
+  {                                                                            \
+    SIMD_POP_BINARY_OPERANDS;                                                  \
+    Frame->valuePush(ValStackPtr, simdCompare<LANE_TYPE>(LHS, RHS, OP));       \
+    break;                                                                     \
+  }
+#define SIMD_UNARY_OP(LANE_TYPE, OP)                                           \
+  {                                                                            \
+    V128 Val = Frame->valuePop<V128>(ValStackPtr);                             \
+    Frame->valuePush(ValStackPtr, simdUnaryOp<LANE_TYPE>(Val, OP));            \
+    break;                                                                     \
+  }
+#define SIMD_SHIFT(LANE_TYPE, OP)                                              \
+  {                                                                            \
+    uint32_t Count = Frame->valuePop<uint32_t>(ValStackPtr);                   \
+    V128 Val = Frame->valuePop<V128>(ValStackPtr);                             \
+    Frame->valuePush(ValStackPtr, simdShift<LANE_TYPE, OP>(Val, Count));       \
+    break;                                                                     \
+  }
+#define SIMD_EXTEND(WIDE_TYPE, NARROW_TYPE, FIRST_LANE)                        \
+  {                                                                            \
+    V128 Val = Frame->valuePop<V128>(ValStackPtr);                             \
+    Frame->valuePush(ValStackPtr,                                              \
+                     simdExtend<WIDE_TYPE, NARROW_TYPE>(Val, FIRST_LANE));     \
+    break;                                                                     \
+  }
+#define SIMD_EXTMUL(WIDE_TYPE, NARROW_TYPE, FIRST_LANE)                        \
+  {                                                                            \
+    SIMD_POP_BINARY_OPERANDS;                                                  \
+    Frame->valuePush(ValStackPtr, simdExtMul<WIDE_TYPE, NARROW_TYPE>(          \
+                                      LHS, RHS, FIRST_LANE));                  \
+    break;                                                                     \
+  }
+#define SIMD_CONVERT(DST_TYPE, SRC_TYPE, OP)                                   \
+  {                                                                            \
+    V128 Val = Frame->valuePop<V128>(ValStackPtr);                             \
+    Frame->valuePush(ValStackPtr, simdConvert<DST_TYPE, SRC_TYPE>(Val, OP));   \
+    break;                                                                     \
+  }
+#define SIMD_TEST(FUNC)                                                        \
+  {                                                                            \
+    V128 Val = Frame->valuePop<V128>(ValStackPtr);                             \
+    Frame->valuePush<int32_t>(ValStackPtr, FUNC(Val));                         \
+    break;                                                                     \
+  }
+// Load 8 bytes as the low half of a vector and extend its lanes
+#define SIMD_LOAD_EXTEND(WIDE_TYPE, NARROW_TYPE)                               \
+  {                                                                            \
+    uint8_t *Addr = getSIMDMemAddr(Ip, Frame, ValStackPtr, Memory,             \
+                                   LinearMemSize, sizeof(uint64_t));           \
+    V128 Val{};                                                                \
+    std::memcpy(&Val, Addr, sizeof(uint64_t));                                 \
+    Frame->valuePush(ValStackPtr, simdExtend<WIDE_TYPE, NARROW_TYPE>(Val, 0)); \
+    break;                                                                     \
+  }
+#define SIMD_LOAD_SPLAT(LANE_TYPE)                                             \
+  {                                                                            \
+    uint8_t *Addr = getSIMDMemAddr(Ip, Frame, ValStackPtr, Memory,             \
+                                   LinearMemSize, sizeof(LANE_TYPE));          \
+    LANE_TYPE Lane;                                                            \
+    std::memcpy(&Lane, Addr, sizeof(LANE_TYPE));                               \
+    Frame->valuePush(ValStackPtr, simdSplat<LANE_TYPE>(Lane));                 \
+    break;                                                                     \
+  }
+#define SIMD_LOAD_ZERO(LANE_TYPE)                                              \
+  {                                                                            \
+    uint8_t *Addr = getSIMDMemAddr(Ip, Frame, ValStackPtr, Memory,             \
+                                   LinearMemSize, sizeof(LANE_TYPE));          \
+    V128 Val{};                                                                \
+    std::memcpy(&Val, Addr, sizeof(LANE_TYPE));                                \
+    Frame->valuePush(ValStackPtr, Val);                                        \
+    break;                                                                     \
+  }
+#define SIMD_LOAD_LANE(LANE_TYPE)                                              \
+  {                                                                            \
+    V128 Val = Frame->valuePop<V128>(ValStackPtr);                             \
+    uint8_t *Addr = getSIMDMemAddr(Ip, Frame, ValStackPtr, Memory,             \
+                                   LinearMemSize, sizeof(LANE_TYPE));          \
+    LANE_TYPE Lane;                                                            \
+    std::memcpy(&Lane, Addr, sizeof(LANE_TYPE));                               \
+    setLane<LANE_TYPE>(Val, *Ip++, Lane);                                      \
+    Frame->valuePush(ValStackPtr, Val);                                        \
+    break;                                                                     \
+  }
+#define SIMD_STORE_LANE(LANE_TYPE)                                             \
+  {                                                                            \
+    V128 Val = Frame->valuePop<V128>(ValStackPtr);                             \
+    uint8_t *Addr = getSIMDMemAddr(Ip, Frame, ValStackPtr, Memory,             \
+                                   LinearMemSize, sizeof(LANE_TYPE));          \
+    LANE_TYPE Lane = getLane<LANE_TYPE>(Val, *Ip++);                           \
+    std::memcpy(Addr, &Lane, sizeof(LANE_TYPE));                               \
+    break;                                                                     \
+  }
+#define SIMD_SPLAT(LANE_TYPE, SCALAR_TYPE)                                     \
+  {                                                                            \
+    auto Scalar = Frame->valuePop<SCALAR_TYPE>(ValStackPtr);                   \
+    Frame->valuePush(ValStackPtr,                                              \
+                     simdSplat<LANE_TYPE>(static_cast<LANE_TYPE>(Scalar)));    \
+    break;                                                                     \
+  }
+#define SIMD_EXTRACT_LANE(LANE_TYPE, SCALAR_TYPE)                              \
+  {                                                                            \
+    V128 Val = Frame->valuePop<V128>(ValStackPtr);                             \
+    Frame->valuePush<SCALAR_TYPE>(ValStackPtr,                                 \
+                                  getLane<LANE_TYPE>(Val, *Ip++));             \
+    break;                                                                     \
+  }
+#define SIMD_REPLACE_LANE(LANE_TYPE, SCALAR_TYPE)                              \
+  {                                                                            \
+    auto Scalar = Frame->valuePop<SCALAR_TYPE>(ValStackPtr);                   \
+    V128 Val = Frame->valuePop<V128>(ValStackPtr);                             \
+    setLane<LANE_TYPE>(Val, *Ip++, static_cast<LANE_TYPE>(Scalar));            \
+    Frame->valuePush(ValStackPtr, Val);                                        \
+    break;                                                                     \
+  }
+
+  // Float lanes are moved as raw bits except by the float lane arithmetic, so
+  // NaN payloads are preserved
+  switch (FDOpcode) {
+  case V128_LOAD: {
+    uint8_t *Addr = getSIMDMemAddr(Ip, Frame, ValStackPtr, Memory,
+                                   LinearMemSize, sizeof(V128));
+    V128 Val;
+    std::memcpy(&Val, Addr, sizeof(V128));
+    Frame->valuePush(ValStackPtr, Val);
+    break;
+  }
+  case V128_LOAD8X8_S:
+    SIMD_LOAD_EXTEND(int16_t, int8_t)
+  case V128_LOAD8X8_U:
+    SIMD_LOAD_EXTEND(uint16_t, uint8_t)
+  case V128_LOAD16X4_S:
+    SIMD_LOAD_EXTEND(int32_t, int16_t)
+  case V128_LOAD16X4_U:
+    SIMD_LOAD_EXTEND(uint32_t, uint16_t)
+  case V128_LOAD32X2_S:
+    SIMD_LOAD_EXTEND(int64_t, int32_t)
+  case V128_LOAD32X2_U:
+    SIMD_LOAD_EXTEND(uint64_t, uint32_t)
+  case V128_LOAD8_SPLAT:
+    SIMD_LOAD_SPLAT(uint8_t)
+  case V128_LOAD16_SPLAT:
+    SIMD_LOAD_SPLAT(uint16_t)
+  case V128_LOAD32_SPLAT:
+    SIMD_LOAD_SPLAT(uint32_t)
+  case V128_LOAD64_SPLAT:
+    SIMD_LOAD_SPLAT(uint64_t)
+  case V128_LOAD32_ZERO:
+    SIMD_LOAD_ZERO(uint32_t)
+  case V128_LOAD64_ZERO:
+    SIMD_LOAD_ZERO(uint64_t)
+  case V128_STORE: {
+    V128 Val = Frame->valuePop<V128>(ValStackPtr);
+    uint8_t *Addr = getSIMDMemAddr(Ip, Frame, ValStackPtr, Memory,
+                                   LinearMemSize, sizeof(V128));
+    std::memcpy(Addr, &Val, sizeof(V128));
+    break;
+  }
+  case V128_LOAD8_LANE:
+    SIMD_LOAD_LANE(uint8_t)
+  case V128_LOAD16_LANE:
+    SIMD_LOAD_LANE(uint16_t)
+  case V128_LOAD32_LANE:
+    SIMD_LOAD_LANE(uint32_t)
+  case V128_LOAD64_LANE:
+    SIMD_LOAD_LANE(uint64_t)
+  case V128_STORE8_LANE:
+    SIMD_STORE_LANE(uint8_t)
+  case V128_STORE16_LANE:
+    SIMD_STORE_LANE(uint16_t)
+  case V128_STORE32_LANE:
+    SIMD_STORE_LANE(uint32_t)
+  case V128_STORE64_LANE:
+    SIMD_STORE_LANE(uint64_t)
+  case V128_CONST: {
+    V128 Val;
+    std::memcpy(&Val, Ip, sizeof(V128));
+    Ip += sizeof(V128);
+    Frame->valuePush(ValStackPtr, Val);
+    break;
+  }
+  case I8X16_SHUFFLE: {
+    SIMD_POP_BINARY_OPERANDS;
+    V128 Res;
+    for (uint32_t I = 0; I < 16; ++I) {
+      uint8_t LaneIdx = Ip[I];
+      setLane<uint8_t>(Res, I,
+                       LaneIdx < 16 ? getLane<uint8_t>(LHS, LaneIdx)
+                                    : getLane<uint8_t>(RHS, LaneIdx - 16));
+    }
+    Ip += 16;
+    Frame->valuePush(ValStackPtr, Res);
+    break;
+  }
+  case I8X16_SWIZZLE: {
+    SIMD_POP_BINARY_OPERANDS;
+    V128 Res;
+    for (uint32_t I = 0; I < 16; ++I) {
+      uint8_t LaneIdx = getLane<uint8_t>(RHS, I);
+      setLane<uint8_t>(Res, I, LaneIdx < 16 ? getLane<uint8_t>(LHS, LaneIdx) : 0);
+    }
+    Frame->valuePush(ValStackPtr, Res);
+    break;
+  }
+  case I8X16_SPLAT:
+    SIMD_SPLAT(uint8_t, uint32_t)
+  case I16X8_SPLAT:
+    SIMD_SPLAT(uint16_t, uint32_t)
+  case I32X4_SPLAT:
+  case F32X4_SPLAT:
+    SIMD_SPLAT(uint32_t, uint32_t)
+  case I64X2_SPLAT:
+  case F64X2_SPLAT:
+    SIMD_SPLAT(uint64_t, uint64_t)
+  case I8X16_EXTRACT_LANE_S:
+    SIMD_EXTRACT_LANE(int8_t, int32_t)
+  case I8X16_EXTRACT_LANE_U:
+    SIMD_EXTRACT_LANE(uint8_t, uint32_t)
+  case I16X8_EXTRACT_LANE_S:
+    SIMD_EXTRACT_LANE(int16_t, int32_t)
+  case I16X8_EXTRACT_LANE_U:
+    SIMD_EXTRACT_LANE(uint16_t, uint32_t)
+  case I32X4_EXTRACT_LANE:
+  case F32X4_EXTRACT_LANE:
+    SIMD_EXTRACT_LANE(uint32_t, uint32_t)
+  case I64X2_EXTRACT_LANE:
+  case F64X2_EXTRACT_LANE:
+    SIMD_EXTRACT_LANE(uint64_t, uint64_t)
+  case I8X16_REPLACE_LANE:
+    SIMD_REPLACE_LANE(uint8_t, uint32_t)
+  case I16X8_REPLACE_LANE:
+    SIMD_REPLACE_LANE(uint16_t, uint32_t)
+  case I32X4_REPLACE_LANE:
+  case F32X4_REPLACE_LANE:
+    SIMD_REPLACE_LANE(uint32_t, uint32_t)
+  case I64X2_REPLACE_LANE:
+  case F64X2_REPLACE_LANE:
+    SIMD_REPLACE_LANE(uint64_t, uint64_t)
+
+  case I8X16_EQ:
+    SIMD_COMPARE(int8_t, SIMDEq)
+  case I8X16_NE:
+    SIMD_COMPARE(int8_t, SIMDNe)
+  case I8X16_LT_S:
+    SIMD_COMPARE(int8_t, SIMDLt)
+  case I8X16_LT_U:
+    SIMD_COMPARE(uint8_t, SIMDLt)
+  case I8X16_GT_S:
+    SIMD_COMPARE(int8_t, SIMDGt)
+  case I8X16_GT_U:
+    SIMD_COMPARE(uint8_t, SIMDGt)
+  case I8X16_LE_S:
+    SIMD_COMPARE(int8_t, SIMDLe)
+  case I8X16_LE_U:
+    SIMD_COMPARE(uint8_t, SIMDLe)
+  case I8X16_GE_S:
+    SIMD_COMPARE(int8_t, SIMDGe)
+  case I8X16_GE_U:
+    SIMD_COMPARE(uint8_t, SIMDGe)
+  case I16X8_EQ:
+    SIMD_COMPARE(int16_t, SIMDEq)
+  case I16X8_NE:
+    SIMD_COMPARE(int16_t, SIMDNe)
+  case I16X8_LT_S:
+    SIMD_COMPARE(int16_t, SIMDLt)
+  case I16X8_LT_U:
+    SIMD_COMPARE(uint16_t, SIMDLt)
+  case I16X8_GT_S:
+    SIMD_COMPARE(int16_t, SIMDGt)
+  case I16X8_GT_U:
+    SIMD_COMPARE(uint16_t, SIMDGt)
+  case I16X8_LE_S:
+    SIMD_COMPARE(int16_t, SIMDLe)
+  case I16X8_LE_U:
+    SIMD_COMPARE(uint16_t, SIMDLe)
+  case I16X8_GE_S:
+    SIMD_COMPARE(int16_t, SIMDGe)
+  case I16X8_GE_U:
+    SIMD_COMPARE(uint16_t, SIMDGe)
+  case I32X4_EQ:
+    SIMD_COMPARE(int32_t, SIMDEq)
+  case I32X4_NE:
+    SIMD_COMPARE(int32_t, SIMDNe)
+  case I32X4_LT_S:
+    SIMD_COMPARE(int32_t, SIMDLt)
+  case I32X4_LT_U:
+    SIMD_COMPARE(uint32_t, SIMDLt)
+  case I32X4_GT_S:
+    SIMD_COMPARE(int32_t, SIMDGt)
+  case I32X4_GT_U:
+    SIMD_COMPARE(uint32_t, SIMDGt)
+  case I32X4_LE_S:
+    SIMD_COMPARE(int32_t, SIMDLe)
+  case I32X4_LE_U:
+    SIMD_COMPARE(uint32_t, SIMDLe)
+  case I32X4_GE_S:
+    SIMD_COMPARE(int32_t, SIMDGe)
+  case I32X4_GE_U:
+    SIMD_COMPARE(uint32_t, SIMDGe)
+  case I64X2_EQ:
+    SIMD_COMPARE(int64_t, SIMDEq)
+  case I64X2_NE:
+    SIMD_COMPARE(int64_t, SIMDNe)
+  case I64X2_LT_S:
+    SIMD_COMPARE(int64_t, SIMDLt)
+  case I64X2_GT_S:
+    SIMD_COMPARE(int64_t, SIMDGt)
+  case I64X2_LE_S:
+    SIMD_COMPARE(int64_t, SIMDLe)
+  case I64X2_GE_S:
+    SIMD_COMPARE(int64_t, SIMDGe)
+
+  case V128_NOT:
+    SIMD_UNARY_OP(uint64_t, [](uint64_t Val) { return ~Val; })
+  case V128_AND:
+    SIMD_BINARY_OP(uint64_t, [](uint64_t L, uint64_t R) { return L & R; })
+  case V128_ANDNOT:
+    SIMD_BINARY_OP(uint64_t, [](uint64_t L, uint64_t R) { return L & ~R; })
+  case V128_OR:
+    SIMD_BINARY_OP(uint64_t, [](uint64_t L, uint64_t R) { return L | R; })
+  case V128_XOR:
+    SIMD_BINARY_OP(uint64_t, [](uint64_t L, uint64_t R) { return L ^ R; })
+  case V128_BITSELECT: {
+    V128 Mask = Frame->valuePop<V128>(ValStackPtr);
+    SIMD_POP_BINARY_OPERANDS;
+    V128 Res;
+    for (uint32_t I = 0; I < 2; ++I) {
+      uint64_t M = getLane<uint64_t>(Mask, I);
+      setLane<uint64_t>(Res, I,
+                        (getLane<uint64_t>(LHS, I) & M) |
+                            (getLane<uint64_t>(RHS, I) & ~M));
+    }
+    Frame->valuePush(ValStackPtr, Res);
+    break;
+  }
+  case V128_ANY_TRUE: {
+    V128 Val = Frame->valuePop<V128>(ValStackPtr);
+    Frame->valuePush<int32_t>(ValStackPtr, (getLane<uint64_t>(Val, 0) |
+                                            getLane<uint64_t>(Val, 1)) != 0);
+    break;
+  }
+
+  case I8X16_ABS:
+    SIMD_UNARY_OP(int8_t, SIMDAbs)
+  case I8X16_NEG:
+    SIMD_UNARY_OP(int8_t, SIMDNeg)
+  case I8X16_POPCNT:
+    SIMD_UNARY_OP(uint8_t, [](uint8_t Val) { return __builtin_popcount(Val); })
+  case I8X16_ALL_TRUE:
+    SIMD_TEST(simdAllTrue<int8_t>)
+  case I8X16_BITMASK:
+    SIMD_TEST(simdBitmask<int8_t>)
+  case I8X16_NARROW_I16X8_S: {
+    SIMD_POP_BINARY_OPERANDS;
+    Frame->valuePush(ValStackPtr, simdNarrow<int8_t, int16_t>(LHS, RHS));
+    break;
+  }
+  case I8X16_NARROW_I16X8_U: {
+    SIMD_POP_BINARY_OPERANDS;
+    Frame->valuePush(ValStackPtr, simdNarrow<uint8_t, int16_t>(LHS, RHS));
+    break;
+  }
+  case I8X16_SHL:
+    SIMD_SHIFT(int8_t, BO_SHL)
+  case I8X16_SHR_S:
+    SIMD_SHIFT(int8_t, BO_SHR)
+  case I8X16_SHR_U:
+    SIMD_SHIFT(uint8_t, BO_SHR)
+  case I8X16_ADD:
+    SIMD_BINARY_OP(uint8_t, SIMDAdd)
+  case I8X16_ADD_SAT_S:
+    SIMD_BINARY_OP(int8_t, SIMDAddSat)
+  case I8X16_ADD_SAT_U:
+    SIMD_BINARY_OP(uint8_t, SIMDAddSat)
+  case I8X16_SUB:
+    SIMD_BINARY_OP(uint8_t, SIMDSub)
+  case I8X16_SUB_SAT_S:
+    SIMD_BINARY_OP(int8_t, SIMDSubSat)
+  case I8X16_SUB_SAT_U:
+    SIMD_BINARY_OP(uint8_t, SIMDSubSat)
+  case I8X16_MIN_S:
+    SIMD_BINARY_OP(int8_t, SIMDMin)
+  case I8X16_MIN_U:
+    SIMD_BINARY_OP(uint8_t, SIMDMin)
+  case I8X16_MAX_S:
+    SIMD_BINARY_OP(int8_t, SIMDMax)
+  case I8X16_MAX_U:
+    SIMD_BINARY_OP(uint8_t, SIMDMax)
+  case I8X16_AVGR_U:
+    SIMD_BINARY_OP(uint8_t, SIMDAvgr)
+
+  case I16X8_EXTADD_PAIRWISE_I8X16_S: {
+    V128 Val = Frame->valuePop<V128>(ValStackPtr);
+    Frame->valuePush(ValStackPtr, simdExtAddPairwise<int16_t, int8_t>(Val));
+    break;
+  }
+  case I16X8_EXTADD_PAIRWISE_I8X16_U: {
+    V128 Val = Frame->valuePop<V128>(ValStackPtr);
+    Frame->valuePush(ValStackPtr, simdExtAddPairwise<uint16_t, uint8_t>(Val));
+    break;
+  }
+  case I32X4_EXTADD_PAIRWISE_I16X8_S: {
+    V128 Val = Frame->valuePop<V128>(ValStackPtr);
+    Frame->valuePush(ValStackPtr, simdExtAddPairwise<int32_t, int16_t>(Val));
+    break;
+  }
+  case I32X4_EXTADD_PAIRWISE_I16X8_U: {
+    V128 Val = Frame->valuePop<V128>(ValStackPtr);
+    Frame->valuePush(ValStackPtr, simdExtAddPairwise<uint32_t, uint16_t>(Val));
+    break;
+  }
+
+  case I16X8_ABS:
+    SIMD_UNARY_OP(int16_t, SIMDAbs)
+  case I16X8_NEG:
+    SIMD_UNARY_OP(int16_t, SIMDNeg)
+  case I16X8_Q15MULR_SAT_S:
+    SIMD_BINARY_OP(int16_t, [](int16_t L, int16_t R) {
+      return saturateLane<int16_t>((int32_t(L) * R + 0x4000) >> 15);
+    })
+  case I16X8_ALL_TRUE:
+    SIMD_TEST(simdAllTrue<int16_t>)
+  case I16X8_BITMASK:
+    SIMD_TEST(simdBitmask<int16_t>)
+  case I16X8_NARROW_I32X4_S: {
+    SIMD_POP_BINARY_OPERANDS;
+    Frame->valuePush(ValStackPtr, simdNarrow<int16_t, int32_t>(LHS, RHS));
+    break;
+  }
+  case I16X8_NARROW_I32X4_U: {
+    SIMD_POP_BINARY_OPERANDS;
+    Frame->valuePush(ValStackPtr, simdNarrow<uint16_t, int32_t>(LHS, RHS));
+    break;
+  }
+  case I16X8_EXTEND_LOW_I8X16_S:
+    SIMD_EXTEND(int16_t, int8_t, 0)
+  case I16X8_EXTEND_HIGH_I8X16_S:
+    SIMD_EXTEND(int16_t, int8_t, 8)
+  case I16X8_EXTEND_LOW_I8X16_U:
+    SIMD_EXTEND(uint16_t, uint8_t, 0)
+  case I16X8_EXTEND_HIGH_I8X16_U:
+    SIMD_EXTEND(uint16_t, uint8_t, 8)
+  case I16X8_SHL:
+    SIMD_SHIFT(int16_t, BO_SHL)
+  case I16X8_SHR_S:
+    SIMD_SHIFT(int16_t, BO_SHR)
+  case I16X8_SHR_U:
+    SIMD_SHIFT(uint16_t, BO_SHR)
+  case I16X8_ADD:
+    SIMD_BINARY_OP(uint16_t, SIMDAdd)
+  case I16X8_ADD_SAT_S:
+    SIMD_BINARY_OP(int16_t, SIMDAddSat)
+  case I16X8_ADD_SAT_U:
+    SIMD_BINARY_OP(uint16_t, SIMDAddSat)
+  case I16X8_SUB:
+    SIMD_BINARY_OP(uint16_t, SIMDSub)
+  case I16X8_SUB_SAT_S:
+    SIMD_BINARY_OP(int16_t, SIMDSubSat)
+  case I16X8_SUB_SAT_U:
+    SIMD_BINARY_OP(uint16_t, SIMDSubSat)
+  case I16X8_MUL:
+    SIMD_BINARY_OP(uint16_t, SIMDMul)
+  case I16X8_MIN_S:
+    SIMD_BINARY_OP(int16_t, SIMDMin)
+  case I16X8_MIN_U:
+    SIMD_BINARY_OP(uint16_t, SIMDMin)
+  case I16X8_MAX_S:
+    SIMD_BINARY_OP(int16_t, SIMDMax)
+  case I16X8_MAX_U:
+    SIMD_BINARY_OP(uint16_t, SIMDMax)
+  case I16X8_AVGR_U:
+    SIMD_BINARY_OP(uint16_t, SIMDAvgr)
+  case I16X8_EXTMUL_LOW_I8X16_S:
+    SIMD_EXTMUL(int16_t, int8_t, 0)
+  case I16X8_EXTMUL_HIGH_I8X16_S:
+    SIMD_EXTMUL(int16_t, int8_t, 8)
+  case I16X8_EXTMUL_LOW_I8X16_U:
+    SIMD_EXTMUL(uint16_t, uint8_t, 0)
+  case I16X8_EXTMUL_HIGH_I8X16_U:
+    SIMD_EXTMUL(uint16_t, uint8_t, 8)
+
+  case I32X4_ABS:
+    SIMD_UNARY_OP(int32_t, SIMDAbs)
+  case I32X4_NEG:
+    SIMD_UNARY_OP(int32_t, SIMDNeg)
+  case I32X4_ALL_TRUE:
+    SIMD_TEST(simdAllTrue<int32_t>)
+  case I32X4_BITMASK:
+    SIMD_TEST(simdBitmask<int32_t>)
+  case I32X4_EXTEND_LOW_I16X8_S:
+    SIMD_EXTEND(int32_t, int16_t, 0)
+  case I32X4_EXTEND_HIGH_I16X8_S:
+    SIMD_EXTEND(int32_t, int16_t, 4)
+  case I32X4_EXTEND_LOW_I16X8_U:
+    SIMD_EXTEND(uint32_t, uint16_t, 0)
+  case I32X4_EXTEND_HIGH_I16X8_U:
+    SIMD_EXTEND(uint32_t, uint16_t, 4)
+  case I32X4_SHL:
+    SIMD_SHIFT(int32_t, BO_SHL)
+  case I32X4_SHR_S:
+    SIMD_SHIFT(int32_t, BO_SHR)
+  case I32X4_SHR_U:
+    SIMD_SHIFT(uint32_t, BO_SHR)
+  case I32X4_ADD:
+    SIMD_BINARY_OP(uint32_t, SIMDAdd)
+  case I32X4_SUB:
+    SIMD_BINARY_OP(uint32_t, SIMDSub)
+  case I32X4_MUL:
+    SIMD_BINARY_OP(uint32_t, SIMDMul)
+  case I32X4_MIN_S:
+    SIMD_BINARY_OP(int32_t, SIMDMin)
+  case I32X4_MIN_U:
+    SIMD_BINARY_OP(uint32_t, SIMDMin)
+  case I32X4_MAX_S:
+    SIMD_BINARY_OP(int32_t, SIMDMax)
+  case I32X4_MAX_U:
+    SIMD_BINARY_OP(uint32_t, SIMDMax)
+  case I32X4_DOT_I16X8_S: {
+    SIMD_POP_BINARY_OPERANDS;
+    V128 Res;
+    for (uint32_t I = 0; I < 4; ++I) {
+      int64_t Sum =
+          int64_t(getLane<int16_t>(LHS, 2 * I)) * getLane<int16_t>(RHS, 2 * I) +
+          int64_t(getLane<int16_t>(LHS, 2 * I + 1)) *
+              getLane<int16_t>(RHS, 2 * I + 1);
+      setLane<uint32_t>(Res, I, static_cast<uint32_t>(Sum));
+    }
+    Frame->valuePush(ValStackPtr, Res);
+    break;
+  }
+  case I32X4_EXTMUL_LOW_I16X8_S:
+    SIMD_EXTMUL(int32_t, int16_t, 0)
+  case I32X4_EXTMUL_HIGH_I16X8_S:
+    SIMD_EXTMUL(int32_t, int16_t, 4)
+  case I32X4_EXTMUL_LOW_I16X8_U:
+    SIMD_EXTMUL(uint32_t, uint16_t, 0)
+  case I32X4_EXTMUL_HIGH_I16X8_U:
+    SIMD_EXTMUL(uint32_t, uint16_t, 4)
+
+  case I64X2_ABS:
+    SIMD_UNARY_OP(int64_t, SIMDAbs)
+  case I64X2_NEG:
+    SIMD_UNARY_OP(int64_t, SIMDNeg)
+  case I64X2_ALL_TRUE:
+    SIMD_TEST(simdAllTrue<int64_t>)
+  case I64X2_BITMASK:
+    SIMD_TEST(simdBitmask<int64_t>)
+  case I64X2_EXTEND_LOW_I32X4_S:
+    SIMD_EXTEND(int64_t, int32_t, 0)
+  case I64X2_EXTEND_HIGH_I32X4_S:
+    SIMD_EXTEND(int64_t, int32_t, 2)
+  case I64X2_EXTEND_LOW_I32X4_U:
+    SIMD_EXTEND(uint64_t, uint32_t, 0)
+  case I64X2_EXTEND_HIGH_I32X4_U:
+    SIMD_EXTEND(uint64_t, uint32_t, 2)
+  case I64X2_SHL:
+    SIMD_SHIFT(int64_t, BO_SHL)
+  case I64X2_SHR_S:
+    SIMD_SHIFT(int64_t, BO_SHR)
+  case I64X2_SHR_U:
+    SIMD_SHIFT(uint64_t, BO_SHR)
+  case I64X2_ADD:
+    SIMD_BINARY_OP(uint64_t, SIMDAdd)
+  case I64X2_SUB:
+    SIMD_BINARY_OP(uint64_t, SIMDSub)
+  case I64X2_MUL:
+    SIMD_BINARY_OP(uint64_t, SIMDMul)
+  case I64X2_EXTMUL_LOW_I32X4_S:
+    SIMD_EXTMUL(int64_t, int32_t, 0)
+  case I64X2_EXTMUL_HIGH_I32X4_S:
+    SIMD_EXTMUL(int64_t, int32_t, 2)
+  case I64X2_EXTMUL_LOW_I32X4_U:
+    SIMD_EXTMUL(uint64_t, uint32_t, 0)
+  case I64X2_EXTMUL_HIGH_I32X4_U:
+    SIMD_EXTMUL(uint64_t, uint32_t, 2)
+
+  case F32X4_EQ:
+    SIMD_COMPARE(float, SIMDEq)
+  case F32X4_NE:
+    SIMD_COMPARE(float, SIMDNe)
+  case F32X4_LT:
+    SIMD_COMPARE(float, SIMDLt)
+  case F32X4_GT:
+    SIMD_COMPARE(float, SIMDGt)
+  case F32X4_LE:
+    SIMD_COMPARE(float, SIMDLe)
+  case F32X4_GE:
+    SIMD_COMPARE(float, SIMDGe)
+  case F32X4_ABS:
+    SIMD_UNARY_OP(uint32_t, [](uint32_t Val) { return Val & 0x7fffffffU; })
+  case F32X4_NEG:
+    SIMD_UNARY_OP(uint32_t, [](uint32_t Val) { return Val ^ 0x80000000U; })
+  case F32X4_SQRT:
+    SIMD_UNARY_OP(float, SIMDSqrt)
+  case F32X4_CEIL:
+    SIMD_UNARY_OP(float, SIMDCeil)
+  case F32X4_FLOOR:
+    SIMD_UNARY_OP(float, SIMDFloor)
+  case F32X4_TRUNC:
+    SIMD_UNARY_OP(float, SIMDTrunc)
+  case F32X4_NEAREST:
+    SIMD_UNARY_OP(float, SIMDNearest)
+  case F32X4_ADD:
+    SIMD_BINARY_OP(float, SIMDFloatOp<BO_ADD>)
+  case F32X4_SUB:
+    SIMD_BINARY_OP(float, SIMDFloatOp<BO_SUB>)
+  case F32X4_MUL:
+    SIMD_BINARY_OP(float, SIMDFloatOp<BO_MUL>)
+  case F32X4_DIV:
+    SIMD_BINARY_OP(float, SIMDFloatOp<BO_DIV>)
+  case F32X4_MIN:
+    SIMD_BINARY_OP(float, SIMDFloatOp<BO_MIN>)
+  case F32X4_MAX:
+    SIMD_BINARY_OP(float, SIMDFloatOp<BO_MAX>)
+  case F32X4_PMIN:
+    SIMD_BINARY_OP(float, SIMDPMin)
+  case F32X4_PMAX:
+    SIMD_BINARY_OP(float, SIMDPMax)
+
+  case F64X2_EQ:
+    SIMD_COMPARE(double, SIMDEq)
+  case F64X2_NE:
+    SIMD_COMPARE(double, SIMDNe)
+  case F64X2_LT:
+    SIMD_COMPARE(double, SIMDLt)
+  case F64X2_GT:
+    SIMD_COMPARE(double, SIMDGt)
+  case F64X2_LE:
+    SIMD_COMPARE(double, SIMDLe)
+  case F64X2_GE:
+    SIMD_COMPARE(double, SIMDGe)
+  case F64X2_ABS:
+    SIMD_UNARY_OP(uint64_t,
+                  [](uint64_t Val) { return Val & 0x7fffffffffffffffULL; })
+  case F64X2_NEG:
+    SIMD_UNARY_OP(uint64_t,
+                  [](uint64_t Val) { return Val ^ 0x8000000000000000ULL; })
+  case F64X2_SQRT:
+    SIMD_UNARY_OP(double, SIMDSqrt)
+  case F64X2_CEIL:
+    SIMD_UNARY_OP(double, SIMDCeil)
+  case F64X2_FLOOR:
+    SIMD_UNARY_OP(double, SIMDFloor)
+  case F64X2_TRUNC:
+    SIMD_UNARY_OP(double, SIMDTrunc)
+  case F64X2_NEAREST:
+    SIMD_UNARY_OP(double, SIMDNearest)
+  case F64X2_ADD:
+    SIMD_BINARY_OP(double, SIMDFloatOp<BO_ADD>)
+  case F64X2_SUB:
+    SIMD_BINARY_OP(double, SIMDFloatOp<BO_SUB>)
+  case F64X2_MUL:
+    SIMD_BINARY_OP(double, SIMDFloatOp<BO_MUL>)
+  case F64X2_DIV:
+    SIMD_BINARY_OP(double, SIMDFloatOp<BO_DIV>)
+  case F64X2_MIN:
+    SIMD_BINARY_OP(double, SIMDFloatOp<BO_MIN>)
+  case F64X2_MAX:
+    SIMD_BINARY_OP(double, SIMDFloatOp<BO_MAX>)
+  case F64X2_PMIN:
+    SIMD_BINARY_OP(double, SIMDPMin)
+  case F64X2_PMAX:
+    SIMD_BINARY_OP(double, SIMDPMax)
+
+  case F32X4_DEMOTE_F64X2_ZERO:
+    SIMD_CONVERT(float, double, [](double Val) {
+      return CanonNaN(static_cast<float>(Val));
+    })
+  case F64X2_PROMOTE_LOW_F32X4:
+    SIMD_CONVERT(double, float, [](float Val) {
+      return CanonNaN(static_cast<double>(Val));
+    })
+  case I32X4_TRUNC_SAT_F32X4_S:
+    SIMD_CONVERT(int32_t, float, [](auto Val) {
+      return saturatingFloatToInt<int32_t>(Val);
+    })
+  case I32X4_TRUNC_SAT_F32X4_U:
+    SIMD_CONVERT(uint32_t, float, [](auto Val) {
+      return saturatingFloatToInt<uint32_t>(Val);
+    })
+  case F32X4_CONVERT_I32X4_S:
+    SIMD_CONVERT(float, int32_t,
+                 [](int32_t Val) { return static_cast<float>(Val); })
+  case F32X4_CONVERT_I32X4_U:
+    SIMD_CONVERT(float, uint32_t,
+                 [](uint32_t Val) { return static_cast<float>(Val); })
+  case I32X4_TRUNC_SAT_F64X2_S_ZERO:
+    SIMD_CONVERT(int32_t, double, [](auto Val) {
+      return saturatingFloatToInt<int32_t>(Val);
+    })
+  case I32X4_TRUNC_SAT_F64X2_U_ZERO:
+    SIMD_CONVERT(uint32_t, double, [](auto Val) {
+      return saturatingFloatToInt<uint32_t>(Val);
+    })
+  case F64X2_CONVERT_LOW_I32X4_S:
+    SIMD_CONVERT(double, int32_t,
+                 [](int32_t Val) { return static_cast<double>(Val); })
+  case F64X2_CONVERT_LOW_I32X4_U:
+    SIMD_CONVERT(double, uint32_t,
+                 [](uint32_t Val) { return static_cast<double>(Val); })
+  default:
+    throw getError(ErrorCode::UnsupportedOpcode);
+  }
+
+#undef SIMD_POP_BINARY_OPERANDS
+#undef SIMD_BINARY_OP
+#undef SIMD_COMPARE
+#undef SIMD_UNARY_OP
+#undef SIMD_SHIFT
+#undef SIMD_EXTEND
+#undef SIMD_EXTMUL
+#undef SIMD_CONVERT
+#undef SIMD_TEST
+#undef SIMD_LOAD_EXTEND
+#undef SIMD_LOAD_SPLAT
+#undef SIMD_LOAD_ZERO
+#undef SIMD_LOAD_LANE
+#undef SIMD_STORE_LANE
+#undef SIMD_SPLAT
+#undef SIMD_EXTRACT_LANE
+#undef SIMD_REPLACE_LANE
+  return Ip;
+}
+
 void BaseInterpreterImpl::interpret() {
 #define DIRECT_DISPATCH 0
 #if !DIRECT_DISPATCH
@@ -1170,17 +2277,25 @@ void BaseInterpreterImpl::interpret() {
         selectOp<int64_t>(Frame, ValStackPtr);
         BREAK;
       }
+      CASE(SELECT_128) : {
+        selectOp<V128>(Frame, ValStackPtr);
+        BREAK;
+      }
       CASE(BLOCK) : {
-        uint32_t CellNum = getWASMTypeCellNumFromOpcode(*Ip++);
+        uint32_t ParamCellNum, CellNum;
+        Ip = readBlockCells(Ip, Mod, ParamCellNum, CellNum);
 
         findBlockAddr(Ip, IpEnd, ElseAddr, EndAddr);
-        Frame->blockPush(ControlStackPtr, EndAddr, ValStackPtr, CellNum,
-                         LABEL_BLOCK);
+        Frame->blockPush(ControlStackPtr, EndAddr, ValStackPtr - ParamCellNum,
+                         CellNum, LABEL_BLOCK);
         BREAK;
       }
       CASE(LOOP) : {
-        uint32_t CellNum = getWASMTypeCellNumFromOpcode(*Ip++);
-        Frame->blockPush(ControlStackPtr, Ip, ValStackPtr, CellNum, LABEL_LOOP);
+        // Branches to a loop carry the loop params instead of its results
+        uint32_t CellNum, ResultCellNum;
+        Ip = readBlockCells(Ip, Mod, CellNum, ResultCellNum);
+        Frame->blockPush(ControlStackPtr, Ip, ValStackPtr - CellNum, CellNum,
+                         LABEL_LOOP);
         BREAK;
       }
       CASE(BR) : {
@@ -1208,6 +2323,17 @@ void BaseInterpreterImpl::interpret() {
         Frame->blockPop(ControlStackPtr, ValStackPtr, Ip, Depth);
         BREAK;
       }
+      CASE(BR_TABLE_DECODED) : {
+        uint32_t Count;
+        Ip = readSafeLEBNumber(Ip, Count);
+        const uint32_t *Targets =
+            FuncInst->BrTableTargets + readDecodedBrTableOffset(Ip);
+        uint32_t LabelIdx =
+            std::min(Count, Frame->valuePop<uint32_t>(ValStackPtr));
+        Depth = Targets[LabelIdx];
+        Frame->blockPop(ControlStackPtr, ValStackPtr, Ip, Depth);
+        BREAK;
+      }
       CASE(DROP) : {
         Frame->valuePop<int32_t>(ValStackPtr);
         BREAK;
@@ -1216,20 +2342,26 @@ void BaseInterpreterImpl::interpret() {
         Frame->valuePop<int64_t>(ValStackPtr);
         BREAK;
       }
+      CASE(DROP_128) : {
+        Frame->valuePop<V128>(ValStackPtr);
+        BREAK;
+      }
       CASE(IF) : {
-        uint32_t CellNum = getWASMTypeCellNumFromOpcode(*Ip++);
+        uint32_t ParamCellNum, CellNum;
+        Ip = readBlockCells(Ip, Mod, ParamCellNum, CellNum);
 
         Cond = Frame->valuePop<int32_t>(ValStackPtr);
         findBlockAddr(Ip, IpEnd, ElseAddr, EndAddr);
         if (Cond) {
-          Frame->blockPush(ControlStackPtr, EndAddr, ValStackPtr, CellNum,
-                           LABEL_IF);
+          Frame->blockPush(ControlStackPtr, EndAddr,
+                           ValStackPtr - ParamCellNum, CellNum, LABEL_IF);
         } else {
           if (ElseAddr == nullptr) {
+            // The params are the results when there is no else branch
             Ip = EndAddr + 1;
           } else {
-            Frame->blockPush(ControlStackPtr, EndAddr, ValStackPtr, CellNum,
-                             LABEL_IF);
+            Frame->blockPush(ControlStackPtr, EndAddr,
+                             ValStackPtr - ParamCellNum, CellNum, LABEL_IF);
             Ip = ElseAddr + 1;
           }
         }
@@ -1269,6 +2401,11 @@ void BaseInterpreterImpl::interpret() {
               ValStackPtr,
               Frame->valueGet<int64_t>(ValStackPtr, LocalPtr + LocalOffset));
           break;
+        case WASMType::V128:
+          Frame->valuePush<V128>(
+              ValStackPtr,
+              Frame->valueGet<V128>(ValStackPtr, LocalPtr + LocalOffset));
+          break;
         default:
           ZEN_ASSERT_TODO();
           break;
@@ -1291,6 +2428,10 @@ void BaseInterpreterImpl::interpret() {
           Frame->valueSet<int64_t>(ValStackPtr, LocalPtr + LocalOffset,
                                    Frame->valuePop<int64_t>(ValStackPtr));
           break;
+        case WASMType::V128:
+          Frame->valueSet<V128>(ValStackPtr, LocalPtr + LocalOffset,
+                                Frame->valuePop<V128>(ValStackPtr));
+          break;
         default:
           ZEN_ASSERT_TODO();
         }
@@ -1312,6 +2453,10 @@ void BaseInterpreterImpl::interpret() {
           Frame->valueSet<int64_t>(ValStackPtr, LocalPtr + LocalOffset,
                                    Frame->valuePeek<int64_t>(ValStackPtr));
           break;
+        case WASMType::V128:
+          Frame->valueSet<V128>(ValStackPtr, LocalPtr + LocalOffset,
+                                Frame->valuePeek<V128>(ValStackPtr));
+          break;
         default:
           ZEN_ASSERT_TODO();
         }
@@ -1395,6 +2540,91 @@ void BaseInterpreterImpl::interpret() {
         Frame->valuePush(ValStackPtr, Memory->CurPages);
         BREAK;
       }
+      CASE(PREFIX_FC) : {
+        uint32_t FCOpcode = 0;
+        Ip = readSafeLEBNumber(Ip, FCOpcode);
+        switch (FCOpcode) {
+        case I32_TRUNC_SAT_S_F32:
+          convertSat<int32_t, float>(Frame, ValStackPtr);
+          break;
+        case I32_TRUNC_SAT_U_F32:
+          convertSat<uint32_t, float>(Frame, ValStackPtr);
+          break;
+        case I32_TRUNC_SAT_S_F64:
+          convertSat<int32_t, double>(Frame, ValStackPtr);
+          break;
+        case I32_TRUNC_SAT_U_F64:
+          convertSat<uint32_t, double>(Frame, ValStackPtr);
+          break;
+        case I64_TRUNC_SAT_S_F32:
+          convertSat<int64_t, float>(Frame, ValStackPtr);
+          break;
+        case I64_TRUNC_SAT_U_F32:
+          convertSat<uint64_t, float>(Frame, ValStackPtr);
+          break;
+        case I64_TRUNC_SAT_S_F64:
+          convertSat<int64_t, double>(Frame, ValStackPtr);
+          break;
+        case I64_TRUNC_SAT_U_F64:
+          convertSat<uint64_t, double>(Frame, ValStackPtr);
+          break;
+        case MEMORY_INIT: {
+          uint32_t DataSegIdx = 0;
+          Ip = readSafeLEBNumber(Ip, DataSegIdx);
+          // Skip the fixed byte for `memory 0`
+          ++Ip;
+          uint32_t Size = Frame->valuePop<uint32_t>(ValStackPtr);
+          uint32_t SrcOffset = Frame->valuePop<uint32_t>(ValStackPtr);
+          uint32_t DestOffset = Frame->valuePop<uint32_t>(ValStackPtr);
+          ErrorCode ErrCode = ModInst->initLinearMemory(DataSegIdx, DestOffset,
+                                                        SrcOffset, Size);
+          if (ErrCode != ErrorCode::NoError) {
+            throw getError(ErrCode);
+          }
+          break;
+        }
+        case DATA_DROP: {
+          uint32_t DataSegIdx = 0;
+          Ip = readSafeLEBNumber(Ip, DataSegIdx);
+          ModInst->dropDataSegment(DataSegIdx);
+          break;
+        }
+        case MEMORY_COPY: {
+          // Skip the fixed bytes for `memory 0` `memory 0`
+          Ip += 2;
+          uint32_t Size = Frame->valuePop<uint32_t>(ValStackPtr);
+          uint32_t SrcOffset = Frame->valuePop<uint32_t>(ValStackPtr);
+          uint32_t DestOffset = Frame->valuePop<uint32_t>(ValStackPtr);
+          ErrorCode ErrCode =
+              ModInst->copyLinearMemory(DestOffset, SrcOffset, Size);
+          if (ErrCode != ErrorCode::NoError) {
+            throw getError(ErrCode);
+          }
+          break;
+        }
+        case MEMORY_FILL: {
+          // Skip the fixed byte for `memory 0`
+          ++Ip;
+          uint32_t Size = Frame->valuePop<uint32_t>(ValStackPtr);
+          uint32_t Value = Frame->valuePop<uint32_t>(ValStackPtr);
+          uint32_t DestOffset = Frame->valuePop<uint32_t>(ValStackPtr);
+          ErrorCode ErrCode = ModInst->fillLinearMemory(
+              DestOffset, static_cast<uint8_t>(Value), Size);
+          if (ErrCode != ErrorCode::NoError) {
+            throw getError(ErrCode);
+          }
+          break;
+        }
+        default:
+          throw getError(ErrorCode::UnsupportedOpcode);
+        }
+        BREAK;
+      }
+      CASE(PREFIX_FD) : {
+        Ip = executeFDInstruction(Ip, Frame, ValStackPtr, Memory,
+                                  LinearMemSize);
+        BREAK;
+      }
       CASE(F32_STORE) : CASE(I32_STORE) : {
         storeOp<uint32_t, uint32_t>(*Memory, Ip, IpEnd, Frame, ValStackPtr,
                                     LinearMemSize);
@@ -1993,21 +3223,14 @@ void BaseInterpreterImpl::interpret() {
         BREAK;
       }
       CASE(RETURN) : {
-        Context.freeFrame(FuncInst, Frame);
-        InterpFrame *PrevFrame = Frame->PrevFrame;
-        ValStackPtr -= (FuncInst->NumReturnCells);
-        std::memcpy(LocalPtr, ValStackPtr, FuncInst->NumReturnCells << 2);
-        if (PrevFrame == nullptr || !PrevFrame->Ip) {
+        if (!returnToCaller(Context, Ip, IpEnd, Frame, ValStackPtr,
+                            ControlStackPtr, LocalPtr, FuncInst)) {
           return;
         }
-        Frame = PrevFrame;
-        Context.setCurFrame(Frame);
-        // update frame
-        updateFrame(Ip, IpEnd, Frame, ValStackPtr, ControlStackPtr, LocalPtr,
-                    FuncInst, true);
         BREAK;
       }
-      CASE(CALL) : {
+      CASE(CALL) :
+      CASE(RETURN_CALL) : {
         Ip = readSafeLEBNumber(Ip, FuncIdx);
 #ifdef ZEN_ENABLE_DEBUG_INTERP
         ZEN_LOG_DEBUG("fidx: %d", FuncIdx);
@@ -2021,23 +3244,63 @@ void BaseInterpreterImpl::interpret() {
           }
           ModInst->setGas(GasLeft - Delta);
 
+          if (Opcode == RETURN_CALL &&
+              !returnToCaller(Context, Ip, IpEnd, Frame, ValStackPtr,
+                              ControlStackPtr, LocalPtr, FuncInst)) {
+            return;
+          }
           BREAK;
         }
 #ifdef ZEN_ENABLE_CHECKED_ARITHMETIC
         Frame->ValueStackPtr = ValStackPtr;
 #define HANDLE_CHECKED_ARITHMETIC_CALL_POSTHOOK                                \
-  ValStackPtr = Frame->ValueStackPtr;
+  ValStackPtr = Frame->ValueStackPtr;                                          \
+  if (Opcode == RETURN_CALL &&                                                 \
+      !returnToCaller(Context, Ip, IpEnd, Frame, ValStackPtr, ControlStackPtr, \
+                      LocalPtr, FuncInst)) {                                   \
+    return;                                                                    \
+  }
 
         HANDLE_CHECKED_ARITHMETIC_CALL(Mod, FuncIdx)
 #undef HANDLE_CHECKED_ARITHMETIC_CALL_POSTHOOK
 #endif // ZEN_ENABLE_CHECKED_ARITHMETIC
 
+        IntrinsicKind Intrinsic = Mod->getIntrinsicKind(FuncIdx);
+        if (Intrinsic != IntrinsicKind::NONE) {
+          // Take the i32 arguments in place instead of marshalling them for
+          // the host function ABI
+          ValStackPtr -= Mod->getFunctionType(FuncIdx)->NumParams;
+          int32_t Result = 0;
+          ErrorCode ErrCode =
+              ModInst->callIntrinsic(Intrinsic, ValStackPtr, Result);
+          if (ErrCode != ErrorCode::NoError) {
+            throw getError(ErrCode);
+          }
+          Frame->valuePush<int32_t>(ValStackPtr, Result);
+
+          if (Opcode == RETURN_CALL &&
+              !returnToCaller(Context, Ip, IpEnd, Frame, ValStackPtr,
+                              ControlStackPtr, LocalPtr, FuncInst)) {
+            return;
+          }
+          BREAK;
+        }
+
         FunctionInstance *FuncInstCallee = ModInst->getFunctionInst(FuncIdx);
+        if (Opcode == RETURN_CALL) {
+          if (!tailCallFuncInst(FuncInstCallee, Context, Ip, IpEnd, Frame,
+                                ValStackPtr, ControlStackPtr, LocalPtr,
+                                FuncInst)) {
+            return;
+          }
+          BREAK;
+        }
         callFuncInst(FuncInstCallee, Context, Ip, IpEnd, Frame, ValStackPtr,
                      ControlStackPtr, LocalPtr, FuncInst);
         BREAK;
       }
-      CASE(CALL_INDIRECT) : {
+      CASE(CALL_INDIRECT) :
+      CASE(RETURN_CALL_INDIRECT) : {
 
         uint32_t TypeIdx = 0, TableIdx = 0;
         Ip = readSafeLEBNumber(Ip, TypeIdx);
@@ -2064,6 +3327,14 @@ void BaseInterpreterImpl::interpret() {
         if (!TypeEntry::isEqual(ActualFuncType, ExpectedFuncType)) {
           throw getError(ErrorCode::IndirectCallTypeMismatch);
         }
+        if (Opcode == RETURN_CALL_INDIRECT) {
+          if (!tailCallFuncInst(FuncInstCallee, Context, Ip, IpEnd, Frame,
+                                ValStackPtr, ControlStackPtr, LocalPtr,
+                                FuncInst)) {
+            return;
+          }
+          BREAK;
+        }
         callFuncInst(FuncInstCallee, Context, Ip, IpEnd, Frame, ValStackPtr,
                      ControlStackPtr, LocalPtr, FuncInst);
         BREAK;
@@ -2078,7 +3349,7 @@ void BaseInterpreterImpl::interpret() {
           ValStackPtr -= (FuncInst->NumReturnCells);
           // copy return value to value stack of prev_frame, frame may
           // be overwrited
-          std::memcpy(LocalPtr, ValStackPtr, FuncInst->NumReturnCells << 2);
+          std::memmove(LocalPtr, ValStackPtr, FuncInst->NumReturnCells << 2);
           Frame = PrevFrame;
           Context.setCurFrame(Frame);
 
@@ -113,10 +113,10 @@ struct InterpFrame {
     ValStackPtr = CurBlock->ValueStackPtr;
     Ip = CurBlock->TargetAddr;
 
-    if (CurBlock->LabelType != common::LABEL_LOOP) {
-      uint32_t CellNum = (ControlStackPtr - 1)->CellNum;
-
-      std::memcpy(ValStackPtr, ValStackPtrOld - CellNum, CellNum << 2);
+    // Results of blocks or params of loops
+    uint32_t CellNum = CurBlock->CellNum;
+    if (CellNum > 0) {
+      std::memmove(ValStackPtr, ValStackPtrOld - CellNum, CellNum << 2);
       ValStackPtr += CellNum;
     }
   }
@@ -178,6 +178,13 @@ public:
                           uint32_t *LocalPtr);
   void freeFrame(runtime::FunctionInstance *FuncInst, InterpFrame *Frame);
 
+  // Free `Frame` and allocate the frame of `Callee` at the same local area,
+  // the arguments must be already moved to the locals of `Frame`. Used by tail
+  // calls, so that the stack doesn't grow.
+  InterpFrame *replaceFrame(runtime::FunctionInstance *FuncInst,
+                            InterpFrame *Frame,
+                            runtime::FunctionInstance *Callee);
+
   InterpFrame *getCurFrame() { return CurFrame; }
   void setCurFrame(InterpFrame *Frame) { CurFrame = Frame; }
 
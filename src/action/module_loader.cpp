@@ -3,6 +3,8 @@
 
 #include "action/module_loader.h"
 #include "action/function_loader.h"
+#include "runtime/codeholder.h"
+#include "runtime/instance.h"
 #include "runtime/symbol_wrapper.h"
 #include "utils/unicode.h"
 #include "utils/wasm.h"
@@ -11,6 +13,12 @@
 #include "action/hook.h"
 #endif
 
+#ifndef ZEN_ENABLE_SGX
+#include "common/thread_pool.h"
+#endif
+
+#include <cstring>
+
 namespace zen::action {
 
 using namespace common;
@@ -58,6 +66,14 @@ void ModuleLoader::load() {
 #endif
 }
 
+WASMType ModuleLoader::readValType() {
+  WASMType Type = LoaderCommon::readValType();
+  if (Type == WASMType::V128) {
+    Mod.UsesSIMD = true;
+  }
+  return Type;
+}
+
 WASMSymbol ModuleLoader::readName() {
   uint32_t NameLen = readU32();
   Bytes NameBytes = readBytes(NameLen);
@@ -176,6 +192,42 @@ ModuleLoader::readConstExpr(WASMType Type) {
   return {Opcode, ConstExpr};
 }
 
+IntrinsicKind ModuleLoader::resolveIntrinsic(WASMSymbol ModuleName,
+                                             WASMSymbol FieldName,
+                                             const TypeEntry &FuncType) {
+  uint32_t EnabledMask = Mod.getRuntime()->getConfig().EnabledIntrinsics;
+  if (EnabledMask == 0 || ModuleName != WASM_SYMBOL_env) {
+    return IntrinsicKind::NONE;
+  }
+
+  IntrinsicKind Kind = IntrinsicKind::NONE;
+  uint32_t NumParams = 0;
+  switch (FieldName) {
+#define DEFINE_INTRINSIC(NAME, FIELD, NUM_PARAMS)                              \
+  case WASM_SYMBOL_##FIELD:                                                    \
+    Kind = IntrinsicKind::NAME;                                                \
+    NumParams = NUM_PARAMS;                                                    \
+    break;
+#include "common/intrinsics.def"
+#undef DEFINE_INTRINSIC
+  default:
+    return IntrinsicKind::NONE;
+  }
+
+  if (!(EnabledMask & getIntrinsicMask(Kind)) ||
+      FuncType.NumParams != NumParams || FuncType.NumReturns != 1 ||
+      FuncType.getReturnType() != WASMType::I32) {
+    return IntrinsicKind::NONE;
+  }
+  const WASMType *ParamTypes = FuncType.getParamTypes();
+  for (uint32_t I = 0; I < NumParams; ++I) {
+    if (ParamTypes[I] != WASMType::I32) {
+      return IntrinsicKind::NONE;
+    }
+  }
+  return Kind;
+}
+
 const void *
 ModuleLoader::resolveImportFunction(WASMSymbol ModuleName, WASMSymbol FieldName,
                                     const TypeEntry &ExpectedFuncType) {
@@ -251,7 +303,7 @@ ModuleLoader::resolveImportFunction(WASMSymbol ModuleName, WASMSymbol FieldName,
   }
 
   for (uint32_t I = 0; I < ExpectedNumReturns; ++I) {
-    WASMType ExpectedType = ExpectedFuncType.ReturnTypes[I];
+    WASMType ExpectedType = ExpectedFuncType.getReturnTypes()[I];
     WASMType ActualType = ActualFuncType[I + ActualNumParams];
     if (ExpectedType != ActualType) {
       std::string DetailErrMsg = "return type mismatch (expected ";
@@ -282,7 +334,21 @@ ModuleLoader::resolveImportFunction(WASMSymbol ModuleName, WASMSymbol FieldName,
   return TargetHostFunc->_ptr;
 }
 
+void ModuleLoader::waitForBytes(const Byte *Until) {
+#ifndef ZEN_ENABLE_SGX
+  if (!Stream) {
+    return;
+  }
+  if (Until > End) {
+    Until = End;
+  }
+  Stream->waitForData(Until - Start);
+#endif
+}
+
 void ModuleLoader::loadModuleHeader() {
+  waitForBytes(Ptr + 2 * sizeof(uint32_t));
+
   // Check magic number
   if (readPlainU32() != WasmMagicNumber) {
     throw getError(ErrorCode::MagicNotDetected);
@@ -296,7 +362,10 @@ void ModuleLoader::loadModuleHeader() {
 
 void ModuleLoader::loadModuleBody() {
   SectionOrder LastSecOrder = SectionOrder::SEC_ORDER_CUSTOM;
+  // Section id and the longest LEB-encoded section size
+  constexpr size_t MaxSectionHeaderSize = 1 + 5;
   while (Ptr < End) {
+    waitForBytes(Ptr + MaxSectionHeaderSize);
     const auto [SecType, SecSize] = loadSectionHeader();
 
     if (SecType > SectionType::SEC_LAST) {
@@ -321,6 +390,10 @@ void ModuleLoader::loadModuleBody() {
     if (SecEnd > End) {
       throw getError(ErrorCode::UnexpectedEnd);
     }
+    // The code section is waited for function by function
+    if (SecType != SectionType::SEC_CODE) {
+      waitForBytes(SecEnd);
+    }
 
     // Swap `SecEnd` and `End` and restore after loading current section
     std::swap(SecEnd, End);
@@ -434,10 +507,19 @@ void ModuleLoader::loadTypeSection() {
     }
 
     uint32_t NumReturns = readU32();
-    WASMType *ReturnTypes = Entry->ReturnTypes;
     if (NumReturns > PresetMaxNumReturns) {
       throw getError(ErrorCode::TooManyReturns);
     }
+    // The JIT compilers return at most one value
+    if (NumReturns > 1) {
+      Mod.UsesMultiValue = true;
+    }
+    WASMType *ReturnTypes = nullptr;
+    if (NumReturns > (__WORDSIZE / 8)) {
+      ReturnTypes = Entry->ReturnTypes = Mod.initReturnTypes(NumReturns);
+    } else {
+      ReturnTypes = Entry->ReturnTypesVec;
+    }
     uint32_t NumReturnCells = 0;
     for (uint32_t J = 0; J < NumReturns; ++J) {
       WASMType Type = readValType();
@@ -453,8 +535,8 @@ void ModuleLoader::loadTypeSection() {
 
     Entry->NumParams = static_cast<uint16_t>(NumParams);
     Entry->NumParamCells = static_cast<uint16_t>(NumParamCells);
-    Entry->NumReturns = static_cast<uint8_t>(NumReturns);
-    Entry->NumReturnCells = static_cast<uint8_t>(NumReturnCells);
+    Entry->NumReturns = static_cast<uint16_t>(NumReturns);
+    Entry->NumReturnCells = static_cast<uint16_t>(NumReturnCells);
     Entry->SmallestTypeIdx = I;
 
     for (uint32_t J = 0; J < I; ++J) {
@@ -506,17 +588,24 @@ void ModuleLoader::loadImportSection() {
         }
 
         const void *FuncPtr = nullptr;
+        IntrinsicKind Intrinsic =
+            resolveIntrinsic(ModuleName, FieldName, *Type);
+        bool Resolved = Intrinsic != IntrinsicKind::NONE;
+        if (Resolved) {
+          FuncPtr = Instance::getIntrinsicFuncPtr(Intrinsic);
+        }
 #ifdef ZEN_ENABLE_CHECKED_ARITHMETIC
-        if (!resolveCheckedArithmeticFunction(
-                &Mod, ModuleName, FieldName,
-                static_cast<uint32_t>(ImportFunctionTable.size()))) {
+        Resolved = Resolved ||
+                   resolveCheckedArithmeticFunction(
+                       &Mod, ModuleName, FieldName,
+                       static_cast<uint32_t>(ImportFunctionTable.size()));
 #endif // ZEN_ENABLE_CHECKED_ARITHMETIC
+        if (!Resolved) {
           FuncPtr = resolveImportFunction(ModuleName, FieldName, *Type);
-#ifdef ZEN_ENABLE_CHECKED_ARITHMETIC
         }
-#endif // ZEN_ENABLE_CHECKED_ARITHMETIC
         ImportFunctionTable.emplace_back(ModuleName, FieldName,
-                                         Type->SmallestTypeIdx, FuncPtr);
+                                         Type->SmallestTypeIdx, FuncPtr,
+                                         Intrinsic);
         break;
       }
 #ifdef ZEN_ENABLE_SPEC_TEST
@@ -845,6 +934,10 @@ void ModuleLoader::loadElementSection() {
 void ModuleLoader::loadDataCountSection() { Mod.DataCount = readU32(); }
 
 void ModuleLoader::loadCodeSection() {
+  // The longest LEB-encoded u32
+  constexpr size_t MaxU32Size = 5;
+
+  waitForBytes(Ptr + MaxU32Size);
   uint32_t NumCodes = readU32();
   // Only check function number consistency, no need to check `NumCodes` range
   if (NumCodes != Mod.NumInternalFunctions) {
@@ -857,124 +950,263 @@ void ModuleLoader::loadCodeSection() {
   CodeEntry *Entry = Mod.initCodeTable(NumCodes);
   uint32_t NumImportFunctions = Mod.getNumImportFunctions();
   uint32_t NumTotalFunctions = NumImportFunctions + NumCodes;
-  for (uint32_t I = NumImportFunctions; I < NumTotalFunctions; ++I) {
-    uint32_t CodeSize = readU32();
-    if (CodeSize > PresetMaxFunctionSize) {
-      throw getError(ErrorCode::FunctionSizeTooLarge);
-    }
 
-    // Include `vec(locals) expr`
-    const Byte *CodePtrStart = Ptr;
-    uint32_t NumLocals = 0;
-    uint32_t NumLocalCells = 0;
-    uint32_t NumLocalVectors = readU32();
-    const Byte *PrevPtr = Ptr;
-
-    // First pass to get the total number and cells of locals
-    for (uint32_t J = 0; J < NumLocalVectors; ++J) {
-      // Number of same type locals
-      uint32_t NumSameLocals = readU32();
-      if (addOverflow(NumLocals, NumSameLocals, NumLocals)) {
-        throw getError(ErrorCode::TooManyLocals);
-      }
+  // Modules executed by the interpreter as a whole have nothing to compile
+  if (Listener && NumCodes > 0 && !Mod.isInterpOnly()) {
+    Mod.Layout.compute();
+    Listener->onCodeSectionStart();
+  }
 
-      WASMType Type = readValType();
-      uint32_t NumCells = getWASMTypeCellNum(Type);
+  uint32_t NumValidationThreads = getNumValidationThreads(NumCodes);
+  std::vector<FunctionBody> DeferredBodies;
+  if (NumValidationThreads > 1) {
+    DeferredBodies.reserve(NumCodes);
+  }
+#ifdef ZEN_ENABLE_MULTIPASS_JIT
+  Mod.CallSeqMap.reserve(NumCodes);
+#endif
 
-      uint32_t NumSameLocalCells;
-      if (mulOverflow(NumSameLocals, NumCells, NumSameLocalCells) ||
-          addOverflow(NumLocalCells, NumSameLocalCells, NumLocalCells)) {
-        throw getError(ErrorCode::TooManyLocals);
+  try {
+    for (uint32_t I = NumImportFunctions; I < NumTotalFunctions; ++I) {
+      waitForBytes(Ptr + MaxU32Size);
+      uint32_t CodeSize = readU32();
+      if (CodeSize > PresetMaxFunctionSize) {
+        throw getError(ErrorCode::FunctionSizeTooLarge);
       }
-    }
+      waitForBytes(Ptr + CodeSize);
+
+      // Include `vec(locals) expr`
+      const Byte *CodePtrStart = Ptr;
+      uint32_t NumLocals = 0;
+      uint32_t NumLocalCells = 0;
+      uint32_t NumLocalVectors = readU32();
+      const Byte *PrevPtr = Ptr;
+
+      // First pass to get the total number and cells of locals
+      for (uint32_t J = 0; J < NumLocalVectors; ++J) {
+        // Number of same type locals
+        uint32_t NumSameLocals = readU32();
+        if (addOverflow(NumLocals, NumSameLocals, NumLocals)) {
+          throw getError(ErrorCode::TooManyLocals);
+        }
 
-    if (NumLocals > PresetMaxFunctionLocals ||
-        NumLocalCells > PresetMaxFunctionLocalCells) {
-      throw getError(ErrorCode::TooManyLocals);
-    }
+        WASMType Type = readValType();
+        uint32_t NumCells = getWASMTypeCellNum(Type);
 
-    WASMType *LocalTypes = Mod.initLocalTypes(NumLocals);
-    WASMType *LocalTypesPtr = LocalTypes;
-    Ptr = PrevPtr;
+        uint32_t NumSameLocalCells;
+        if (mulOverflow(NumSameLocals, NumCells, NumSameLocalCells) ||
+            addOverflow(NumLocalCells, NumSameLocalCells, NumLocalCells)) {
+          throw getError(ErrorCode::TooManyLocals);
+        }
+      }
 
-    // Second pass to set the local types
-    for (uint32_t J = 0; J < NumLocalVectors; ++J) {
-      uint32_t NumSameLocals = readU32();
-      WASMType Type = readValType();
-      std::memset(LocalTypesPtr, to_underlying(Type), NumSameLocals);
-      if (addOverflow(LocalTypesPtr, NumSameLocals, LocalTypesPtr)) {
+      if (NumLocals > PresetMaxFunctionLocals ||
+          NumLocalCells > PresetMaxFunctionLocalCells) {
         throw getError(ErrorCode::TooManyLocals);
       }
-    }
 
-    TypeEntry *FuncType = Mod.getFunctionType(I);
-    ZEN_ASSERT(FuncType);
-    uint32_t NumParamsAndLocals;
-    if (addOverflow(static_cast<uint32_t>(FuncType->NumParams), NumLocals,
-                    NumParamsAndLocals)) {
-      throw getError(ErrorCode::TooManyLocals);
-    }
-    size_t TotalLocalSize = NumParamsAndLocals * sizeof(uint32_t);
-    if (TotalLocalSize > 0) {
-      Entry->LocalOffsets = Mod.initLocalOffsets(TotalLocalSize);
-
-      const WASMType *ParamTypes = FuncType->getParamTypes();
-      uint32_t LocalOffset = 0;
-
-      // Set the offsets of parameters
-      for (uint32_t J = 0; J < FuncType->NumParams; ++J) {
-        Entry->LocalOffsets[J] = LocalOffset;
-        uint32_t ParamSize = getWASMTypeCellNum(ParamTypes[J]);
-        if (addOverflow(LocalOffset, ParamSize, LocalOffset)) {
-          throw getError(ErrorCode::TooManyParams);
-        }
-      }
+      WASMType *LocalTypes = Mod.initLocalTypes(NumLocals);
+      WASMType *LocalTypesPtr = LocalTypes;
+      Ptr = PrevPtr;
 
-      // Set the offsets of local variables
-      for (uint32_t J = 0; J < NumLocals; ++J) {
-        Entry->LocalOffsets[FuncType->NumParams + J] = LocalOffset;
-        uint32_t LocalSize = getWASMTypeCellNum(LocalTypes[J]);
-        if (addOverflow(LocalOffset, LocalSize, LocalOffset)) {
+      // Second pass to set the local types
+      for (uint32_t J = 0; J < NumLocalVectors; ++J) {
+        uint32_t NumSameLocals = readU32();
+        WASMType Type = readValType();
+        std::memset(LocalTypesPtr, to_underlying(Type), NumSameLocals);
+        if (addOverflow(LocalTypesPtr, NumSameLocals, LocalTypesPtr)) {
           throw getError(ErrorCode::TooManyLocals);
         }
       }
 
+      TypeEntry *FuncType = Mod.getFunctionType(I);
+      ZEN_ASSERT(FuncType);
+      uint32_t NumParamsAndLocals;
+      if (addOverflow(static_cast<uint32_t>(FuncType->NumParams), NumLocals,
+                      NumParamsAndLocals)) {
+        throw getError(ErrorCode::TooManyLocals);
+      }
+      size_t TotalLocalSize = NumParamsAndLocals * sizeof(uint32_t);
+      if (TotalLocalSize > 0) {
+        Entry->LocalOffsets = Mod.initLocalOffsets(TotalLocalSize);
+
+        const WASMType *ParamTypes = FuncType->getParamTypes();
+        uint32_t LocalOffset = 0;
+
+        // Set the offsets of parameters
+        for (uint32_t J = 0; J < FuncType->NumParams; ++J) {
+          Entry->LocalOffsets[J] = LocalOffset;
+          uint32_t ParamSize = getWASMTypeCellNum(ParamTypes[J]);
+          if (addOverflow(LocalOffset, ParamSize, LocalOffset)) {
+            throw getError(ErrorCode::TooManyParams);
+          }
+        }
+
+        // Set the offsets of local variables
+        for (uint32_t J = 0; J < NumLocals; ++J) {
+          Entry->LocalOffsets[FuncType->NumParams + J] = LocalOffset;
+          uint32_t LocalSize = getWASMTypeCellNum(LocalTypes[J]);
+          if (addOverflow(LocalOffset, LocalSize, LocalOffset)) {
+            throw getError(ErrorCode::TooManyLocals);
+          }
+        }
+
 #if defined(ZEN_ENABLE_DWASM) && defined(ZEN_ENABLE_JIT)
-      Entry->JITStackCost = (LocalOffset << 2) + 64;
+        Entry->JITStackCost = (LocalOffset << 2) + 64;
 #endif
-    } else {
+      } else {
 #if defined(ZEN_ENABLE_DWASM) && defined(ZEN_ENABLE_JIT)
-      Entry->JITStackCost = 64;
+        Entry->JITStackCost = 64;
 #endif
-    }
+      }
 
-    // ActualCodeSize < CodeSize < PresetMaxFunctionSize < UINT32_MAX
-    uint32_t ActualCodeSize = CodePtrStart + CodeSize - Ptr;
+      // ActualCodeSize < CodeSize < PresetMaxFunctionSize < UINT32_MAX
+      uint32_t ActualCodeSize = CodePtrStart + CodeSize - Ptr;
 
-    Entry->NumLocals = static_cast<uint16_t>(NumLocals);
-    Entry->NumLocalCells = static_cast<uint16_t>(NumLocalCells);
-    Entry->LocalTypes = LocalTypes;
-    Entry->CodePtr = reinterpret_cast<const uint8_t *>(Ptr);
-    Entry->CodeSize = ActualCodeSize;
-    Entry->CodeOffset = CodeOffset;
-    Entry->Stats = Module::SF_none;
+      Entry->NumLocals = static_cast<uint16_t>(NumLocals);
+      Entry->NumLocalCells = static_cast<uint16_t>(NumLocalCells);
+      Entry->LocalTypes = LocalTypes;
+      Entry->CodePtr = reinterpret_cast<const uint8_t *>(Ptr);
+      Entry->CodeSize = ActualCodeSize;
+      Entry->CodeOffset = CodeOffset;
+      Entry->Stats = Module::SF_none;
 
-    const Byte *CodePtrEnd;
-    if (addOverflow(Ptr, ActualCodeSize, CodePtrEnd) || CodePtrEnd > End) {
-      throw getError(ErrorCode::UnexpectedEnd);
+      const Byte *CodePtrEnd;
+      if (addOverflow(Ptr, ActualCodeSize, CodePtrEnd) || CodePtrEnd > End) {
+        throw getError(ErrorCode::UnexpectedEnd);
+      }
+
+#ifdef ZEN_ENABLE_MULTIPASS_JIT
+      // Insert the entry in advance, so function loaders running in parallel
+      // only look it up
+      Mod.CallSeqMap.emplace(I, std::vector<uint32_t>());
+#endif
+
+      if (NumValidationThreads > 1) {
+        DeferredBodies.push_back({Ptr, CodePtrEnd, I, FuncType, Entry, {}});
+      } else {
+        FunctionLoader FuncLoader(Mod, Ptr, CodePtrEnd, I, *FuncType, *Entry);
+        FuncLoader.load();
+        setBrTableTargets(*Entry, FuncLoader.takeBrTableTargets());
+
+        if (Entry->Stats & Module::SF_simd) {
+          Mod.UsesSIMD = true;
+        }
+        if (Entry->Stats & Module::SF_multi_value) {
+          Mod.UsesMultiValue = true;
+        }
+        if (Listener && !Mod.isInterpOnly()) {
+          Listener->onFunctionLoaded(I - NumImportFunctions);
+        }
+      }
+
+      Ptr = CodePtrEnd;
+      if (addOverflow(CodeOffset, ActualCodeSize, CodeOffset) ||
+          CodeOffset > PresetMaxTotalFunctionSize) {
+        throw getError(ErrorCode::CodeSectionTooLarge);
+      }
+
+      ++Entry;
+    }
+  } catch (const Error &) {
+    // Errors of the preceding function bodies would have been thrown before
+    // this one when loading sequentially, so report them first
+    validateFunctionBodies(DeferredBodies, NumValidationThreads);
+    throw;
+  }
+
+  validateFunctionBodies(DeferredBodies, NumValidationThreads);
+  for (const FunctionBody &Body : DeferredBodies) {
+    setBrTableTargets(*Body.Entry, Body.BrTableTargets);
+    if (Body.Entry->Stats & Module::SF_simd) {
+      Mod.UsesSIMD = true;
+    }
+    if (Body.Entry->Stats & Module::SF_multi_value) {
+      Mod.UsesMultiValue = true;
     }
+  }
+}
+
+void ModuleLoader::setBrTableTargets(CodeEntry &Entry,
+                                     const std::vector<uint32_t> &Targets) {
+  if (Targets.empty()) {
+    return;
+  }
+  size_t Size = Targets.size() * sizeof(uint32_t);
+  Entry.BrTableTargets = static_cast<uint32_t *>(Mod.allocate(Size));
+  std::memcpy(Entry.BrTableTargets, Targets.data(), Size);
+}
+
+uint32_t ModuleLoader::getNumValidationThreads(uint32_t NumCodes) const {
+#ifdef ZEN_ENABLE_SGX
+  return 1;
+#else
+  // Spawning threads costs more than validating small code sections
+  constexpr size_t MinParallelCodeSectionSize = 256 * 1024;
+  // Bodies must be validated in order to notify the listener one by one
+  if (Stream || Listener ||
+      static_cast<size_t>(End - Ptr) < MinParallelCodeSectionSize) {
+    return 1;
+  }
+  uint32_t NumThreads = Mod.getRuntime()->getConfig().NumValidationThreads;
+  return std::max(1u, std::min(NumThreads, NumCodes));
+#endif // ZEN_ENABLE_SGX
+}
 
-    FunctionLoader FuncLoader(Mod, Ptr, CodePtrEnd, I, *FuncType, *Entry);
-    FuncLoader.load();
+void ModuleLoader::validateFunctionBodies(std::vector<FunctionBody> &Bodies,
+                                          uint32_t NumThreads) {
+  if (Bodies.empty()) {
+    return;
+  }
 
-    Ptr = CodePtrEnd;
-    if (addOverflow(CodeOffset, ActualCodeSize, CodeOffset) ||
-        CodeOffset > PresetMaxTotalFunctionSize) {
-      throw getError(ErrorCode::CodeSectionTooLarge);
+#ifdef ZEN_ENABLE_SGX
+  ZEN_UNREACHABLE();
+#else
+  // Bodies are claimed in ascending order, and a worker stops claiming once a
+  // body before the next one has failed. So all the bodies before the first
+  // failed one are validated and the reported error is deterministic.
+  std::atomic<size_t> NextBodyIdx = 0;
+  std::atomic<size_t> FirstErrorBodyIdx = Bodies.size();
+  Mutex ErrorMutex;
+  Error FirstError(ErrorCode::NoError);
+
+  auto ValidateBodies = [&](void *) {
+    while (true) {
+      size_t BodyIdx = NextBodyIdx.fetch_add(1, std::memory_order_relaxed);
+      if (BodyIdx >= FirstErrorBodyIdx.load(std::memory_order_relaxed)) {
+        break;
+      }
+      FunctionBody &Body = Bodies[BodyIdx];
+      try {
+        FunctionLoader FuncLoader(Mod, Body.Start, Body.End, Body.FuncIdx,
+                                  *Body.FuncType, *Body.Entry);
+        FuncLoader.load();
+        Body.BrTableTargets = FuncLoader.takeBrTableTargets();
+      } catch (const Error &Err) {
+        LockGuard<Mutex> Lock(ErrorMutex);
+        if (BodyIdx < FirstErrorBodyIdx) {
+          FirstErrorBodyIdx = BodyIdx;
+          FirstError = Err;
+        }
+        break;
+      }
     }
+  };
 
-    ++Entry;
+  {
+    // The loading thread is also a worker
+    ThreadPool<void> Pool(NumThreads - 1);
+    for (uint32_t I = 0; I < Pool.getThreadCount(); ++I) {
+      Pool.pushTask(ValidateBodies);
+    }
+    Pool.setNoNewTask();
+    ValidateBodies(nullptr);
+  }
+
+  if (FirstErrorBodyIdx < Bodies.size()) {
+    throw FirstError;
   }
+#endif // ZEN_ENABLE_SGX
 }
 
 void ModuleLoader::loadDataSection() {
@@ -991,12 +1223,25 @@ void ModuleLoader::loadDataSection() {
   uint32_t TotalDataSize = 0;
   DataEntry *Entry = Mod.initDataTable(NumDataSegments);
   for (uint32_t I = 0; I < NumDataSegments; ++I) {
-    uint32_t MemIdx = readU32();
-    if (!Mod.isValidMem(MemIdx)) {
-      throw getError(ErrorCode::UnknownMemory);
+    // 0: active in memory 0, 1: passive, 2: active with memory index
+    uint32_t SegmentKind = readU32();
+    if (SegmentKind > 2) {
+      throw getError(ErrorCode::InvalidDataSegmentKind);
+    }
+    bool Passive = SegmentKind == 1;
+
+    uint32_t MemIdx = 0;
+    uint8_t ExprKind = 0;
+    InitExpr Expr{};
+    if (!Passive) {
+      if (SegmentKind == 2) {
+        MemIdx = readU32();
+      }
+      if (!Mod.isValidMem(MemIdx)) {
+        throw getError(ErrorCode::UnknownMemory);
+      }
+      std::tie(ExprKind, Expr) = readConstExpr(WASMType::I32);
     }
-
-    const auto [ExprKind, Expr] = readConstExpr(WASMType::I32);
 
     uint32_t DataSegmentSize = readU32();
     if (DataSegmentSize > PresetMaxDataSegmentSize ||
@@ -1014,6 +1259,7 @@ void ModuleLoader::loadDataSection() {
     Entry->Offset = DataPtrOffset;
     Entry->InitExprKind = ExprKind;
     Entry->InitExprVal = Expr;
+    Entry->Passive = Passive;
 
     ++Entry;
   }
@@ -6,8 +6,27 @@
 
 #include "action/loader_common.h"
 
+namespace zen::runtime {
+class CodeHolder;
+} // namespace zen::runtime
+
 namespace zen::action {
 
+// Receives the progress of the code section loading, used to overlap JIT
+// compilation with loading
+class FunctionLoadListener {
+public:
+  virtual ~FunctionLoadListener() = default;
+
+  // Called before loading the first function body, all sections preceding the
+  // code section are loaded and the instance layout is computed
+  virtual void onCodeSectionStart() = 0;
+
+  // Called after the function body is validated, `FuncIdx` excludes import
+  // functions
+  virtual void onFunctionLoaded(uint32_t FuncIdx) = 0;
+};
+
 class HostModuleLoader {
 public:
   HostModuleLoader(runtime::HostModule &M) : Mod(M) {}
@@ -41,10 +60,21 @@ public:
 
   void load();
 
+  // Streaming mode: bytes are appended to `Source` while loading, so wait for
+  // them before parsing each section or function body
+  void setStreamingSource(const runtime::CodeHolder *Source) {
+    Stream = Source;
+  }
+
+  void setFunctionLoadListener(FunctionLoadListener *L) { Listener = L; }
+
 private:
   ModuleLoader(runtime::Module &M, const Byte *PtrStart, const Byte *PtrEnd)
       : LoaderCommon(M, PtrStart, PtrEnd) {}
 
+  // Also marks the module as using SIMD when the type is v128
+  WASMType readValType();
+
   WASMSymbol readName();
   Limits readLimits();
   TableType readTableType();
@@ -53,9 +83,41 @@ private:
 
   std::pair<uint8_t, runtime::InitExpr> readConstExpr(WASMType Type);
 
+  // Returns IntrinsicKind::NONE if the import isn't an enabled intrinsic with
+  // the expected signature
+  common::IntrinsicKind resolveIntrinsic(WASMSymbol ModuleName,
+                                         WASMSymbol FieldName,
+                                         const runtime::TypeEntry &FuncType);
+
   const void *resolveImportFunction(WASMSymbol ModuleName, WASMSymbol FieldName,
                                     const runtime::TypeEntry &ExpectedFuncType);
 
+  // Block until the bytes before `Until`(capped at `End`) are available
+  void waitForBytes(const Byte *Until);
+
+  // Function body whose validation is deferred to `validateFunctionBodies`
+  struct FunctionBody {
+    const Byte *Start;
+    const Byte *End;
+    uint32_t FuncIdx;
+    const runtime::TypeEntry *FuncType;
+    runtime::CodeEntry *Entry;
+    // Filled by the validating thread
+    std::vector<uint32_t> BrTableTargets;
+  };
+
+  void setBrTableTargets(runtime::CodeEntry &Entry,
+                         const std::vector<uint32_t> &Targets);
+
+  // Returns 1 if the function bodies should be validated one by one while
+  // loading the code section
+  uint32_t getNumValidationThreads(uint32_t NumCodes) const;
+
+  // Validate function bodies in parallel, throw the error of the body with
+  // the lowest index if any
+  void validateFunctionBodies(std::vector<FunctionBody> &Bodies,
+                              uint32_t NumThreads);
+
   std::pair<SectionType, uint32_t> loadSectionHeader() {
     SectionType SecType = static_cast<SectionType>(readByte());
     uint32_t SecSize = readU32();
@@ -86,6 +148,8 @@ private:
 
   bool HasNameSection = false;
   size_t ModuleSize = 0;
+  const runtime::CodeHolder *Stream = nullptr;
+  FunctionLoadListener *Listener = nullptr;
 }; // class ModuleLoader
 
 } // namespace zen::action
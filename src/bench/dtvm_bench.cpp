@@ -0,0 +1,745 @@
+// Copyright (C) 2021-2023 the DTVM authors. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+// Runs the benchmark corpus(tests/bench) in every run mode built in and in the
+// evmone baseline interpreter. Loading, compilation, instantiation and
+// execution are timed apart, the percentiles are written as JSON and can be
+// compared against a stored baseline to catch regressions.
+//
+// Every Wasm contract exports `run(i32 n) -> i64`, every EVM contract reads n
+// from its first calldata word, n is given by --scale.
+
+#include "evmc/evmc.hpp"
+#include "evmc/mocked_host.h"
+#include "evmone/baseline.hpp"
+#include "evmone/vm.hpp"
+#include "utils/logging.h"
+#include "utils/others.h"
+#include "utils/statistics.h"
+#include "zetaengine.h"
+#include <CLI/CLI.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <rapidjson/document.h>
+#include <rapidjson/istreamwrapper.h>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+#include <thread>
+
+using namespace zen::common;
+using namespace zen::runtime;
+using namespace zen::utils;
+
+namespace {
+
+enum class BenchPhase : uint32_t {
+  Load = 0,
+  Compile = 1,     // JIT compilation, or code analysis for evmone
+  Instantiate = 2, // a fresh host state for evmone
+  Execute = 3,
+  NumBenchPhases
+};
+
+constexpr uint32_t NumBenchPhases =
+    to_underlying(BenchPhase::NumBenchPhases);
+
+constexpr const char *PhaseNames[NumBenchPhases] = {
+    "load",
+    "compile",
+    "instantiate",
+    "execute",
+};
+
+// Baseline times below this are dominated by the timer noise
+constexpr double MinComparedTimeMs = 0.01;
+
+struct BenchMode {
+  const char *Name;
+  bool IsEVM;
+  RunMode Mode;
+  bool Lazy;
+};
+
+constexpr BenchMode AllModes[] = {
+    {"interpreter", false, RunMode::InterpMode, false},
+#ifdef ZEN_ENABLE_SINGLEPASS_JIT
+    {"singlepass", false, RunMode::SinglepassMode, false},
+#endif
+#ifdef ZEN_ENABLE_MULTIPASS_JIT
+    {"multipass", false, RunMode::MultipassMode, false},
+    {"multipass-lazy", false, RunMode::MultipassMode, true},
+#endif
+    {"evmone", true, RunMode::InterpMode, false},
+};
+
+struct BenchOptions {
+  std::string CorpusDir = ZEN_BENCH_CORPUS_DIR;
+  std::string Filter;
+  std::vector<std::string> Modes;
+  uint32_t NumWarmups = 2;
+  uint32_t NumIterations = 10;
+  uint32_t Scale = 1000;
+  std::vector<uint32_t> ThreadCounts;
+  uint32_t NumThreadRounds = 20;
+  std::string OutputPath;
+  std::string BaselinePath;
+  double Threshold = 10;
+};
+
+struct Contract {
+  std::string Name;
+  bool IsEVM;
+  std::vector<uint8_t> Code; // hex text for EVM contracts
+};
+
+// All the times are in milliseconds
+struct PhaseSummary {
+  double Min = 0;
+  double Mean = 0;
+  double P50 = 0;
+  double P90 = 0;
+  double P99 = 0;
+};
+
+struct BenchResult {
+  std::string Name;
+  std::string Mode;
+  std::string Checksum; // the result of the contract
+  PhaseSummary Phases[NumBenchPhases];
+};
+
+struct ScalingResult {
+  std::string Name;
+  std::string Mode;
+  uint32_t NumThreads;
+  double Throughput; // rounds per second
+  PhaseSummary Round;
+};
+
+using PhaseTimes = std::array<double, NumBenchPhases>;
+
+double getElapsedMs(SteadyClock::time_point Start) {
+  return chrono::duration<double, std::milli>(SteadyClock::now() - Start)
+      .count();
+}
+
+// Nearest-rank percentiles
+PhaseSummary summarize(std::vector<double> Samples) {
+  PhaseSummary Summary;
+  if (Samples.empty()) {
+    return Summary;
+  }
+  std::sort(Samples.begin(), Samples.end());
+  auto GetPercentile = [&Samples](double Percent) {
+    size_t Rank =
+        static_cast<size_t>(std::ceil(Percent / 100 * Samples.size()));
+    return Samples[std::max<size_t>(Rank, 1) - 1];
+  };
+  Summary.Min = Samples.front();
+  Summary.Mean = std::accumulate(Samples.begin(), Samples.end(), 0.0) /
+                 Samples.size();
+  Summary.P50 = GetPercentile(50);
+  Summary.P90 = GetPercentile(90);
+  Summary.P99 = GetPercentile(99);
+  return Summary;
+}
+
+bool loadCorpusDir(const std::string &Dir, const std::string &Suffix,
+                   bool IsEVM, const std::string &Filter,
+                   std::vector<Contract> &Contracts) {
+  namespace fs = std::filesystem;
+  std::error_code EC;
+  std::vector<fs::path> Paths;
+  for (const auto &Entry : fs::directory_iterator(Dir, EC)) {
+    const std::string &FileName = Entry.path().filename().string();
+    if (FileName.size() > Suffix.size() &&
+        FileName.compare(FileName.size() - Suffix.size(), Suffix.size(),
+                         Suffix) == 0) {
+      Paths.push_back(Entry.path());
+    }
+  }
+  if (EC) {
+    ZEN_LOG_ERROR("failed to read corpus directory %s", Dir.c_str());
+    return false;
+  }
+  std::sort(Paths.begin(), Paths.end());
+  for (const fs::path &Path : Paths) {
+    std::string Name = Path.filename().string();
+    Name.resize(Name.size() - Suffix.size());
+    if (!Filter.empty() && Name.find(Filter) == std::string::npos) {
+      continue;
+    }
+    Contract C{Name, IsEVM, {}};
+    if (!readBinaryFile(Path.string(), C.Code)) {
+      ZEN_LOG_ERROR("failed to read %s", Path.c_str());
+      return false;
+    }
+    Contracts.push_back(std::move(C));
+  }
+  return true;
+}
+
+// ==================== Wasm ====================
+
+std::unique_ptr<Runtime> newBenchRuntime(const BenchMode &Mode) {
+  RuntimeConfig Config;
+  Config.Mode = Mode.Mode;
+  // Compilation is timed by the runtime statistics
+  Config.EnableStatistics = true;
+#ifdef ZEN_ENABLE_MULTIPASS_JIT
+  Config.EnableMultipassLazy = Mode.Lazy;
+#endif
+  return Runtime::newRuntime(Config);
+}
+
+bool getChecksum(const std::vector<TypedValue> &Results,
+                 std::string &Checksum) {
+  if (Results.size() != 1 || Results[0].Type != WASMType::I64) {
+    return false;
+  }
+  Checksum = std::to_string(Results[0].Value.I64);
+  return true;
+}
+
+bool runWasmOnce(Runtime &RT, const Contract &C, const std::string &Arg,
+                 uint32_t Iter, PhaseTimes &Times, std::string &Checksum) {
+  Statistics &Stats = RT.getStatistics();
+  // Drop what the previous iteration left, e.g. background compilation
+  Stats.takePhaseTimeCosts();
+
+  // Modules are cached by name
+  std::string ModName = C.Name + "#" + std::to_string(Iter);
+  auto Start = SteadyClock::now();
+  MayBe<Module *> ModRet = RT.loadModule(ModName, C.Code.data(), C.Code.size());
+  double LoadTime = getElapsedMs(Start);
+  if (!ModRet) {
+    const auto &ErrMsg = ModRet.getError().getFormattedMessage(false);
+    ZEN_LOG_ERROR("failed to load %s: %s", C.Name.c_str(), ErrMsg.c_str());
+    return false;
+  }
+  Module *Mod = *ModRet;
+  auto Costs = Stats.takePhaseTimeCosts();
+  double CompileTime =
+      Costs[to_underlying(StatisticPhase::JITCompilation)] +
+      Costs[to_underlying(StatisticPhase::JITLazyPrecompilation)];
+  Times[to_underlying(BenchPhase::Load)] =
+      std::max(LoadTime - CompileTime, 0.0);
+  Times[to_underlying(BenchPhase::Compile)] = CompileTime;
+
+  bool Success = false;
+  {
+    IsolationUniquePtr Iso = RT.createUnmanagedIsolation();
+    Start = SteadyClock::now();
+    MayBe<Instance *> InstRet = Iso->createInstance(*Mod);
+    Times[to_underlying(BenchPhase::Instantiate)] = getElapsedMs(Start);
+    if (!InstRet) {
+      const auto &ErrMsg = InstRet.getError().getFormattedMessage(false);
+      ZEN_LOG_ERROR("failed to instantiate %s: %s", C.Name.c_str(),
+                    ErrMsg.c_str());
+    } else {
+      Instance *Inst = *InstRet;
+      std::vector<TypedValue> Results;
+      Start = SteadyClock::now();
+      bool CallRet = RT.callWasmFunction(*Inst, "run", {Arg}, Results);
+      Times[to_underlying(BenchPhase::Execute)] = getElapsedMs(Start);
+      if (!CallRet) {
+        const auto &ErrMsg = Inst->getError().getFormattedMessage(false);
+        ZEN_LOG_ERROR("failed to run %s: %s", C.Name.c_str(), ErrMsg.c_str());
+      } else if (!getChecksum(Results, Checksum)) {
+        ZEN_LOG_ERROR("%s must return an i64", C.Name.c_str());
+      } else {
+        Success = true;
+      }
+    }
+  }
+
+  RT.unloadModule(Mod);
+  return Success;
+}
+
+// Run instances of one module on `NumThreads` threads at once, every thread
+// instantiates and runs the contract `NumRounds` times
+bool runWasmScaling(Runtime &RT, Module &Mod, const std::string &Arg,
+                    uint32_t NumThreads, uint32_t NumRounds,
+                    ScalingResult &Result) {
+  std::vector<std::vector<double>> ThreadSamples(NumThreads);
+  std::atomic<bool> Failed = false;
+  std::vector<std::thread> Threads;
+  auto Start = SteadyClock::now();
+  for (uint32_t T = 0; T < NumThreads; ++T) {
+    Threads.emplace_back([&, T]() {
+      Isolation *Iso = RT.createManagedIsolation();
+      if (!Iso) {
+        Failed = true;
+        return;
+      }
+      for (uint32_t R = 0; R < NumRounds && !Failed; ++R) {
+        auto RoundStart = SteadyClock::now();
+        MayBe<Instance *> InstRet = Iso->createInstance(Mod);
+        if (!InstRet) {
+          Failed = true;
+          break;
+        }
+        std::vector<TypedValue> Results;
+        if (!RT.callWasmFunction(**InstRet, "run", {Arg}, Results)) {
+          Failed = true;
+        }
+        Iso->deleteInstance(*InstRet);
+        ThreadSamples[T].push_back(getElapsedMs(RoundStart));
+      }
+      RT.deleteManagedIsolation(Iso);
+    });
+  }
+  for (std::thread &Thread : Threads) {
+    Thread.join();
+  }
+  double WallTime = getElapsedMs(Start);
+  RT.getStatistics().takePhaseTimeCosts();
+  if (Failed) {
+    return false;
+  }
+
+  std::vector<double> Samples;
+  for (const auto &S : ThreadSamples) {
+    Samples.insert(Samples.end(), S.begin(), S.end());
+  }
+  Result.NumThreads = NumThreads;
+  Result.Throughput = Samples.size() / WallTime * 1000;
+  Result.Round = summarize(std::move(Samples));
+  return true;
+}
+
+// ==================== EVM ====================
+
+bool runEVMOnce(evmone::VM &VM, const Contract &C, uint32_t Scale,
+                PhaseTimes &Times, std::string &Checksum) {
+  auto Start = SteadyClock::now();
+  std::optional<evmc::bytes> Code = evmc::from_spaced_hex(std::string_view(
+      reinterpret_cast<const char *>(C.Code.data()), C.Code.size()));
+  Times[to_underlying(BenchPhase::Load)] = getElapsedMs(Start);
+  if (!Code) {
+    ZEN_LOG_ERROR("%s is not valid hex", C.Name.c_str());
+    return false;
+  }
+
+  Start = SteadyClock::now();
+  const evmc::bytes_view CodeView(Code->data(), Code->size());
+  evmone::baseline::CodeAnalysis Analysis =
+      evmone::baseline::analyze(CodeView, false);
+  Times[to_underlying(BenchPhase::Compile)] = getElapsedMs(Start);
+
+  Start = SteadyClock::now();
+  evmc::MockedHost Host;
+  uint8_t Input[32] = {0};
+  for (uint32_t I = 0; I < sizeof(Scale); ++I) {
+    Input[sizeof(Input) - 1 - I] = static_cast<uint8_t>(Scale >> (I * 8));
+  }
+  evmc_message Msg{};
+  Msg.gas = std::numeric_limits<int64_t>::max();
+  Msg.input_data = Input;
+  Msg.input_size = sizeof(Input);
+  Times[to_underlying(BenchPhase::Instantiate)] = getElapsedMs(Start);
+
+  Start = SteadyClock::now();
+  evmc::Result Result{evmone::baseline::execute(
+      VM, evmc::MockedHost::get_interface(), Host.to_context(), EVMC_SHANGHAI,
+      Msg, Analysis)};
+  Times[to_underlying(BenchPhase::Execute)] = getElapsedMs(Start);
+  if (Result.status_code != EVMC_SUCCESS) {
+    ZEN_LOG_ERROR("failed to run %s: status %d", C.Name.c_str(),
+                  static_cast<int>(Result.status_code));
+    return false;
+  }
+  Checksum = evmc::hex({Result.output_data, Result.output_size});
+  return true;
+}
+
+// ==================== Driver ====================
+
+bool runContract(const BenchMode &Mode, Runtime *RT, evmone::VM &VM,
+                 const Contract &C, const BenchOptions &Opts,
+                 BenchResult &Result) {
+  std::vector<double> Samples[NumBenchPhases];
+  std::string Arg = std::to_string(Opts.Scale);
+  uint32_t NumRuns = Opts.NumWarmups + Opts.NumIterations;
+  for (uint32_t I = 0; I < NumRuns; ++I) {
+    PhaseTimes Times = {};
+    std::string Checksum;
+    bool Success = C.IsEVM ? runEVMOnce(VM, C, Opts.Scale, Times, Checksum)
+                           : runWasmOnce(*RT, C, Arg, I, Times, Checksum);
+    if (!Success) {
+      return false;
+    }
+    if (!Result.Checksum.empty() && Result.Checksum != Checksum) {
+      ZEN_LOG_ERROR("%s returned %s, but %s before", C.Name.c_str(),
+                    Checksum.c_str(), Result.Checksum.c_str());
+      return false;
+    }
+    Result.Checksum = Checksum;
+    if (I < Opts.NumWarmups) {
+      continue;
+    }
+    for (uint32_t P = 0; P < NumBenchPhases; ++P) {
+      Samples[P].push_back(Times[P]);
+    }
+  }
+  Result.Name = C.Name;
+  Result.Mode = Mode.Name;
+  for (uint32_t P = 0; P < NumBenchPhases; ++P) {
+    Result.Phases[P] = summarize(std::move(Samples[P]));
+  }
+  return true;
+}
+
+bool runScaling(const BenchMode &Mode, Runtime &RT, const Contract &C,
+                const BenchOptions &Opts,
+                std::vector<ScalingResult> &Results) {
+  std::string ModName = C.Name + "#scaling";
+  MayBe<Module *> ModRet = RT.loadModule(ModName, C.Code.data(), C.Code.size());
+  if (!ModRet) {
+    return false;
+  }
+  std::string Arg = std::to_string(Opts.Scale);
+  bool Success = true;
+  for (uint32_t NumThreads : Opts.ThreadCounts) {
+    ScalingResult Result;
+    Result.Name = C.Name;
+    Result.Mode = Mode.Name;
+    if (!runWasmScaling(RT, **ModRet, Arg, NumThreads, Opts.NumThreadRounds,
+                        Result)) {
+      ZEN_LOG_ERROR("failed to run %s on %u threads", C.Name.c_str(),
+                    NumThreads);
+      Success = false;
+      break;
+    }
+    Results.push_back(Result);
+  }
+  RT.unloadModule(*ModRet);
+  return Success;
+}
+
+void printResults(const std::vector<BenchResult> &Results,
+                  const std::vector<ScalingResult> &ScalingResults) {
+  printf("%-12s %-15s %12s %12s %12s %12s %12s\n", "contract", "mode",
+         "load p50", "compile p50", "inst p50", "exec p50", "exec p99");
+  for (const BenchResult &R : Results) {
+    auto GetPhase = [&R](BenchPhase Phase) -> const PhaseSummary & {
+      return R.Phases[to_underlying(Phase)];
+    };
+    printf("%-12s %-15s %10.3fms %10.3fms %10.3fms %10.3fms %10.3fms\n",
+           R.Name.c_str(), R.Mode.c_str(), GetPhase(BenchPhase::Load).P50,
+           GetPhase(BenchPhase::Compile).P50,
+           GetPhase(BenchPhase::Instantiate).P50,
+           GetPhase(BenchPhase::Execute).P50,
+           GetPhase(BenchPhase::Execute).P99);
+  }
+  if (ScalingResults.empty()) {
+    return;
+  }
+  printf("\n%-12s %-15s %8s %14s %12s %12s\n", "contract", "mode", "threads",
+         "rounds/s", "round p50", "round p99");
+  for (const ScalingResult &R : ScalingResults) {
+    printf("%-12s %-15s %8u %14.1f %10.3fms %10.3fms\n", R.Name.c_str(),
+           R.Mode.c_str(), R.NumThreads, R.Throughput, R.Round.P50,
+           R.Round.P99);
+  }
+}
+
+template <typename Writer>
+void writeSummary(Writer &W, const PhaseSummary &S) {
+  W.StartObject();
+  W.Key("min");
+  W.Double(S.Min);
+  W.Key("mean");
+  W.Double(S.Mean);
+  W.Key("p50");
+  W.Double(S.P50);
+  W.Key("p90");
+  W.Double(S.P90);
+  W.Key("p99");
+  W.Double(S.P99);
+  W.EndObject();
+}
+
+bool writeJSON(const std::string &Path, const BenchOptions &Opts,
+               const std::vector<BenchResult> &Results,
+               const std::vector<ScalingResult> &ScalingResults) {
+  std::ofstream File(Path);
+  if (!File) {
+    ZEN_LOG_ERROR("failed to open %s", Path.c_str());
+    return false;
+  }
+  rapidjson::OStreamWrapper Stream(File);
+  rapidjson::PrettyWriter<rapidjson::OStreamWrapper> W(Stream);
+  W.StartObject();
+  W.Key("scale");
+  W.Uint(Opts.Scale);
+  W.Key("iterations");
+  W.Uint(Opts.NumIterations);
+  W.Key("results");
+  W.StartArray();
+  for (const BenchResult &R : Results) {
+    W.StartObject();
+    W.Key("name");
+    W.String(R.Name.c_str());
+    W.Key("mode");
+    W.String(R.Mode.c_str());
+    W.Key("checksum");
+    W.String(R.Checksum.c_str());
+    for (uint32_t P = 0; P < NumBenchPhases; ++P) {
+      W.Key(PhaseNames[P]);
+      writeSummary(W, R.Phases[P]);
+    }
+    W.EndObject();
+  }
+  W.EndArray();
+  W.Key("scaling");
+  W.StartArray();
+  for (const ScalingResult &R : ScalingResults) {
+    W.StartObject();
+    W.Key("name");
+    W.String(R.Name.c_str());
+    W.Key("mode");
+    W.String(R.Mode.c_str());
+    W.Key("threads");
+    W.Uint(R.NumThreads);
+    W.Key("throughput");
+    W.Double(R.Throughput);
+    W.Key("round");
+    writeSummary(W, R.Round);
+    W.EndObject();
+  }
+  W.EndArray();
+  W.EndObject();
+  File << "\n";
+  return true;
+}
+
+// Compare the medians with the baseline, returns the number of regressions
+// beyond `Threshold` percent, or -1 if the baseline can't be read
+int compareWithBaseline(const std::string &Path, const BenchOptions &Opts,
+                        const std::vector<BenchResult> &Results,
+                        const std::vector<ScalingResult> &ScalingResults) {
+  std::ifstream File(Path);
+  if (!File.is_open()) {
+    ZEN_LOG_ERROR("failed to open baseline %s", Path.c_str());
+    return -1;
+  }
+  rapidjson::IStreamWrapper Stream(File);
+  rapidjson::Document Baseline;
+  Baseline.ParseStream(Stream);
+  if (Baseline.HasParseError() || !Baseline.IsObject() ||
+      !Baseline.HasMember("results") || !Baseline["results"].IsArray()) {
+    ZEN_LOG_ERROR("failed to read baseline %s", Path.c_str());
+    return -1;
+  }
+  if (Baseline.HasMember("scale") && Baseline["scale"].IsUint() &&
+      Baseline["scale"].GetUint() != Opts.Scale) {
+    ZEN_LOG_WARN("baseline was measured with scale %u",
+                 Baseline["scale"].GetUint());
+  }
+
+  const double Factor = 1 + Opts.Threshold / 100;
+  auto Matches = [](const rapidjson::Value &Entry, const std::string &Name,
+                    const std::string &Mode) {
+    return Entry.IsObject() && Entry.HasMember("name") &&
+           Entry.HasMember("mode") && Entry["name"].IsString() &&
+           Entry["mode"].IsString() && Name == Entry["name"].GetString() &&
+           Mode == Entry["mode"].GetString();
+  };
+  auto GetMedian = [](const rapidjson::Value &Entry, const char *Key,
+                      double &Median) {
+    if (!Entry.HasMember(Key) || !Entry[Key].IsObject() ||
+        !Entry[Key].HasMember("p50") || !Entry[Key]["p50"].IsNumber()) {
+      return false;
+    }
+    Median = Entry[Key]["p50"].GetDouble();
+    return true;
+  };
+
+  int NumRegressions = 0;
+  for (const BenchResult &R : Results) {
+    for (const auto &Entry : Baseline["results"].GetArray()) {
+      if (!Matches(Entry, R.Name, R.Mode)) {
+        continue;
+      }
+      for (uint32_t P = 0; P < NumBenchPhases; ++P) {
+        double Old = 0;
+        double New = R.Phases[P].P50;
+        if (!GetMedian(Entry, PhaseNames[P], Old) ||
+            Old < MinComparedTimeMs || New <= Old * Factor) {
+          continue;
+        }
+        printf("REGRESSION %s/%s %s p50 %.3fms -> %.3fms (+%.1f%%)\n",
+               R.Name.c_str(), R.Mode.c_str(), PhaseNames[P], Old, New,
+               (New / Old - 1) * 100);
+        ++NumRegressions;
+      }
+    }
+  }
+
+  if (!Baseline.HasMember("scaling") || !Baseline["scaling"].IsArray()) {
+    return NumRegressions;
+  }
+  for (const ScalingResult &R : ScalingResults) {
+    for (const auto &Entry : Baseline["scaling"].GetArray()) {
+      if (!Matches(Entry, R.Name, R.Mode) || !Entry.HasMember("threads") ||
+          !Entry["threads"].IsUint() ||
+          Entry["threads"].GetUint() != R.NumThreads ||
+          !Entry.HasMember("throughput") || !Entry["throughput"].IsNumber()) {
+        continue;
+      }
+      double Old = Entry["throughput"].GetDouble();
+      if (R.Throughput * Factor >= Old) {
+        continue;
+      }
+      printf("REGRESSION %s/%s %u threads %.1f -> %.1f rounds/s (%.1f%%)\n",
+             R.Name.c_str(), R.Mode.c_str(), R.NumThreads, Old, R.Throughput,
+             (R.Throughput / Old - 1) * 100);
+      ++NumRegressions;
+    }
+  }
+  return NumRegressions;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  BenchOptions Opts;
+  LoggerLevel LogLevel = LoggerLevel::Warn;
+  const std::unordered_map<std::string, LoggerLevel> LogMap = {
+      {"trace", LoggerLevel::Trace}, {"debug", LoggerLevel::Debug},
+      {"info", LoggerLevel::Info},   {"warn", LoggerLevel::Warn},
+      {"error", LoggerLevel::Error}, {"fatal", LoggerLevel::Fatal},
+      {"off", LoggerLevel::Off},
+  };
+  std::vector<std::string> ModeNames;
+  for (const BenchMode &Mode : AllModes) {
+    ModeNames.push_back(Mode.Name);
+  }
+
+  try {
+    CLI::App CLIParser("ZetaEngine Benchmark Harness\n", "dtvm_bench");
+    CLIParser.add_option("--corpus-dir", Opts.CorpusDir,
+                         "Directory of the built benchmark corpus");
+    CLIParser.add_option("--filter", Opts.Filter,
+                         "Only run the contracts whose names contain it");
+    CLIParser.add_option("--modes", Opts.Modes, "Modes to run(default all)")
+        ->delimiter(',')
+        ->check(CLI::IsMember(ModeNames));
+    CLIParser.add_option("--warmup", Opts.NumWarmups,
+                         "Untimed runs before the timed ones");
+    CLIParser.add_option("--iterations", Opts.NumIterations, "Timed runs")
+        ->check(CLI::PositiveNumber);
+    CLIParser.add_option("--scale", Opts.Scale,
+                         "The work size argument passed to the contracts");
+    CLIParser
+        .add_option("--threads", Opts.ThreadCounts,
+                    "Thread counts to run instances of one Wasm module on at "
+                    "once(e.g. 1,2,4,8,16,32,64)")
+        ->delimiter(',')
+        ->check(CLI::Range(1u, 1024u));
+    CLIParser.add_option("--thread-rounds", Opts.NumThreadRounds,
+                         "Instantiations and runs per thread");
+    CLIParser.add_option("--output", Opts.OutputPath,
+                         "Write the results as JSON to this file");
+    CLIParser.add_option("--baseline", Opts.BaselinePath,
+                         "Compare the results with this JSON file");
+    CLIParser.add_option("--threshold", Opts.Threshold,
+                         "Percent slowdown to report as a regression");
+    CLIParser.add_option("--log-level", LogLevel, "Log level")
+        ->transform(CLI::CheckedTransformer(LogMap, CLI::ignore_case));
+    CLI11_PARSE(CLIParser, argc, argv);
+  } catch (const std::exception &e) {
+    printf("failed to parse command line arguments: %s\n", e.what());
+    return EXIT_FAILURE;
+  }
+
+  try {
+    zen::setGlobalLogger(createConsoleLogger("dtvm_bench_logger", LogLevel));
+  } catch (const std::exception &e) {
+    printf("failed to create logger: %s\n", e.what());
+    return EXIT_FAILURE;
+  }
+
+  std::vector<Contract> Contracts;
+  if (!loadCorpusDir(Opts.CorpusDir + "/wasm", ".wasm", false, Opts.Filter,
+                     Contracts) ||
+      !loadCorpusDir(Opts.CorpusDir + "/evm", ".evm.hex", true, Opts.Filter,
+                     Contracts)) {
+    return EXIT_FAILURE;
+  }
+
+  bool Success = true;
+  std::vector<BenchResult> Results;
+  std::vector<ScalingResult> ScalingResults;
+  // Every Wasm mode must compute the same results
+  std::unordered_map<std::string, std::string> WasmChecksums;
+  evmone::VM VM;
+  for (const BenchMode &Mode : AllModes) {
+    if (!Opts.Modes.empty() &&
+        std::find(Opts.Modes.begin(), Opts.Modes.end(), Mode.Name) ==
+            Opts.Modes.end()) {
+      continue;
+    }
+    std::unique_ptr<Runtime> RT;
+    if (!Mode.IsEVM) {
+      RT = newBenchRuntime(Mode);
+      if (!RT) {
+        ZEN_LOG_ERROR("failed to create %s runtime", Mode.Name);
+        return EXIT_FAILURE;
+      }
+    }
+    for (const Contract &C : Contracts) {
+      if (C.IsEVM != Mode.IsEVM) {
+        continue;
+      }
+      BenchResult Result;
+      if (!runContract(Mode, RT.get(), VM, C, Opts, Result)) {
+        ZEN_LOG_ERROR("%s failed in %s mode", C.Name.c_str(), Mode.Name);
+        Success = false;
+        continue;
+      }
+      if (!C.IsEVM) {
+        auto [It, Inserted] = WasmChecksums.emplace(C.Name, Result.Checksum);
+        if (!Inserted && It->second != Result.Checksum) {
+          ZEN_LOG_ERROR("%s returned %s in %s mode, but %s in other modes",
+                        C.Name.c_str(), Result.Checksum.c_str(), Mode.Name,
+                        It->second.c_str());
+          Success = false;
+        }
+        if (!Opts.ThreadCounts.empty() &&
+            !runScaling(Mode, *RT, C, Opts, ScalingResults)) {
+          Success = false;
+        }
+      }
+      Results.push_back(std::move(Result));
+    }
+  }
+
+  printResults(Results, ScalingResults);
+
+  if (!Opts.OutputPath.empty() &&
+      !writeJSON(Opts.OutputPath, Opts, Results, ScalingResults)) {
+    Success = false;
+  }
+
+  if (!Opts.BaselinePath.empty()) {
+    int NumRegressions =
+        compareWithBaseline(Opts.BaselinePath, Opts, Results, ScalingResults);
+    if (NumRegressions != 0) {
+      Success = false;
+    }
+    if (NumRegressions > 0) {
+      printf("%d regressions beyond %.1f%%\n", NumRegressions,
+             Opts.Threshold);
+    }
+  }
+
+  return Success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -55,6 +55,32 @@ int exitMain(int ExitCode, Runtime *RT = nullptr) {
 #define SIMPLE_LOG_ERROR(...) ZEN_LOG_ERROR(__VA_ARGS__)
 #endif // ZEN_ENABLE_EVMABI_TEST
 
+// Feed the module to the runtime chunk by chunk to emulate reading it from
+// storage, used to benchmark streaming loading against the whole-buffer path
+static MayBe<Module *> loadModuleByStream(Runtime &RT,
+                                          const std::string &ModName,
+                                          const CodeHolder &Code,
+                                          uint32_t ChunkSize,
+                                          uint32_t ChunkIntervalUs,
+                                          const std::string &EntryHint) {
+  size_t Size = Code.getSize();
+  auto Stream = RT.startModuleStream(ModName, Size, EntryHint);
+  if (!Stream) {
+    return getError(ErrorCode::InvalidRawData);
+  }
+  const auto *Bytes = static_cast<const uint8_t *>(Code.getData());
+  for (size_t Offset = 0; Offset < Size; Offset += ChunkSize) {
+    if (ChunkIntervalUs > 0) {
+      usleep(ChunkIntervalUs);
+    }
+    size_t CurChunkSize = std::min<size_t>(ChunkSize, Size - Offset);
+    if (!Stream->append(Bytes + Offset, CurChunkSize)) {
+      break;
+    }
+  }
+  return Stream->finish();
+}
+
 int main(int argc, char *argv[]) {
 #ifdef ZEN_ENABLE_PROFILER
   ProfilerStart("dtvm.prof");
@@ -80,6 +106,8 @@ int main(int argc, char *argv[]) {
   LoggerLevel LogLevel = LoggerLevel::Info;
   uint32_t NumExtraCompilations = 0;
   uint32_t NumExtraExecutions = 0;
+  uint32_t StreamChunkSize = 0;
+  uint32_t StreamChunkIntervalUs = 0;
   RuntimeConfig Config;
   bool EnableBenchmark = false;
 
@@ -92,6 +120,12 @@ int main(int argc, char *argv[]) {
       {"singlepass", RunMode::SinglepassMode},
       {"multipass", RunMode::MultipassMode},
   };
+  const std::unordered_map<std::string, IntrinsicKind> IntrinsicMap = {
+#define DEFINE_INTRINSIC(NAME, FIELD, NUM_PARAMS) {#FIELD, IntrinsicKind::NAME},
+#include "common/intrinsics.def"
+#undef DEFINE_INTRINSIC
+  };
+  std::vector<IntrinsicKind> Intrinsics;
   const std::unordered_map<std::string, LoggerLevel> LogMap = {
       {"trace", LoggerLevel::Trace}, {"debug", LoggerLevel::Debug},
       {"info", LoggerLevel::Info},   {"warn", LoggerLevel::Warn},
@@ -117,11 +151,20 @@ int main(int argc, char *argv[]) {
                           "The number of extra compilations");
     CLIParser->add_option("--num-extra-executions", NumExtraExecutions,
                           "The number of extra executions");
+    CLIParser->add_option("--stream-chunk-size", StreamChunkSize,
+                          "Load the module by streaming chunks of this size");
+    CLIParser->add_option("--stream-chunk-interval-us", StreamChunkIntervalUs,
+                          "Delay before each streaming chunk to emulate I/O");
     CLIParser->add_flag("--enable-statistics", Config.EnableStatistics,
                         "Enable statistics");
     CLIParser->add_flag("--disable-wasm-memory-map",
                         Config.DisableWasmMemoryMap, "Disable wasm memory map");
     CLIParser->add_flag("--benchmark", EnableBenchmark, "Enable benchmark");
+    CLIParser
+        ->add_option("--enable-intrinsics", Intrinsics,
+                     "Implement these \"env\" imports in the runtime(e.g. "
+                     "memcpy memset)")
+        ->transform(CLI::CheckedTransformer(IntrinsicMap));
     // If you want to trace the cpu instructions of wasm func,
     // you can qemu-x86_64 -cpu qemu64,+ssse3,+sse4.1,+sse4.2,+x2apic
     // -singlestep -d in_asm -strace dtvm $ARGS_OF_DTVM 2>&1 | tee trace.log
@@ -130,6 +173,24 @@ int main(int argc, char *argv[]) {
         "--enable-gdb-tracing-hook", Config.EnableGdbTracingHook,
         "Enable gdb cpu instruction tracing hook(then can trace cpu "
         "instructions when executing wasm in gdb)");
+    CLIParser->add_option("--num-validation-threads",
+                          Config.NumValidationThreads,
+                          "Number of threads to validate function bodies of "
+                          "large modules");
+    CLIParser->add_flag("--disable-shared-code-heap",
+                        Config.DisableSharedCodeHeap,
+                        "Give each module its own JIT code memory");
+    CLIParser->add_flag("--enable-huge-page-code", Config.EnableHugePageCode,
+                        "Use transparent huge pages for JIT code");
+    CLIParser->add_flag("--enable-huge-page-memory",
+                        Config.EnableHugePageMemory,
+                        "Use transparent huge pages for wasm memories");
+#ifdef ZEN_ENABLE_LINUX_PERF
+    CLIParser->add_flag("--enable-perf-map", Config.EnablePerfMap,
+                        "Write JIT symbols to /tmp/perf-<pid>.map");
+    CLIParser->add_flag("--enable-jitdump", Config.EnableJitDump,
+                        "Write JIT symbols and code to jit-<pid>.dump");
+#endif // ZEN_ENABLE_LINUX_PERF
 #ifdef ZEN_ENABLE_MULTIPASS_JIT
     CLIParser->add_flag("--disable-multipass-greedyra",
                         Config.DisableMultipassGreedyRA,
@@ -142,12 +203,23 @@ int main(int argc, char *argv[]) {
                      "Number of threads for multipass JIT(set 0 for automatic "
                      "determination)")
         ->excludes(DMMOption);
+    CLIParser->add_flag("--disable-multipass-function-layout",
+                        Config.DisableMultipassFunctionLayout,
+                        "Disable call graph ordered function layout of "
+                        "multipass JIT");
     CLIParser->add_flag("--enable-multipass-lazy", Config.EnableMultipassLazy,
                         "Enable multipass lazy mode(on request compile)");
+    CLIParser->add_option("--multipass-profile-dir",
+                          Config.MultipassProfileDir,
+                          "Directory of the profiles to order background "
+                          "compilation in multipass lazy mode");
     CLIParser->add_option("--entry-hint", EntryHint, "Entry function hint");
 #endif // ZEN_ENABLE_MULTIPASS_JIT
 
     CLI11_PARSE(*CLIParser, argc, argv);
+    for (IntrinsicKind Kind : Intrinsics) {
+      Config.EnabledIntrinsics |= getIntrinsicMask(Kind);
+    }
   } catch (const std::exception &e) {
     printf("failed to parse command line arguments: %s\n", e.what());
     return exitMain(EXIT_FAILURE);
@@ -247,7 +319,20 @@ int main(int argc, char *argv[]) {
   /// ================ Load user's module ================
 
   const auto &ActualEntryHint = !EntryHint.empty() ? EntryHint : FuncName;
-  MayBe<Module *> ModRet = RT->loadModule(Filename, ActualEntryHint);
+  CodeHolderUniquePtr StreamCode;
+  if (StreamChunkSize > 0) {
+    try {
+      StreamCode = CodeHolder::newFileCodeHolder(*RT, Filename);
+    } catch (const std::exception &e) {
+      SIMPLE_LOG_ERROR("failed to load module: %s", e.what());
+      return exitMain(EXIT_FAILURE, RT.get());
+    }
+  }
+  MayBe<Module *> ModRet =
+      StreamCode ? loadModuleByStream(*RT, Filename, *StreamCode,
+                                      StreamChunkSize, StreamChunkIntervalUs,
+                                      ActualEntryHint)
+                 : RT->loadModule(Filename, ActualEntryHint);
   if (!ModRet) {
     const Error &Err = ModRet.getError();
     ZEN_ASSERT(!Err.isEmpty());
@@ -328,7 +413,10 @@ int main(int argc, char *argv[]) {
       // Use new filename to avoid cache based on filename
       std::string NewWasmName = Filename + std::to_string(I);
       MayBe<Module *> TestModRet =
-          RT->loadModule(NewWasmName, Code->getData(), Code->getSize());
+          StreamChunkSize > 0
+              ? loadModuleByStream(*RT, NewWasmName, *Code, StreamChunkSize,
+                                   StreamChunkIntervalUs, ActualEntryHint)
+              : RT->loadModule(NewWasmName, Code->getData(), Code->getSize());
       ZEN_ASSERT(TestModRet);
       RT->unloadModule(*TestModRet);
     }
@@ -0,0 +1,348 @@
+// Copyright (C) 2021-2023 the DTVM authors. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "common/code_heap.h"
+
+#ifndef ZEN_ENABLE_SGX
+#include "utils/logging.h"
+#include <algorithm>
+#include <limits>
+
+namespace zen::common {
+
+namespace {
+
+// Epoch of the threads in JIT code, 0 if not in JIT code
+struct ThreadEpoch {
+  ThreadEpoch();
+  ~ThreadEpoch();
+  std::atomic<uint64_t> Epoch{0};
+  uint32_t Depth = 0;
+};
+
+// Incremented on each retirement, a block retired at epoch `E` is reclaimed
+// when all threads in JIT code have entered after `E`
+std::atomic<uint64_t> GlobalEpoch{1};
+
+Mutex ThreadEpochsMtx;
+std::vector<ThreadEpoch *> ThreadEpochs;
+
+ThreadEpoch::ThreadEpoch() {
+  LockGuard<Mutex> Lock(ThreadEpochsMtx);
+  ThreadEpochs.push_back(this);
+}
+
+ThreadEpoch::~ThreadEpoch() {
+  LockGuard<Mutex> Lock(ThreadEpochsMtx);
+  ThreadEpochs.erase(
+      std::find(ThreadEpochs.begin(), ThreadEpochs.end(), this));
+}
+
+thread_local ThreadEpoch CurThreadEpoch;
+
+uint64_t getMinActiveEpoch() {
+  uint64_t MinEpoch = std::numeric_limits<uint64_t>::max();
+  LockGuard<Mutex> Lock(ThreadEpochsMtx);
+  for (const ThreadEpoch *TE : ThreadEpochs) {
+    uint64_t Epoch = TE->Epoch.load(std::memory_order_seq_cst);
+    if (Epoch) {
+      MinEpoch = std::min(MinEpoch, Epoch);
+    }
+  }
+  return MinEpoch;
+}
+
+size_t getSizeClass(size_t Size) {
+  size_t NumPages = Size / CodeHeap::PageSize;
+  size_t Class = 0;
+  while ((size_t(1) << Class) < NumPages) {
+    ++Class;
+  }
+  return Class;
+}
+
+bool isSizeClassSize(size_t Size) {
+  return Size <= CodeHeap::MaxSizeClassSize &&
+         (size_t(CodeHeap::PageSize) << getSizeClass(Size)) == Size;
+}
+
+} // namespace
+
+CodeHeap::ExecutionScope::ExecutionScope() {
+  ThreadEpoch &TE = CurThreadEpoch;
+  if (TE.Depth++) {
+    return;
+  }
+  // Publish the epoch before running any code, and retry if a block was
+  // retired meanwhile as the retirement may not have seen it
+  uint64_t Epoch;
+  do {
+    Epoch = GlobalEpoch.load(std::memory_order_seq_cst);
+    TE.Epoch.store(Epoch, std::memory_order_seq_cst);
+  } while (GlobalEpoch.load(std::memory_order_seq_cst) != Epoch);
+}
+
+CodeHeap::ExecutionScope::~ExecutionScope() {
+  ThreadEpoch &TE = CurThreadEpoch;
+  ZEN_ASSERT(TE.Depth > 0);
+  if (--TE.Depth == 0) {
+    TE.Epoch.store(0, std::memory_order_release);
+  }
+}
+
+std::unique_ptr<CodeHeap> CodeHeap::newCodeHeap(bool UseHugePages) {
+  std::unique_ptr<CodeHeap> Heap(new CodeHeap(UseHugePages));
+  if (!Heap->addRegion()) {
+    return nullptr;
+  }
+  return Heap;
+}
+
+CodeHeap::~CodeHeap() {
+  for (const auto &R : Regions) {
+    platform::munmap(R->Start, RegionSize);
+    platform::munmap(R->WriteStart, RegionSize);
+  }
+}
+
+bool CodeHeap::addRegion() {
+  void *ExecAddr = nullptr;
+  void *WriteAddr = nullptr;
+  if (!platform::mapDualView(RegionSize, &ExecAddr, &WriteAddr)) {
+    return false;
+  }
+  // Blocks are allocated from the region start, so the code is packed into
+  // the first huge pages. The pages are first touched through the writable
+  // view, which decides their size
+  if (UseHugePages && !(platform::adviseHugePages(WriteAddr, RegionSize) &&
+                        platform::adviseHugePages(ExecAddr, RegionSize))) {
+    ZEN_LOG_WARN("transparent huge pages not supported for JIT code");
+  }
+  auto R = std::make_unique<Region>();
+  R->Start = static_cast<uint8_t *>(ExecAddr);
+  R->WriteStart = static_cast<uint8_t *>(WriteAddr);
+  R->Top = R->Start;
+  Regions.push_back(std::move(R));
+  return true;
+}
+
+uint32_t CodeHeap::acquireRegion() {
+  LockGuard<Mutex> Lock(Mtx);
+  // Keep half of the region for the pools placed in it to grow
+  uint32_t BestIdx = 0;
+  size_t BestUsed = std::numeric_limits<size_t>::max();
+  for (uint32_t I = 0; I < Regions.size(); ++I) {
+    size_t Used = Regions[I]->Top - Regions[I]->Start;
+    if (Used < BestUsed) {
+      BestIdx = I;
+      BestUsed = Used;
+    }
+  }
+  if (BestUsed < RegionSize / 2 || !addRegion()) {
+    return BestIdx;
+  }
+  return Regions.size() - 1;
+}
+
+uint8_t *CodeHeap::getRegionStart(uint32_t RegionIdx) {
+  LockGuard<Mutex> Lock(Mtx);
+  return Regions[RegionIdx]->Start;
+}
+
+uint8_t *CodeHeap::getRegionWriteStart(uint32_t RegionIdx) {
+  LockGuard<Mutex> Lock(Mtx);
+  return Regions[RegionIdx]->WriteStart;
+}
+
+size_t CodeHeap::getBlockSize(size_t Size) {
+  Size = ZEN_ALIGN(Size, PageSize);
+  if (Size > MaxSizeClassSize) {
+    return Size;
+  }
+  return size_t(PageSize) << getSizeClass(Size);
+}
+
+uint8_t *CodeHeap::allocate(uint32_t RegionIdx, size_t Size) {
+  ZEN_ASSERT(Size && Size % PageSize == 0);
+  LockGuard<Mutex> Lock(Mtx);
+  Region &R = *Regions[RegionIdx];
+  if (!RetiredBlocks.empty()) {
+    reclaimRetiredBlocks();
+  }
+
+  uint8_t *Ptr = nullptr;
+  if (isSizeClassSize(Size)) {
+    auto &FreeList = R.FreeLists[getSizeClass(Size)];
+    if (!FreeList.empty()) {
+      Ptr = FreeList.back();
+      FreeList.pop_back();
+      FreeSize -= Size;
+    }
+  }
+  if (!Ptr) {
+    // Best fit in the large blocks, the rest is freed again
+    auto It = R.LargeFreeBlocks.lower_bound(Size);
+    if (It != R.LargeFreeBlocks.end()) {
+      size_t BlockSize = It->first;
+      Ptr = It->second;
+      R.LargeFreeBlocks.erase(It);
+      FreeSize -= BlockSize;
+      if (BlockSize > Size) {
+        addFreeBlock(R, Ptr + Size, BlockSize - Size);
+      }
+    }
+  }
+  if (!Ptr) {
+    if (static_cast<size_t>(R.Start + RegionSize - R.Top) < Size) {
+      return nullptr;
+    }
+    Ptr = R.Top;
+    R.Top += Size;
+  }
+  UsedSize += Size;
+  return Ptr;
+}
+
+bool CodeHeap::extend(uint32_t RegionIdx, uint8_t *End, size_t Size) {
+  ZEN_ASSERT(Size % PageSize == 0);
+  LockGuard<Mutex> Lock(Mtx);
+  Region &R = *Regions[RegionIdx];
+  if (End != R.Top ||
+      static_cast<size_t>(R.Start + RegionSize - R.Top) < Size) {
+    return false;
+  }
+  R.Top += Size;
+  UsedSize += Size;
+  return true;
+}
+
+void CodeHeap::retire(uint32_t RegionIdx, uint8_t *Ptr, size_t Size) {
+  LockGuard<Mutex> Lock(Mtx);
+  uint64_t Epoch = GlobalEpoch.fetch_add(1, std::memory_order_seq_cst);
+  RetiredBlocks.push_back({RegionIdx, Ptr, Size, Epoch});
+  UsedSize -= Size;
+  RetiredSize += Size;
+  reclaimRetiredBlocks();
+}
+
+void CodeHeap::retire(uint32_t RegionIdx,
+                      const std::unordered_map<uint8_t *, size_t> &Blocks) {
+  if (Blocks.empty()) {
+    return;
+  }
+  LockGuard<Mutex> Lock(Mtx);
+  uint64_t Epoch = GlobalEpoch.fetch_add(1, std::memory_order_seq_cst);
+  for (const auto &[Ptr, Size] : Blocks) {
+    RetiredBlocks.push_back({RegionIdx, Ptr, Size, Epoch});
+    UsedSize -= Size;
+    RetiredSize += Size;
+  }
+  reclaimRetiredBlocks();
+}
+
+CodeHeap::Usage CodeHeap::getUsage() {
+  LockGuard<Mutex> Lock(Mtx);
+  if (!RetiredBlocks.empty()) {
+    reclaimRetiredBlocks();
+  }
+  Usage U;
+  U.NumRegions = Regions.size();
+  U.ReservedSize = Regions.size() * RegionSize;
+  U.UsedSize = UsedSize;
+  U.FreeSize = FreeSize;
+  U.RetiredSize = RetiredSize;
+  return U;
+}
+
+void CodeHeap::addFreeBlock(Region &R, uint8_t *Ptr, size_t Size) {
+  ZEN_ASSERT(Size && Size % PageSize == 0);
+  FreeSize += Size;
+  if (isSizeClassSize(Size)) {
+    R.FreeLists[getSizeClass(Size)].push_back(Ptr);
+  } else {
+    R.LargeFreeBlocks.emplace(Size, Ptr);
+  }
+}
+
+void CodeHeap::reclaimRetiredBlocks() {
+  uint64_t MinEpoch = getMinActiveEpoch();
+  auto It = std::remove_if(
+      RetiredBlocks.begin(), RetiredBlocks.end(), [&](const RetiredBlock &B) {
+        if (B.Epoch >= MinEpoch) {
+          return false;
+        }
+        RetiredSize -= B.Size;
+        addFreeBlock(*Regions[B.RegionIdx], B.Ptr, B.Size);
+        return true;
+      });
+  RetiredBlocks.erase(It, RetiredBlocks.end());
+}
+
+void *MemPool<CODE_POOL>::allocateFromHeap(size_t Size, size_t Align) {
+  if (!MemStart) {
+    RegionIdx = Heap->acquireRegion();
+    MemStart = Heap->getRegionStart(RegionIdx);
+    WriteStart = Heap->getRegionWriteStart(RegionIdx);
+    MemEnd = MemPageEnd = MemStart;
+  }
+
+  auto AllocateBlock = [&](size_t BlockSize) {
+    uint8_t *Ptr = Heap->allocate(RegionIdx, BlockSize);
+    if (!Ptr) {
+      ZEN_ABORT(); // not supported, exit
+    }
+    Blocks[Ptr] = BlockSize;
+    MemEnd = MemPageEnd = std::max(MemPageEnd, Ptr + BlockSize);
+    return Ptr;
+  };
+
+  // Page aligned code gets its own block to be retired separately
+  if (Align >= PageSize) {
+    ZEN_ASSERT(PageSize % Align == 0);
+    return AllocateBlock(CodeHeap::getBlockSize(Size));
+  }
+
+  uint8_t *Ptr = reinterpret_cast<uint8_t *>(
+      ZEN_ALIGN(reinterpret_cast<uintptr_t>(ChunkTop), Align));
+  if (ChunkStart && Ptr + Size > ChunkEnd) {
+    size_t GrowSize = Ptr + Size - ChunkEnd;
+    GrowSize = ZEN_ALIGN(GrowSize, PageSize);
+    if (Heap->extend(RegionIdx, ChunkEnd, GrowSize)) {
+      Blocks[ChunkStart] += GrowSize;
+      ChunkEnd += GrowSize;
+      MemEnd = MemPageEnd = std::max(MemPageEnd, ChunkEnd);
+    }
+  }
+  if (!ChunkStart || Ptr + Size > ChunkEnd) {
+    constexpr size_t MinChunkSize = 16 * PageSize;
+    ChunkStart = AllocateBlock(
+        CodeHeap::getBlockSize(std::max(Size + Align, MinChunkSize)));
+    ChunkEnd = ChunkStart + Blocks[ChunkStart];
+    Ptr = reinterpret_cast<uint8_t *>(
+        ZEN_ALIGN(reinterpret_cast<uintptr_t>(ChunkStart), Align));
+  }
+  ChunkTop = Ptr + Size;
+  return Ptr;
+}
+
+void MemPool<CODE_POOL>::releaseHeapBlocks() {
+  // Other modules run code from the same heap, a thread may still be returning
+  // through this code, so it is only reused once every thread has left it
+  Heap->retire(RegionIdx, Blocks);
+  Blocks.clear();
+}
+
+void MemPool<CODE_POOL>::retire(void *Ptr) {
+  LockGuard<Mutex> Lock(Mtx);
+  if (!Heap) {
+    return;
+  }
+  auto It = Blocks.find(static_cast<uint8_t *>(Ptr));
+  ZEN_ASSERT(It != Blocks.end() && It->first != ChunkStart);
+  Heap->retire(RegionIdx, It->first, It->second);
+  Blocks.erase(It);
+}
+
+} // namespace zen::common
+
+#endif // ZEN_ENABLE_SGX
@@ -0,0 +1,122 @@
+// Copyright (C) 2021-2023 the DTVM authors. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef ZEN_COMMON_CODE_HEAP_H
+#define ZEN_COMMON_CODE_HEAP_H
+
+#include "common/mem_pool.h"
+
+#ifndef ZEN_ENABLE_SGX
+#include <atomic>
+#include <map>
+#include <unordered_map>
+
+namespace zen::common {
+
+// Runtime-wide code heap shared by the code pools of all modules.
+//
+// The heap reserves dual-mapped regions of CodeMemPool::MaxCodeSize bytes,
+// a code pool places all its blocks in one region, so the code and stubs of a
+// module are always reachable by rel32 from each other. Blocks are page
+// granular and recycled through size-class free lists. Code which may still
+// be executed when superseded is retired, and reclaimed once every thread in
+// JIT code has entered it after the retirement.
+class CodeHeap {
+public:
+  struct Usage {
+    size_t NumRegions = 0;
+    size_t ReservedSize = 0;
+    size_t UsedSize = 0;    // allocated to code pools
+    size_t FreeSize = 0;    // in the free lists
+    size_t RetiredSize = 0; // waiting for reclamation
+  };
+
+  // Marks the current thread executing JIT code during its lifetime, nested
+  // scopes are allowed
+  class ExecutionScope {
+  public:
+    ExecutionScope();
+    ~ExecutionScope();
+    NONCOPYABLE(ExecutionScope);
+  };
+
+  // Returns nullptr if the platform doesn't support the dual mapping, the
+  // regions are advised to be backed by transparent huge pages if
+  // `UseHugePages`
+  static std::unique_ptr<CodeHeap> newCodeHeap(bool UseHugePages = false);
+
+  ~CodeHeap();
+
+  NONCOPYABLE(CodeHeap);
+
+  // Returns the index of the region for a new code pool
+  uint32_t acquireRegion();
+
+  uint8_t *getRegionStart(uint32_t RegionIdx);
+
+  uint8_t *getRegionWriteStart(uint32_t RegionIdx);
+
+  // Round `Size` up to the size of the block allocated for it
+  static size_t getBlockSize(size_t Size);
+
+  // `Size` must be a block size, returns nullptr if the region is full
+  uint8_t *allocate(uint32_t RegionIdx, size_t Size);
+
+  // Grow the block ending at `End` by `Size` bytes in place, only possible if
+  // it's the last block of the region
+  bool extend(uint32_t RegionIdx, uint8_t *End, size_t Size);
+
+  // The code in the block must be unreachable from now on, but threads in JIT
+  // code may still be running it
+  void retire(uint32_t RegionIdx, uint8_t *Ptr, size_t Size);
+
+  // Retire all the blocks of a destroyed code pool at once, start => size
+  void retire(uint32_t RegionIdx,
+              const std::unordered_map<uint8_t *, size_t> &Blocks);
+
+  Usage getUsage();
+
+  static constexpr size_t PageSize = CodeMemPool::PageSize;
+  // Size classes of 1, 2, 4, ... 64 pages, larger blocks are best fit
+  static constexpr size_t NumSizeClasses = 7;
+  static constexpr size_t MaxSizeClassSize = PageSize << (NumSizeClasses - 1);
+  static constexpr size_t RegionSize = CodeMemPool::MaxCodeSize;
+
+private:
+  struct Region {
+    uint8_t *Start;
+    uint8_t *WriteStart;
+    uint8_t *Top;
+    std::vector<uint8_t *> FreeLists[NumSizeClasses];
+    std::multimap<size_t, uint8_t *> LargeFreeBlocks;
+  };
+
+  struct RetiredBlock {
+    uint32_t RegionIdx;
+    uint8_t *Ptr;
+    size_t Size;
+    uint64_t Epoch;
+  };
+
+  explicit CodeHeap(bool UseHugePages) : UseHugePages(UseHugePages) {}
+
+  bool addRegion();
+
+  void addFreeBlock(Region &R, uint8_t *Ptr, size_t Size);
+
+  void reclaimRetiredBlocks();
+
+  const bool UseHugePages;
+  Mutex Mtx;
+  std::vector<std::unique_ptr<Region>> Regions;
+  std::vector<RetiredBlock> RetiredBlocks;
+  size_t UsedSize = 0;
+  size_t FreeSize = 0;
+  size_t RetiredSize = 0;
+};
+
+} // namespace zen::common
+
+#endif // ZEN_ENABLE_SGX
+
+#endif // ZEN_COMMON_CODE_HEAP_H
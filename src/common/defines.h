@@ -69,6 +69,12 @@ constexpr size_t PresetMaxNumMemories = 1;
 // At most one table is allowed in MVP
 constexpr size_t PresetMaxNumTables = 1;
 
+// Gas charged for each byte written by memory.copy, memory.fill and
+// memory.init when the instance is metered. The instrumented gas calls only
+// know the instruction count, so the length dependent part is charged by the
+// runtime
+constexpr uint64_t BulkMemoryGasPerByte = 1;
+
 // when protect stack overflow by cpu trap(no dwasm mode), leave guard memory in
 // stack
 constexpr int64_t StackGuardSize = 16384;
@@ -114,11 +120,10 @@ constexpr size_t PresetReservedStackSize = 4 * 1024 * 1024;   // 4MB
 
 constexpr size_t PresetMaxSectionSize = 512 * 1024 * 1024; // 512MB
 constexpr size_t PresetMaxNameLength = UINT16_MAX;
-constexpr size_t PresetMaxNumParams = UINT16_MAX;     // uint16_t
-constexpr size_t PresetMaxNumParamCells = UINT16_MAX; // uint16_t
-// At most one return value in MVP
-constexpr size_t PresetMaxNumReturns = 1;                 // uint8_t: 2 bits
-constexpr size_t PresetMaxNumReturnCells = (1u << 6) - 1; // uint8_t: 6 bits
+constexpr size_t PresetMaxNumParams = UINT16_MAX;      // uint16_t
+constexpr size_t PresetMaxNumParamCells = UINT16_MAX;  // uint16_t
+constexpr size_t PresetMaxNumReturns = UINT16_MAX;     // uint16_t
+constexpr size_t PresetMaxNumReturnCells = UINT16_MAX; // uint16_t
 
 constexpr size_t PresetMaxMemoryPages = 1u << 16;                // 65536 pages
 constexpr size_t PresetMaxFunctionSize = 16 * 1024 * 1024;       // 16MB
@@ -46,6 +46,20 @@ enum Opcode {
 #undef DEFINE_WASM_OPCODE
 }; // Opcode
 
+// Sub-opcodes following PREFIX_FC
+enum FCOpcode {
+#define DEFINE_WASM_OPCODE(NAME, OPCODE, TEXT) NAME = OPCODE,
+#include "common/wasm_defs/opcode_fc.def"
+#undef DEFINE_WASM_OPCODE
+}; // FCOpcode
+
+// Sub-opcodes following PREFIX_FD
+enum FDOpcode {
+#define DEFINE_WASM_OPCODE(NAME, OPCODE, TEXT) NAME = OPCODE,
+#include "common/wasm_defs/opcode_fd.def"
+#undef DEFINE_WASM_OPCODE
+}; // FDOpcode
+
 enum LabelType {
   LABEL_BLOCK,
   LABEL_LOOP,
@@ -58,6 +72,18 @@ enum class InputFormat {
   EVM,
 };
 
+// Library functions implemented by the runtime, see "common/intrinsics.def"
+enum class IntrinsicKind : uint8_t {
+  NONE = 0,
+#define DEFINE_INTRINSIC(NAME, FIELD, NUM_PARAMS) NAME,
+#include "common/intrinsics.def"
+#undef DEFINE_INTRINSIC
+};
+
+constexpr uint32_t getIntrinsicMask(IntrinsicKind Kind) {
+  return 1u << static_cast<uint32_t>(Kind);
+}
+
 enum class RunMode {
   InterpMode = 0,
   SinglepassMode = 1,
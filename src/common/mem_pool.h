@@ -8,10 +8,10 @@
 #include "common/errors.h"
 #include "platform/map.h"
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #ifndef NDEBUG
-#include <unordered_map>
 #ifdef ZEN_BUILD_PLATFORM_LINUX
 #ifndef ZEN_ENABLE_SGX
 #include <malloc.h>
@@ -207,16 +207,48 @@ private:
 using SysMemPool = MemPool<SYS_POOL>;
 
 #ifndef ZEN_ENABLE_SGX
+class CodeHeap;
+
+// Code is emitted and patched through a writable view of the pool and executed
+// from another executable view, so the page protection never changes after
+// the pool is created. Falls back to a single view whose pages are made
+// writable on allocation and executable by the users when the platform
+// doesn't support the dual mapping.
+//
+// With a `CodeHeap`, the pool doesn't reserve its own memory and takes blocks
+// from one region of the heap instead, see `CodeHeap`
 template <> class MemPool<CODE_POOL> {
 public:
-  MemPool() {
-    MemStart = reinterpret_cast<uint8_t *>(platform::mmap(
-        NULL, MaxCodeSize, PROT_NONE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0));
+  explicit MemPool(CodeHeap *Heap = nullptr) : Heap(Heap) {
+    if (Heap) {
+      // The region is acquired on the first allocation
+      MemStart = WriteStart = MemEnd = MemPageEnd = nullptr;
+      return;
+    }
+    void *ExecAddr = nullptr;
+    void *WriteAddr = nullptr;
+    if (platform::mapDualView(MaxCodeSize, &ExecAddr, &WriteAddr)) {
+      MemStart = reinterpret_cast<uint8_t *>(ExecAddr);
+      WriteStart = reinterpret_cast<uint8_t *>(WriteAddr);
+    } else {
+      MemStart = reinterpret_cast<uint8_t *>(platform::mmap(
+          NULL, MaxCodeSize, PROT_NONE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0));
+      WriteStart = MemStart;
+    }
     MemEnd = MemStart;
     MemPageEnd = MemStart;
   }
 
-  ~MemPool() { platform::munmap(MemStart, MaxCodeSize); }
+  ~MemPool() {
+    if (Heap) {
+      releaseHeapBlocks();
+      return;
+    }
+    platform::munmap(MemStart, MaxCodeSize);
+    if (isDualMapped()) {
+      platform::munmap(WriteStart, MaxCodeSize);
+    }
+  }
 
   NONCOPYABLE(MemPool);
 
@@ -225,6 +257,9 @@ public:
       return nullptr;
     }
     LockGuard<Mutex> Lock(Mtx);
+    if (Heap) {
+      return allocateFromHeap(Size, Align);
+    }
     uint8_t *Ptr = reinterpret_cast<uint8_t *>(
         ZEN_ALIGN(reinterpret_cast<uintptr_t>(MemEnd), Align));
     size_t NewSize = reinterpret_cast<uintptr_t>(Ptr) + Size -
@@ -236,7 +271,10 @@ public:
     if (MemEnd > MemPageEnd) {
       uint8_t *NewMemPageEnd = reinterpret_cast<uint8_t *>(
           ZEN_ALIGN(reinterpret_cast<uintptr_t>(MemEnd), PageSize));
-      platform::mprotect(MemPageEnd, NewMemPageEnd - MemPageEnd, PROT_WRITE);
+      if (!isDualMapped()) {
+        platform::mprotect(MemPageEnd, NewMemPageEnd - MemPageEnd,
+                           PROT_WRITE);
+      }
       MemPageEnd = NewMemPageEnd;
     }
     return Ptr;
@@ -246,6 +284,40 @@ public:
   const auto *getMemEnd() const { return MemEnd; }
   const auto *getMemPageEnd() const { return MemPageEnd; }
 
+  // Release the code allocated with `PageSize` alignment once no thread is
+  // running it, the code must be unreachable. Only supported with a
+  // `CodeHeap`, the code is kept until the pool is destroyed otherwise
+  void retire(void *Ptr);
+
+  // Call `Fn(Start, End)` for each memory range holding the code of the pool
+  template <typename F> void forEachCodeRange(F Fn) {
+    LockGuard<Mutex> Lock(Mtx);
+    if (!Heap) {
+      Fn(MemStart, MemPageEnd);
+      return;
+    }
+    for (const auto &[Ptr, Size] : Blocks) {
+      Fn(Ptr, Ptr + Size);
+    }
+  }
+
+  bool isDualMapped() const { return Heap || WriteStart != MemStart; }
+
+  // Returns the address to write the code at `ExecPtr` through
+  template <typename T> T *getWritableAddr(T *ExecPtr) const {
+    auto *Ptr = reinterpret_cast<const uint8_t *>(ExecPtr);
+    ZEN_ASSERT(Ptr >= MemStart && Ptr < MemStart + MaxCodeSize);
+    return reinterpret_cast<T *>(const_cast<uint8_t *>(WriteStart) +
+                                 (Ptr - MemStart));
+  }
+
+  // Make the written code executable, nothing to do when dual mapped
+  void protectExecutable(void *ExecPtr, size_t Size) {
+    if (!isDualMapped()) {
+      platform::mprotect(ExecPtr, Size, PROT_READ | PROT_EXEC);
+    }
+  }
+
   // not too large to avoid mmap failure
 #ifndef ZEN_ENABLE_OCCLUM
   static constexpr const size_t MaxCodeSize = INT32_MAX;
@@ -257,10 +329,25 @@ public:
   static constexpr const size_t DefaultAlign = 16;
 
 private:
+  // Defined in common/code_heap.cpp, called with `Mtx` locked
+  void *allocateFromHeap(size_t Size, size_t Align);
+  void releaseHeapBlocks();
+
   uint8_t *MemStart;
+  uint8_t *WriteStart;
   uint8_t *MemEnd;
   uint8_t *MemPageEnd;
   Mutex Mtx;
+
+  // Only used with a `CodeHeap`
+  CodeHeap *Heap = nullptr;
+  uint32_t RegionIdx = 0;
+  // The block unaligned allocations are bumped in
+  uint8_t *ChunkStart = nullptr;
+  uint8_t *ChunkTop = nullptr;
+  uint8_t *ChunkEnd = nullptr;
+  // Start => size of the blocks taken from the heap
+  std::unordered_map<uint8_t *, size_t> Blocks;
 };
 #else
 template <> class MemPool<CODE_POOL> {
@@ -285,6 +372,19 @@ public:
     return Ptr;
   }
 
+  void retire([[maybe_unused]] void *Ptr) {}
+
+  // SGX forbids the dual mapping, the code is written in place
+  bool isDualMapped() const { return false; }
+
+  template <typename T> T *getWritableAddr(T *ExecPtr) const {
+    return ExecPtr;
+  }
+
+  void protectExecutable(void *ExecPtr, size_t Size) {
+    platform::mprotect(ExecPtr, Size, PROT_READ | PROT_EXEC);
+  }
+
   static constexpr const size_t DefaultAlign = 16;
 
 private:
@@ -5,6 +5,9 @@
 #define ZEN_COMMON_TYPE_H
 
 #include "common/defines.h"
+#include <cmath>
+#include <limits>
+#include <type_traits>
 
 namespace zen::common {
 
@@ -383,6 +386,24 @@ template <> inline double FloatAttr<double>::toIntMin<int64_t, false>() {
   return -1.0;
 }
 
+// Semantics of the trunc_sat instructions: NaN is converted to 0, values out
+// of the range of `ToIntType` are clamped to its min or max value
+template <typename ToIntType, typename FloatType>
+inline ToIntType saturatingFloatToInt(FloatType Value) {
+  using SignedType = std::make_signed_t<ToIntType>;
+  constexpr bool IsSigned = std::is_signed_v<ToIntType>;
+  if (std::isnan(Value)) {
+    return 0;
+  }
+  if (Value <= FloatAttr<FloatType>::template toIntMin<SignedType, IsSigned>()) {
+    return std::numeric_limits<ToIntType>::min();
+  }
+  if (Value >= FloatAttr<FloatType>::template toIntMax<SignedType, IsSigned>()) {
+    return std::numeric_limits<ToIntType>::max();
+  }
+  return static_cast<ToIntType>(Value);
+}
+
 // ============================================================================
 // Type Wrapper
 // ============================================================================
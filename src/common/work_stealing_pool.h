@@ -0,0 +1,230 @@
+// Copyright (C) 2021-2023 the DTVM authors. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef ZEN_COMMON_WORK_STEALING_POOL_H
+#define ZEN_COMMON_WORK_STEALING_POOL_H
+
+#include "common/defines.h"
+#include "common/thread_pool.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace zen::common {
+
+enum class TaskPriority : uint8_t {
+  // Tasks that an executing thread is about to wait for
+  Foreground,
+  // Tasks that only speed up the future execution
+  Background,
+};
+
+// Thread pool whose tasks are plain values passed to one handler, so pushing a
+// task never allocates a std::function. Background tasks pushed by a pool
+// thread go to the back of its own deque, and the owner takes its newest task
+// first while idle threads steal the oldest ones of the others. Background
+// tasks pushed by other threads are kept in a shared FIFO lane. Foreground
+// tasks are kept in another shared lane which is always served first.
+template <typename ThreadContext, typename TaskT> class WorkStealingPool {
+public:
+  using TaskHandler = std::function<void(ThreadContext *, TaskT)>;
+
+  WorkStealingPool(TaskHandler Handler, const ConcurrencyT TC = 0)
+      : Handler(std::move(Handler)),
+        ThreadCount(TC > 0 ? TC
+                           : std::min(std::thread::hardware_concurrency() + 1,
+                                      ConcurrencyT(8))) {
+    Workers = std::make_unique<Worker[]>(ThreadCount);
+    Threads = std::make_unique<std::thread[]>(ThreadCount);
+  }
+
+  ~WorkStealingPool() { interrupt(); }
+
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+  ConcurrencyT getThreadCount() const { return ThreadCount; }
+
+  // Must be called for every thread before `start`
+  void setThreadContext(ConcurrencyT ThreadId, ThreadContext *Ctx) {
+    ZEN_ASSERT(ThreadId < ThreadCount);
+    ZEN_ASSERT(Ctx);
+    Workers[ThreadId].Ctx = Ctx;
+  }
+
+  void start() {
+    ZEN_ASSERT(!Running);
+    Running = true;
+    for (ConcurrencyT I = 0; I < ThreadCount; ++I) {
+      Threads[I] = std::thread([this, I] { runWorker(I); });
+    }
+  }
+
+  void pushTask(TaskT Task, TaskPriority Priority = TaskPriority::Background) {
+    // Count the task first, so it never goes below zero when the task is taken
+    // right after being queued
+    ++NumPendingTasks;
+    if (Priority == TaskPriority::Foreground) {
+      pushSharedTask(ForegroundLane, Task);
+    } else if (CurrentPool == this) {
+      Worker &W = Workers[CurrentThreadId];
+      std::lock_guard<std::mutex> Lock(W.Mutex);
+      W.Tasks.push_back(Task);
+    } else {
+      pushSharedTask(BackgroundLane, Task);
+    }
+    if (NumSleepingThreads > 0) {
+      std::lock_guard<std::mutex> Lock(SleepMutex);
+      TaskAvailableCV.notify_one();
+    }
+  }
+
+  size_t getTasksQueued() const { return NumPendingTasks; }
+
+  // Wait until all the queued tasks are finished
+  void waitForTasks() {
+    std::unique_lock<std::mutex> Lock(SleepMutex);
+    AllTasksDoneCV.wait(Lock, [this] {
+      return (NumPendingTasks == 0 && NumRunningTasks == 0) || !Running;
+    });
+  }
+
+  // Stop all threads after their current tasks, drop the queued tasks
+  void interrupt() {
+    if (!Running) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> Lock(SleepMutex);
+      Running = false;
+    }
+    TaskAvailableCV.notify_all();
+    AllTasksDoneCV.notify_all();
+    for (ConcurrencyT I = 0; I < ThreadCount; ++I) {
+      Threads[I].join();
+    }
+  }
+
+private:
+  struct Worker {
+    ThreadContext *Ctx = nullptr;
+    std::mutex Mutex;
+    std::deque<TaskT> Tasks;
+  };
+
+  struct SharedLane {
+    std::mutex Mutex;
+    std::deque<TaskT> Tasks;
+    std::atomic<size_t> NumTasks = 0;
+  };
+
+  static void pushSharedTask(SharedLane &Lane, TaskT Task) {
+    std::lock_guard<std::mutex> Lock(Lane.Mutex);
+    Lane.Tasks.push_back(Task);
+    ++Lane.NumTasks;
+  }
+
+  static bool popSharedTask(SharedLane &Lane, TaskT &Task) {
+    if (Lane.NumTasks == 0) {
+      return false;
+    }
+    std::lock_guard<std::mutex> Lock(Lane.Mutex);
+    if (Lane.Tasks.empty()) {
+      return false;
+    }
+    Task = Lane.Tasks.front();
+    Lane.Tasks.pop_front();
+    --Lane.NumTasks;
+    return true;
+  }
+
+  bool popOwnTask(ConcurrencyT ThreadId, TaskT &Task) {
+    Worker &W = Workers[ThreadId];
+    std::lock_guard<std::mutex> Lock(W.Mutex);
+    if (W.Tasks.empty()) {
+      return false;
+    }
+    Task = W.Tasks.back();
+    W.Tasks.pop_back();
+    return true;
+  }
+
+  bool stealTask(ConcurrencyT ThreadId, TaskT &Task) {
+    for (ConcurrencyT I = 1; I < ThreadCount; ++I) {
+      Worker &W = Workers[(ThreadId + I) % ThreadCount];
+      std::lock_guard<std::mutex> Lock(W.Mutex);
+      if (!W.Tasks.empty()) {
+        Task = W.Tasks.front();
+        W.Tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool popTask(ConcurrencyT ThreadId, TaskT &Task) {
+    return popSharedTask(ForegroundLane, Task) || popOwnTask(ThreadId, Task) ||
+           popSharedTask(BackgroundLane, Task) || stealTask(ThreadId, Task);
+  }
+
+  void runWorker(ConcurrencyT ThreadId) {
+    ThreadContext *Ctx = Workers[ThreadId].Ctx;
+    if constexpr (!std::is_void_v<ThreadContext>) {
+      ZEN_ASSERT(Ctx);
+    }
+    CurrentPool = this;
+    CurrentThreadId = ThreadId;
+    while (Running) {
+      TaskT Task;
+      if (popTask(ThreadId, Task)) {
+        ++NumRunningTasks;
+        --NumPendingTasks;
+        Handler(Ctx, Task);
+        if (--NumRunningTasks == 0 && NumPendingTasks == 0) {
+          std::lock_guard<std::mutex> Lock(SleepMutex);
+          AllTasksDoneCV.notify_all();
+        }
+        continue;
+      }
+
+      std::unique_lock<std::mutex> Lock(SleepMutex);
+      ++NumSleepingThreads;
+      // Pairs with the check of `NumSleepingThreads` in `pushTask`, one of
+      // both sides sees the update of the other
+      TaskAvailableCV.wait(Lock,
+                           [this] { return NumPendingTasks > 0 || !Running; });
+      --NumSleepingThreads;
+    }
+  }
+
+  TaskHandler Handler;
+  const ConcurrencyT ThreadCount;
+
+  std::unique_ptr<Worker[]> Workers;
+  std::unique_ptr<std::thread[]> Threads;
+
+  SharedLane ForegroundLane;
+  SharedLane BackgroundLane;
+
+  // The pool and the index of the current thread if it's a pool thread
+  static inline thread_local const WorkStealingPool *CurrentPool = nullptr;
+  static inline thread_local ConcurrencyT CurrentThreadId = 0;
+
+  // Tasks in all lanes which are not taken by any thread yet
+  std::atomic<size_t> NumPendingTasks = 0;
+  std::atomic<size_t> NumRunningTasks = 0;
+  std::atomic<uint32_t> NumSleepingThreads = 0;
+  std::atomic<bool> Running = false;
+  std::mutex SleepMutex;
+  std::condition_variable TaskAvailableCV;
+  std::condition_variable AllTasksDoneCV;
+};
+
+} // namespace zen::common
+
+#endif // ZEN_COMMON_WORK_STEALING_POOL_H
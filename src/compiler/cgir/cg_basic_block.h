@@ -74,6 +74,15 @@ public:
 
   MCSymbol *getSymbol() const;
 
+  /// Cold blocks are only executed on the exception paths, they are placed
+  /// after all the hot blocks and emitted into the cold part of the code.
+  bool isCold() const { return IsCold; }
+  void setCold(bool Cold = true) { IsCold = Cold; }
+
+  /// Alignment of the block start in bytes, 1 means no alignment.
+  unsigned getAlignment() const { return Alignment; }
+  void setAlignment(unsigned Align) { Alignment = Align; }
+
   /// Insert MI into the instruction list before I.
   iterator insert(iterator I, CgInstruction *MI) {
     assert((I == end() || I->getParent() == this) &&
@@ -300,6 +309,9 @@ private:
   /// Keep track of the physical registers that are livein of the basicblock.
   LiveInVector LiveIns;
 
+  bool IsCold = false;
+  unsigned Alignment = 1;
+
   /// since getSymbol is a relatively heavy-weight operation, the symbol
   /// is only computed once and is cached.
   mutable MCSymbol *BlockSymbol = nullptr;
@@ -85,6 +85,16 @@ public:
     _cg_basic_blocks.emplace_back(CgBB);
   }
 
+  // Lay out the blocks in the order of `Order`, which must contain every
+  // block of the function, and renumber them accordingly
+  void reorderCgBasicBlocks(llvm::ArrayRef<CgBasicBlock *> Order) {
+    ZEN_ASSERT(Order.size() == _cg_basic_blocks.size());
+    for (BlockNum I = 0; I < Order.size(); ++I) {
+      Order[I]->setNumber(I);
+      _cg_basic_blocks[I] = Order[I];
+    }
+  }
+
   CgBasicBlock *getCgBasicBlock(BlockNum BBIdx) const {
     ZEN_ASSERT(BBIdx < _cg_basic_blocks.size());
     return _cg_basic_blocks[BBIdx];
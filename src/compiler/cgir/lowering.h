@@ -37,6 +37,7 @@ public:
     for (MBasicBlock *MIRBB : _mir_func) {
       ZEN_ASSERT(MIRBB);
 
+      InColdBlock = isExceptionBB(MIRBB);
       if (MIRBB == MEntryBB) {
         setInsertBlock(EntryMBB);
         SELF.lowerFormalArguments();
@@ -85,8 +86,25 @@ protected:
     return CgBB;
   }
 
+  // The blocks handling exceptions are cold, so are the blocks split from them
+  // during lowering
+  bool isExceptionBB(const MBasicBlock *MIRBB) const {
+    if (MIRBB == _mir_func.getExceptionHandlingBB() ||
+        MIRBB == _mir_func.getExceptionReturnBB()) {
+      return true;
+    }
+    for (const auto &[ErrCode, ExceptionSetBB] :
+         _mir_func.getExceptionSetBBs()) {
+      if (MIRBB == ExceptionSetBB) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   void setInsertBlock(CgBasicBlock *CgBB) {
     CurBB = CgBB;
+    CgBB->setCold(InColdBlock);
     MF->appendCgBasicBlock(CgBB);
   }
 
@@ -153,6 +171,11 @@ protected:
       OperandReg = lowerExpr(*Operand);
     }
 
+    // The operand was a tail call, which already leaves the function
+    if (!CurBB->empty() && CurBB->back().isReturn()) {
+      return;
+    }
+
     SELF.lowerReturnStmt(VT, OperandReg);
   }
 
@@ -710,6 +733,7 @@ protected:
 
   CgRegisterInfo &MRI;
   CgBasicBlock *CurBB = nullptr;
+  bool InColdBlock = false;
   CompileUnorderedMap<const MInstruction *, CgRegister> _expr_reg_map;
   CompileUnorderedMap<uint32_t, CgRegister> _var_reg_map;
   // Map from MIR BB to CgIR BB; the key is the index of MIR BB
@@ -51,8 +51,12 @@ protected:
     llvm::MCSymbol *FuncSym = MF->getSymbol();
     Streamer->emitSymbolAttribute(FuncSym, llvm::MCSA_ELF_TypeFunction);
     Streamer->emitLabel(FuncSym);
-    for (CgBasicBlock *BB : *MF) {
-      emitBasicBlock(BB);
+    // The cold blocks are placed after the hot blocks by block placement
+    auto ColdBegin = std::find_if(MF->begin(), MF->end(), [](CgBasicBlock *BB) {
+      return BB->isCold();
+    });
+    for (auto It = MF->begin(); It != ColdBegin; ++It) {
+      emitBasicBlock(*It);
     }
 
 #ifdef ZEN_ENABLE_LINUX_PERF
@@ -66,10 +70,24 @@ protected:
     }
 #endif
 
+    // Cold blocks of all functions go to the subsection after the hot code
+    if (ColdBegin != MF->end()) {
+      llvm::MCSection *TextSection = Streamer->getCurrentSectionOnly();
+      Streamer->switchSection(TextSection,
+                              llvm::MCConstantExpr::create(1, Context));
+      for (auto It = ColdBegin; It != MF->end(); ++It) {
+        emitBasicBlock(*It);
+      }
+      Streamer->switchSection(TextSection);
+    }
+
     emitJumpTableInfo();
   }
 
   void emitBasicBlock(CgBasicBlock *MBB) {
+    if (MBB->getAlignment() > 1) {
+      Streamer->emitCodeAlignment(MBB->getAlignment(), STI, 0);
+    }
     // Refer to the following URL:
     // https://github.com/llvm/llvm-project/blob/release%2F15.x/llvm/lib/CodeGen/AsmPrinter/AsmPrinter.cpp#L3629-L3642
     if (!MBB->pred_empty() && (!isBlockOnlyReachableByFallthrough(MBB))) {
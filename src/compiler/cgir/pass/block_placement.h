@@ -0,0 +1,111 @@
+// Copyright (C) 2021-2023 the DTVM authors. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "compiler/cgir/cg_function.h"
+#include "compiler/common/common_defs.h"
+
+namespace COMPILER {
+
+/// Post-RA block placement. The cold blocks(exception paths and the blocks
+/// only reachable from them) are moved after all the hot blocks, so the hot
+/// blocks are laid out as fall-through chains and MC lowering can emit the
+/// cold blocks after the code of all functions. Loop headers are aligned.
+///
+/// The target provides:
+///   void updateTerminator(CgBasicBlock &MBB, CgBasicBlock *OldFallthrough);
+///   unsigned getLoopAlignment() const;
+template <typename T> class CgBlockPlacement : public NonCopyable {
+public:
+  CgBlockPlacement(CgFunction &MF) : MF(MF) {
+    markColdBlocks();
+    placeColdBlocks();
+    alignLoopHeaders();
+  }
+
+protected:
+  // Returns the block which MBB can fall through to in the final code
+  CgBasicBlock *getFallthroughBlock(const CgBasicBlock &MBB) const {
+    uint32_t NextIdx = MBB.getNumber() + 1;
+    if (NextIdx == MF.size()) {
+      return nullptr;
+    }
+    CgBasicBlock *NextMBB = MF.getCgBasicBlock(NextIdx);
+    // Hot and cold blocks are emitted into different places
+    return NextMBB->isCold() == MBB.isCold() ? NextMBB : nullptr;
+  }
+
+  CgFunction &MF;
+
+private:
+  static bool mayFallThrough(const CgBasicBlock &MBB) {
+    return MBB.empty() || !MBB.back().isBarrier();
+  }
+
+  void markColdBlocks() {
+    CgBasicBlock *EntryMBB = &MF.front();
+    bool Changed = true;
+    while (Changed) {
+      Changed = false;
+      for (CgBasicBlock *MBB : MF) {
+        if (MBB == EntryMBB || MBB->isCold() || MBB->pred_empty()) {
+          continue;
+        }
+        if (llvm::all_of(MBB->predecessors(),
+                         [](const CgBasicBlock *Pred) {
+                           return Pred->isCold();
+                         })) {
+          MBB->setCold();
+          Changed = true;
+        }
+      }
+    }
+  }
+
+  void placeColdBlocks() {
+    CompileMemPool &MemPool = MF.getContext().MemPool;
+    CompileVector<CgBasicBlock *> Order(MemPool);
+    CompileVector<CgBasicBlock *> ColdMBBs(MemPool);
+    // The block each block falls through to in the original layout
+    CompileUnorderedMap<CgBasicBlock *, CgBasicBlock *> Fallthroughs(MemPool);
+    Order.reserve(MF.size());
+    for (CgBasicBlock *MBB : MF) {
+      uint32_t NextIdx = MBB->getNumber() + 1;
+      if (NextIdx < MF.size() && mayFallThrough(*MBB)) {
+        Fallthroughs[MBB] = MF.getCgBasicBlock(NextIdx);
+      }
+      (MBB->isCold() ? ColdMBBs : Order).push_back(MBB);
+    }
+    if (ColdMBBs.empty()) {
+      return;
+    }
+    Order.insert(Order.end(), ColdMBBs.begin(), ColdMBBs.end());
+    MF.reorderCgBasicBlocks(Order);
+
+    for (CgBasicBlock *MBB : MF) {
+      auto It = Fallthroughs.find(MBB);
+      SELF.updateTerminator(*MBB,
+                            It != Fallthroughs.end() ? It->second : nullptr);
+    }
+  }
+
+  void alignLoopHeaders() {
+    CgBasicBlock *EntryMBB = &MF.front();
+    unsigned LoopAlignment = SELF.getLoopAlignment();
+    for (CgBasicBlock *MBB : MF) {
+      if (MBB == EntryMBB || MBB->isCold()) {
+        continue;
+      }
+      // A hot block branched to by a hot block laid out after it heads a
+      // loop
+      for (const CgBasicBlock *Pred : MBB->predecessors()) {
+        if (!Pred->isCold() && Pred->getNumber() >= MBB->getNumber()) {
+          MBB->setAlignment(LoopAlignment);
+          break;
+        }
+      }
+    }
+  }
+};
+
+} // namespace COMPILER
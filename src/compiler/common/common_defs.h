@@ -8,6 +8,7 @@
 #include "common/mem_pool.h"
 #include "common/operators.h"
 #include "common/thread_pool.h"
+#include "common/work_stealing_pool.h"
 #include "common/type.h"
 #include "platform/platform.h"
 #include "runtime/instance.h"
@@ -136,6 +137,16 @@ public:
 #endif
   }
 
+  // Release all allocations at once, the first slab is kept for the next
+  // allocations instead of returning it to the system
+  void reset() {
+    AllocImpl.Reset();
+#ifndef NDEBUG
+    common::LockGuard<common::Mutex> Lock(AllocMutex);
+    AllocSizes.clear();
+#endif
+  }
+
   template <typename T, typename... Arguments>
   T *newObject(Arguments &&...Args) {
     void *Ptr = allocate(sizeof(T), alignof(T));
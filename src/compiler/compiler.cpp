@@ -13,10 +13,12 @@
 #include "compiler/cgir/pass/register_coalescer.h"
 #include "compiler/context.h"
 #include "compiler/frontend/parser.h"
+#include "compiler/function_layout.h"
 #include "compiler/mir/function.h"
 #include "compiler/mir/module.h"
 #include "compiler/mir/pass/dead_basicblock_elim.h"
 #include "compiler/mir/pass/verifier.h"
+#include "compiler/target/x86/x86_cg_block_placement.h"
 #include "compiler/target/x86/x86_cg_peephole.h"
 #include "compiler/target/x86/x86_mc_lowering.h"
 #include "compiler/target/x86/x86lowering.h"
@@ -136,6 +138,13 @@ void JITCompilerBase::compileMIRToCgIR(MModule &MMod, MFunction &MFunc,
                   "##########\n\n";
   MF.dump();
 #endif
+
+  X86CgBlockPlacement BlockPlacement(MF);
+#ifdef ZEN_ENABLE_MULTIPASS_JIT_LOGGING
+  llvm::dbgs() << "\n########## CgIR Dump After Block Placement "
+                  "##########\n\n";
+  MF.dump();
+#endif
   if (MF.EvictAdvisor) {
     MF.EvictAdvisor.reset();
   }
@@ -322,14 +331,15 @@ void JITCompilerBase::emitObjectBuffer(CompileContext *Ctx) {
   if (!CodeOrErr) {
     throw getError(ErrorCode::ObjectFileResolvingFailed);
   }
-  std::memcpy(Ctx->CodePtr, CodeOrErr->data(), Ctx->CodeSize);
+  std::memcpy(Ctx->CodeMPool->getWritableAddr(Ctx->CodePtr), CodeOrErr->data(),
+              Ctx->CodeSize);
 }
 
 void WasmJITCompiler::compileWasmToMC(WasmFrontendContext &Ctx, MModule &Mod,
                                       uint32_t FuncIdx, bool DisableGreedyRA) {
   if (Ctx.Inited) {
     // Release all memory allocated by previous function compilation
-    Ctx.MemPool = CompileMemPool();
+    Ctx.MemPool.reset();
     if (Ctx.Lazy) {
       Ctx.reinitialize();
     }
@@ -354,24 +364,189 @@ void WasmJITCompiler::compileWasmToMC(WasmFrontendContext &Ctx, MModule &Mod,
   Ctx.getMCLowering().runOnCgFunction(CgFunc);
 }
 
+void WasmJITCompiler::compileInterpThunks(bool Lazy) {
+  InterpThunkPtrs.assign(NumInternalFunctions, nullptr);
+  uint32_t NumThunks = 0;
+  for (uint32_t I = 0; I < NumInternalFunctions; ++I) {
+    NumThunks += isInterpOnlyFunction(I);
+  }
+  if (NumThunks == 0) {
+    return;
+  }
+
+  auto &CodeMPool = WasmMod->getJITCodeMemPool();
+  size_t ThunksSize = NumThunks * JITStubBuilder::InterpThunkCodeSize;
+  size_t Align = Lazy ? common::CodeMemPool::PageSize
+                      : common::CodeMemPool::DefaultAlign;
+  uint8_t *ThunkPtr = reinterpret_cast<uint8_t *>(
+      CodeMPool.allocate(TO_MPROTECT_CODE_SIZE(ThunksSize), Align));
+  uint8_t *ThunksPtr = ThunkPtr;
+  uint32_t NumImportFunctions = WasmMod->getNumImportFunctions();
+  for (uint32_t I = 0; I < NumInternalFunctions; ++I) {
+    if (!isInterpOnlyFunction(I)) {
+      continue;
+    }
+    JITStubBuilder::compileInterpThunk(CodeMPool.getWritableAddr(ThunkPtr),
+                                       NumImportFunctions + I);
+    InterpThunkPtrs[I] = ThunkPtr;
+    ThunkPtr += JITStubBuilder::InterpThunkCodeSize;
+  }
+  // The eager code is protected as a whole once finished
+  if (Lazy) {
+    CodeMPool.protectExecutable(ThunksPtr, TO_MPROTECT_CODE_SIZE(ThunksSize));
+  }
+}
+
+EagerJITCompiler::EagerJITCompiler(Module *WasmMod)
+    : WasmJITCompiler(WasmMod) {}
+
+EagerJITCompiler::~EagerJITCompiler() {
+  // Must stop the threads before destroying their contexts, `finishCompile`
+  // may have been skipped when loading failed
+  if (ThreadPool) {
+    ThreadPool->setNoNewTask();
+    ThreadPool.reset();
+  }
+  AuxContexts.clear();
+  if (MainContext) {
+    MainContext->ThreadMemPool.deleteObject(Mod);
+    delete MainContext;
+  }
+}
+
 void EagerJITCompiler::compile() {
-  auto Timer = Stats.startRecord(zen::utils::StatisticPhase::JITCompilation);
+  beginCompile();
+
+  if (!Config.DisableMultipassFunctionLayout) {
+    // Functions of a cluster are compiled into the same context one after
+    // another, so callers and their callees are laid out close together
+    std::vector<FunctionCluster> Clusters = buildFunctionClusters(*WasmMod);
+    if (ThreadPool) {
+      // Compile larger clusters first like the functions below
+      std::stable_sort(Clusters.begin(), Clusters.end(),
+                       [](const auto &LHS, const auto &RHS) {
+                         return LHS.CodeSize > RHS.CodeSize;
+                       });
+    }
+    for (FunctionCluster &Cluster : Clusters) {
+      dispatchCompileTask(std::move(Cluster.FuncIdxs));
+    }
+  } else if (!ThreadPool) {
+    for (uint32_t I = 0; I < NumInternalFunctions; ++I) {
+      dispatchCompileTask(I);
+    }
+  } else {
+    // Sort functions by code size in descending order in order to compile
+    // larger functions first
+    const uint32_t NumImportFunctions = WasmMod->getNumImportFunctions();
+    auto &MainMemPool = MainContext->ThreadMemPool;
+    CompileVector<std::pair<uint32_t, uint32_t>> FuncIdxAndSizes(MainMemPool);
+    FuncIdxAndSizes.reserve(NumInternalFunctions);
+    for (uint32_t I = 0; I < NumInternalFunctions; ++I) {
+      CodeEntry *CE = WasmMod->getCodeEntry(NumImportFunctions + I);
+      ZEN_ASSERT(CE);
+      FuncIdxAndSizes.emplace_back(I, CE->CodeSize);
+    }
+    std::sort(FuncIdxAndSizes.begin(), FuncIdxAndSizes.end(),
+              [](const auto &LHS, const auto &RHS) {
+                return LHS.second > RHS.second;
+              });
+
+    for (const auto &[FuncIdx, FuncSize] : FuncIdxAndSizes) {
+      dispatchCompileTask(FuncIdx);
+    }
+  }
+
+  finishCompile();
+}
+
+void EagerJITCompiler::beginCompile() {
+  ZEN_ASSERT(!MainContext);
+  ZEN_ASSERT(NumInternalFunctions > 0);
+  CompileTimer = Stats.startRecord(zen::utils::StatisticPhase::JITCompilation);
+
+  MainContext = new WasmFrontendContext(*WasmMod);
+  Mod = MainContext->ThreadMemPool.newObject<MModule>(*MainContext);
+  buildAllMIRFuncTypes(*MainContext, *Mod, *WasmMod);
+  MainContext->CodeMPool = &WasmMod->getJITCodeMemPool();
 
-  WasmFrontendContext MainContext(*WasmMod);
-  auto &MainMemPool = MainContext.ThreadMemPool;
+  if (Config.DisableMultipassMultithread) {
+    return;
+  }
+
+  ThreadPool = std::make_unique<common::ThreadPool<WasmFrontendContext>>(
+      std::min(Config.NumMultipassThreads, NumInternalFunctions));
+  uint32_t NumThreads = ThreadPool->getThreadCount();
+  ZEN_LOG_DEBUG("using %u threads for multipass JIT compilation", NumThreads);
+
+  // Some threads may not have compiled functions, so when all compilation
+  // tasks are completed, in the context of these threads:
+  // - Inited == false
+  // - CodePtr == nullptr
+  // - CodeSize == 0
+  // - CodeOffset == 0
+  // - FuncOffsetMap.empty() == true
+  // - ExternRelocs.empty() == true
+  AuxContexts = std::vector<WasmFrontendContext>(NumThreads - 1, *MainContext);
+  ThreadPool->setThreadContext(0, MainContext, emitObjectBuffer);
+  for (uint32_t I = 0; I < NumThreads - 1; ++I) {
+    ThreadPool->setThreadContext(I + 1, &AuxContexts[I], emitObjectBuffer);
+  }
+}
+
+void EagerJITCompiler::dispatchCompileTask(uint32_t FuncIdx) {
+  ZEN_ASSERT(MainContext);
+  if (isInterpOnlyFunction(FuncIdx)) {
+    return;
+  }
+  if (!ThreadPool) {
+    compileWasmToMC(*MainContext, *Mod, FuncIdx,
+                    Config.DisableMultipassGreedyRA);
+    return;
+  }
+  ThreadPool->pushTask([this, FuncIdx](WasmFrontendContext *Ctx) {
+    compileWasmToMC(*Ctx, *Mod, FuncIdx, Config.DisableMultipassGreedyRA);
+  });
+}
 
-  MModule Mod(MainContext);
-  buildAllMIRFuncTypes(MainContext, Mod, *WasmMod);
-  MainContext.CodeMPool = &WasmMod->getJITCodeMemPool();
+void EagerJITCompiler::dispatchCompileTask(std::vector<uint32_t> FuncIdxs) {
+  ZEN_ASSERT(MainContext);
+  FuncIdxs.erase(std::remove_if(FuncIdxs.begin(), FuncIdxs.end(),
+                                [this](uint32_t FuncIdx) {
+                                  return isInterpOnlyFunction(FuncIdx);
+                                }),
+                 FuncIdxs.end());
+  if (FuncIdxs.empty()) {
+    return;
+  }
+  if (!ThreadPool) {
+    for (uint32_t FuncIdx : FuncIdxs) {
+      compileWasmToMC(*MainContext, *Mod, FuncIdx,
+                      Config.DisableMultipassGreedyRA);
+    }
+    return;
+  }
+  ThreadPool->pushTask(
+      [this, FuncIdxs = std::move(FuncIdxs)](WasmFrontendContext *Ctx) {
+        for (uint32_t FuncIdx : FuncIdxs) {
+          compileWasmToMC(*Ctx, *Mod, FuncIdx, Config.DisableMultipassGreedyRA);
+        }
+      });
+}
 
+void EagerJITCompiler::finishCompile() {
+  ZEN_ASSERT(MainContext);
   const uint32_t NumImportFunctions = WasmMod->getNumImportFunctions();
-  ZEN_ASSERT(NumInternalFunctions > 0);
 
 #ifdef ZEN_ENABLE_LINUX_PERF
-  utils::JitDumpWriter JitDumpWriter;
+  auto &PerfRegistry = utils::PerfSymbolRegistry::getInstance();
 #define JIT_DUMP_WRITE_FUNC(FuncIdx, FuncAddr, FuncSize)                       \
-  JitDumpWriter.writeFunc(WasmMod->getWasmFuncDebugName(FuncIdx),              \
-                          reinterpret_cast<uint64_t>(FuncAddr), FuncSize)
+  do {                                                                         \
+    if (PerfRegistry.isEnabled()) {                                            \
+      PerfRegistry.registerCode(WasmMod->getWasmFuncDebugName(FuncIdx),        \
+                                FuncAddr, FuncSize);                           \
+    }                                                                          \
+  } while (0)
 #else
 #define JIT_DUMP_WRITE_FUNC(...)
 #endif
@@ -391,71 +566,54 @@ void EagerJITCompiler::compile() {
 
   auto &CodeMPool = WasmMod->getJITCodeMemPool();
   uint8_t *JITCode = const_cast<uint8_t *>(CodeMPool.getMemStart());
-  if (Config.DisableMultipassMultithread) {
-    for (uint32_t I = 0; I < NumInternalFunctions; ++I) {
-      compileWasmToMC(MainContext, Mod, I, Config.DisableMultipassGreedyRA);
+  uint8_t *WritableJITCode = CodeMPool.getWritableAddr(JITCode);
+  // Patch a call to a function of another context or left to the interpreter
+  auto PatchRelocation = [&](WasmFrontendContext *Ctx, const auto &Reloc,
+                             uint64_t FuncSymValue) {
+    uint64_t RelOffset = Ctx->CodeOffset + Reloc.Offset;
+    uint64_t RelValue = FuncSymValue + Reloc.Addend - RelOffset;
+    WritableJITCode[RelOffset] = RelValue & 0xff;
+    WritableJITCode[RelOffset + 1] = (RelValue >> 8) & 0xff;
+    WritableJITCode[RelOffset + 2] = (RelValue >> 16) & 0xff;
+    WritableJITCode[RelOffset + 3] = (RelValue >> 24) & 0xff;
+  };
+  auto PatchInterpThunkRelocation = [&](WasmFrontendContext *Ctx,
+                                        const auto &Reloc) {
+    uint8_t *ThunkPtr = InterpThunkPtrs[Reloc.CalleeFuncIdx];
+    if (!ThunkPtr) {
+      throw getError(ErrorCode::ObjectFileResolvingFailed);
     }
-    emitObjectBuffer(&MainContext);
-    ZEN_ASSERT(MainContext.ExternRelocs.empty());
-    for (const auto &[FuncIdx, FuncOffset] : MainContext.FuncOffsetMap) {
+    PatchRelocation(Ctx, Reloc, ThunkPtr - JITCode);
+  };
+
+  if (!ThreadPool) {
+    emitObjectBuffer(MainContext);
+    compileInterpThunks(false);
+    // Only the functions left to the interpreter are external
+    for (const auto &Reloc : MainContext->ExternRelocs) {
+      PatchInterpThunkRelocation(MainContext, Reloc);
+    }
+    for (const auto &[FuncIdx, FuncOffset] : MainContext->FuncOffsetMap) {
       uint32_t RealFuncIdx = NumImportFunctions + FuncIdx;
       CodeEntry *CE = WasmMod->getCodeEntry(RealFuncIdx);
       ZEN_ASSERT(CE);
-      CE->JITCodePtr = MainContext.CodePtr + FuncOffset;
+      CE->JITCodePtr = MainContext->CodePtr + FuncOffset;
       JIT_DUMP_WRITE_FUNC(RealFuncIdx, CE->JITCodePtr,
-                          MainContext.FuncSizeMap[FuncIdx]);
+                          MainContext->FuncSizeMap[FuncIdx]);
       INSERT_JITED_FUNC_PTR((void *)(CE->JITCodePtr), RealFuncIdx);
     }
   } else {
-    common::ThreadPool<WasmFrontendContext> ThreadPool(
-        std::min(Config.NumMultipassThreads, NumInternalFunctions));
-    uint32_t NumThreads = ThreadPool.getThreadCount();
-    ZEN_LOG_DEBUG("using %u threads for multipass JIT compilation", NumThreads);
-
-    CompileVector<WasmFrontendContext> AuxContexts(NumThreads - 1, MainContext,
-                                                   MainMemPool);
-    // Some threads may not have compiled functions, so when all compilation
-    // tasks are completed, in the context of these threads:
-    // - Inited == false
-    // - CodePtr == nullptr
-    // - CodeSize == 0
-    // - CodeOffset == 0
-    // - FuncOffsetMap.empty() == true
-    // - ExternRelocs.empty() == true
-    CompileVector<WasmFrontendContext *> Contexts(MainMemPool);
-
-    ThreadPool.setThreadContext(0, &MainContext, emitObjectBuffer);
-    Contexts.push_back(&MainContext);
-    for (uint32_t I = 0; I < NumThreads - 1; ++I) {
-      ThreadPool.setThreadContext(I + 1, &AuxContexts[I], emitObjectBuffer);
-      Contexts.push_back(&AuxContexts[I]);
-    }
-
-    // Sort functions by code size in descending order in order to compile
-    // larger functions first
-    CompileVector<std::pair<uint32_t, uint32_t>> FuncIdxAndSizes(MainMemPool);
-    FuncIdxAndSizes.reserve(NumInternalFunctions);
-    for (uint32_t I = 0; I < NumInternalFunctions; ++I) {
-      CodeEntry *CE = WasmMod->getCodeEntry(NumImportFunctions + I);
-      ZEN_ASSERT(CE);
-      FuncIdxAndSizes.emplace_back(I, CE->CodeSize);
-    }
-    std::sort(FuncIdxAndSizes.begin(), FuncIdxAndSizes.end(),
-              [](const auto &LHS, const auto &RHS) {
-                return LHS.second > RHS.second;
-              });
+    ThreadPool->setNoNewTask();
+    ThreadPool->waitForTasks();
+    compileInterpThunks(false);
 
-    for (const auto &[FuncIdx, FuncSize] : FuncIdxAndSizes) {
-      ThreadPool.pushTask([&, FuncIdx = FuncIdx](WasmFrontendContext *Ctx) {
-        compileWasmToMC(*Ctx, Mod, FuncIdx, Config.DisableMultipassGreedyRA);
-      });
+    auto &MainMemPool = MainContext->ThreadMemPool;
+    CompileVector<WasmFrontendContext *> Contexts(MainMemPool);
+    Contexts.push_back(MainContext);
+    for (WasmFrontendContext &Ctx : AuxContexts) {
+      Contexts.push_back(&Ctx);
     }
 
-    ThreadPool.setNoNewTask();
-    // Must call the `waitForTasks` method explicitly, because `Contexts` will
-    // be destructed before `ThreadPool`
-    ThreadPool.waitForTasks();
-
     CompileUnorderedMap<uint32_t, WasmFrontendContext *> FuncIdxToCtxIdMap(
         MainMemPool);
     FuncIdxToCtxIdMap.reserve(NumInternalFunctions);
@@ -475,29 +633,33 @@ void EagerJITCompiler::compile() {
       for (const auto &Reloc : Ctx->ExternRelocs) {
         auto It = FuncIdxToCtxIdMap.find(Reloc.CalleeFuncIdx);
         if (It == FuncIdxToCtxIdMap.end()) {
-          throw getError(ErrorCode::ObjectFileResolvingFailed);
+          PatchInterpThunkRelocation(Ctx, Reloc);
+          continue;
         }
         WasmFrontendContext *CalleeCtx = It->second;
-        uint64_t RelOffset = Ctx->CodeOffset + Reloc.Offset;
-        uint64_t FuncSymValue = CalleeCtx->CodeOffset +
-                                CalleeCtx->FuncOffsetMap[Reloc.CalleeFuncIdx];
-        uint64_t RelValue = FuncSymValue + Reloc.Addend - RelOffset;
-        JITCode[RelOffset] = RelValue & 0xff;
-        JITCode[RelOffset + 1] = (RelValue >> 8) & 0xff;
-        JITCode[RelOffset + 2] = (RelValue >> 16) & 0xff;
-        JITCode[RelOffset + 3] = (RelValue >> 24) & 0xff;
+        PatchRelocation(Ctx, Reloc,
+                        CalleeCtx->CodeOffset +
+                            CalleeCtx->FuncOffsetMap[Reloc.CalleeFuncIdx]);
       }
     }
   }
+  for (uint32_t I = 0; I < NumInternalFunctions; ++I) {
+    if (uint8_t *ThunkPtr = InterpThunkPtrs[I]) {
+      uint32_t RealFuncIdx = NumImportFunctions + I;
+      CodeEntry *CE = WasmMod->getCodeEntry(RealFuncIdx);
+      ZEN_ASSERT(CE);
+      CE->JITCodePtr = ThunkPtr;
+      INSERT_JITED_FUNC_PTR((void *)(CE->JITCodePtr), RealFuncIdx);
+    }
+  }
   size_t CodeSize = CodeMPool.getMemEnd() - JITCode;
 
-  platform::mprotect(JITCode, TO_MPROTECT_CODE_SIZE(CodeSize),
-                     PROT_READ | PROT_EXEC);
+  CodeMPool.protectExecutable(JITCode, TO_MPROTECT_CODE_SIZE(CodeSize));
   WasmMod->setJITCodeAndSize(JITCode, CodeSize);
 
   SORT_JITED_FUNC_PTRS;
 
-  Stats.stopRecord(Timer);
+  Stats.stopRecord(CompileTimer);
 }
 
 LazyJITCompiler::LazyJITCompiler(Module *WasmMod)
@@ -506,11 +668,29 @@ LazyJITCompiler::LazyJITCompiler(Module *WasmMod)
   MainContext->Lazy = true;
   MainContext->CodeMPool = &WasmMod->getJITCodeMemPool();
   Mod = MainContext->ThreadMemPool.newObject<MModule>(*MainContext);
+  PendingCallSites.resize(NumInternalFunctions);
+  InstalledCodePtrs.resize(NumInternalFunctions, nullptr);
+  FastRACodePtrs.resize(NumInternalFunctions, nullptr);
 
   const runtime::RuntimeConfig &Config = WasmMod->getRuntime()->getConfig();
 
+  if (!Config.MultipassProfileDir.empty()) {
+    uint64_t ModuleHash = LazyCompileProfile::hashModule(
+        WasmMod->getWASMBytecode(), WasmMod->getWASMBytecodeSize());
+    Profile =
+        std::make_unique<LazyCompileProfile>(ModuleHash, NumInternalFunctions);
+    if (Profile->load(Config.MultipassProfileDir)) {
+      ZEN_LOG_DEBUG("loaded lazy compile profile %s",
+                    Profile->getFilePath(Config.MultipassProfileDir).c_str());
+    }
+  }
+
   if (!Config.DisableMultipassMultithread) {
-    ThreadPool = std::make_unique<common::ThreadPool<WasmFrontendContext>>(
+    ThreadPool = std::make_unique<
+        common::WorkStealingPool<WasmFrontendContext, uint32_t>>(
+        [this](WasmFrontendContext *Ctx, uint32_t Task) {
+          runCompileTask(*Ctx, Task);
+        },
         std::min(Config.NumMultipassThreads, NumInternalFunctions));
     uint32_t NumThreads = ThreadPool->getThreadCount();
     ZEN_LOG_DEBUG("using %u threads for multipass JIT background compilation",
@@ -528,6 +708,7 @@ LazyJITCompiler::LazyJITCompiler(Module *WasmMod)
       CompileStatuses[I] = CompileStatus::None;
       GreedyRACodePtrs[I] = nullptr;
     }
+    ThreadPool->start();
   }
 }
 
@@ -535,22 +716,44 @@ LazyJITCompiler::~LazyJITCompiler() {
   if (ThreadPool) {
     ThreadPool->interrupt();
   }
+  if (Profile && !Profile->save(Config.MultipassProfileDir)) {
+    ZEN_LOG_WARN("failed to save lazy compile profile %s",
+                 Profile->getFilePath(Config.MultipassProfileDir).c_str());
+  }
   MainContext->ThreadMemPool.deleteObject(Mod);
   delete MainContext;
 }
 
-void LazyJITCompiler::dispatchCompileTask(uint32_t FuncIdx) {
-  if (CompileStatuses[FuncIdx] != CompileStatus::None) {
-    return;
+void LazyJITCompiler::dispatchCompileTask(uint32_t FuncIdx,
+                                          common::TaskPriority Priority) {
+  CompileStatus Status = CompileStatus::None;
+  if (!CompileStatuses[FuncIdx].compare_exchange_strong(
+          Status, CompileStatus::Pending)) {
+    // A pending background task is queued again in the foreground lane, the
+    // later one of both tasks finds the function taken and does nothing
+    if (Status != CompileStatus::Pending ||
+        Priority != common::TaskPriority::Foreground) {
+      return;
+    }
   }
-  CompileStatuses[FuncIdx] = CompileStatus::Pending;
-  ThreadPool->pushTask([&, FuncIdx](WasmFrontendContext *Ctx) {
-    compileFunctionInBackgroud(*Ctx, FuncIdx);
-  });
+  ThreadPool->pushTask(FuncIdx, Priority);
   ZEN_LOG_DEBUG("push function %d compile task into thread pool", FuncIdx);
 }
 
-void LazyJITCompiler::dispatchCompileTasksDepthFirst(WasmFrontendContext &Ctx) {
+void LazyJITCompiler::runCompileTask(WasmFrontendContext &Ctx, uint32_t Task) {
+  if (Task == DispatchEntryTasks) {
+    dispatchEntryCompileTasks(Ctx);
+    return;
+  }
+  CompileStatus Status = CompileStatus::Pending;
+  if (CompileStatuses[Task].compare_exchange_strong(
+          Status, CompileStatus::InProgress)) {
+    compileFunctionInBackgroud(Ctx, Task);
+  }
+}
+
+void LazyJITCompiler::dispatchCompileTasksDepthFirst(
+    WasmFrontendContext &Ctx, CompileVector<uint32_t> &Order) {
   uint32_t NumImportFunctions = WasmMod->getNumImportFunctions();
   const auto &ExportedFuncIdxs = WasmMod->getExportedFuncIdxs();
   const auto &CallSeqMap = WasmMod->getCallSeqMap();
@@ -579,7 +782,7 @@ void LazyJITCompiler::dispatchCompileTasksDepthFirst(WasmFrontendContext &Ctx) {
   while (!Stack.empty()) {
     uint32_t FuncIdx = Stack.back();
     Stack.pop_back();
-    dispatchCompileTask(FuncIdx);
+    Order.push_back(FuncIdx);
     Visited[FuncIdx] = true;
     const auto &CallSeq = CallSeqMap.at(FuncIdx + NumImportFunctions);
     for (auto It = CallSeq.rbegin(); It != CallSeq.rend(); ++It) {
@@ -593,18 +796,45 @@ void LazyJITCompiler::dispatchCompileTasksDepthFirst(WasmFrontendContext &Ctx) {
   }
 }
 
-void LazyJITCompiler::dispatchCompileTasksInOrder(WasmFrontendContext &Ctx) {
+void LazyJITCompiler::dispatchCompileTasksInOrder(
+    WasmFrontendContext &Ctx, CompileVector<uint32_t> &Order) {
   for (uint32_t I = 0; I < NumInternalFunctions; ++I) {
-    dispatchCompileTask(I);
+    Order.push_back(I);
   }
 }
 
 void LazyJITCompiler::dispatchEntryCompileTasks(WasmFrontendContext &Ctx) {
+  CompileVector<uint32_t> Order(Ctx.MemPool);
+
+  // Functions called in previous executions go first, in the order of their
+  // first calls
+  if (Profile) {
+    for (uint32_t FuncIdx : Profile->getPreviousOrder()) {
+      Order.push_back(FuncIdx);
+    }
+  }
+
   // First strategy: dispatch compile tasks in depth-first order
-  dispatchCompileTasksDepthFirst(Ctx);
+  dispatchCompileTasksDepthFirst(Ctx, Order);
 
   // Second strategy: dispatch compile tasks in order of function index
-  // dispatchCompileTasksInOrder(Ctx);
+  // dispatchCompileTasksInOrder(Ctx, Order);
+
+  // Only the first occurrence of each function counts
+  CompileVector<bool> Seen(NumInternalFunctions, false, Ctx.MemPool);
+  CompileVector<uint32_t> UniqueOrder(Ctx.MemPool);
+  for (uint32_t FuncIdx : Order) {
+    if (!Seen[FuncIdx]) {
+      Seen[FuncIdx] = true;
+      UniqueOrder.push_back(FuncIdx);
+    }
+  }
+
+  // The tasks go to the deque of the current thread, which takes its newest
+  // task first, so push the most urgent one last
+  for (auto It = UniqueOrder.rbegin(); It != UniqueOrder.rend(); ++It) {
+    dispatchCompileTask(*It);
+  }
 }
 
 void LazyJITCompiler::precompile() {
@@ -616,9 +846,19 @@ void LazyJITCompiler::precompile() {
   for (uint32_t I = 0; I < NumInternalFunctions; ++I) {
     StubBuilder.compileFunctionToStub(I);
   }
+  // The functions left to the interpreter are never compiled, their stubs go
+  // to their thunks right away
+  compileInterpThunks(true);
+  for (uint32_t I = 0; I < NumInternalFunctions; ++I) {
+    if (InterpThunkPtrs[I]) {
+      installFunctionCode(I, InterpThunkPtrs[I]);
+      if (ThreadPool) {
+        CompileStatuses[I] = CompileStatus::Done;
+      }
+    }
+  }
   if (ThreadPool) {
-    ThreadPool->pushTask(
-        [this](WasmFrontendContext *Ctx) { dispatchEntryCompileTasks(*Ctx); });
+    ThreadPool->pushTask(DispatchEntryTasks);
   }
   uint32_t NumImportFunctions = WasmMod->getNumImportFunctions();
   for (uint32_t I = 0; I < NumInternalFunctions; ++I) {
@@ -626,10 +866,20 @@ void LazyJITCompiler::precompile() {
     CodeEntry *CE = WasmMod->getCodeEntry(RealFuncIdx);
     ZEN_ASSERT(CE);
     CE->JITCodePtr = StubBuilder.getFuncStubCodePtr(I);
-    // JIT_DUMP_WRITE_FUNC(RealFuncIdx, CE->JITCodePtr,
-    //                     MainContext.FuncSizeMap[FuncIdx]);
-    // INSERT_JITED_FUNC_PTR((void *)(CE->JITCodePtr), RealFuncIdx);
   }
+#ifdef ZEN_ENABLE_LINUX_PERF
+  auto &PerfRegistry = utils::PerfSymbolRegistry::getInstance();
+  if (PerfRegistry.isEnabled()) {
+    PerfRegistry.registerCode("dtvm_stub_resolver",
+                              StubBuilder.getStubResolverPtr(),
+                              StubBuilder.getStubResolverCodeSize());
+    for (uint32_t I = 0; I < NumInternalFunctions; ++I) {
+      PerfRegistry.registerCode(
+          WasmMod->getWasmFuncDebugName(NumImportFunctions + I) + "@stub",
+          StubBuilder.getFuncStubCodePtr(I), JITStubBuilder::EachStubCodeSize);
+    }
+  }
+#endif
   Stats.stopRecord(Timer);
 }
 
@@ -639,61 +889,213 @@ uint8_t *LazyJITCompiler::compileFunction(WasmFrontendContext &Ctx,
   compileWasmToMC(Ctx, *Mod, FuncIdx, DisableGreedyRA);
   emitObjectBuffer(&Ctx);
   uint8_t *JITCode = const_cast<uint8_t *>(Ctx.CodeMPool->getMemStart());
-  for (const auto &Reloc : Ctx.ExternRelocs) {
-    uint64_t RelOffset = Ctx.CodeOffset + Reloc.Offset;
-    uint64_t FuncSymValue =
-        StubBuilder.getFuncStubCodePtr(Reloc.CalleeFuncIdx) - JITCode;
-    uint64_t RelValue = FuncSymValue + Reloc.Addend - RelOffset;
-    JITCode[RelOffset] = RelValue & 0xff;
-    JITCode[RelOffset + 1] = (RelValue >> 8) & 0xff;
-    JITCode[RelOffset + 2] = (RelValue >> 16) & 0xff;
-    JITCode[RelOffset + 3] = (RelValue >> 24) & 0xff;
+  uint8_t *WritableJITCode = Ctx.CodeMPool->getWritableAddr(JITCode);
+  uint8_t *JITFuncCodePtr = Ctx.CodePtr;
+  {
+    // Call directly the callees installed already, and record the calls to
+    // the stubs of the others
+    std::lock_guard<std::mutex> Lock(CallSiteMutex);
+    for (const auto &Reloc : Ctx.ExternRelocs) {
+      uint64_t RelOffset = Ctx.CodeOffset + Reloc.Offset;
+      uint8_t *TargetPtr = InstalledCodePtrs[Reloc.CalleeFuncIdx];
+      if (!TargetPtr) {
+        TargetPtr = StubBuilder.getFuncStubCodePtr(Reloc.CalleeFuncIdx);
+        PendingCallSites[Reloc.CalleeFuncIdx].push_back(
+            {JITCode + RelOffset, Reloc.Addend, JITFuncCodePtr});
+      }
+      uint64_t FuncSymValue = TargetPtr - JITCode;
+      uint64_t RelValue = FuncSymValue + Reloc.Addend - RelOffset;
+      WritableJITCode[RelOffset] = RelValue & 0xff;
+      WritableJITCode[RelOffset + 1] = (RelValue >> 8) & 0xff;
+      WritableJITCode[RelOffset + 2] = (RelValue >> 16) & 0xff;
+      WritableJITCode[RelOffset + 3] = (RelValue >> 24) & 0xff;
+    }
+    // The recorded calls may be patched right after unlocking, which changes
+    // the protection as well without the dual mapping
+    Ctx.CodeMPool->protectExecutable(JITFuncCodePtr,
+                                     TO_MPROTECT_CODE_SIZE(Ctx.CodeSize));
   }
   Ctx.ExternRelocs.clear();
   Ctx.FuncOffsetMap.clear();
-  uint8_t *JITFuncCodePtr = Ctx.CodePtr;
-  platform::mprotect(JITFuncCodePtr, TO_MPROTECT_CODE_SIZE(Ctx.CodeSize),
-                     PROT_READ | PROT_EXEC);
+#ifdef ZEN_ENABLE_LINUX_PERF
+  auto &PerfRegistry = utils::PerfSymbolRegistry::getInstance();
+  if (PerfRegistry.isEnabled()) {
+    // Foreground compilation uses fastRA and may be replaced by the background
+    // greedyRA version later, so tag the tier in the symbol name
+    uint32_t RealFuncIdx = FuncIdx + WasmMod->getNumImportFunctions();
+    std::string FuncName = WasmMod->getWasmFuncDebugName(RealFuncIdx);
+    if (DisableGreedyRA && !Config.DisableMultipassGreedyRA) {
+      FuncName += "@fastra";
+    }
+    PerfRegistry.registerCode(FuncName, JITFuncCodePtr,
+                              Ctx.FuncSizeMap[FuncIdx]);
+  }
+#endif
+  Ctx.FuncSizeMap.clear();
   return JITFuncCodePtr;
 }
 
+void LazyJITCompiler::installFunctionCode(uint32_t FuncIdx,
+                                          uint8_t *JITFuncCodePtr) {
+  std::lock_guard<std::mutex> Lock(CallSiteMutex);
+  if (InstalledCodePtrs[FuncIdx]) {
+    return;
+  }
+  StubBuilder.updateStubJmpTargetPtr(StubBuilder.getFuncStubCodePtr(FuncIdx),
+                                     JITFuncCodePtr);
+  InstalledCodePtrs[FuncIdx] = JITFuncCodePtr;
+
+  auto &CodeMPool = WasmMod->getJITCodeMemPool();
+  // The fastRA code is unreachable through the stub now, and never called
+  // directly
+  if (FastRACodePtrs[FuncIdx]) {
+    retireFastRACode(FuncIdx, FastRACodePtrs[FuncIdx]);
+    FastRACodePtrs[FuncIdx] = nullptr;
+  }
+  constexpr uintptr_t CacheLineSize = 64;
+  std::vector<CallSite> CallSites;
+  CallSites.swap(PendingCallSites[FuncIdx]);
+  for (const CallSite &Site : CallSites) {
+    // Only a store within one cache line is atomic to the concurrent
+    // instruction fetch, the other calls keep going through the stub
+    uintptr_t LineOffset = reinterpret_cast<uintptr_t>(Site.RelPtr) &
+                           (CacheLineSize - 1);
+    if (LineOffset + sizeof(int32_t) > CacheLineSize) {
+      continue;
+    }
+    int64_t RelValue = JITFuncCodePtr - Site.RelPtr + Site.Addend;
+    ZEN_ASSERT(RelValue >= INT32_MIN && RelValue <= INT32_MAX);
+    uint8_t *WritableRelPtr = CodeMPool.getWritableAddr(Site.RelPtr);
+    if (CodeMPool.isDualMapped()) {
+      JITStubBuilder::updateCallRelTarget(WritableRelPtr,
+                                          static_cast<int32_t>(RelValue));
+      continue;
+    }
+
+    // The code of each function starts at a page boundary and the 4 bytes
+    // don't cross a page, so only the page of this call changes protection
+    uint8_t *PagePtr = reinterpret_cast<uint8_t *>(
+        reinterpret_cast<uintptr_t>(Site.RelPtr) & ~(MPROTECT_CHUNK_SIZE - 1));
+    platform::mprotect(PagePtr, MPROTECT_CHUNK_SIZE,
+                       PROT_READ | PROT_WRITE | PROT_EXEC);
+    JITStubBuilder::updateCallRelTarget(WritableRelPtr,
+                                        static_cast<int32_t>(RelValue));
+    platform::mprotect(PagePtr, MPROTECT_CHUNK_SIZE, PROT_READ | PROT_EXEC);
+  }
+}
+
 void LazyJITCompiler::compileFunctionInBackgroud(WasmFrontendContext &Ctx,
                                                  uint32_t FuncIdx) {
   ZEN_LOG_DEBUG("compile function %d in background", FuncIdx);
-  CompileStatuses[FuncIdx] = CompileStatus::InProgress;
+  ZEN_ASSERT(CompileStatuses[FuncIdx] == CompileStatus::InProgress);
   auto Timer = Stats.startRecord(utils::StatisticPhase::JITLazyBgCompilation);
-  uint8_t *JITFuncCodePtr =
-      compileFunction(Ctx, FuncIdx, Config.DisableMultipassGreedyRA);
-  uint8_t *FuncStubCodePtr = StubBuilder.getFuncStubCodePtr(FuncIdx);
+  // Functions never called in previous executions are unlikely to be hot
+  bool DisableGreedyRA =
+      Config.DisableMultipassGreedyRA || isColdFunction(FuncIdx);
+  uint8_t *JITFuncCodePtr = compileFunction(Ctx, FuncIdx, DisableGreedyRA);
+  if (BackgroundCompileHook) {
+    BackgroundCompileHook(FuncIdx);
+  }
   GreedyRACodePtrs[FuncIdx] = JITFuncCodePtr;
   CompileStatuses[FuncIdx] = CompileStatus::Done;
-  JITStubBuilder::updateStubJmpTargetPtr(FuncStubCodePtr, JITFuncCodePtr);
+  // When profiling, the stub is kept until the first call, which records the
+  // function and then patches the stub. A call recorded before the status is
+  // done may have missed the code, so it's installed here. The status and the
+  // call record are both sequentially consistent, so at least one side sees
+  // the other.
+  if (!Profile || Profile->isCalled(FuncIdx)) {
+    installFunctionCode(FuncIdx, JITFuncCodePtr);
+  }
   Stats.stopRecord(Timer);
 }
 
 uint8_t *LazyJITCompiler::compileFunctionOnRequest(uint8_t *FuncStubCodePtr) {
   uint32_t FuncIdx = StubBuilder.getFuncIdxByStubCodePtr(FuncStubCodePtr);
+  if (Profile) {
+    Profile->recordCall(FuncIdx);
+  }
+  if (ThreadPool && CompileStatuses[FuncIdx] == CompileStatus::Done) {
+    uint8_t *JITFuncCodePtr = GreedyRACodePtrs[FuncIdx];
+    installFunctionCode(FuncIdx, JITFuncCodePtr);
+    return JITFuncCodePtr;
+  }
+  // Instances of the module running on other threads may request the same
+  // or other functions concurrently
+  std::lock_guard<std::mutex> Lock(MainContextMutex);
+  {
+    std::lock_guard<std::mutex> CallSiteLock(CallSiteMutex);
+    if (uint8_t *JITFuncCodePtr = InstalledCodePtrs[FuncIdx]) {
+      return JITFuncCodePtr;
+    }
+    if (uint8_t *FastRACodePtr = FastRACodePtrs[FuncIdx]) {
+      return FastRACodePtr;
+    }
+  }
   if (!ThreadPool) { // Single thread lazy mode
     auto Timer = Stats.startRecord(utils::StatisticPhase::JITLazyFgCompilation);
     uint8_t *JITFuncCodePtr =
         compileFunction(*MainContext, FuncIdx, Config.DisableMultipassGreedyRA);
-    JITStubBuilder::updateStubJmpTargetPtr(FuncStubCodePtr, JITFuncCodePtr);
+    installFunctionCode(FuncIdx, JITFuncCodePtr);
     Stats.stopRecord(Timer);
     return JITFuncCodePtr;
   }
-  if (CompileStatuses[FuncIdx] == CompileStatus::Done) {
-    return GreedyRACodePtrs[FuncIdx];
+  // The function and its callees will be executed right away, so their
+  // optimized versions go before the other background tasks
+  uint32_t NumImportFunctions = WasmMod->getNumImportFunctions();
+  dispatchCompileTask(FuncIdx, common::TaskPriority::Foreground);
+  const auto &CallSeqMap = WasmMod->getCallSeqMap();
+  for (uint32_t CalleeIdx : CallSeqMap.at(FuncIdx + NumImportFunctions)) {
+    ZEN_ASSERT(CalleeIdx >= NumImportFunctions);
+    dispatchCompileTask(CalleeIdx - NumImportFunctions,
+                        common::TaskPriority::Foreground);
   }
   ZEN_LOG_DEBUG("compile function %d on request", FuncIdx);
   auto Timer = Stats.startRecord(utils::StatisticPhase::JITLazyFgCompilation);
   // Compile the function with fastRA for faster compilation
-  uint8_t *JITFuncCodePtr = compileFunction(*MainContext, FuncIdx, true);
+  uint8_t *FastRACodePtr = compileFunction(*MainContext, FuncIdx, true);
   Stats.stopRecord(Timer);
   if (CompileStatuses[FuncIdx] == CompileStatus::Done) {
-    return GreedyRACodePtrs[FuncIdx];
+    installFunctionCode(FuncIdx, GreedyRACodePtrs[FuncIdx]);
   }
-  JITStubBuilder::updateStubJmpTargetPtr(FuncStubCodePtr, JITFuncCodePtr);
-  return JITFuncCodePtr;
+  return installFastRACode(FuncIdx, FastRACodePtr);
+}
+
+uint8_t *LazyJITCompiler::installFastRACode(uint32_t FuncIdx,
+                                            uint8_t *FastRACodePtr) {
+  std::lock_guard<std::mutex> Lock(CallSiteMutex);
+  if (uint8_t *JITFuncCodePtr = InstalledCodePtrs[FuncIdx]) {
+    // The background compilation is done meanwhile, the fastRA code never ran
+    retireFastRACode(FuncIdx, FastRACodePtr);
+    return JITFuncCodePtr;
+  }
+  // The fastRA version is replaced once the background compilation is done,
+  // so only the stub goes to it
+  StubBuilder.updateStubJmpTargetPtr(StubBuilder.getFuncStubCodePtr(FuncIdx),
+                                     FastRACodePtr);
+  // Compiled concurrently by another thread, which may still be running it
+  if (FastRACodePtrs[FuncIdx]) {
+    retireFastRACode(FuncIdx, FastRACodePtrs[FuncIdx]);
+  }
+  FastRACodePtrs[FuncIdx] = FastRACodePtr;
+  return FastRACodePtr;
+}
+
+void LazyJITCompiler::retireFastRACode(uint32_t FuncIdx,
+                                       uint8_t *FastRACodePtr) {
+  // Only the direct callees of the function may have calls from its code
+  uint32_t NumImportFunctions = WasmMod->getNumImportFunctions();
+  const auto &CallSeqMap = WasmMod->getCallSeqMap();
+  for (uint32_t CalleeIdx : CallSeqMap.at(FuncIdx + NumImportFunctions)) {
+    ZEN_ASSERT(CalleeIdx >= NumImportFunctions);
+    std::vector<CallSite> &CallSites =
+        PendingCallSites[CalleeIdx - NumImportFunctions];
+    CallSites.erase(std::remove_if(CallSites.begin(), CallSites.end(),
+                                   [FastRACodePtr](const CallSite &Site) {
+                                     return Site.CodePtr == FastRACodePtr;
+                                   }),
+                    CallSites.end());
+  }
+  WasmMod->getJITCodeMemPool().retire(FastRACodePtr);
 }
 
 std::pair<std::unique_ptr<MModule>, std::vector<void *>>
@@ -712,8 +1114,8 @@ MIRTextJITCompiler::compile(CompileContext &Context, const char *Ptr,
   }
   emitObjectBuffer(&Context);
   std::vector<void *> FuncPtrs(Mod->getNumFunctions());
-  platform::mprotect(Context.CodePtr, TO_MPROTECT_CODE_SIZE(Context.CodeSize),
-                     PROT_READ | PROT_EXEC);
+  Context.CodeMPool->protectExecutable(Context.CodePtr,
+                                      TO_MPROTECT_CODE_SIZE(Context.CodeSize));
   for (const auto &[FuncIdx, FuncOffset] : Context.FuncOffsetMap) {
     FuncPtrs[FuncIdx] = Context.CodePtr + FuncOffset;
   }
@@ -5,6 +5,7 @@
 #define ZEN_COMPILER_COMPILER_H
 
 #include "compiler/common/common_defs.h"
+#include "compiler/lazy_profile.h"
 #include "compiler/stub/stub_builder.h"
 
 namespace COMPILER {
@@ -37,19 +38,53 @@ protected:
   void compileWasmToMC(WasmFrontendContext &Ctx, MModule &Mod, uint32_t FuncIdx,
                        bool DisableGreedyRA);
 
+  bool isInterpOnlyFunction(uint32_t FuncIdx) const {
+    return WasmMod->isInterpOnlyFunction(FuncIdx +
+                                         WasmMod->getNumImportFunctions());
+  }
+
+  // Write the thunks of the functions left to the interpreter into
+  // `InterpThunkPtrs`, which are called instead of their compiled code
+  void compileInterpThunks(bool Lazy);
+
   runtime::Module *WasmMod;
   const uint32_t NumInternalFunctions;
   const runtime::RuntimeConfig &Config;
   utils::Statistics &Stats;
+  // nullptr for the compiled functions
+  std::vector<uint8_t *> InterpThunkPtrs;
 };
 
 class EagerJITCompiler final : public WasmJITCompiler {
 public:
-  EagerJITCompiler(runtime::Module *WasmMod) : WasmJITCompiler(WasmMod) {}
+  EagerJITCompiler(runtime::Module *WasmMod);
 
-  ~EagerJITCompiler() override = default;
+  ~EagerJITCompiler() override;
 
   void compile();
+
+  // `compile` is split into the following three steps, so that functions can
+  // be dispatched one by one while the module is still being loaded
+
+  void beginCompile();
+
+  /// \warning not thread-safe, call it from the loading thread only
+  void dispatchCompileTask(uint32_t FuncIdx);
+
+  void finishCompile();
+
+private:
+  // Compile the functions one after another in the same context
+  void dispatchCompileTask(std::vector<uint32_t> FuncIdxs);
+
+  WasmFrontendContext *MainContext = nullptr;
+  MModule *Mod = nullptr;
+  uint32_t CompileTimer = 0;
+
+  // These two fields are only used in multithread compilation mode
+  std::vector<WasmFrontendContext> AuxContexts;
+  // must be declared after AuxContexts
+  std::unique_ptr<common::ThreadPool<WasmFrontendContext>> ThreadPool;
 };
 
 class LazyJITCompiler final : public WasmJITCompiler {
@@ -58,11 +93,17 @@ public:
 
   ~LazyJITCompiler() override;
 
-  void dispatchCompileTask(uint32_t FuncIdx);
+  void dispatchCompileTask(
+      uint32_t FuncIdx,
+      common::TaskPriority Priority = common::TaskPriority::Background);
 
-  void dispatchCompileTasksDepthFirst(WasmFrontendContext &Ctx);
+  // Append the functions to compile in the background to `Order`, the most
+  // urgent first
+  void dispatchCompileTasksDepthFirst(WasmFrontendContext &Ctx,
+                                      CompileVector<uint32_t> &Order);
 
-  void dispatchCompileTasksInOrder(WasmFrontendContext &Ctx);
+  void dispatchCompileTasksInOrder(WasmFrontendContext &Ctx,
+                                   CompileVector<uint32_t> &Order);
 
   void dispatchEntryCompileTasks(WasmFrontendContext &Ctx);
 
@@ -75,6 +116,30 @@ public:
 
   uint8_t *compileFunctionOnRequest(uint8_t *FuncStubCodePtr);
 
+  // Returns nullptr if the function still runs through its stub or fastRA
+  // code
+  uint8_t *getInstalledCodePtr(uint32_t FuncIdx) {
+    std::lock_guard<std::mutex> Lock(CallSiteMutex);
+    return InstalledCodePtrs[FuncIdx];
+  }
+
+  // Only for tests, the number of direct calls still going to the stub of the
+  // function
+  size_t getNumPendingCallSites(uint32_t FuncIdx) {
+    std::lock_guard<std::mutex> Lock(CallSiteMutex);
+    return PendingCallSites[FuncIdx].size();
+  }
+
+  void waitForBackgroundCompilation() {
+    if (ThreadPool) {
+      ThreadPool->waitForTasks();
+    }
+  }
+
+  // Only for tests, runs on the compiling thread before the background
+  // compiled code of a function is published
+  static inline void (*BackgroundCompileHook)(uint32_t FuncIdx) = nullptr;
+
 private:
   enum class CompileStatus : uint8_t {
     None,
@@ -83,9 +148,52 @@ private:
     Done,
   };
 
+  // Task value of dispatching the compile tasks from the entry functions
+  static constexpr uint32_t DispatchEntryTasks = -1u;
+
+  void runCompileTask(WasmFrontendContext &Ctx, uint32_t Task);
+
+  bool isColdFunction(uint32_t FuncIdx) const {
+    return Profile && Profile->hasPreviousProfile() &&
+           !Profile->isPreviouslyCalled(FuncIdx);
+  }
+
+  // Retarget the stub of the function to its final code, and the direct
+  // calls to the stub recorded so far to the final code
+  void installFunctionCode(uint32_t FuncIdx, uint8_t *JITFuncCodePtr);
+
+  // Retarget the stub of the function to its fastRA code until the final code
+  // is installed, the superseded fastRA code is retired. Returns the code to
+  // run, which is the final code if installed already
+  uint8_t *installFastRACode(uint32_t FuncIdx, uint8_t *FastRACodePtr);
+
+  // Retire the superseded fastRA code of the function, and forget the calls in
+  // it still waiting for their callees, which would be patched into reclaimed
+  // code otherwise. Requires `CallSiteMutex`
+  void retireFastRACode(uint32_t FuncIdx, uint8_t *FastRACodePtr);
+
+  // A rel32 of a direct call to the stub of a not yet installed function
+  struct CallSite {
+    uint8_t *RelPtr;
+    int64_t Addend;
+    // Start of the caller code holding the call
+    uint8_t *CodePtr;
+  };
+
+  // Protects the fields below, the stub retargeting and the protection
+  // changes of compiled code
+  std::mutex CallSiteMutex;
+  std::vector<std::vector<CallSite>> PendingCallSites;
+  std::vector<uint8_t *> InstalledCodePtrs;
+  std::vector<uint8_t *> FastRACodePtrs;
+
   JITStubBuilder StubBuilder;
+  // Serializes the compilations on request, which all use MainContext
+  std::mutex MainContextMutex;
   WasmFrontendContext *MainContext;
   MModule *Mod;
+  // Only created if the profile directory is configured
+  std::unique_ptr<LazyCompileProfile> Profile;
 
   // These four fields are only used in multithread lazy compilation mode
   std::vector<WasmFrontendContext> AuxContexts;
@@ -93,7 +201,8 @@ private:
   std::unique_ptr<std::atomic<CompileStatus>[]> CompileStatuses;
   // must be declared before ThreadPool
   std::unique_ptr<std::atomic<uint8_t *>[]> GreedyRACodePtrs;
-  std::unique_ptr<common::ThreadPool<WasmFrontendContext>> ThreadPool;
+  std::unique_ptr<common::WorkStealingPool<WasmFrontendContext, uint32_t>>
+      ThreadPool;
 };
 
 class MIRTextJITCompiler final : public JITCompilerBase {
@@ -102,6 +102,73 @@ static LLVMTargetMachine *createTargetMachine() {
       Triple, CPUStr, FeaturesStr, Options, llvm::None));
 }
 
+static common::Mutex PooledTargetsMutex;
+
+// Intentionally leaked, the targets must not be destroyed after the static
+// state of LLVM at exit
+static std::vector<std::unique_ptr<CompileTarget>> &getPooledTargets() {
+  static auto *PooledTargets =
+      new std::vector<std::unique_ptr<CompileTarget>>();
+  return *PooledTargets;
+}
+
+std::unique_ptr<CompileTarget> CompileTarget::acquire() {
+  {
+    common::LockGuard<common::Mutex> Lock(PooledTargetsMutex);
+    auto &PooledTargets = getPooledTargets();
+    if (!PooledTargets.empty()) {
+      std::unique_ptr<CompileTarget> Target = std::move(PooledTargets.back());
+      PooledTargets.pop_back();
+      return Target;
+    }
+  }
+  return std::unique_ptr<CompileTarget>(new CompileTarget());
+}
+
+void CompileTarget::release(std::unique_ptr<CompileTarget> Target) {
+  if (!Target) {
+    return;
+  }
+  common::LockGuard<common::Mutex> Lock(PooledTargetsMutex);
+  auto &PooledTargets = getPooledTargets();
+  if (PooledTargets.size() < MaxNumPooledTargets) {
+    PooledTargets.push_back(std::move(Target));
+  }
+}
+
+CompileTarget::CompileTarget() {
+#ifdef ZEN_BUILD_TARGET_X86_64
+  Workaround = MemPool.newObject<X86LLVMWorkaround>();
+#else
+#error "Unsupported target"
+#endif
+
+  TM.reset(createTargetMachine());
+
+  STI = Workaround->getSubtargetImpl(*TM, MemPool);
+  if (!STI) {
+    MemPool.deleteObject(Workaround);
+    throw getError(ErrorCode::UnexpectedSubtarget);
+  }
+
+#ifdef ZEN_BUILD_TARGET_X86_64
+  const llvm::X86Subtarget *X86STI =
+      static_cast<const llvm::X86Subtarget *>(STI);
+  if (!X86STI->hasSSE41()) {
+    MemPool.deleteObject(STI);
+    MemPool.deleteObject(Workaround);
+    throw getError(ErrorCode::UnexpectedSubtarget);
+  }
+#else
+#error "Unsupported target"
+#endif
+}
+
+CompileTarget::~CompileTarget() {
+  MemPool.deleteObject(STI);
+  MemPool.deleteObject(Workaround);
+}
+
 CompileContext::CompileContext() {
   // Ensure LLVM is initialized only once in the current process
   [[maybe_unused]] static bool _ = []() {
@@ -122,11 +189,8 @@ CompileContext::~CompileContext() {
     ThreadMemPool.deleteObject(MCL);
     ZEN_ASSERT(MCCtx);
     ThreadMemPool.deleteObject(MCCtx);
-    ZEN_ASSERT(STI);
-    ThreadMemPool.deleteObject(STI);
-    ZEN_ASSERT(Workaround);
-    ThreadMemPool.deleteObject(Workaround);
   }
+  CompileTarget::release(std::move(Target));
 
   /* Only need to delete the following objects when on debug mode or using a
    * SysMemPool */
@@ -153,7 +217,8 @@ CompileContext::CompileContext(const CompileContext &OtherCtx) {
 }
 
 void CompileContext::initialize() {
-  initializeTargetMachine();
+  ZEN_ASSERT(!Target);
+  Target = CompileTarget::acquire();
 
   initializeMC();
 
@@ -180,41 +245,17 @@ void CompileContext::reinitialize() {
   initializeMC();
 }
 
-void CompileContext::initializeTargetMachine() {
-#ifdef ZEN_BUILD_TARGET_X86_64
-  Workaround = ThreadMemPool.newObject<X86LLVMWorkaround>();
-#else
-#error "Unsupported target"
-#endif
-
-  TM.reset(createTargetMachine());
-
-  STI = Workaround->getSubtargetImpl(*TM, ThreadMemPool);
-  if (!STI) {
-    throw getError(ErrorCode::UnexpectedSubtarget);
-  }
-
-#ifdef ZEN_BUILD_TARGET_X86_64
-  const llvm::X86Subtarget *X86STI =
-      static_cast<const llvm::X86Subtarget *>(STI);
-  if (!X86STI->hasSSE41()) {
-    throw getError(ErrorCode::UnexpectedSubtarget);
-  }
-#else
-#error "Unsupported target"
-#endif
-}
-
 void CompileContext::initializeMC() {
+  llvm::LLVMTargetMachine &TM = Target->getTargetMachine();
   MCCtx = ThreadMemPool.newObject<llvm::MCContext>(
-      TM->getTargetTriple(), TM->getMCAsmInfo(), TM->getMCRegisterInfo(),
-      TM->getMCSubtargetInfo(), nullptr, &TM->Options.MCOptions,
+      TM.getTargetTriple(), TM.getMCAsmInfo(), TM.getMCRegisterInfo(),
+      TM.getMCSubtargetInfo(), nullptr, &TM.Options.MCOptions,
       false); // TODO: AutoReset?
 
-  MCCtx->setObjectFileInfo(TM->getObjFileLowering());
+  MCCtx->setObjectFileInfo(TM.getObjFileLowering());
 
 #ifdef ZEN_BUILD_TARGET_X86_64
-  MCL = ThreadMemPool.newObject<X86MCLowering>(*TM, *MCCtx, ObjBuffer);
+  MCL = ThreadMemPool.newObject<X86MCLowering>(TM, *MCCtx, ObjBuffer);
   MCL->initialize();
 #else
 #error "Unsupported target"
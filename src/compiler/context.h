@@ -27,6 +27,36 @@ struct PointerTypeKeyInfo;
 struct DenseMapAPFloatKeyInfo;
 class X86MCLowering;
 
+/// LLVM target machine, subtarget and workaround, which are expensive to
+/// create and don't depend on the compiled module. A context takes one from a
+/// process-wide pool when initialized and gives it back when destroyed, so
+/// the compile threads of later modules reuse them.
+class CompileTarget : public NonCopyable {
+public:
+  static std::unique_ptr<CompileTarget> acquire();
+
+  static void release(std::unique_ptr<CompileTarget> Target);
+
+  ~CompileTarget();
+
+  LLVMWorkaround &getLLVMWorkaround() const { return *Workaround; }
+
+  llvm::LLVMTargetMachine &getTargetMachine() const { return *TM; }
+
+  const llvm::TargetSubtargetInfo &getSubtargetInfo() const { return *STI; }
+
+  // Upper bound of the idle targets kept in the pool
+  static constexpr size_t MaxNumPooledTargets = 64;
+
+private:
+  CompileTarget();
+
+  CompileMemPool MemPool;
+  LLVMWorkaround *Workaround = nullptr;
+  std::unique_ptr<llvm::LLVMTargetMachine> TM;
+  llvm::TargetSubtargetInfo *STI = nullptr;
+};
+
 class CompileContext {
   using FunctionTypeSet = llvm::DenseSet<MFunctionType *, FunctionTypeKeyInfo>;
   using PointerTypeSet = llvm::DenseSet<MPointerType *, PointerTypeKeyInfo>;
@@ -67,11 +97,17 @@ public:
 
   X86MCLowering &getMCLowering() const { return *MCL; }
 
-  LLVMWorkaround &getLLVMWorkaround() const { return *Workaround; }
+  LLVMWorkaround &getLLVMWorkaround() const {
+    return Target->getLLVMWorkaround();
+  }
 
-  llvm::LLVMTargetMachine &getTargetMachine() const { return *TM; }
+  llvm::LLVMTargetMachine &getTargetMachine() const {
+    return Target->getTargetMachine();
+  }
 
-  const llvm::TargetSubtargetInfo &getSubtargetInfo() const { return *STI; }
+  const llvm::TargetSubtargetInfo &getSubtargetInfo() const {
+    return Target->getSubtargetInfo();
+  }
 
   llvm::MCContext &getMCContext() const { return *MCCtx; }
 
@@ -99,8 +135,7 @@ public:
 
   // Lifecycle of the memory pool aligns with that of the compilation thread
   CompileMemPool ThreadMemPool;
-  // Need to be replaced with a new one after the current thread compiles the
-  // previous function
+  // Need to be reset after the current thread compiles the previous function
   CompileMemPool MemPool;
   common::CodeMemPool *CodeMPool = nullptr;
 
@@ -117,21 +152,16 @@ public:
   uint64_t CodeSize = 0;
   uint64_t CodeOffset = 0;
   CompileUnorderedMap<uint32_t, uint64_t> FuncOffsetMap{ThreadMemPool};
-#ifdef ZEN_ENABLE_LINUX_PERF
-  // Only for perf
+  // Only filled for perf
   CompileUnorderedMap<uint32_t, uint64_t> FuncSizeMap{ThreadMemPool};
-#endif
   CompileVector<ExternRelocations> ExternRelocs{ThreadMemPool};
 
 private:
-  void initializeTargetMachine();
   void initializeMC();
 
   /// ================ LLVM Related ================
 
-  LLVMWorkaround *Workaround = nullptr;
-  std::unique_ptr<llvm::LLVMTargetMachine> TM;
-  llvm::TargetSubtargetInfo *STI = nullptr;
+  std::unique_ptr<CompileTarget> Target;
 
   /// ================ MC Related ================
 
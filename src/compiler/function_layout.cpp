@@ -0,0 +1,93 @@
+// Copyright (C) 2021-2023 the DTVM authors. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "compiler/function_layout.h"
+#include "runtime/module.h"
+#include <algorithm>
+#include <numeric>
+
+namespace COMPILER {
+
+namespace {
+
+// Limit of the wasm code size of a cluster, the machine code is a few times
+// larger so a cluster spans a few pages at most
+constexpr uint64_t MaxClusterCodeSize = 4096;
+
+} // namespace
+
+std::vector<FunctionCluster>
+buildFunctionClusters(const Module &WasmMod) {
+  const uint32_t NumImportFunctions = WasmMod.getNumImportFunctions();
+  const uint32_t NumFunctions = WasmMod.getNumInternalFunctions();
+  const auto &CallSeqMap = WasmMod.getCallSeqMap();
+
+  std::vector<std::vector<uint32_t>> Callers(NumFunctions);
+  for (uint32_t FuncIdx = 0; FuncIdx < NumFunctions; ++FuncIdx) {
+    for (uint32_t CalleeIdx : CallSeqMap.at(FuncIdx + NumImportFunctions)) {
+      ZEN_ASSERT(CalleeIdx >= NumImportFunctions);
+      CalleeIdx -= NumImportFunctions;
+      if (CalleeIdx != FuncIdx) {
+        Callers[CalleeIdx].push_back(FuncIdx);
+      }
+    }
+  }
+
+  std::vector<FunctionCluster> Clusters(NumFunctions);
+  std::vector<uint32_t> ClusterIdxs(NumFunctions);
+  for (uint32_t FuncIdx = 0; FuncIdx < NumFunctions; ++FuncIdx) {
+    const CodeEntry *CE = WasmMod.getCodeEntry(FuncIdx + NumImportFunctions);
+    ZEN_ASSERT(CE);
+    FunctionCluster &Cluster = Clusters[FuncIdx];
+    Cluster.FuncIdxs.push_back(FuncIdx);
+    Cluster.CodeSize = std::max<uint64_t>(CE->CodeSize, 1);
+    Cluster.Hotness = Callers[FuncIdx].size();
+    ClusterIdxs[FuncIdx] = FuncIdx;
+  }
+
+  auto IsHotter = [&](uint32_t LHS, uint32_t RHS) {
+    return Callers[LHS].size() > Callers[RHS].size();
+  };
+  std::vector<uint32_t> Order(NumFunctions);
+  std::iota(Order.begin(), Order.end(), 0);
+  std::stable_sort(Order.begin(), Order.end(), IsHotter);
+
+  for (uint32_t FuncIdx : Order) {
+    if (Callers[FuncIdx].empty()) {
+      continue;
+    }
+    // The hottest caller is the most likely one, callers are sorted by index
+    // so ties go to the first one
+    const auto &FuncCallers = Callers[FuncIdx];
+    uint32_t CallerIdx =
+        *std::min_element(FuncCallers.begin(), FuncCallers.end(), IsHotter);
+    FunctionCluster &CallerCluster = Clusters[ClusterIdxs[CallerIdx]];
+    FunctionCluster &Cluster = Clusters[ClusterIdxs[FuncIdx]];
+    if (&CallerCluster == &Cluster ||
+        CallerCluster.CodeSize + Cluster.CodeSize > MaxClusterCodeSize) {
+      continue;
+    }
+    for (uint32_t MergedIdx : Cluster.FuncIdxs) {
+      ClusterIdxs[MergedIdx] = ClusterIdxs[CallerIdx];
+      CallerCluster.FuncIdxs.push_back(MergedIdx);
+    }
+    CallerCluster.CodeSize += Cluster.CodeSize;
+    CallerCluster.Hotness += Cluster.Hotness;
+    Cluster = FunctionCluster();
+  }
+
+  Clusters.erase(std::remove_if(Clusters.begin(), Clusters.end(),
+                                [](const FunctionCluster &Cluster) {
+                                  return Cluster.FuncIdxs.empty();
+                                }),
+                 Clusters.end());
+  // Hotness / CodeSize in descending order
+  std::stable_sort(Clusters.begin(), Clusters.end(),
+                   [](const FunctionCluster &LHS, const FunctionCluster &RHS) {
+                     return LHS.Hotness * RHS.CodeSize >
+                            RHS.Hotness * LHS.CodeSize;
+                   });
+  return Clusters;
+}
+
+} // namespace COMPILER
@@ -0,0 +1,32 @@
+// Copyright (C) 2021-2023 the DTVM authors. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef COMPILER_FUNCTION_LAYOUT_H
+#define COMPILER_FUNCTION_LAYOUT_H
+
+#include "compiler/common/common_defs.h"
+
+namespace COMPILER {
+
+// Functions compiled into one context as a unit, so they are laid out
+// contiguously in this order
+struct FunctionCluster {
+  std::vector<uint32_t> FuncIdxs; // excluding import functions
+  uint64_t CodeSize = 0;          // total size of the wasm function bodies
+  uint64_t Hotness = 0;
+};
+
+// Group the internal functions into clusters by the static call graph in the
+// style of call-chain clustering(C3): visiting the functions from the hottest,
+// the cluster of each function is appended to the cluster of its most likely
+// caller unless the merged cluster grows too large. Without an execution
+// profile, the hotness of a function is estimated by the number of its
+// callers and all call edges weigh the same.
+//
+// The clusters are returned in the order of decreasing hotness density.
+std::vector<FunctionCluster>
+buildFunctionClusters(const Module &WasmMod);
+
+} // namespace COMPILER
+
+#endif // COMPILER_FUNCTION_LAYOUT_H
@@ -0,0 +1,169 @@
+// Copyright (C) 2021-2023 the DTVM authors. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "compiler/lazy_profile.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+namespace COMPILER {
+
+namespace {
+
+constexpr char ProfileMagic[8] = {'D', 'T', 'V', 'M', 'P', 'R', 'O', 'F'};
+constexpr uint32_t ProfileVersion = 1;
+
+struct ProfileHeader {
+  char Magic[8];
+  uint32_t Version;
+  uint32_t NumFunctions;
+  uint64_t ModuleHash;
+  uint32_t NumEntries;
+  uint32_t Reserved;
+};
+
+} // namespace
+
+LazyCompileProfile::LazyCompileProfile(uint64_t ModuleHash,
+                                       uint32_t NumFunctions)
+    : ModuleHash(ModuleHash), NumFunctions(NumFunctions),
+      StartTime(std::chrono::steady_clock::now()),
+      PreviouslyCalled(NumFunctions, false),
+      Called(std::make_unique<std::atomic<bool>[]>(NumFunctions)) {
+  for (uint32_t I = 0; I < NumFunctions; ++I) {
+    Called[I] = false;
+  }
+}
+
+uint64_t LazyCompileProfile::hashModule(const uint8_t *Data, size_t Size) {
+  // FNV-1a over 8-byte words, it only has to tell different modules apart
+  constexpr uint64_t FNVOffsetBasis = 0xcbf29ce484222325ULL;
+  constexpr uint64_t FNVPrime = 0x100000001b3ULL;
+  uint64_t Hash = FNVOffsetBasis ^ Size;
+  size_t I = 0;
+  for (; I + sizeof(uint64_t) <= Size; I += sizeof(uint64_t)) {
+    uint64_t Word;
+    std::memcpy(&Word, Data + I, sizeof(Word));
+    Hash = (Hash ^ Word) * FNVPrime;
+  }
+  for (; I < Size; ++I) {
+    Hash = (Hash ^ Data[I]) * FNVPrime;
+  }
+  return Hash;
+}
+
+std::string LazyCompileProfile::getFilePath(const std::string &Dir) const {
+  char FileName[32];
+  snprintf(FileName, sizeof(FileName), "%016" PRIx64 ".prof", ModuleHash);
+  return Dir + '/' + FileName;
+}
+
+bool LazyCompileProfile::load(const std::string &Dir) {
+  FILE *File = fopen(getFilePath(Dir).c_str(), "rb");
+  if (!File) {
+    return false;
+  }
+
+  ProfileHeader Header;
+  bool Valid = fread(&Header, sizeof(Header), 1, File) == 1 &&
+               std::memcmp(Header.Magic, ProfileMagic, sizeof(ProfileMagic)) ==
+                   0 &&
+               Header.Version == ProfileVersion &&
+               Header.NumFunctions == NumFunctions &&
+               Header.ModuleHash == ModuleHash &&
+               Header.NumEntries <= NumFunctions;
+  std::vector<Entry> Entries;
+  if (Valid) {
+    Entries.resize(Header.NumEntries);
+    Valid = fread(Entries.data(), sizeof(Entry), Entries.size(), File) ==
+            Entries.size();
+  }
+  fclose(File);
+
+  std::vector<bool> Seen(NumFunctions, false);
+  for (const Entry &E : Entries) {
+    if (!Valid || E.FuncIdx >= NumFunctions || Seen[E.FuncIdx]) {
+      Valid = false;
+      break;
+    }
+    Seen[E.FuncIdx] = true;
+  }
+  if (!Valid) {
+    return false;
+  }
+
+  PreviousEntries = std::move(Entries);
+  PreviouslyCalled = std::move(Seen);
+  PreviousOrder.clear();
+  for (const Entry &E : PreviousEntries) {
+    PreviousOrder.push_back(E.FuncIdx);
+  }
+  return true;
+}
+
+bool LazyCompileProfile::save(const std::string &Dir) const {
+  std::vector<Entry> Entries;
+  {
+    std::lock_guard<std::mutex> Lock(RecordMutex);
+    Entries = RecordedEntries;
+  }
+  if (Entries.empty()) {
+    // Nothing ran, keep the previous profile
+    return true;
+  }
+  // Calls in different threads may be recorded out of order
+  std::stable_sort(Entries.begin(), Entries.end(),
+                   [](const Entry &LHS, const Entry &RHS) {
+                     return LHS.FirstCallUs < RHS.FirstCallUs;
+                   });
+  for (const Entry &E : PreviousEntries) {
+    if (!Called[E.FuncIdx]) {
+      Entries.push_back(E);
+    }
+  }
+
+  ProfileHeader Header;
+  std::memcpy(Header.Magic, ProfileMagic, sizeof(ProfileMagic));
+  Header.Version = ProfileVersion;
+  Header.NumFunctions = NumFunctions;
+  Header.ModuleHash = ModuleHash;
+  Header.NumEntries = static_cast<uint32_t>(Entries.size());
+  Header.Reserved = 0;
+
+  // Write to a temporary file and rename it, so that concurrent processes
+  // never read a partial profile
+  std::string FilePath = getFilePath(Dir);
+  std::string TmpFilePath = FilePath + ".tmp" + std::to_string(getpid());
+  FILE *File = fopen(TmpFilePath.c_str(), "wb");
+  if (!File) {
+    return false;
+  }
+  bool Success =
+      fwrite(&Header, sizeof(Header), 1, File) == 1 &&
+      fwrite(Entries.data(), sizeof(Entry), Entries.size(), File) ==
+          Entries.size();
+  Success = (fclose(File) == 0) && Success;
+  if (!Success || std::rename(TmpFilePath.c_str(), FilePath.c_str()) != 0) {
+    std::remove(TmpFilePath.c_str());
+    return false;
+  }
+  return true;
+}
+
+void LazyCompileProfile::recordCall(uint32_t FuncIdx) {
+  ZEN_ASSERT(FuncIdx < NumFunctions);
+  if (Called[FuncIdx].exchange(true)) {
+    return;
+  }
+  auto Elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now() - StartTime)
+                     .count();
+  uint32_t FirstCallUs =
+      static_cast<uint32_t>(std::min<int64_t>(Elapsed, UINT32_MAX));
+  std::lock_guard<std::mutex> Lock(RecordMutex);
+  RecordedEntries.push_back({FuncIdx, FirstCallUs});
+}
+
+} // namespace COMPILER
@@ -0,0 +1,83 @@
+// Copyright (C) 2021-2023 the DTVM authors. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef COMPILER_LAZY_PROFILE_H
+#define COMPILER_LAZY_PROFILE_H
+
+#include "common/defines.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace COMPILER {
+
+// Functions that actually ran in previous executions of the same module, in
+// the order of their first calls. Lazy JIT compiles them first in background
+// with greedy RA, and the never called functions later with fast RA.
+//
+// The profile is stored in "<Dir>/<ModuleHash>.prof":
+//   Header { "DTVMPROF", Version, NumFunctions, ModuleHash, NumEntries }
+//   Entry  { FuncIdx, FirstCallUs } * NumEntries
+// where FuncIdx excludes import functions and FirstCallUs is the time since
+// the module was compiled.
+class LazyCompileProfile {
+public:
+  LazyCompileProfile(uint64_t ModuleHash, uint32_t NumFunctions);
+
+  static uint64_t hashModule(const uint8_t *Data, size_t Size);
+
+  // Returns false if the profile doesn't exist or doesn't match the module
+  bool load(const std::string &Dir);
+
+  // Write the functions called in this execution, followed by the previously
+  // profiled functions not called this time
+  bool save(const std::string &Dir) const;
+
+  /// \note thread-safe, only the first call of each function is recorded
+  void recordCall(uint32_t FuncIdx);
+
+  /// \note thread-safe
+  bool isCalled(uint32_t FuncIdx) const {
+    ZEN_ASSERT(FuncIdx < NumFunctions);
+    return Called[FuncIdx];
+  }
+
+  bool hasPreviousProfile() const { return !PreviousOrder.empty(); }
+
+  const std::vector<uint32_t> &getPreviousOrder() const {
+    return PreviousOrder;
+  }
+
+  bool isPreviouslyCalled(uint32_t FuncIdx) const {
+    ZEN_ASSERT(FuncIdx < NumFunctions);
+    return PreviouslyCalled[FuncIdx];
+  }
+
+  std::string getFilePath(const std::string &Dir) const;
+
+private:
+  struct Entry {
+    uint32_t FuncIdx;
+    uint32_t FirstCallUs;
+  };
+
+  uint64_t ModuleHash;
+  uint32_t NumFunctions;
+  std::chrono::steady_clock::time_point StartTime;
+
+  // Loaded from the profile file, read-only after `load`
+  std::vector<Entry> PreviousEntries;
+  std::vector<uint32_t> PreviousOrder;
+  std::vector<bool> PreviouslyCalled;
+
+  std::unique_ptr<std::atomic<bool>[]> Called;
+  mutable std::mutex RecordMutex;
+  std::vector<Entry> RecordedEntries;
+};
+
+} // namespace COMPILER
+
+#endif // COMPILER_LAZY_PROFILE_H
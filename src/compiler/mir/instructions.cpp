@@ -121,6 +121,9 @@ void MInstruction::print(llvm::raw_ostream &OS) const {
          << " (target = " << icall->getCalleeAddr() << ", ";
     } else {
       auto *dcall = llvm::cast<CallInstruction>(this);
+      if (dcall->isTailCall()) {
+        OS << "tail ";
+      }
       OS << "call %" << dcall->getCalleeIdx() << " (";
     }
     for (OperandNum i = 0; i < getNumOperands(); ++i) {
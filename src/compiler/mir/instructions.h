@@ -315,6 +315,11 @@ public:
 
   uint32_t getCalleeIdx() const { return _callee_idx; }
 
+  // A tail call is the operand of a ReturnInstruction(or the statement before
+  // it when returning void), the target may reuse the frame of the caller
+  bool isTailCall() const { return _is_tail_call; }
+  void setTailCall(bool is_tail_call) { _is_tail_call = is_tail_call; }
+
 private:
   friend class DynamicOperandInstruction;
   CallInstruction(MType *type, uint32_t callee_idx,
@@ -322,6 +327,7 @@ private:
       : CallInstructionBase(type, OP_call, args), _callee_idx(callee_idx) {}
 
   uint32_t _callee_idx = 0;
+  bool _is_tail_call = false;
 };
 
 // Indirect Call Instruction
@@ -3,6 +3,7 @@
 
 #include "compiler/stub/stub_builder.h"
 #include "compiler/compiler.h"
+#include "entrypoint/entrypoint.h"
 
 using namespace COMPILER;
 
@@ -20,13 +21,48 @@ void JITStubBuilder::updateStubJmpTargetPtr(uint8_t *CurStubCodePtr,
   /// atomicity.
 
   /// \note x86_64 only
+  uint8_t *WritableStubCodePtr = CodeMPool.getWritableAddr(CurStubCodePtr);
   asm volatile(
       "xchgl %0, 1(%1)" // +1 because the jmp instructions first byte is opcode
       :
-      : "r"(CallRelOffsetI32), "r"(CurStubCodePtr)
+      : "r"(CallRelOffsetI32), "r"(WritableStubCodePtr)
       : "memory");
 }
 
+/// \note thread safe
+void JITStubBuilder::updateCallRelTarget(uint8_t *RelPtr, int32_t RelValue) {
+  /// Same as `updateStubJmpTargetPtr`, the caller ensures the 4 bytes don't
+  /// cross a cache line, so instruction fetch sees either the old or new value
+  asm volatile("xchgl %0, (%1)" : : "r"(RelValue), "r"(RelPtr) : "memory");
+}
+
+void JITStubBuilder::compileInterpThunk(uint8_t *WritablePtr,
+                                        uint32_t FuncIdx) {
+  uint64_t HelperAddr =
+      reinterpret_cast<uint64_t>(zen::runtime::Instance::callInterpOnJIT);
+  uint64_t BridgeAddr = reinterpret_cast<uint64_t>(callInterpFromJIT);
+  uint8_t *Ptr = WritablePtr;
+  // movl $FuncIdx, %r10d
+  *Ptr++ = 0x41;
+  *Ptr++ = 0xba;
+  std::memcpy(Ptr, &FuncIdx, 4);
+  Ptr += 4;
+  // movabsq $HelperAddr, %r11
+  *Ptr++ = 0x49;
+  *Ptr++ = 0xbb;
+  std::memcpy(Ptr, &HelperAddr, 8);
+  Ptr += 8;
+  // movabsq $BridgeAddr, %rax, which is not an argument register
+  *Ptr++ = 0x48;
+  *Ptr++ = 0xb8;
+  std::memcpy(Ptr, &BridgeAddr, 8);
+  Ptr += 8;
+  // jmpq *%rax
+  *Ptr++ = 0xff;
+  *Ptr++ = 0xe0;
+  ZEN_ASSERT(static_cast<size_t>(Ptr - WritablePtr) == InterpThunkCodeSize);
+}
+
 static uint64_t
 compileOnRequestTrampoline([[maybe_unused]] zen::runtime::Instance *Inst,
                            uint8_t *NextFuncStubCodePtr) {
@@ -56,14 +92,17 @@ void JITStubBuilder::compileStubResolver() {
       CodeMPool.allocate(StubResolverCodeSize, common::CodeMemPool::PageSize));
   ZEN_ASSERT(NewStubResolverPtr);
 
+  uint8_t *WritableStubResolverPtr =
+      CodeMPool.getWritableAddr(NewStubResolverPtr);
+
   // Use std::copy to avoid misaligned src addresses in memcpy
   std::copy(StubResolverPtr, StubResolverPtr + StubResolverCodeSize,
-            NewStubResolverPtr);
+            WritableStubResolverPtr);
 
   uint8_t *StubResolverPatchPointPtr =
       reinterpret_cast<uint8_t *>(stubResolverPatchPoint);
   auto *NewStubResolverPatchPointPtr =
-      NewStubResolverPtr + (StubResolverPatchPointPtr - StubResolverPtr);
+      WritableStubResolverPtr + (StubResolverPatchPointPtr - StubResolverPtr);
   uint64_t TrampolineFuncAddr =
       reinterpret_cast<uint64_t>(compileOnRequestTrampoline);
 
@@ -71,41 +110,48 @@ void JITStubBuilder::compileStubResolver() {
   // code, +2 because moveabsq first 2 bytes is opcode
   std::memcpy(NewStubResolverPatchPointPtr + 2, &TrampolineFuncAddr, 8);
 
-  platform::mprotect(NewStubResolverPtr, StubResolverCodeSize,
-                     PROT_READ | PROT_EXEC);
+  CodeMPool.protectExecutable(NewStubResolverPtr, StubResolverCodeSize);
   this->StubResolverPtr = NewStubResolverPtr;
+  this->StubResolverCodeSize = StubResolverCodeSize;
 }
 
 void JITStubBuilder::allocateStubSpace(uint32_t NumInternalFunctions) {
   size_t TotalStubCodeSize = NumInternalFunctions * EachStubCodeSize;
   StubsCodePtr = reinterpret_cast<uint8_t *>(
       CodeMPool.allocate(TotalStubCodeSize, common::CodeMemPool::PageSize));
-  platform::mprotect(StubsCodePtr, TotalStubCodeSize, PROT_WRITE | PROT_EXEC);
+  // The stubs are patched while running, keep them writable without the dual
+  // mapping
+  if (!CodeMPool.isDualMapped()) {
+    platform::mprotect(StubsCodePtr, TotalStubCodeSize,
+                       PROT_WRITE | PROT_EXEC);
+  }
 }
 
 void JITStubBuilder::compileFunctionToStub(uint32_t FuncIdx) {
   uint8_t *CurFuncStubCodePtr = StubsCodePtr + FuncIdx * EachStubCodeSize;
+  uint8_t *WritableStubCodePtr = CodeMPool.getWritableAddr(CurFuncStubCodePtr);
 
   uint8_t *StubTmplPtr = reinterpret_cast<uint8_t *>(&stubTemplate);
 
   // Use std::copy to avoid misaligned src addresses in memcpy
   std::copy(StubTmplPtr, reinterpret_cast<uint8_t *>(stubTemplateEnd),
-            CurFuncStubCodePtr);
-
-  // Update the first instruction(jmp instruction) of trampoline default to
-  // jumping to the next instruction
-  std::memset(CurFuncStubCodePtr + 1, 0, 4);
+            WritableStubCodePtr);
 
   uint8_t *StubTmplPatchPointPtr =
       reinterpret_cast<uint8_t *>(stubTemplatePatchPoint);
 
-  uint8_t *NewStubTmplPatchPointPtr =
-      CurFuncStubCodePtr + (StubTmplPatchPointPtr - StubTmplPtr);
+  size_t PatchPointOffset = StubTmplPatchPointPtr - StubTmplPtr;
+  uint8_t *NewStubTmplPatchPointPtr = CurFuncStubCodePtr + PatchPointOffset;
+  // Update the first instruction(jmp instruction) of trampoline default to
+  // jumping to the next instruction
+  std::memset(WritableStubCodePtr + 1, 0, 4);
+
   // -5 because the call instructions has 5 bytes
   int64_t CallRelOffset = StubResolverPtr - NewStubTmplPatchPointPtr - 5;
   ZEN_ASSERT(CallRelOffset <= UINT32_MAX);
 
   // StubResolver not too far, use call(0xe8) offset
   int32_t CallRelOffsetI32 = static_cast<int32_t>(CallRelOffset);
-  std::memcpy(NewStubTmplPatchPointPtr + 1, &CallRelOffsetI32, 4);
+  std::memcpy(WritableStubCodePtr + PatchPointOffset + 1, &CallRelOffsetI32,
+              4);
 }
@@ -14,8 +14,11 @@ public:
       : CodeMPool(CodeMemPool) {}
 
   /// \note thread safe
-  static void updateStubJmpTargetPtr(uint8_t *CurStubCodePtr,
-                                     uint8_t *TargetPtr);
+  void updateStubJmpTargetPtr(uint8_t *CurStubCodePtr, uint8_t *TargetPtr);
+
+  /// \note thread safe, `RelPtr` is the writable address of the code, see
+  /// `CodeMemPool::getWritableAddr`
+  static void updateCallRelTarget(uint8_t *RelPtr, int32_t RelValue);
 
   void allocateStubSpace(uint32_t NumInternalFunctions);
 
@@ -27,17 +30,30 @@ public:
     return StubsCodePtr + FuncIdx * EachStubCodeSize;
   }
 
+  uint8_t *getStubResolverPtr() const { return StubResolverPtr; }
+
+  size_t getStubResolverCodeSize() const { return StubResolverCodeSize; }
+
   uint32_t getFuncIdxByStubCodePtr(uint8_t *FuncStubCodePtr) const {
     return (FuncStubCodePtr - StubsCodePtr) / EachStubCodeSize;
   }
 
+  /// Write the thunk of a function left to the interpreter at `WritablePtr`,
+  /// which jumps to the interpreter bridge with the function index
+  static void compileInterpThunk(uint8_t *WritablePtr, uint32_t FuncIdx);
+
+  // jmp rel32 + call rel32
   static const size_t EachStubCodeSize = 10;
 
+  // mov imm32 + 2 * movabs imm64 + jmp reg
+  static const size_t InterpThunkCodeSize = 28;
+
 private:
   zen::common::CodeMemPool &CodeMPool;
   // each module has one stub resolver
   // need put it in module's code ptr so the relative offset in int32 range
   uint8_t *StubResolverPtr = nullptr;
+  size_t StubResolverCodeSize = 0;
   uint8_t *StubsCodePtr = nullptr;
 };
 
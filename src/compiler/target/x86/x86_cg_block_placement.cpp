@@ -0,0 +1,49 @@
+// Copyright (C) 2021-2023 the DTVM authors. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "compiler/target/x86/x86_cg_block_placement.h"
+#include "compiler/llvm-prebuild/Target/X86/X86Subtarget.h"
+
+using namespace llvm;
+
+namespace COMPILER {
+void X86CgBlockPlacement::updateTerminator(CgBasicBlock &MBB,
+                                           CgBasicBlock *OldFallthrough) {
+  CgBasicBlock *NextMBB = getFallthroughBlock(MBB);
+  if (OldFallthrough && OldFallthrough != NextMBB) {
+    SmallVector<CgOperand, 1> Operands{
+        CgOperand::createMBB(OldFallthrough),
+    };
+    MF.createCgInstruction(MBB, MF.getTargetInstrInfo().get(X86::JMP_1),
+                           Operands);
+  }
+
+  if (!NextMBB || MBB.empty()) {
+    return;
+  }
+  CgInstruction &JmpMI = MBB.back();
+  if (JmpMI.getOpcode() != X86::JMP_1) {
+    return;
+  }
+  CgBasicBlock *TargetMBB = JmpMI.getOperand(0).getMBB();
+  if (TargetMBB == NextMBB) {
+    JmpMI.eraseFromParent();
+    return;
+  }
+
+  // jcc cond, NextMBB; jmp TargetMBB
+  // optimized to: jcc !cond, TargetMBB; fall through to NextMBB
+  if (&JmpMI == &MBB.front()) {
+    return;
+  }
+  CgInstruction &JccMI = *std::prev(MBB.end(), 2);
+  if (JccMI.getOpcode() != X86::JCC_1 ||
+      JccMI.getOperand(0).getMBB() != NextMBB) {
+    return;
+  }
+  auto CC = static_cast<X86::CondCode>(JccMI.getOperand(1).getImm());
+  JccMI.getOperand(0).setMBB(TargetMBB);
+  JccMI.getOperand(1).setImm(X86::GetOppositeBranchCondition(CC));
+  JmpMI.eraseFromParent();
+}
+} // namespace COMPILER
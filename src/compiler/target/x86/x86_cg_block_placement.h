@@ -0,0 +1,18 @@
+// Copyright (C) 2021-2023 the DTVM authors. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "compiler/cgir/cg_basic_block.h"
+#include "compiler/cgir/pass/block_placement.h"
+
+namespace COMPILER {
+class X86CgBlockPlacement : public CgBlockPlacement<X86CgBlockPlacement> {
+public:
+  using CgBlockPlacement::CgBlockPlacement;
+  // Make the branches of MBB agree with the new layout, OldFallthrough is the
+  // block MBB fell through to in the original layout
+  void updateTerminator(CgBasicBlock &MBB, CgBasicBlock *OldFallthrough);
+  unsigned getLoopAlignment() const { return 16; }
+};
+
+} // namespace COMPILER
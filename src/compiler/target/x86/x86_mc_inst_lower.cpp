@@ -226,6 +226,17 @@ void X86MCInstLower::lower(CgInstruction *MI, llvm::MCInst &OutMI) {
     ZEN_ASSERT(OutMI.getNumOperands() == 1 && "Unexpected number of operands!");
     break;
 
+  // TCRETURNdi64 - The epilogue is already inserted before the tail call, so
+  // it's just a jump to the callee, use the rel32 form to get the same
+  // relocation as direct calls.
+  case X86::TCRETURNdi64: {
+    MCOperand Callee = OutMI.getOperand(0);
+    OutMI = MCInst();
+    OutMI.setOpcode(X86::JMP_4);
+    OutMI.addOperand(Callee);
+    break;
+  }
+
   case X86::ADC8ri:
   case X86::ADC16ri:
   case X86::ADC32ri:
@@ -1348,6 +1348,12 @@ CgRegister X86CgLowering::lowerCall(const CallInstructionBase &Inst) {
   SmallVector<CgOperand, 8> CallOperands;
 
   bool IsIndirectCall = llvm::isa<ICallInstruction>(Inst);
+  unsigned StackAdjustNumBytes = getCallFrameSize(Inst);
+  // The stack arguments of a tail call would overwrite the incoming ones of
+  // the caller, so lower it as a normal call followed by the return
+  bool IsTailCall = !IsIndirectCall &&
+                    llvm::cast<CallInstruction>(Inst).isTailCall() &&
+                    StackAdjustNumBytes == 0;
 
   if (IsIndirectCall) {
     const auto &ICallInst = llvm::cast<ICallInstruction>(Inst);
@@ -1359,8 +1365,13 @@ CgRegister X86CgLowering::lowerCall(const CallInstructionBase &Inst) {
         CgOperand::createFuncOperand(DCallInst.getCalleeIdx()));
   }
 
-  // Add a register mask operand representing the call-preserved registers.
-  CallOperands.push_back(CgOperand::createRegMask(CSR_64_RegMask));
+  if (IsTailCall) {
+    // The stack adjustment of TCRETURNdi64
+    CallOperands.push_back(CgOperand::createImmOperand(0));
+  } else {
+    // Add a register mask operand representing the call-preserved registers.
+    CallOperands.push_back(CgOperand::createRegMask(CSR_64_RegMask));
+  }
 
   OperandNum NumOperands = Inst.getNumOperands();
   SmallVector<CgRegister, 6> ArgVirtRegs;
@@ -1373,8 +1384,6 @@ CgRegister X86CgLowering::lowerCall(const CallInstructionBase &Inst) {
     ArgVirtRegs.push_back(ArgVirtReg);
   }
 
-  unsigned StackAdjustNumBytes = getCallFrameSize(Inst);
-
   // Issue CALLSEQ_START
   unsigned AdjStackDown = TII.getCallFrameSetupOpcode();
   SmallVector<CgOperand, 3> StackDownOperands{
@@ -1382,7 +1391,9 @@ CgRegister X86CgLowering::lowerCall(const CallInstructionBase &Inst) {
       CgOperand::createImmOperand(0),
       CgOperand::createImmOperand(0),
   };
-  MF->createCgInstruction(*CurBB, TII.get(AdjStackDown), StackDownOperands);
+  if (!IsTailCall) {
+    MF->createCgInstruction(*CurBB, TII.get(AdjStackDown), StackDownOperands);
+  }
 
   uint32_t GPRIdx = 0;
   uint32_t FPRIdx = 0;
@@ -1426,6 +1437,13 @@ CgRegister X86CgLowering::lowerCall(const CallInstructionBase &Inst) {
     }
   }
 
+  if (IsTailCall) {
+    // Jump to the callee after the epilogue, the callee returns to our caller
+    // with the result in the same register
+    MF->createCgInstruction(*CurBB, TII.get(X86::TCRETURNdi64), CallOperands);
+    return X86::NoRegister;
+  }
+
   MType *Type = Inst.getType();
   MVT VT = getMVT(*Type);
   CgRegister ReturnReg = getReturnRegister(VT);
@@ -4,6 +4,7 @@
 #include "action/bytecode_visitor.h"
 #include "compiler/mir/module.h"
 #include "compiler/mir/pointer.h"
+#include <algorithm>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -69,15 +70,27 @@ void buildAllMIRFuncTypes(WasmFrontendContext &Context, MModule &MMod,
 
   for (uint32_t I = 0; I < NumInternalFunctions; ++I) {
     TypeEntry *FuncType = WasmMod.getFunctionType(I + NumImportFunctions);
+    // Functions of types without MIR equivalent are left to the interpreter,
+    // and so are their callers, so a placeholder keeps the indices aligned.
+    // Function bodies may not be loaded yet when streaming.
+    const WASMType *ParamTypes = FuncType->getParamTypes();
+    if (FuncType->NumReturns > 1 ||
+        std::find(ParamTypes, ParamTypes + FuncType->NumParams,
+                  WASMType::V128) != ParamTypes + FuncType->NumParams ||
+        FuncType->getReturnType() == WASMType::V128) {
+      CompileVector<MType *> MParamTypes(1, Context.ThreadMemPool);
+      MParamTypes[0] = MPointerType::create(Context, Context.VoidType);
+      MMod.addFuncType(
+          MFunctionType::create(Context, Context.VoidType, MParamTypes));
+      continue;
+    }
     CompileVector<MType *> MParamTypes(FuncType->NumParams + 1,
                                        Context.ThreadMemPool);
     MParamTypes[0] = MPointerType::create(Context, Context.VoidType);
-    const WASMType *ParamTypes = FuncType->getParamTypes();
     for (uint32_t J = 0; J < FuncType->NumParams; ++J) {
       MParamTypes[J + 1] = Context.getMIRTypeFromWASMType(ParamTypes[J]);
     }
-    MType *MRetType = Context.getMIRTypeFromWASMType(
-        FuncType->NumReturns > 0 ? FuncType->ReturnTypes[0] : WASMType::VOID);
+    MType *MRetType = Context.getMIRTypeFromWASMType(FuncType->getReturnType());
     MMod.addFuncType(MFunctionType::create(Context, *MRetType, MParamTypes));
   }
 }
@@ -257,7 +270,7 @@ void FunctionMirBuilder::finalizeFunctionBase() {
   auto ReturnZero = [&]() {
     Operand Ret;
     WASMType WType =
-        static_cast<WASMType>(Ctx.getWasmFuncType().ReturnTypes[0]);
+        static_cast<WASMType>(Ctx.getWasmFuncType().getReturnTypes()[0]);
     switch (WType) {
     case WASMType::I32:
       Ret = handleConst<WASMType::I32>(0);
@@ -518,7 +531,7 @@ void FunctionMirBuilder::handleBranchTable(
   }
 }
 
-void FunctionMirBuilder::handleReturn(Operand Opnd) {
+void FunctionMirBuilder::releaseStackCost() {
 #ifdef ZEN_ENABLE_DWASM
   const auto &Layout = Ctx.getWasmMod().getLayout();
   MInstruction *StackCost =
@@ -529,6 +542,10 @@ void FunctionMirBuilder::handleReturn(Operand Opnd) {
       false, OP_sub, &Ctx.I32Type, StackCost, CurFuncStackCost);
   setInstanceElement(&Ctx.I32Type, NewStackCost, Layout.StackCostOffset);
 #endif
+}
+
+void FunctionMirBuilder::handleReturn(Operand Opnd) {
+  releaseStackCost();
 
   MInstruction *Ret = extractOperand(Opnd);
   MType *Type = Ret ? Ret->getType() : &Ctx.VoidType;
@@ -550,6 +567,40 @@ FunctionMirBuilder::Operand FunctionMirBuilder::handleCall(
   }
 }
 
+void FunctionMirBuilder::handleReturnCall(uint32_t FuncIdx, uintptr_t Target,
+                                          bool IsImport, bool FarCall,
+                                          const ArgumentInfo &ArgInfo,
+                                          const std::vector<Operand> &Args) {
+  if (IsImport) {
+    // Host functions are called by address, keep the frame
+    handleReturn(handleCall(FuncIdx, Target, IsImport, FarCall, ArgInfo, Args));
+    return;
+  }
+
+  ZEN_ASSERT(Target == 0);
+  // The callee reports exceptions to our caller directly, so neither the
+  // exception check nor the memory reload is needed after the call
+  CompileVector<MInstruction *> MIRArgs = createCallArgs(Args);
+  releaseStackCost();
+  WASMType Wtype = ArgInfo.getReturnType();
+  MType *Mtype = Ctx.getMIRTypeFromWASMType(Wtype);
+  bool IsStmt = Wtype == WASMType::VOID;
+  // exclude import functions
+  FuncIdx -= Ctx.getWasmMod().getNumImportFunctions();
+  auto *Call =
+      createInstruction<CallInstruction>(IsStmt, Mtype, FuncIdx, MIRArgs);
+  Call->setTailCall(true);
+  createInstruction<ReturnInstruction>(true, Mtype, IsStmt ? nullptr : Call);
+}
+
+void FunctionMirBuilder::handleReturnCallIndirect(
+    uint32_t TypeIdx, Operand IndirectFuncIdx, uint32_t TblIdx,
+    const ArgumentInfo &ArgInfo, const std::vector<Operand> &Args) {
+  // The callee is only known at runtime and may be a host function
+  handleReturn(
+      handleCallIndirect(TypeIdx, IndirectFuncIdx, TblIdx, ArgInfo, Args));
+}
+
 FunctionMirBuilder::Operand FunctionMirBuilder::handleCallIndirect(
     uint32_t TypeIdx, Operand IndirectFuncIdxOp, uint32_t TblIdx,
     const ArgumentInfo &ArgInfo, const std::vector<Operand> &Args) {
@@ -660,6 +711,17 @@ void FunctionMirBuilder::checkCallException(bool IsImportOrIndirect) {
 #endif // ZEN_ENABLE_CPU_EXCEPTION
 }
 
+void FunctionMirBuilder::callRuntimeHelper(
+    uintptr_t Func, std::initializer_list<MInstruction *> Args) {
+  CompileVector<MInstruction *> MIRArgs(Ctx.MemPool);
+  MIRArgs.reserve(Args.size() + 1);
+  MIRArgs.push_back(InstanceAddr);
+  MIRArgs.insert(MIRArgs.end(), Args.begin(), Args.end());
+  MInstruction *FuncAddr = createIntConstInstruction(&Ctx.I64Type, Func);
+  createInstruction<ICallInstruction>(true, &Ctx.VoidType, FuncAddr, MIRArgs);
+  checkCallException(true);
+}
+
 // ==================== Parametric Instruction Handlers ====================
 
 FunctionMirBuilder::Operand
@@ -755,6 +817,34 @@ FunctionMirBuilder::Operand FunctionMirBuilder::handleMemoryGrow(Operand Opnd) {
   return Operand(PrevNumPages, WASMType::I32);
 }
 
+void FunctionMirBuilder::handleMemoryInit(uint32_t DataSegIdx,
+                                          Operand DestOffset, Operand SrcOffset,
+                                          Operand Size) {
+  callRuntimeHelper(uintptr_t(Instance::initMemoryOnJIT),
+                    {createIntConstInstruction(&Ctx.I32Type, DataSegIdx),
+                     extractOperand(DestOffset), extractOperand(SrcOffset),
+                     extractOperand(Size)});
+}
+
+void FunctionMirBuilder::handleDataDrop(uint32_t DataSegIdx) {
+  callRuntimeHelper(uintptr_t(Instance::dropDataSegmentOnJIT),
+                    {createIntConstInstruction(&Ctx.I32Type, DataSegIdx)});
+}
+
+void FunctionMirBuilder::handleMemoryCopy(Operand DestOffset, Operand SrcOffset,
+                                          Operand Size) {
+  callRuntimeHelper(uintptr_t(Instance::copyMemoryOnJIT),
+                    {extractOperand(DestOffset), extractOperand(SrcOffset),
+                     extractOperand(Size)});
+}
+
+void FunctionMirBuilder::handleMemoryFill(Operand DestOffset, Operand Value,
+                                          Operand Size) {
+  callRuntimeHelper(uintptr_t(Instance::fillMemoryOnJIT),
+                    {extractOperand(DestOffset), extractOperand(Value),
+                     extractOperand(Size)});
+}
+
 std::tuple<MInstruction *, MInstruction *, int32_t>
 FunctionMirBuilder::getMemoryLocation(MInstruction *Base, uint32_t Offset,
                                       MType *Type) {
@@ -66,6 +66,10 @@ class FunctionMirBuilder final {
 public:
   typedef WasmFrontendContext CompilerContext;
 
+  // Constants are folded by the optimization passes, the bytecode visitor
+  // emits them as they are
+  static constexpr bool FoldConstants = false;
+
   FunctionMirBuilder(CompilerContext &Context, MFunction &MFunc);
 
   class Operand {
@@ -204,6 +208,13 @@ public:
                              uint32_t TblIdx, const ArgumentInfo &ArgInfo,
                              const std::vector<Operand> &Args);
 
+  void handleReturnCall(uint32_t FuncIdx, uintptr_t Target, bool IsImport,
+                        bool FarCall, const ArgumentInfo &ArgInfo,
+                        const std::vector<Operand> &Args);
+  void handleReturnCallIndirect(uint32_t TypeIdx, Operand IndirectFuncIdx,
+                                uint32_t TblIdx, const ArgumentInfo &ArgInfo,
+                                const std::vector<Operand> &Args);
+
   // ==================== Parametric Instruction Handlers ====================
 
   Operand handleSelect(Operand CondOp, Operand LHSOp, Operand RHSOp);
@@ -259,6 +270,15 @@ public:
 
   Operand handleMemoryGrow(Operand Opnd);
 
+  void handleMemoryInit(uint32_t DataSegIdx, Operand DestOffset,
+                        Operand SrcOffset, Operand Size);
+
+  void handleDataDrop(uint32_t DataSegIdx);
+
+  void handleMemoryCopy(Operand DestOffset, Operand SrcOffset, Operand Size);
+
+  void handleMemoryFill(Operand DestOffset, Operand Value, Operand Size);
+
   // ==================== Numeric Instruction Handlers ====================
 
   template <WASMType Ty>
@@ -466,6 +486,23 @@ public:
     return Operand(Ret, DestType);
   }
 
+  // No MIR opcode saturates, so call the same helper as the interpreter
+  template <WASMType DestType, WASMType SrcType, bool Sext>
+  Operand handleFloatToIntSat(Operand Opnd) {
+    using IntType = typename WASMTypeAttr<DestType>::Type;
+    using CIntType =
+        std::conditional_t<Sext, IntType, std::make_unsigned_t<IntType>>;
+    using CFloatType = typename WASMTypeAttr<SrcType>::Type;
+    MType *DestMType = Ctx.getMIRTypeFromWASMType(DestType);
+    MInstruction *FuncAddr = createIntConstInstruction(
+        &Ctx.I64Type,
+        uint64_t(&common::saturatingFloatToInt<CIntType, CFloatType>));
+    CompileVector<MInstruction *> Args{{extractOperand(Opnd)}, Ctx.MemPool};
+    MInstruction *Ret = createInstruction<ICallInstruction>(false, DestMType,
+                                                            FuncAddr, Args);
+    return Operand(makeReusableValue(Ret, DestMType), DestType);
+  }
+
   template <WASMType DestType, WASMType SrcType, bool Sext>
   Operand handleIntExtend(Operand Opnd) {
     MInstruction *OpndInstr = extractOperand(Opnd);
@@ -628,10 +665,8 @@ private:
                               NextBlock, BranchInst);
   }
 
-  template <typename CallInst, typename Callee>
-  Operand handleCallBase(Callee FuncInstr, const ArgumentInfo &ArgInfo,
-                         const std::vector<Operand> &Args,
-                         bool IsImportOrIndirect) {
+  CompileVector<MInstruction *>
+  createCallArgs(const std::vector<Operand> &Args) {
     // ensure the first argument is the instance pointer
     CompileVector<MInstruction *> MIRArgs(Args.size() + 1, Ctx.MemPool);
     MIRArgs[0] =
@@ -639,6 +674,14 @@ private:
     for (size_t I = 0, E = Args.size(); I < E; ++I) {
       MIRArgs[I + 1] = extractOperand(Args[I]);
     }
+    return MIRArgs;
+  }
+
+  template <typename CallInst, typename Callee>
+  Operand handleCallBase(Callee FuncInstr, const ArgumentInfo &ArgInfo,
+                         const std::vector<Operand> &Args,
+                         bool IsImportOrIndirect) {
+    CompileVector<MInstruction *> MIRArgs = createCallArgs(Args);
     WASMType Wtype = ArgInfo.getReturnType();
     MType *Mtype = Ctx.getMIRTypeFromWASMType(Wtype);
     /// There are only two forms of CallInstructions in MIR
@@ -672,6 +715,14 @@ private:
 
   void checkCallException(bool IsImportOrIndirect);
 
+  // Subtract the stack cost of the current function before leaving it
+  void releaseStackCost();
+
+  // Call a runtime helper which may set the instance exception, `Args`
+  // excludes the instance
+  void callRuntimeHelper(uintptr_t Func,
+                         std::initializer_list<MInstruction *> Args);
+
   // Assign feature values(from local.get/global.get/load/memory.size) to a
   // temp variable, considering that the corresponding set
   // instruction(local.set/global.set/store/memory.grow) may modify these
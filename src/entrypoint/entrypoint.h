@@ -17,6 +17,11 @@ void callNative(GenericFunctionPointer F, uint64_t *Args, uint64_t NumStackArgs,
                 bool SkipInstanceProcessing);
 void callNative_end();
 
+// Interpreter bridges jumped to by the thunks of the functions left to the
+// interpreter, see callNative_x86_64.S
+void callInterpFromJIT();
+void callInterpFromSinglepassJIT();
+
 typedef double (*Float64FuncPtr)(GenericFunctionPointer, uint64_t *, uint64_t,
                                  bool);
 typedef float (*Float32FuncPtr)(GenericFunctionPointer, uint64_t *, uint64_t,
@@ -84,29 +84,15 @@ static EVMAbiMockContext *getEVMAbiMockContext(Instance *instance) {
   return (EVMAbiMockContext *)CustomData;
 }
 
-static void getAddress(Instance *instance, int32_t ResultOffset) {
+static void getAddress(Instance *instance, HostBytes<20> Result) {
   static uint8_t MOCK_CUR_CONTRACt_ADDR[20] = {0x05};
-  if (!VALIDATE_APP_ADDR(ResultOffset, 20)) {
-    instance->setExceptionByHostapi(
-        getErrorWithExtraMessage(ErrorCode::EnvAbort, OUT_OF_BOUND_ERROR));
-    return;
-  }
-
-  uint8_t *NativeResult = (uint8_t *)ADDR_APP_TO_NATIVE(ResultOffset);
-  memcpy(NativeResult, MOCK_CUR_CONTRACt_ADDR, 20);
+  memcpy(Result.Ptr, MOCK_CUR_CONTRACt_ADDR, 20);
 }
 
 static int32_t getBlockHash(Instance *instance, int64_t BlockNum,
-                            int32_t ResultOffset) {
+                            HostBytes<32> Result) {
   static uint8_t MOCK_BLOCK_HASH[32] = {0x06};
-  if (!VALIDATE_APP_ADDR(ResultOffset, 32)) {
-    instance->setExceptionByHostapi(
-        getErrorWithExtraMessage(ErrorCode::EnvAbort, OUT_OF_BOUND_ERROR));
-    return -1;
-  }
-
-  uint8_t *NativeResult = (uint8_t *)ADDR_APP_TO_NATIVE(ResultOffset);
-  memcpy(NativeResult, MOCK_BLOCK_HASH, 32);
+  memcpy(Result.Ptr, MOCK_BLOCK_HASH, 32);
   return 0;
 }
 
@@ -115,41 +101,20 @@ static int32_t getCallDataSize(Instance *instance) {
   return 4;
 }
 
-static void getCaller(Instance *instance, int32_t ResultOffset) {
+static void getCaller(Instance *instance, HostBytes<20> Result) {
   static uint8_t MOCK_CALLER[20] = {0x04};
-  if (!VALIDATE_APP_ADDR(ResultOffset, 20)) {
-    instance->setExceptionByHostapi(
-        getErrorWithExtraMessage(ErrorCode::EnvAbort, OUT_OF_BOUND_ERROR));
-    return;
-  }
-
-  uint8_t *NativeResult = (uint8_t *)ADDR_APP_TO_NATIVE(ResultOffset);
-  memcpy(NativeResult, MOCK_CALLER, 20);
+  memcpy(Result.Ptr, MOCK_CALLER, 20);
 }
 
 // getCallValue(wasm_inst: *mut ZenInstanceExtern, ResultOffset: i32)
-static void getCallValue(Instance *instance, int32_t ResultOffset) {
-  if (!VALIDATE_APP_ADDR(ResultOffset, 32)) {
-    instance->setExceptionByHostapi(
-        getErrorWithExtraMessage(ErrorCode::EnvAbort, OUT_OF_BOUND_ERROR));
-    return;
-  }
-
-  uint8_t *NativeResult = (uint8_t *)ADDR_APP_TO_NATIVE(ResultOffset);
-  memset(NativeResult, 0x0, 32);
+static void getCallValue(Instance *instance, HostBytes<32> Result) {
+  memset(Result.Ptr, 0x0, 32);
 }
 
 // getChainId(wasm_inst: *mut ZenInstanceExtern, ResultOffset: i32)
-static void getChainId(Instance *instance, int32_t ResultOffset) {
+static void getChainId(Instance *instance, HostBytes<32> Result) {
   static uint8_t MOCK_CHAIN_ID[32] = {0x07};
-  if (!VALIDATE_APP_ADDR(ResultOffset, 32)) {
-    instance->setExceptionByHostapi(
-        getErrorWithExtraMessage(ErrorCode::EnvAbort, OUT_OF_BOUND_ERROR));
-    return;
-  }
-
-  uint8_t *NativeResult = (uint8_t *)ADDR_APP_TO_NATIVE(ResultOffset);
-  memcpy(NativeResult, MOCK_CHAIN_ID, 32);
+  memcpy(Result.Ptr, MOCK_CHAIN_ID, 32);
 }
 
 static void callDataCopy(Instance *instance, int32_t ResultOffset,
@@ -185,22 +150,15 @@ static int64_t getBlockGasLimit(Instance *instance) { return 1000000; }
 
 static int64_t getBlockNumber(Instance *instance) { return 12345; }
 
-static void getTxOrigin(Instance *instance, int32_t ResultOffset) {
+static void getTxOrigin(Instance *instance, HostBytes<20> Result) {
   static uint8_t MOCK_TX_ORIGIN[20] = {0x03};
-  if (!VALIDATE_APP_ADDR(ResultOffset, 20)) {
-    instance->setExceptionByHostapi(
-        getErrorWithExtraMessage(ErrorCode::EnvAbort, OUT_OF_BOUND_ERROR));
-    return;
-  }
-
-  uint8_t *NativeResult = (uint8_t *)ADDR_APP_TO_NATIVE(ResultOffset);
-  memcpy(NativeResult, MOCK_TX_ORIGIN, 20);
+  memcpy(Result.Ptr, MOCK_TX_ORIGIN, 20);
 }
 
 static int64_t getBlockTimestamp(Instance *instance) { return 1234567890L; }
 
-static void storageStore(Instance *instance, int32_t KeyBytesOffset,
-                         int32_t ValueBytesOffset) {
+static void storageStore(Instance *instance, HostBytes<32> KeyBytes,
+                         HostBytes<32> ValueBytes) {
   printf("storageStore hostapi called\n");
   auto EvmAbiMockCtx = getEVMAbiMockContext(instance);
   if (!EvmAbiMockCtx) {
@@ -208,20 +166,8 @@ static void storageStore(Instance *instance, int32_t KeyBytesOffset,
         ErrorCode::EnvAbort, EVM_ABI_CONTEXT_NOT_FOUND));
     return;
   }
-  if (!VALIDATE_APP_ADDR(KeyBytesOffset, 32)) {
-    instance->setExceptionByHostapi(
-        getErrorWithExtraMessage(ErrorCode::EnvAbort, OUT_OF_BOUND_ERROR));
-    return;
-  }
-  if (!VALIDATE_APP_ADDR(ValueBytesOffset, 32)) {
-    instance->setExceptionByHostapi(
-        getErrorWithExtraMessage(ErrorCode::EnvAbort, OUT_OF_BOUND_ERROR));
-    return;
-  }
-  const uint8_t *native_key_bytes32 =
-      (const uint8_t *)ADDR_APP_TO_NATIVE(KeyBytesOffset);
-  const uint8_t *native_value_bytes32 =
-      (const uint8_t *)ADDR_APP_TO_NATIVE(ValueBytesOffset);
+  const uint8_t *native_key_bytes32 = KeyBytes.Ptr;
+  const uint8_t *native_value_bytes32 = ValueBytes.Ptr;
   std::vector<uint8_t> native_value_bytes32_vec(native_value_bytes32,
                                                 native_value_bytes32 + 32);
   printf("storageStore key: %s, value: %s\n",
@@ -231,8 +177,8 @@ static void storageStore(Instance *instance, int32_t KeyBytesOffset,
                                      native_value_bytes32_vec);
 }
 
-static void storageLoad(Instance *instance, int32_t KeyBytesOffset,
-                        int32_t ResultOffset) {
+static void storageLoad(Instance *instance, HostBytes<32> KeyBytes,
+                        HostBytes<32> Result) {
   printf("storageLoad hostapi called\n");
   auto EvmAbiMockCtx = getEVMAbiMockContext(instance);
   if (!EvmAbiMockCtx) {
@@ -241,23 +187,9 @@ static void storageLoad(Instance *instance, int32_t KeyBytesOffset,
     return;
   }
 
-  if (!VALIDATE_APP_ADDR(KeyBytesOffset, 32)) {
-    instance->setExceptionByHostapi(
-        getErrorWithExtraMessage(ErrorCode::EnvAbort, OUT_OF_BOUND_ERROR));
-    return;
-  }
-  if (!VALIDATE_APP_ADDR(ResultOffset, 32)) {
-    instance->setExceptionByHostapi(
-        getErrorWithExtraMessage(ErrorCode::EnvAbort, OUT_OF_BOUND_ERROR));
-    return;
-  }
-  const uint8_t *native_key_bytes32 =
-      (const uint8_t *)ADDR_APP_TO_NATIVE(KeyBytesOffset);
   const auto &native_value_bytes32 = EvmAbiMockCtx->getCurContractStore(
-      zen::utils::toHex(native_key_bytes32, 32));
-
-  uint8_t *NativeResult = (uint8_t *)ADDR_APP_TO_NATIVE(ResultOffset);
-  memcpy(NativeResult, native_value_bytes32.data(), 32);
+      zen::utils::toHex(KeyBytes.Ptr, 32));
+  memcpy(Result.Ptr, native_value_bytes32.data(), 32);
 }
 
 static void emitLogEvent(Instance *instance, int32_t DataOffset, int32_t Length,
@@ -326,13 +258,9 @@ static void emitLogEvent(Instance *instance, int32_t DataOffset, int32_t Length,
   }
 }
 
-static void finish(Instance *instance, int32_t DataOffset, int32_t Length) {
-  if (!VALIDATE_APP_ADDR(DataOffset, Length)) {
-    instance->setExceptionByHostapi(
-        getErrorWithExtraMessage(ErrorCode::EnvAbort, OUT_OF_BOUND_ERROR));
-    return;
-  }
-  if (Length < 0 || Length > 1024) {
+static void finish(Instance *instance, HostBuffer Data) {
+  uint32_t Length = Data.Len;
+  if (Length > 1024) {
     instance->setExceptionByHostapi(
         getErrorWithExtraMessage(ErrorCode::EnvAbort, ""));
     return;
@@ -343,10 +271,7 @@ static void finish(Instance *instance, int32_t DataOffset, int32_t Length) {
     return;
   }
 
-  const uint8_t *native_data = (const uint8_t *)ADDR_APP_TO_NATIVE(DataOffset);
-  std::vector<uint8_t> finish_msg;
-  finish_msg.resize(Length);
-  memcpy((uint8_t *)finish_msg.data(), native_data, Length);
+  std::vector<uint8_t> finish_msg(Data.Ptr, Data.Ptr + Length);
   printf("evm finish with: %s\n",
          zen::utils::toHex(finish_msg.data(), finish_msg.size()).c_str());
   instance->setError(ErrorCode::InstanceExit);
@@ -358,22 +283,15 @@ static void invalid(Instance *instance) {
       getErrorWithExtraMessage(ErrorCode::EnvAbort, ""));
 }
 
-static void revert(Instance *instance, int32_t DataOffset, int32_t Length) {
-  if (!VALIDATE_APP_ADDR(DataOffset, Length)) {
-    instance->setExceptionByHostapi(
-        getErrorWithExtraMessage(ErrorCode::EnvAbort, OUT_OF_BOUND_ERROR));
-    return;
-  }
-  if (Length <= 0 || Length > 1024) {
+static void revert(Instance *instance, HostBuffer Data) {
+  uint32_t Length = Data.Len;
+  if (Length == 0 || Length > 1024) {
     instance->setExceptionByHostapi(
         getErrorWithExtraMessage(ErrorCode::EnvAbort, ""));
     return;
   }
 
-  const uint8_t *native_data = (const uint8_t *)ADDR_APP_TO_NATIVE(DataOffset);
-  std::vector<uint8_t> revert_msg;
-  revert_msg.resize(Length);
-  memcpy((uint8_t *)revert_msg.data(), native_data, Length);
+  std::vector<uint8_t> revert_msg(Data.Ptr, Data.Ptr + Length);
   printf("evm revert with: %s\n",
          zen::utils::toHex(revert_msg.data(), revert_msg.size()).c_str());
   instance->setExceptionByHostapi(
@@ -20,6 +20,23 @@ void munmap(void *Addr, size_t Len);
 
 void mprotect(void *Addr, size_t Len, int Prot);
 
+#ifndef ZEN_ENABLE_SGX
+// Map the same shared memory twice, once readable and executable to
+// `ExecAddr` and once readable and writable to `WriteAddr`. Returns false if
+// the platform doesn't allow it, nothing is mapped in that case
+bool mapDualView(size_t Len, void **ExecAddr, void **WriteAddr);
+
+constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+// Same as mmap except that the returned address is aligned to HugePageSize
+void *mmapHugePageAligned(size_t Len, int Prot, int Flags, int Fd,
+                          size_t Offset);
+
+// Advise the kernel to back the huge page aligned part of the range with
+// transparent huge pages. Returns false if not supported
+bool adviseHugePages(void *Addr, size_t Len);
+#endif
+
 struct FileMapInfo {
   void *Addr;
   size_t Length;
@@ -40,6 +40,104 @@ void mprotect(void *Addr, size_t Len, int Prot) {
   }
 }
 
+bool mapDualView([[maybe_unused]] size_t Len, [[maybe_unused]] void **ExecAddr,
+                 [[maybe_unused]] void **WriteAddr) {
+#if defined(ZEN_BUILD_PLATFORM_LINUX) && !defined(ZEN_ENABLE_OCCLUM)
+  unsigned int Flags = MFD_CLOEXEC;
+#ifdef MFD_EXEC
+  // Required to map the memfd as executable when vm.memfd_noexec is 1
+  Flags |= MFD_EXEC;
+#endif
+  int Fd = ::memfd_create("dtvm-code", Flags);
+#ifdef MFD_EXEC
+  if (Fd < 0 && errno == EINVAL) { // kernels before 6.3
+    Fd = ::memfd_create("dtvm-code", MFD_CLOEXEC);
+  }
+#endif
+  if (Fd < 0) {
+    ZEN_LOG_DEBUG("failed to create memfd due to '%s'", std::strerror(errno));
+    return false;
+  }
+  // The file is sparse, the pages are only committed when written
+  void *Exec = MAP_FAILED;
+  void *Write = MAP_FAILED;
+  if (::ftruncate(Fd, static_cast<off_t>(Len)) == 0) {
+    Exec = ::mmap(nullptr, Len, PROT_READ | PROT_EXEC, MAP_SHARED, Fd, 0);
+    Write = ::mmap(nullptr, Len, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+  }
+  int SavedErrno = errno;
+  // The mappings keep the memory alive
+  ::close(Fd);
+  if (Exec == MAP_FAILED || Write == MAP_FAILED) {
+    ZEN_LOG_DEBUG("failed to map memfd twice due to '%s'",
+                  std::strerror(SavedErrno));
+    if (Exec != MAP_FAILED) {
+      ::munmap(Exec, Len);
+    }
+    if (Write != MAP_FAILED) {
+      ::munmap(Write, Len);
+    }
+    return false;
+  }
+  *ExecAddr = Exec;
+  *WriteAddr = Write;
+  return true;
+#else
+  // Occlum and the other platforms forbid or lack shared executable memory
+  return false;
+#endif
+}
+
+void *mmapHugePageAligned(size_t Len, int Prot, int Flags, int Fd,
+                          size_t Offset) {
+  if (!Len) {
+    return nullptr;
+  }
+  // Reserve a huge page more, then map at the aligned address in it and
+  // release the rest
+  size_t ReserveLen = Len + HugePageSize;
+  uint8_t *Reserved = static_cast<uint8_t *>(
+      mmap(nullptr, ReserveLen, PROT_NONE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0));
+  if (Reserved == MAP_FAILED) {
+    return MAP_FAILED;
+  }
+  uint8_t *Aligned = reinterpret_cast<uint8_t *>(
+      ZEN_ALIGN(reinterpret_cast<uintptr_t>(Reserved), HugePageSize));
+  void *Ptr = mmap(Aligned, Len, Prot, Flags | MAP_FIXED, Fd, Offset);
+  if (Ptr == MAP_FAILED) {
+    munmap(Reserved, ReserveLen);
+    return MAP_FAILED;
+  }
+  ZEN_ASSERT(Ptr == Aligned);
+  if (Aligned != Reserved) {
+    munmap(Reserved, Aligned - Reserved);
+  }
+  if (Aligned + Len != Reserved + ReserveLen) {
+    munmap(Aligned + Len, Reserved + ReserveLen - (Aligned + Len));
+  }
+  return Ptr;
+}
+
+bool adviseHugePages([[maybe_unused]] void *Addr, [[maybe_unused]] size_t Len) {
+#ifdef MADV_HUGEPAGE
+  uintptr_t Start = ZEN_ALIGN(reinterpret_cast<uintptr_t>(Addr), HugePageSize);
+  uintptr_t End =
+      (reinterpret_cast<uintptr_t>(Addr) + Len) & ~(HugePageSize - 1);
+  if (Start >= End) {
+    return false;
+  }
+  if (::madvise(reinterpret_cast<void *>(Start), End - Start, MADV_HUGEPAGE) !=
+      0) {
+    ZEN_LOG_DEBUG("failed to madvise huge pages due to '%s'",
+                  std::strerror(errno));
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
 bool mapFile(FileMapInfo *Info, const char *Filename) {
   int Fd = ::open(Filename, O_RDWR);
   if (Fd < 0) {
@@ -61,12 +61,76 @@ CodeHolder::newRawDataCodeHolder(Runtime &RT, const void *Data, size_t Size) {
   return RawData;
 }
 
+#ifndef ZEN_ENABLE_SGX
+CodeHolderUniquePtr CodeHolder::newStreamingCodeHolder(Runtime &RT,
+                                                       size_t Size) {
+  if (Size > PresetMaxModuleSize) {
+    throw getError(ErrorCode::ModuleSizeTooLarge);
+  }
+
+  void *Buf = RT.allocate(sizeof(CodeHolder));
+  ZEN_ASSERT(Buf);
+
+  CodeHolderUniquePtr Stream(
+      new (Buf) CodeHolder(RT, HolderKind::kStreaming));
+
+  void *Data = RT.allocate(Size);
+  ZEN_ASSERT(Data);
+
+  Stream->Data = Data;
+  Stream->Size = Size;
+
+  return Stream;
+}
+
+bool CodeHolder::appendData(const void *Chunk, size_t ChunkSize) {
+  ZEN_ASSERT(Kind == HolderKind::kStreaming);
+  size_t Offset = AvailableSize.load(std::memory_order_relaxed);
+  if (Closed || ChunkSize > Size - Offset) {
+    return false;
+  }
+  // The consumer never reads beyond `AvailableSize`, so the copy needs no lock
+  std::memcpy(static_cast<uint8_t *>(const_cast<void *>(Data)) + Offset, Chunk,
+              ChunkSize);
+  {
+    LockGuard<Mutex> Lock(StreamMutex);
+    AvailableSize.store(Offset + ChunkSize, std::memory_order_release);
+  }
+  DataAvailableCV.notify_one();
+  return true;
+}
+
+void CodeHolder::closeStream() {
+  ZEN_ASSERT(Kind == HolderKind::kStreaming);
+  {
+    LockGuard<Mutex> Lock(StreamMutex);
+    Closed = true;
+  }
+  DataAvailableCV.notify_all();
+}
+
+void CodeHolder::waitForData(size_t Offset) const {
+  ZEN_ASSERT(Kind == HolderKind::kStreaming);
+  if (AvailableSize.load(std::memory_order_acquire) >= Offset) {
+    return;
+  }
+  UniqueLock<Mutex> Lock(StreamMutex);
+  DataAvailableCV.wait(Lock, [this, Offset] {
+    return AvailableSize.load(std::memory_order_acquire) >= Offset || Closed;
+  });
+  if (AvailableSize.load(std::memory_order_acquire) < Offset) {
+    throw getError(ErrorCode::UnexpectedEnd);
+  }
+}
+#endif // ZEN_ENABLE_SGX
+
 CodeHolder::~CodeHolder() {
   switch (Kind) {
   case HolderKind::kFile:
     releaseFileCodeHolder();
     break;
   case HolderKind::kRawData:
+  case HolderKind::kStreaming:
     releaseRawDataCodeHolder();
     break;
   default:
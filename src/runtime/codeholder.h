@@ -8,13 +8,18 @@
 #include "common/defines.h"
 #include "runtime/object.h"
 
+#ifndef ZEN_ENABLE_SGX
+#include <atomic>
+#include <condition_variable>
+#endif
+
 namespace zen::runtime {
 
 class CodeHolder : public RuntimeObject<CodeHolder> {
   friend class RuntimeObjectDestroyer;
 
 public:
-  enum class HolderKind { kFile, kRawData };
+  enum class HolderKind { kFile, kRawData, kStreaming };
 
   static CodeHolderUniquePtr newFileCodeHolder(Runtime &RT,
                                                const std::string &Filename);
@@ -22,6 +27,25 @@ public:
   static CodeHolderUniquePtr newRawDataCodeHolder(Runtime &RT, const void *Data,
                                                   size_t Size);
 
+#ifndef ZEN_ENABLE_SGX
+  /// Create a holder of `Size` bytes which are filled by `appendData` later.
+  /// The buffer is allocated up front so pointers into it stay valid while
+  /// the module is loaded from it.
+  static CodeHolderUniquePtr newStreamingCodeHolder(Runtime &RT, size_t Size);
+
+  /// \note thread safe, only one producer is allowed
+  /// \return false if the stream is closed or the data exceeds the total size
+  bool appendData(const void *Chunk, size_t ChunkSize);
+
+  /// Wake up the consumer and make it fail on missing bytes, called when the
+  /// producer stops early
+  void closeStream();
+
+  /// Block until the first `Offset` bytes are available
+  /// \throw UnexpectedEnd if the stream is closed before that
+  void waitForData(size_t Offset) const;
+#endif // ZEN_ENABLE_SGX
+
   HolderKind getKind() const { return Kind; }
 
   const void *getData() const { return Data; }
@@ -43,6 +67,14 @@ private:
   const void *Data = nullptr;
 
   size_t Size = 0;
+
+#ifndef ZEN_ENABLE_SGX
+  // Only used in streaming holder
+  std::atomic<size_t> AvailableSize = 0;
+  std::atomic<bool> Closed = false;
+  mutable common::Mutex StreamMutex;
+  mutable std::condition_variable DataAvailableCV;
+#endif // ZEN_ENABLE_SGX
 };
 
 } // namespace zen::runtime
@@ -6,6 +6,7 @@
 
 #include "common/defines.h"
 #include "utils/logging.h"
+#include <string>
 
 namespace zen::runtime {
 
@@ -24,6 +25,28 @@ struct RuntimeConfig {
   bool EnableStatistics = false;
   // Enable cpu instruction tracer hook
   bool EnableGdbTracingHook = false;
+  // Mask of `common::getIntrinsicMask` bits, the enabled "env" imports are
+  // implemented by the runtime instead of the host module. Off by default as
+  // they charge gas per byte like the bulk memory instructions.
+  uint32_t EnabledIntrinsics = 0;
+#ifndef ZEN_ENABLE_SGX
+  // Number of threads to validate function bodies of large modules(set 1 to
+  // validate them in the loading thread)
+  uint32_t NumValidationThreads = 4;
+  // Give each module its own code memory instead of the code heap shared by
+  // all modules of the runtime
+  bool DisableSharedCodeHeap = false;
+  // Advise transparent huge pages for the shared code heap
+  bool EnableHugePageCode = false;
+  // Advise transparent huge pages for the mmap-ed wasm memories
+  bool EnableHugePageMemory = false;
+#endif // ZEN_ENABLE_SGX
+#ifdef ZEN_ENABLE_LINUX_PERF
+  // Write JIT code symbols to /tmp/perf-<pid>.map for linux perf
+  bool EnablePerfMap = false;
+  // Write JIT code symbols and code to jit-<pid>.dump for perf inject
+  bool EnableJitDump = false;
+#endif // ZEN_ENABLE_LINUX_PERF
 #ifdef ZEN_ENABLE_MULTIPASS_JIT
   // Disable greedy register allocation of multipass JIT
   bool DisableMultipassGreedyRA = false;
@@ -31,8 +54,13 @@ struct RuntimeConfig {
   bool DisableMultipassMultithread = false;
   // Number of threads for multipass JIT if DisableMultipassMultithread is false
   uint32_t NumMultipassThreads = 8;
+  // Disable the call graph ordered function layout of eager multipass JIT
+  bool DisableMultipassFunctionLayout = false;
   // Enable multipass lazy mode(on request compile)
   bool EnableMultipassLazy = false;
+  // Directory of the profiles recording which functions ran in multipass lazy
+  // mode, used to order background compilation(empty to disable)
+  std::string MultipassProfileDir;
 #endif // ZEN_ENABLE_MULTIPASS_JIT
 
   bool validate() {
@@ -43,8 +71,24 @@ struct RuntimeConfig {
           "multipass multithread compiling disabled in gdb tracing mode");
       DisableMultipassMultithread = true;
     }
+    if (!MultipassProfileDir.empty() && !EnableMultipassLazy) {
+      ZEN_LOG_WARN("multipass profile is only used in multipass lazy mode");
+    }
 #endif // ZEN_ENABLE_MULTIPASS_JIT
 
+#ifndef ZEN_ENABLE_SGX
+    if (NumValidationThreads == 0) {
+      ZEN_LOG_FATAL("function body validation thread number is 0");
+      return false;
+    }
+    if (EnableHugePageCode && DisableSharedCodeHeap) {
+      ZEN_LOG_WARN("huge pages are only used by the shared code heap");
+    }
+    if (EnableHugePageMemory && DisableWasmMemoryMap) {
+      ZEN_LOG_WARN("huge pages are only used by mmap-ed wasm memories");
+    }
+#endif // ZEN_ENABLE_SGX
+
     switch (Mode) {
 #ifndef ZEN_ENABLE_SINGLEPASS_JIT
     case common::RunMode::SinglepassMode: {
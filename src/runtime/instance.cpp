@@ -4,12 +4,15 @@
 #include "runtime/instance.h"
 
 #include "action/instantiator.h"
+#include "action/interpreter.h"
 #include "common/enums.h"
 #include "common/errors.h"
 #include "common/traphandler.h"
 #include "entrypoint/entrypoint.h"
 #include "runtime/config.h"
 #include <algorithm>
+#include <cstring>
+#include <utility>
 
 namespace zen::runtime {
 
@@ -134,6 +137,9 @@ InstanceUniquePtr Instance::newInstance(Isolation &Iso, const Module &Mod,
 #endif // ZEN_ENABLE_JIT
 
   Inst->setGas(GasLimit);
+  Inst->GasMetered = GasLimit != 0 || Mod.getGasFuncIdx() != -1u;
+
+  Inst->MemAllocator = const_cast<Module &>(Mod).getMemoryAllocator();
 
   action::Instantiator Instantiator;
   Instantiator.instantiate(*Inst);
@@ -142,7 +148,6 @@ InstanceUniquePtr Instance::newInstance(Isolation &Iso, const Module &Mod,
 }
 
 Instance::~Instance() {
-  auto *MemAllocator = getWasmMemoryAllocator();
   for (uint32_t I = 0; I < NumTotalMemories; ++I) {
     if (Memories[I].MemBase) {
       MemAllocator->freeWasmMemory(Memories[I].getWasmMemoryData());
@@ -177,7 +182,8 @@ Instance::~Instance() {
 // ==================== Memory Accessing Methods ====================
 
 WasmMemoryAllocator *Instance::getWasmMemoryAllocator() {
-  return const_cast<Module *>(Mod)->getMemoryAllocator();
+  ZEN_ASSERT(MemAllocator);
+  return MemAllocator;
 }
 
 void Instance::protectMemory() {
@@ -223,8 +229,6 @@ bool Instance::growLinearMemory(uint32_t MemIdx, uint32_t GrowPagesDelta) {
     return false;
   }
 
-  auto *MemAllocator = getWasmMemoryAllocator();
-
   WasmMemoryData NewMemData = MemAllocator->enlargeWasmMemory(
       WasmMemoryData{
           .Type = Mem->Kind,
@@ -281,6 +285,163 @@ bool Instance::validatedNativeAddr(uint8_t *NativeAddr, uint32_t Size) {
   return Valid;
 }
 
+// ==================== Bulk Memory Methods ====================
+
+ErrorCode Instance::chargeBulkMemoryGas(uint32_t Size) {
+  if (!GasMetered) {
+    return ErrorCode::NoError;
+  }
+  uint64_t Cost = uint64_t(Size) * BulkMemoryGasPerByte;
+  if (Gas < Cost) {
+    Gas = 0;
+    return ErrorCode::GasLimitExceeded;
+  }
+  Gas -= Cost;
+  return ErrorCode::NoError;
+}
+
+ErrorCode Instance::copyLinearMemory(uint32_t DestOffset, uint32_t SrcOffset,
+                                     uint32_t Size) {
+  const MemoryInstance &Mem = getDefaultMemoryInst();
+  if (uint64_t(DestOffset) + Size > Mem.MemSize ||
+      uint64_t(SrcOffset) + Size > Mem.MemSize) {
+    return ErrorCode::OutOfBoundsMemory;
+  }
+  ErrorCode ErrCode = chargeBulkMemoryGas(Size);
+  if (ErrCode != ErrorCode::NoError || Size == 0) {
+    return ErrCode;
+  }
+  // The ranges may overlap. libc selects the fastest implementation for the
+  // CPU (e.g. rep movsb or AVX2 loops) after the single check above
+  std::memmove(Mem.MemBase + DestOffset, Mem.MemBase + SrcOffset, Size);
+  return ErrorCode::NoError;
+}
+
+ErrorCode Instance::fillLinearMemory(uint32_t DestOffset, uint8_t Value,
+                                     uint32_t Size) {
+  const MemoryInstance &Mem = getDefaultMemoryInst();
+  if (uint64_t(DestOffset) + Size > Mem.MemSize) {
+    return ErrorCode::OutOfBoundsMemory;
+  }
+  ErrorCode ErrCode = chargeBulkMemoryGas(Size);
+  if (ErrCode != ErrorCode::NoError || Size == 0) {
+    return ErrCode;
+  }
+  std::memset(Mem.MemBase + DestOffset, Value, Size);
+  return ErrorCode::NoError;
+}
+
+ErrorCode Instance::initLinearMemory(uint32_t DataSegIdx, uint32_t DestOffset,
+                                     uint32_t SrcOffset, uint32_t Size) {
+  ZEN_ASSERT(DataSegIdx < DroppedDataSegs.size());
+  const DataEntry *Seg = Mod->getDataEntry(DataSegIdx);
+  // A dropped segment behaves as an empty one
+  uint32_t SegSize = DroppedDataSegs[DataSegIdx] ? 0 : Seg->Size;
+  const MemoryInstance &Mem = getDefaultMemoryInst();
+  if (uint64_t(DestOffset) + Size > Mem.MemSize ||
+      uint64_t(SrcOffset) + Size > SegSize) {
+    return ErrorCode::OutOfBoundsMemory;
+  }
+  ErrorCode ErrCode = chargeBulkMemoryGas(Size);
+  if (ErrCode != ErrorCode::NoError || Size == 0) {
+    return ErrCode;
+  }
+  std::memcpy(Mem.MemBase + DestOffset,
+              Mod->getWASMBytecode() + Seg->Offset + SrcOffset, Size);
+  return ErrorCode::NoError;
+}
+
+ErrorCode Instance::callIntrinsic(IntrinsicKind Kind, const uint32_t *Args,
+                                  int32_t &Result) {
+  if (!hasMemory()) {
+    return ErrorCode::OutOfBoundsMemory;
+  }
+  const MemoryInstance &Mem = getDefaultMemoryInst();
+  switch (Kind) {
+  case IntrinsicKind::MEMCPY:
+  case IntrinsicKind::MEMMOVE:
+    // Overlapping memcpy is undefined in C, behave as memmove to keep it
+    // deterministic
+    Result = Args[0];
+    return copyLinearMemory(Args[0], Args[1], Args[2]);
+  case IntrinsicKind::MEMSET:
+    Result = Args[0];
+    return fillLinearMemory(Args[0], static_cast<uint8_t>(Args[1]), Args[2]);
+  case IntrinsicKind::MEMCMP: {
+    uint32_t Size = Args[2];
+    if (uint64_t(Args[0]) + Size > Mem.MemSize ||
+        uint64_t(Args[1]) + Size > Mem.MemSize) {
+      return ErrorCode::OutOfBoundsMemory;
+    }
+    ErrorCode ErrCode = chargeBulkMemoryGas(Size);
+    if (ErrCode != ErrorCode::NoError) {
+      return ErrCode;
+    }
+    const uint8_t *LHS = Mem.MemBase + Args[0];
+    const uint8_t *RHS = Mem.MemBase + Args[1];
+    Result = 0;
+    // Only the sign of std::memcmp is specified, return the difference of the
+    // first mismatched bytes as the wasm libc does
+    if (Size > 0 && std::memcmp(LHS, RHS, Size) != 0) {
+      auto [LHSEnd, RHSEnd] = std::mismatch(LHS, LHS + Size, RHS);
+      Result = int32_t(*LHSEnd) - int32_t(*RHSEnd);
+    }
+    return ErrorCode::NoError;
+  }
+  case IntrinsicKind::STRLEN: {
+    uint32_t Offset = Args[0];
+    if (Offset >= Mem.MemSize) {
+      return ErrorCode::OutOfBoundsMemory;
+    }
+    const uint8_t *Str = Mem.MemBase + Offset;
+    const void *Terminator = std::memchr(Str, 0, Mem.MemSize - Offset);
+    if (!Terminator) {
+      return ErrorCode::OutOfBoundsMemory;
+    }
+    uint32_t Length = static_cast<const uint8_t *>(Terminator) - Str;
+    Result = static_cast<int32_t>(Length);
+    return chargeBulkMemoryGas(Length);
+  }
+  default:
+    ZEN_UNREACHABLE();
+  }
+}
+
+namespace {
+
+template <size_t> using IntrinsicArg = uint32_t;
+
+template <IntrinsicKind Kind, typename IndicesT> struct IntrinsicEntry;
+
+template <IntrinsicKind Kind, size_t... Indices>
+struct IntrinsicEntry<Kind, std::index_sequence<Indices...>> {
+  static int32_t call(Instance *Inst, IntrinsicArg<Indices>... Args) {
+    const uint32_t ArgVals[] = {Args...};
+    int32_t Result = 0;
+    ErrorCode ErrCode = Inst->callIntrinsic(Kind, ArgVals, Result);
+    if (ErrCode != ErrorCode::NoError) {
+      Inst->setExceptionByHostapi(getError(ErrCode));
+    }
+    return Result;
+  }
+};
+
+} // namespace
+
+const void *Instance::getIntrinsicFuncPtr(IntrinsicKind Kind) {
+  switch (Kind) {
+#define DEFINE_INTRINSIC(NAME, FIELD, NUM_PARAMS)                              \
+  case IntrinsicKind::NAME:                                                    \
+    return reinterpret_cast<const void *>(                                     \
+        &IntrinsicEntry<IntrinsicKind::NAME,                                   \
+                        std::make_index_sequence<NUM_PARAMS>>::call);
+#include "common/intrinsics.def"
+#undef DEFINE_INTRINSIC
+  default:
+    ZEN_UNREACHABLE();
+  }
+}
+
 // ==================== Error/Exception Methods ====================
 
 void Instance::setExecutionError(const Error &NewErr, uint32_t IgnoredDepth,
@@ -296,7 +457,8 @@ void Instance::setExecutionError(const Error &NewErr, uint32_t IgnoredDepth,
 #ifdef ZEN_ENABLE_DUMP_CALL_STACK
   auto Mode = getRuntime()->getConfig().Mode;
   using common::RunMode;
-  if (Mode == RunMode::SinglepassMode || Mode == RunMode::MultipassMode) {
+  if ((Mode == RunMode::SinglepassMode || Mode == RunMode::MultipassMode) &&
+      !Mod->isInterpOnly()) {
     if (NumTraces == 0 &&
         !(NewErr.isEmpty() || NewErr.getCode() == ErrorCode::InstanceExit)) {
       // // jit trace need only set once
@@ -323,6 +485,104 @@ int32_t Instance::growInstanceMemoryOnJIT(Instance *Inst,
   return -1;
 }
 
+void Instance::copyMemoryOnJIT(Instance *Inst, uint32_t DestOffset,
+                               uint32_t SrcOffset, uint32_t Size) {
+  ErrorCode ErrCode = Inst->copyLinearMemory(DestOffset, SrcOffset, Size);
+  if (ErrCode != ErrorCode::NoError) {
+    setInstanceExceptionOnJIT(Inst, ErrCode);
+  }
+}
+
+void Instance::fillMemoryOnJIT(Instance *Inst, uint32_t DestOffset,
+                               uint32_t Value, uint32_t Size) {
+  ErrorCode ErrCode =
+      Inst->fillLinearMemory(DestOffset, static_cast<uint8_t>(Value), Size);
+  if (ErrCode != ErrorCode::NoError) {
+    setInstanceExceptionOnJIT(Inst, ErrCode);
+  }
+}
+
+void Instance::initMemoryOnJIT(Instance *Inst, uint32_t DataSegIdx,
+                               uint32_t DestOffset, uint32_t SrcOffset,
+                               uint32_t Size) {
+  ErrorCode ErrCode =
+      Inst->initLinearMemory(DataSegIdx, DestOffset, SrcOffset, Size);
+  if (ErrCode != ErrorCode::NoError) {
+    setInstanceExceptionOnJIT(Inst, ErrCode);
+  }
+}
+
+void Instance::dropDataSegmentOnJIT(Instance *Inst, uint32_t DataSegIdx) {
+  Inst->dropDataSegment(DataSegIdx);
+}
+
+Instance::InterpResultOnJIT
+Instance::callInterpOnJIT(Instance *Inst, uint32_t FuncIdx,
+                          const uint64_t *RegArgs, const uint64_t *StackArgs) {
+  constexpr uint32_t NumIntRegArgs = 5; // rdi holds the instance
+  constexpr uint32_t NumFloatRegArgs = 8;
+  InterpResultOnJIT Result = {0, 0};
+
+  // Destroy the values before the exception unwinds the native frames in CPU
+  // exception mode
+  {
+    // JIT code never calls functions passing v128 or multiple values
+    const TypeEntry *Type = Inst->Mod->getFunctionType(FuncIdx);
+    ZEN_ASSERT(Type->NumReturns <= 1);
+    const WASMType *ParamTypes = Type->getParamTypes();
+    std::vector<TypedValue> Args(Type->NumParams);
+    uint32_t NumIntArgs = 0;
+    uint32_t NumFloatArgs = 0;
+    uint32_t NumStackArgs = 0;
+    for (uint32_t I = 0; I < Type->NumParams; ++I) {
+      WASMType ParamType = ParamTypes[I];
+      ZEN_ASSERT(ParamType != WASMType::V128);
+      bool IsFloat = ParamType == WASMType::F32 || ParamType == WASMType::F64;
+      const uint64_t *Arg;
+      if (!IsFloat && NumIntArgs < NumIntRegArgs) {
+        Arg = RegArgs + NumIntArgs++;
+      } else if (IsFloat && NumFloatArgs < NumFloatRegArgs) {
+        Arg = RegArgs + NumIntRegArgs + NumFloatArgs++;
+      } else {
+        Arg = StackArgs + NumStackArgs++;
+      }
+      Args[I].Type = ParamType;
+      std::memcpy(&Args[I].Value, Arg, getWASMTypeSize(ParamType));
+    }
+
+    std::vector<TypedValue> Results(Type->NumReturns);
+    if (Type->NumReturns > 0) {
+      Results[0].Type = Type->getReturnType();
+    }
+
+    Runtime *RT = Inst->getRuntime();
+    RuntimeObjectUniquePtr<action::InterpStack> Stack =
+        std::move(Inst->InterpStackOnJIT);
+    if (!Stack) {
+      Stack = action::InterpStack::newInterpStack(*RT, PresetReservedStackSize);
+    }
+    Stack->Top = Stack->Bottom;
+    try {
+      RT->interpretWasmFunction(*Inst, FuncIdx, Args, Results, *Stack);
+      if (!Results.empty()) {
+        std::memcpy(&Result.Value, &Results[0].Value,
+                    getWASMTypeSize(Results[0].Type));
+      }
+    } catch (const Error &Err) {
+      Inst->setError(Err);
+      Result.Exception = 1;
+    }
+    Inst->InterpStackOnJIT = std::move(Stack);
+  }
+
+#ifdef ZEN_ENABLE_CPU_EXCEPTION
+  if (Result.Exception) {
+    throwInstanceExceptionOnJIT(Inst);
+  }
+#endif
+  return Result;
+}
+
 void Instance::setInstanceExceptionOnJIT(Instance *Inst,
                                          common::ErrorCode ErrCode) {
   Inst->setExecutionError(common::getError(ErrCode), 1,
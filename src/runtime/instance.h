@@ -26,6 +26,7 @@ namespace zen {
 
 namespace action {
 class Instantiator;
+class InterpStack;
 } // namespace action
 
 namespace singlepass {
@@ -53,11 +54,14 @@ struct FunctionInstance final {
   uint32_t MaxBlockDepth;
   uint32_t CodeSize;
 
-  FunctionKind Kind : 2;
-  uint8_t NumReturns : 2;
-  uint8_t NumReturnCells : 4;
-  WASMType ReturnTypes[2];
+  FunctionKind Kind;
+  uint16_t NumReturns;
+  uint16_t NumReturnCells;
 
+  union {
+    WASMType *ReturnTypes;
+    WASMType ReturnTypesVec[__WORDSIZE / 8];
+  };
   union {
     WASMType *ParamTypes;
     WASMType ParamTypesVec[__WORDSIZE / 8];
@@ -65,6 +69,7 @@ struct FunctionInstance final {
   TypeEntry *FuncType;
   WASMType *LocalTypes;
   uint32_t *LocalOffsets;
+  const uint32_t *BrTableTargets;
   const uint8_t *CodePtr;
 #ifdef ZEN_ENABLE_JIT
   const uint8_t *JITCodePtr;
@@ -74,6 +79,10 @@ struct FunctionInstance final {
     return NumParams > (__WORDSIZE / 8) ? ParamTypes : ParamTypesVec;
   }
 
+  WASMType *getReturnTypes() {
+    return NumReturns > (__WORDSIZE / 8) ? ReturnTypes : ReturnTypesVec;
+  }
+
   WASMType getLocalType(uint32_t LocalIdx) {
     ZEN_ASSERT(LocalIdx < (NumParams + NumLocals));
     if (LocalIdx < NumParams) {
@@ -111,7 +120,8 @@ struct GlobalInstance final {
   uint32_t Offset;
 };
 
-/// \warning: not support multi-threading
+/// \warning: an instance must only be used by the thread that created it,
+/// other threads may run other instances of the same module concurrently
 class Instance final : public RuntimeObject<Instance> {
   using Error = common::Error;
   using ErrorCode = common::ErrorCode;
@@ -173,6 +183,30 @@ public:
   bool __attribute__((noinline))
   validatedNativeAddr(uint8_t *NativeAddr, uint32_t Size);
 
+  // ==================== Bulk Memory Methods ====================
+
+  // Shared by all execution modes. The whole range is checked once, then
+  // `BulkMemoryGasPerByte` is charged for each byte if the instance is metered
+  // before the bytes are moved. Return the trap code or ErrorCode::NoError
+  ErrorCode copyLinearMemory(uint32_t DestOffset, uint32_t SrcOffset,
+                             uint32_t Size);
+  ErrorCode fillLinearMemory(uint32_t DestOffset, uint8_t Value, uint32_t Size);
+  ErrorCode initLinearMemory(uint32_t DataSegIdx, uint32_t DestOffset,
+                             uint32_t SrcOffset, uint32_t Size);
+
+  // Execute the intrinsic with the i32 parameters listed in
+  // "common/intrinsics.def", following the same rules
+  ErrorCode callIntrinsic(common::IntrinsicKind Kind, const uint32_t *Args,
+                          int32_t &Result);
+
+  // Host function ABI entry of the intrinsic, bound to the import
+  static const void *getIntrinsicFuncPtr(common::IntrinsicKind Kind);
+
+  void dropDataSegment(uint32_t DataSegIdx) {
+    ZEN_ASSERT(DataSegIdx < DroppedDataSegs.size());
+    DroppedDataSegs[DataSegIdx] = true;
+  }
+
   // ==================== Global Accessing Methods ====================
 
   uint8_t *getGlobalAddr(uint32_t GlobalIdx) {
@@ -224,6 +258,30 @@ public:
   static int32_t growInstanceMemoryOnJIT(Instance *Inst,
                                          uint32_t GrowPagesDelta);
 
+  // Bulk memory helpers called by JIT code, which set the instance exception
+  // on traps
+  static void copyMemoryOnJIT(Instance *Inst, uint32_t DestOffset,
+                              uint32_t SrcOffset, uint32_t Size);
+  static void fillMemoryOnJIT(Instance *Inst, uint32_t DestOffset,
+                              uint32_t Value, uint32_t Size);
+  static void initMemoryOnJIT(Instance *Inst, uint32_t DataSegIdx,
+                              uint32_t DestOffset, uint32_t SrcOffset,
+                              uint32_t Size);
+  static void dropDataSegmentOnJIT(Instance *Inst, uint32_t DataSegIdx);
+
+  // Returned in rax and rdx to the interpreter bridge
+  struct InterpResultOnJIT {
+    uint64_t Value;
+    uint64_t Exception;
+  };
+
+  // Called through the interpreter bridge by JIT code calling a function left
+  // to the interpreter. `RegArgs` holds rsi, rdx, rcx, r8, r9 and the low
+  // halves of xmm0-xmm7 of the call, `StackArgs` the arguments on the stack.
+  static InterpResultOnJIT callInterpOnJIT(Instance *Inst, uint32_t FuncIdx,
+                                           const uint64_t *RegArgs,
+                                           const uint64_t *StackArgs);
+
   void setJITStackSize(uint64_t NewStackSize) { JITStackSize = NewStackSize; }
 
   static void __attribute__((noinline))
@@ -260,6 +318,10 @@ public:
   uint64_t getGas() const { return Gas; }
   void setGas(uint64_t NewGas) { Gas = NewGas; }
 
+  // Instances created with a gas limit or of a module with the gas function
+  // are metered, which also charges the bulk memory operations
+  bool isGasMetered() const { return GasMetered; }
+
   void *getCustomData() { return CustomData; }
   void setCustomData(void *NewCustomData) { CustomData = NewCustomData; }
 
@@ -305,6 +367,8 @@ private:
 
   void protectMemory();
 
+  ErrorCode chargeBulkMemoryGas(uint32_t Size);
+
   Isolation *Iso = nullptr;
   const Module *Mod = nullptr;
 
@@ -329,6 +393,7 @@ private:
   Error Err = ErrorCode::NoError;
 
   uint64_t Gas = 0;
+  bool GasMetered = false;
 
   // exit code set by Instance.exit(ExitCode)
   int32_t InstanceExitCode = 0;
@@ -358,10 +423,23 @@ private:
 
   bool DataSegsInited = false;
 
+  // Indexed by data segment, active segments are dropped after instantiation
+  std::vector<bool> DroppedDataSegs;
+
+  // The memory allocator of the creating thread, looked up once instead of on
+  // every call
+  WasmMemoryAllocator *MemAllocator = nullptr;
+
 #ifdef ZEN_ENABLE_VIRTUAL_STACK
   // one instance maybe called by hostapi( instanceA -> hostapi -> instanceA )
   std::queue<utils::VirtualStackInfo *> VirtualStacks;
 #endif
+
+#ifdef ZEN_ENABLE_JIT
+  // Reused by the calls of JIT code to the functions left to the interpreter,
+  // taken while in use in case a host function calls back into the instance
+  RuntimeObjectUniquePtr<action::InterpStack> InterpStackOnJIT;
+#endif
 };
 
 } // namespace runtime
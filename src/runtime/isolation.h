@@ -30,6 +30,8 @@ class Isolation : public RuntimeObject<Isolation> {
 public:
   static IsolationUniquePtr newIsolation(Runtime &RT) noexcept;
 
+  // A non-zero `GasLimit` enables gas metering for the instance, modules
+  // with the gas function are always metered
   common::MayBe<Instance *> createInstance(Module &Mod,
                                            uint64_t GasLimit = 0) noexcept;
 
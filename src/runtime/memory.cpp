@@ -3,6 +3,7 @@
 
 #include "runtime/memory.h"
 #include "common/enums.h"
+#include "platform/map.h"
 #include "runtime/module.h"
 #include "utils/logging.h"
 #include "utils/others.h"
@@ -36,6 +37,9 @@ static bool verifyCanUseMmapBucketByModuleDataSegments(Module *Mod) {
   }
   for (size_t I = 0; I < Mod->getNumDataSegments(); I++) {
     auto *Seg = Mod->getDataEntry(I);
+    if (Seg->Passive) {
+      continue;
+    }
     if (Seg->MemIdx != 0) {
       return false;
     }
@@ -67,6 +71,7 @@ WasmMemoryAllocator::WasmMemoryAllocator(
 #ifdef ZEN_ENABLE_CPU_EXCEPTION
     UseMmap = true;
 #endif // ZEN_ENABLE_CPU_EXCEPTION
+    UseHugePages = UseMmap && CurRuntime->getConfig().EnableHugePageMemory;
     bool UseMmapBucket = UseMmap;
     // if wasm module data segments has init-expr which not use i32/i64,
     // then not use mmap
@@ -132,7 +137,7 @@ WasmMemoryAllocator::WasmMemoryAllocator(
 
         for (size_t I = 0; I < Mod->getNumDataSegments(); I++) {
           auto *Seg = Mod->getDataEntry(I);
-          if (Seg->MemIdx != 0) {
+          if (Seg->Passive || Seg->MemIdx != 0) {
             continue;
           }
           int64_t BaseOffset = 0;
@@ -225,9 +230,8 @@ WasmMemoryBucketSlice WasmMemoryAllocator::getOrCreateMmapSpace(
       size_t MmapSize = WasmMemoryAllocatorMmapSize;
       ZEN_ASSERT(sizeof(size_t) > 4);
 
-      auto BucketMemAddr =
-          (uint8_t *)::mmap(nullptr, MmapSize, PROT_NONE,
-                            MAP_FILE | MAP_PRIVATE, MmapMemoryInitFd, 0);
+      auto BucketMemAddr = mmapMemorySpace(MmapSize, MAP_FILE | MAP_PRIVATE,
+                                           MmapMemoryInitFd);
       if (!BucketMemAddr || (BucketMemAddr == (uint8_t *)-1)) {
         ZEN_ABORT();
       }
@@ -325,6 +329,22 @@ void WasmMemoryAllocator::mprotectReadWriteWasmMemoryData(
   }
 }
 
+uint8_t *WasmMemoryAllocator::mmapMemorySpace(size_t MmapSize, int Flags,
+                                              int Fd) {
+  if (!UseHugePages) {
+    return (uint8_t *)::mmap(nullptr, MmapSize, PROT_NONE, Flags, Fd, 0);
+  }
+  // align the space to huge pages, the bucket items are multiples of
+  // huge pages, so every linear memory in the space starts aligned too
+  auto *Addr = (uint8_t *)platform::mmapHugePageAligned(MmapSize, PROT_NONE,
+                                                         Flags, Fd, 0);
+  if (Addr != (uint8_t *)MAP_FAILED &&
+      !platform::adviseHugePages(Addr, MmapSize)) {
+    ZEN_LOG_WARN("transparent huge pages not supported for wasm memory");
+  }
+  return Addr;
+}
+
 // allocate linear memory space when not use mmap-bucket
 WasmMemoryData WasmMemoryAllocator::allocateNonBucketMemory(size_t MemorySize) {
   if (UseMmap) {
@@ -333,9 +353,8 @@ WasmMemoryData WasmMemoryAllocator::allocateNonBucketMemory(size_t MemorySize) {
     size_t MmapSize = WasmMemoryAllocatorMmapSize;
     ZEN_ASSERT(sizeof(size_t) > 4);
 
-    auto *MemoryData =
-        (uint8_t *)::mmap(nullptr, MmapSize, PROT_NONE,
-                          MAP_ANONYMOUS | MAP_FILE | MAP_PRIVATE, -1, 0);
+    auto *MemoryData = mmapMemorySpace(
+        MmapSize, MAP_ANONYMOUS | MAP_FILE | MAP_PRIVATE, -1);
     if (!MemoryData || (MemoryData == (uint8_t *)-1)) {
       ZEN_ABORT();
     }
@@ -368,9 +387,8 @@ WasmMemoryData WasmMemoryAllocator::reallocateNonBucketMemoryAndFillZerosToNew(
     // then all linear memories should allocated by mmap
     size_t MmapSize = WasmMemoryAllocatorMmapSize;
     ZEN_ASSERT(sizeof(size_t) > 4);
-    auto *NewMemoryData =
-        (uint8_t *)::mmap(nullptr, MmapSize, PROT_NONE,
-                          MAP_ANONYMOUS | MAP_FILE | MAP_PRIVATE, -1, 0);
+    auto *NewMemoryData = mmapMemorySpace(
+        MmapSize, MAP_ANONYMOUS | MAP_FILE | MAP_PRIVATE, -1);
     if (!NewMemoryData || (NewMemoryData == (uint8_t *)-1)) {
       ZEN_ABORT();
     }
@@ -119,6 +119,8 @@ private:
   WasmMemoryDataType DefaultMemoryType;
 
   bool UseMmap = false;
+  // advise transparent huge pages for the mmap-ed spaces
+  bool UseHugePages = false;
   size_t MmapMemoryInitFileSize = 0;
   // the bucket contains init-size + grow-max-size(zeros)
   // when grow to not larger then it, just inc the size.
@@ -151,6 +153,9 @@ private:
 
   void internalFreeWasmMemory(const WasmMemoryData &Data);
 
+  // reserve the PROT_NONE space of a linear memory or a bucket
+  uint8_t *mmapMemorySpace(size_t MmapSize, int Flags, int Fd);
+
   WasmMemoryBucketSlice getOrCreateMmapSpace(
       const uint8_t
           *BucketAllocSand, // sand to alloc bucket. eg. MemoryInstance*
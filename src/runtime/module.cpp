@@ -17,6 +17,9 @@
 #ifdef ZEN_ENABLE_MULTIPASS_JIT
 #include "compiler/compiler.h"
 #endif
+#ifdef ZEN_ENABLE_LINUX_PERF
+#include "utils/perf.h"
+#endif
 
 extern struct VNMInterface_ *vnmi_functions();
 
@@ -112,7 +115,7 @@ bool TypeEntry::isEqual(TypeEntry *Type1, TypeEntry *Type2) {
   }
   if (std::memcmp(Type1->getParamTypes(), Type2->getParamTypes(),
                   sizeof(WASMType) * Type1->NumParams) ||
-      std::memcmp(Type1->ReturnTypes, Type2->ReturnTypes,
+      std::memcmp(Type1->getReturnTypes(), Type2->getReturnTypes(),
                   sizeof(WASMType) * Type1->NumReturns)) {
     return false;
   }
@@ -130,7 +133,13 @@ Module::InstanceLayout::getGlobalTypeAndOffset(uint32_t GlobalIdx) const {
   };
 }
 
-Module::Module(Runtime *RT) : BaseModule(RT, ModuleType::WASM), Layout(*this) {
+Module::Module(Runtime *RT)
+    : BaseModule(RT, ModuleType::WASM), Layout(*this)
+#if defined(ZEN_ENABLE_JIT) && !defined(ZEN_ENABLE_SGX)
+      ,
+      JITCodeMemPool(RT->getJITCodeHeap())
+#endif
+{
   // when not SGX and the memory init size not too small, set use_mmap =
   // true
   MemAllocOptions.UseMmap = false;
@@ -156,6 +165,13 @@ Module::~Module() {
   }
 #endif
 
+#if defined(ZEN_ENABLE_JIT) && defined(ZEN_ENABLE_LINUX_PERF)
+  // The code pool is released with the module, its symbols are stale now
+  JITCodeMemPool.forEachCodeRange([](const uint8_t *Start, const uint8_t *End) {
+    PerfSymbolRegistry::getInstance().releaseCodeRegion(Start, End);
+  });
+#endif
+
   destroyTypeTable();
   destroyImportTables();
   destroyFunctionTable();
@@ -177,7 +193,8 @@ void Module::releaseMemoryAllocatorCache() {
   }
 }
 
-ModuleUniquePtr Module::newModule(Runtime &RT, CodeHolderUniquePtr CodeHolder,
+ModuleUniquePtr Module::newModule(Runtime &RT,
+                                  CodeHolderUniquePtr &&CodeHolder,
                                   const std::string &EntryHint) {
   void *ObjBuf = RT.allocate(sizeof(Module));
   ZEN_ASSERT(ObjBuf);
@@ -193,6 +210,18 @@ ModuleUniquePtr Module::newModule(Runtime &RT, CodeHolderUniquePtr CodeHolder,
                               static_cast<const Byte *>(CodeHolder->getData()),
                               CodeHolder->getSize());
 
+#ifndef ZEN_ENABLE_SGX
+  // Must be destroyed before the module because its threads use the module
+  std::unique_ptr<action::StreamingJITCompiler> StreamingCompiler;
+  if (CodeHolder->getKind() == CodeHolder::HolderKind::kStreaming) {
+    Loader.setStreamingSource(CodeHolder.get());
+    if (action::StreamingJITCompiler::isSupported(*Mod)) {
+      StreamingCompiler = std::make_unique<action::StreamingJITCompiler>(*Mod);
+      Loader.setFunctionLoadListener(StreamingCompiler.get());
+    }
+  }
+#endif
+
   auto &Stats = RT.getStatistics();
   auto Timer = Stats.startRecord(utils::StatisticPhase::Load);
 
@@ -200,11 +229,22 @@ ModuleUniquePtr Module::newModule(Runtime &RT, CodeHolderUniquePtr CodeHolder,
 
   Stats.stopRecord(Timer);
 
+  bool CompiledWhileLoading = false;
+#ifndef ZEN_ENABLE_SGX
+  if (StreamingCompiler) {
+    // Functions are compiled during loading, wait for them before recomputing
+    // the layout they read
+    StreamingCompiler->finish();
+    CompiledWhileLoading = true;
+  }
+#endif
+
   Mod->Layout.compute();
 
   Mod->CodeHolder = std::move(CodeHolder);
 
-  if (Mod->NumInternalFunctions > 0) {
+  if (Mod->NumInternalFunctions > 0 && !CompiledWhileLoading &&
+      !Mod->isInterpOnly()) {
     action::performJITCompile(*Mod);
   }
 
@@ -227,6 +267,8 @@ const uint8_t *Module::getWASMBytecode() const {
   return static_cast<const uint8_t *>(CodeHolder->getData());
 }
 
+size_t Module::getWASMBytecodeSize() const { return CodeHolder->getSize(); }
+
 // ==================== Segment Accessing Methods ====================
 
 uint32_t Module::getFunctionTypeIdx(uint32_t FuncIdx) const {
@@ -251,6 +293,14 @@ CodeEntry *Module::getCodeEntry(uint32_t FuncIdx) const {
   return CodeTable + InternalFuncIdx;
 }
 
+bool Module::isInterpOnlyFunction(uint32_t FuncIdx) const {
+  const CodeEntry *Func = getCodeEntry(FuncIdx);
+  if (!Func) {
+    return false;
+  }
+  return isInterpOnly() || (Func->Stats & (SF_simd | SF_multi_value));
+}
+
 bool Module::getExportFunc(WASMSymbol Name, uint32_t &FuncIdx) const noexcept {
   // perhaps use a hashmap instead if there are too much export functions.
   for (uint32_t I = 0; I < NumExports; ++I) {
@@ -277,11 +327,14 @@ bool Module::getExportFunc(const std::string &Name,
 
 WasmMemoryAllocator *Module::getMemoryAllocator() {
   auto ThreadId = utils::getThreadLocalUniqueId();
-  if (!ThreadLocalMemAllocatorMap->containsKey(ThreadId)) {
-    ThreadLocalMemAllocatorMap->put(
-        ThreadId, new WasmMemoryAllocator(this, &MemAllocOptions));
+  // Only the current thread inserts its own key
+  if (WasmMemoryAllocator *Allocator =
+          ThreadLocalMemAllocatorMap->get(ThreadId)) {
+    return Allocator;
   }
-  return ThreadLocalMemAllocatorMap->get(ThreadId);
+  auto *Allocator = new WasmMemoryAllocator(this, &MemAllocOptions);
+  ThreadLocalMemAllocatorMap->put(ThreadId, Allocator);
+  return Allocator;
 }
 
 // ==================== Destroy Table Methods ====================
@@ -291,6 +344,10 @@ void Module::destroyTypeTable() {
     if (TypeTable[I].NumParams > (__WORDSIZE / 8) && TypeTable[I].ParamTypes) {
       deallocate(TypeTable[I].ParamTypes);
     }
+    if (TypeTable[I].NumReturns > (__WORDSIZE / 8) &&
+        TypeTable[I].ReturnTypes) {
+      deallocate(TypeTable[I].ReturnTypes);
+    }
   }
   deallocate(TypeTable);
 }
@@ -349,6 +406,9 @@ void Module::destroyCodeTable() {
     if (CodeTable[I].LocalOffsets) {
       deallocate(CodeTable[I].LocalOffsets);
     }
+    if (CodeTable[I].BrTableTargets) {
+      deallocate(CodeTable[I].BrTableTargets);
+    }
   }
   deallocate(CodeTable);
 }
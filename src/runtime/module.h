@@ -5,6 +5,7 @@
 #define ZEN_RUNTIME_MODULE_H
 
 #include "common/const_string_pool.h"
+#include "common/enums.h"
 #include "common/errors.h"
 #include "runtime/memory.h"
 #include "runtime/object.h"
@@ -124,9 +125,12 @@ private:
 struct TypeEntry final {
   uint16_t NumParams;
   uint16_t NumParamCells;
-  uint8_t NumReturns : 2;
-  uint8_t NumReturnCells : 6;
-  WASMType ReturnTypes[2];
+  uint16_t NumReturns;
+  uint16_t NumReturnCells;
+  union {
+    WASMType *ReturnTypes;
+    WASMType ReturnTypesVec[__WORDSIZE / 8];
+  };
   union {
     WASMType *ParamTypes;
     WASMType ParamTypesVec[__WORDSIZE / 8];
@@ -140,9 +144,16 @@ struct TypeEntry final {
     return ParamTypesVec;
   }
 
+  const WASMType *getReturnTypes() const {
+    if (NumReturns > (__WORDSIZE / 8)) {
+      return ReturnTypes;
+    }
+    return ReturnTypesVec;
+  }
+
   WASMType getReturnType() const {
     ZEN_ASSERT(NumReturns <= 1);
-    return NumReturns > 0 ? ReturnTypes[0] : WASMType::VOID;
+    return NumReturns > 0 ? ReturnTypesVec[0] : WASMType::VOID;
   }
 
   static bool isEqual(TypeEntry *Type1, TypeEntry *Type2);
@@ -156,11 +167,15 @@ struct ImportEntryBase {
 struct ImportFunctionEntry final : ImportEntryBase {
   uint32_t TypeIdx;
   const void *FuncPtr;
+  // FuncPtr is the runtime implementation if it isn't IntrinsicKind::NONE
+  common::IntrinsicKind Intrinsic;
   /// \note constructor is required to initialize under C++14
-  ImportFunctionEntry(WASMSymbol ModuleName, WASMSymbol FieldName,
-                      uint32_t TypeIdx, const void *FuncPtr)
+  ImportFunctionEntry(
+      WASMSymbol ModuleName, WASMSymbol FieldName, uint32_t TypeIdx,
+      const void *FuncPtr,
+      common::IntrinsicKind Intrinsic = common::IntrinsicKind::NONE)
       : ImportEntryBase{ModuleName, FieldName}, TypeIdx(TypeIdx),
-        FuncPtr(FuncPtr) {}
+        FuncPtr(FuncPtr), Intrinsic(Intrinsic) {}
 };
 
 struct ImportTableEntry final : ImportEntryBase {
@@ -252,6 +267,9 @@ struct CodeEntry {
   uint16_t NumLocalCells;
   WASMType *LocalTypes;
   uint32_t *LocalOffsets;
+  // Targets of the br_tables rewritten to BR_TABLE_DECODED, see
+  // utils::MinDecodedBrTableTargets
+  uint32_t *BrTableTargets;
   uint32_t Stats;
   // indicate the approximate offset of current function in wasm bytecode
   uint32_t CodeOffset;
@@ -266,6 +284,9 @@ struct DataEntry {
   uint32_t Offset;
   uint8_t InitExprKind;
   InitExpr InitExprVal;
+  // Passive segments are only copied into the memory by memory.init, the
+  // memory index and init expression are unused
+  bool Passive;
 };
 
 class Module final : public BaseModule<Module> {
@@ -336,12 +357,17 @@ class Module final : public BaseModule<Module> {
 public:
   enum StatsFlags : uint32_t {
     SF_none = 0,
-    SF_global = 1 << 0, // Access global variables
-    SF_memory = 1 << 1, // Access linear memory
-    SF_table = 1 << 2,  // Access table
+    SF_global = 1 << 0,      // Access global variables
+    SF_memory = 1 << 1,      // Access linear memory
+    SF_table = 1 << 2,       // Access table
+    SF_simd = 1 << 3,        // Use v128 values
+    SF_multi_value = 1 << 4, // Use multiple results or type index blocks
   };
 
-  static ModuleUniquePtr newModule(Runtime &RT, CodeHolderUniquePtr CodeHolder,
+  /// \note `CodeHolder` is only taken over on success, so a streaming holder
+  /// stays valid for its producer when loading fails
+  static ModuleUniquePtr newModule(Runtime &RT,
+                                   CodeHolderUniquePtr &&CodeHolder,
                                    const std::string &EntryHint = "");
 
   void releaseMemoryAllocatorCache();
@@ -350,6 +376,8 @@ public:
 
   const uint8_t *getWASMBytecode() const;
 
+  size_t getWASMBytecodeSize() const;
+
   // ==================== Number Methods ====================
 
   uint32_t getNumImportFunctions() const { return NumImportFunctions; }
@@ -416,6 +444,13 @@ public:
     return ImportFunctionTable[FuncIdx];
   }
 
+  // Returns IntrinsicKind::NONE for internal functions
+  common::IntrinsicKind getIntrinsicKind(uint32_t FuncIdx) const {
+    return FuncIdx < NumImportFunctions
+               ? ImportFunctionTable[FuncIdx].Intrinsic
+               : common::IntrinsicKind::NONE;
+  }
+
   const FuncEntry &getInternalFunction(uint32_t InternalFuncIdx) const {
     ZEN_ASSERT(InternalFuncIdx < NumInternalFunctions);
     return InternalFunctionTable[InternalFuncIdx];
@@ -469,6 +504,26 @@ public:
 
   uint32_t getGasFuncIdx() const { return GasFuncIdx; }
 
+  // The JIT compilers don't lower v128 yet, so functions using v128 values are
+  // always executed by the interpreter, whatever the run mode is
+  bool usesSIMD() const { return UsesSIMD; }
+
+  // The JIT compilers return at most one value and only support single value
+  // block types, so such functions are also executed by the interpreter
+  bool usesMultiValue() const { return UsesMultiValue; }
+
+  // On x86-64, JIT code calls the functions left to the interpreter through
+  // the interpreter bridge. Elsewhere the whole module is interpreted.
+  bool isInterpOnly() const {
+#ifdef ZEN_BUILD_TARGET_X86_64
+    return false;
+#else
+    return UsesSIMD || UsesMultiValue;
+#endif
+  }
+
+  bool isInterpOnlyFunction(uint32_t FuncIdx) const;
+
   WasmMemoryAllocator *getMemoryAllocator();
 
   bool checkUseSoftLinearMemoryCheck() const {
@@ -582,6 +637,10 @@ private:
     return N > 0 ? (WASMType *)allocate(sizeof(WASMType) * N) : nullptr;
   }
 
+  WASMType *initReturnTypes(uint32_t N) {
+    return N > 0 ? (WASMType *)allocate(sizeof(WASMType) * N) : nullptr;
+  }
+
   WASMType *initLocalTypes(uint32_t N) {
     return N > 0 ? (WASMType *)allocate(sizeof(WASMType) * N) : nullptr;
   }
@@ -682,6 +741,9 @@ private:
 
   uint32_t GasFuncIdx = -1u;
 
+  bool UsesSIMD = false;
+  bool UsesMultiValue = false;
+
   WasmMemoryAllocatorOptions MemAllocOptions;
 
   // thread_id => WasmMemoryAllocator*
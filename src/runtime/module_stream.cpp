@@ -0,0 +1,62 @@
+// Copyright (C) 2021-2023 the DTVM authors. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "runtime/module_stream.h"
+
+namespace zen::runtime {
+
+using namespace common;
+
+ModuleStream::ModuleStream(Runtime &RT, WASMSymbol Name,
+                           CodeHolderUniquePtr Code,
+                           const std::string &EntryHint)
+    : RT(RT), Name(Name), Code(std::move(Code)), Stream(this->Code.get()),
+      LoadErr(ErrorCode::NoError) {
+  LoaderThread = std::thread([this, EntryHint] { runLoader(EntryHint); });
+}
+
+ModuleStream::~ModuleStream() {
+  if (LoaderThread.joinable()) {
+    // Abandoned stream, make the loader fail on the missing bytes
+    Stream->closeStream();
+    LoaderThread.join();
+    RT.getStatistics().clearAllTimers();
+    RT.freeSymbol(Name);
+  }
+}
+
+void ModuleStream::runLoader(const std::string &EntryHint) noexcept {
+  try {
+    // `Code` is only taken over by the module on success, so `append` can be
+    // called safely until the stream is closed
+    Mod = Module::newModule(RT, std::move(Code), EntryHint);
+  } catch (const Error &Err) {
+    LoadErr = Err;
+    // Reject further chunks
+    Stream->closeStream();
+  }
+}
+
+bool ModuleStream::append(const void *Data, size_t Size) noexcept {
+  if (!LoaderThread.joinable() || !Data) {
+    return false;
+  }
+  return Stream->appendData(Data, Size);
+}
+
+MayBe<Module *> ModuleStream::finish() noexcept {
+  if (!LoaderThread.joinable()) {
+    return getError(ErrorCode::InvalidRawData);
+  }
+  Stream->closeStream();
+  LoaderThread.join();
+
+  if (!Mod) {
+    RT.getStatistics().clearAllTimers();
+    RT.freeSymbol(Name);
+    return LoadErr;
+  }
+  return RT.addModule(Name, std::move(Mod));
+}
+
+} // namespace zen::runtime
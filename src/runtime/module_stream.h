@@ -0,0 +1,52 @@
+// Copyright (C) 2021-2023 the DTVM authors. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef ZEN_RUNTIME_MODULE_STREAM_H
+#define ZEN_RUNTIME_MODULE_STREAM_H
+
+#include "runtime/codeholder.h"
+#include "runtime/module.h"
+
+#include <thread>
+
+namespace zen::runtime {
+
+// Loads a module whose bytes arrive in chunks. The module is parsed on a
+// background thread while `append` is called, see `Runtime::startModuleStream`
+class ModuleStream final {
+  using Error = common::Error;
+
+public:
+  ~ModuleStream();
+
+  NONCOPYABLE(ModuleStream);
+
+  /// Append the next chunk of the module bytes
+  /// \return false if loading has failed or the chunk exceeds the module size
+  bool append(const void *Data, size_t Size) noexcept;
+
+  /// Wait until the module is loaded(and compiled), then register it in the
+  /// runtime. Missing bytes make loading fail with UnexpectedEnd.
+  common::MayBe<Module *> finish() noexcept;
+
+private:
+  friend class Runtime;
+
+  ModuleStream(Runtime &RT, WASMSymbol Name, CodeHolderUniquePtr Code,
+               const std::string &EntryHint);
+
+  void runLoader(const std::string &EntryHint) noexcept;
+
+  Runtime &RT;
+  WASMSymbol Name;
+  CodeHolderUniquePtr Code;
+  // Valid until `finish` returns, owned by either `Code` or `Mod`
+  CodeHolder *Stream;
+  ModuleUniquePtr Mod;
+  Error LoadErr;
+  std::thread LoaderThread;
+};
+
+} // namespace zen::runtime
+
+#endif // ZEN_RUNTIME_MODULE_STREAM_H
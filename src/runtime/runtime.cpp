@@ -19,6 +19,12 @@
 #include "runtime/symbol_wrapper.h"
 #include "utils/logging.h"
 #include "utils/statistics.h"
+#ifndef ZEN_ENABLE_SGX
+#include "runtime/module_stream.h"
+#endif
+#ifdef ZEN_ENABLE_LINUX_PERF
+#include "utils/perf.h"
+#endif
 #ifdef ZEN_ENABLE_VIRTUAL_STACK
 #include "utils/virtual_stack.h"
 #endif
@@ -29,6 +35,29 @@ namespace zen::runtime {
 using namespace common;
 using namespace utils;
 
+bool Runtime::initRuntime() {
+  if (!SymbolPool.initPool()) {
+    return false;
+  }
+#ifdef ZEN_ENABLE_LINUX_PERF
+  if (Config.EnablePerfMap || Config.EnableJitDump) {
+    PerfSymbolRegistry::getInstance().enable(Config.EnablePerfMap,
+                                             Config.EnableJitDump);
+  }
+#endif
+#if defined(ZEN_ENABLE_JIT) && !defined(ZEN_ENABLE_SGX)
+  if (Config.Mode != RunMode::InterpMode && !Config.DisableSharedCodeHeap) {
+    JITCodeHeap = common::CodeHeap::newCodeHeap(Config.EnableHugePageCode);
+    if (!JITCodeHeap) {
+      ZEN_LOG_WARN("shared code heap not supported, fall back to the code "
+                   "memory of each module");
+    }
+    Stats.setCodeHeap(JITCodeHeap.get());
+  }
+#endif
+  return true;
+}
+
 void Runtime::cleanRuntime() {
 
   Isolations.clear();
@@ -196,6 +225,11 @@ Module *Runtime::loadModule(WASMSymbol Name, CodeHolderUniquePtr CodeHolder,
       Module::newModule(*this, std::move(CodeHolder), EntryHint);
   // All errors in Module::newModule are thrown as exceptions, so the return
   // value must be valid when the following line is executed
+  ZEN_ASSERT(Mod);
+  return addModule(Name, std::move(Mod));
+}
+
+Module *Runtime::addModule(WASMSymbol Name, ModuleUniquePtr Mod) {
   ZEN_ASSERT(Mod);
   auto *ModulePtr = Mod.get();
   ModulePtr->setName(Name);
@@ -210,6 +244,31 @@ Module *Runtime::loadModule(WASMSymbol Name, CodeHolderUniquePtr CodeHolder,
   return ModulePtr;
 }
 
+#ifndef ZEN_ENABLE_SGX
+std::unique_ptr<ModuleStream>
+Runtime::startModuleStream(const std::string &ModName, size_t ModuleSize,
+                           const std::string &EntryHint) noexcept {
+  if (ModName.empty() || !ModuleSize) {
+    return nullptr;
+  }
+
+  WASMSymbol Name = newSymbol(ModName.c_str(), ModName.size());
+  if (ModulePool.find(Name) != ModulePool.end()) {
+    freeSymbol(Name);
+    return nullptr;
+  }
+
+  try {
+    auto Code = CodeHolder::newStreamingCodeHolder(*this, ModuleSize);
+    return std::unique_ptr<ModuleStream>(
+        new ModuleStream(*this, Name, std::move(Code), EntryHint));
+  } catch (const Error &) {
+    freeSymbol(Name);
+    return nullptr;
+  }
+}
+#endif // ZEN_ENABLE_SGX
+
 bool Runtime::unloadModule(const Module *Mod) noexcept {
   WASMSymbol Name = Mod->getName();
   return ModulePool.erase(Name) != 0;
@@ -256,7 +315,7 @@ static bool checkMainFuncType(TypeEntry *Type) {
       !(ParamTypes[0] == WASMType::I32 && ParamTypes[1] == WASMType::I32)) {
     return false;
   }
-  if (Type->NumReturns && Type->ReturnTypes[0] != WASMType::I32) {
+  if (Type->NumReturns && Type->getReturnType() != WASMType::I32) {
     return false;
   }
   return true;
@@ -382,7 +441,8 @@ static void callWasmFuncFromVirtualStack(VirtualStackInfo *StackInfo) {
 void Runtime::callWasmFunctionOnPhysStack(
     Instance &Inst, uint32_t FuncIdx, const std::vector<TypedValue> &Args,
     std::vector<common::TypedValue> &Results) noexcept {
-  if (getConfig().Mode == RunMode::InterpMode) {
+  if (getConfig().Mode == RunMode::InterpMode ||
+      Inst.getModule()->isInterpOnlyFunction(FuncIdx)) {
     callWasmFunctionInInterpMode(Inst, FuncIdx, Args, Results);
   } else {
 #ifdef ZEN_ENABLE_JIT
@@ -435,7 +495,7 @@ bool Runtime::callWasmFunction(Instance &Inst, uint32_t FuncIdx,
   uint32_t NumReturns = Func->NumReturns;
   Results.resize(NumReturns);
   for (uint32_t I = 0; I < NumReturns; ++I) {
-    Results[I].Type = Func->ReturnTypes[I];
+    Results[I].Type = Func->getReturnTypes()[I];
   }
 
   auto Timer = Stats.startRecord(utils::StatisticPhase::Execution);
@@ -458,8 +518,9 @@ bool Runtime::callWasmFunction(Instance &Inst, uint32_t FuncIdx,
       Inst.clearError();
     } else {
 #ifdef ZEN_ENABLE_DUMP_CALL_STACK
-      if (Config.Mode == RunMode::SinglepassMode ||
-          Config.Mode == RunMode::MultipassMode) {
+      if ((Config.Mode == RunMode::SinglepassMode ||
+           Config.Mode == RunMode::MultipassMode) &&
+          !Inst.getModule()->isInterpOnlyFunction(FuncIdx)) {
         Inst.dumpCallStackOnJIT();
       }
 #endif
@@ -476,26 +537,43 @@ void Runtime::callWasmFunctionInInterpMode(Instance &Inst, uint32_t FuncIdx,
   using namespace action;
   RuntimeObjectUniquePtr<InterpStack> Stack =
       InterpStack::newInterpStack(*this, PresetReservedStackSize);
-  InterpreterExecContext Context(&Inst, Stack.get());
-  uint8_t *Bottom = Stack->top();
+
+  Inst.getRuntime()->startCPUTracing();
+  try {
+    interpretWasmFunction(Inst, FuncIdx, Args, Results, *Stack);
+  } catch (const Error &Err) {
+    Inst.getRuntime()->endCPUTracing();
+    Inst.setError(Err);
+    return;
+  }
+  Inst.getRuntime()->endCPUTracing();
+}
+
+void Runtime::interpretWasmFunction(Instance &Inst, uint32_t FuncIdx,
+                                    const std::vector<TypedValue> &Args,
+                                    std::vector<TypedValue> &Results,
+                                    action::InterpStack &Stack) {
+  using namespace action;
+  InterpreterExecContext Context(&Inst, &Stack);
+  uint8_t *Bottom = Stack.top();
 
   for (const TypedValue &Arg : Args) {
     const UntypedValue &Val = Arg.Value;
     switch (Arg.Type) {
     case WASMType::I32: {
-      Stack->push<int32_t>(Val.I32);
+      Stack.push<int32_t>(Val.I32);
       break;
     }
     case WASMType::I64: {
-      Stack->push<int64_t>(Val.I64);
+      Stack.push<int64_t>(Val.I64);
       break;
     }
     case WASMType::F32: {
-      Stack->push<float>(Val.F32);
+      Stack.push<float>(Val.F32);
       break;
     }
     case WASMType::F64: {
-      Stack->push<double>(Val.F64);
+      Stack.push<double>(Val.F64);
       break;
     }
     default:
@@ -508,15 +586,7 @@ void Runtime::callWasmFunctionInInterpMode(Instance &Inst, uint32_t FuncIdx,
   InterpFrame *Frame = Context.allocFrame(Func, (uint32_t *)Bottom);
   ZEN_ASSERT(Frame != nullptr);
 
-  Inst.getRuntime()->startCPUTracing();
-  try {
-    Interpreter.interpret();
-  } catch (const Error &Err) {
-    Inst.getRuntime()->endCPUTracing();
-    Inst.setError(Err);
-    return;
-  }
-  Inst.getRuntime()->endCPUTracing();
+  Interpreter.interpret();
 
   for (TypedValue &Result : Results) {
     UntypedValue &Val = Result.Value;
@@ -551,6 +621,10 @@ void Runtime::callWasmFunctionInInterpMode(Instance &Inst, uint32_t FuncIdx,
 void Runtime::callWasmFunctionInJITMode(Instance &Inst, uint32_t FuncIdx,
                                         const std::vector<TypedValue> &Args,
                                         std::vector<TypedValue> &Results) {
+#ifndef ZEN_ENABLE_SGX
+  // The retired code of the shared code heap is kept until the call returns
+  common::CodeHeap::ExecutionScope CodeScope;
+#endif
   FunctionInstance *Func = Inst.getFunctionInst(FuncIdx);
   Inst.setJITStackSize(PresetReservedStackSize);
   bool IsImport = FuncIdx < Inst.getModule()->getNumImportFunctions();
@@ -4,6 +4,7 @@
 #ifndef ZEN_RUNTIME_RUNTIME_H
 #define ZEN_RUNTIME_RUNTIME_H
 
+#include "common/code_heap.h"
 #include "common/const_string_pool.h"
 #include "common/enums.h"
 #include "common/errors.h"
@@ -19,6 +20,10 @@
 #include <utility>
 #include <vector>
 
+namespace zen::action {
+class InterpStack;
+} // namespace zen::action
+
 namespace zen::runtime {
 
 class HostModule;
@@ -26,6 +31,7 @@ class Module;
 class Instance;
 class Runtime;
 class Isolation;
+class ModuleStream;
 
 typedef struct VNMIEnvInternal_ {
   VNMIEnv _env;
@@ -38,6 +44,12 @@ typedef struct VNMIEnvInternal_ {
   RT->mergeHostModule(OriginMod, Namespace::m_##ModName##_desc)
 
 // Only some of the methods of the Runtime class are thread-safe
+//
+// One runtime and its loaded modules(with their JIT code) can be shared by
+// several threads: once the modules are loaded, each thread creates its own
+// isolations and instances of them and calls them concurrently with the other
+// threads. Loading and unloading modules, and the other methods marked as not
+// thread-safe, must not run concurrently with them.
 
 class Runtime final {
   using MemPool = common::SysMemPool;
@@ -135,6 +147,19 @@ public:
   loadModule(const std::string &ModName, const void *Data, size_t DataSize,
              const std::string &EntryHint = "") noexcept;
 
+#ifndef ZEN_ENABLE_SGX
+  /// Start loading a module whose `ModuleSize` bytes arrive in chunks through
+  /// `ModuleStream::append`. Sections are parsed on a background thread as
+  /// soon as their bytes arrive, and in multipass eager mode every function is
+  /// compiled once its body is validated.
+  /// \warning not thread-safe, and no other module may be loaded or unloaded
+  /// until `ModuleStream::finish` returns
+  /// \return nullptr if the arguments are invalid or the name is in use
+  std::unique_ptr<ModuleStream>
+  startModuleStream(const std::string &ModName, size_t ModuleSize,
+                    const std::string &EntryHint = "") noexcept;
+#endif // ZEN_ENABLE_SGX
+
   /// \warning not thread-safe
   bool unloadModule(const Module *Mod) noexcept;
 
@@ -280,6 +305,12 @@ public:
 
   utils::Statistics &getStatistics() { return Stats; }
 
+#if defined(ZEN_ENABLE_JIT) && !defined(ZEN_ENABLE_SGX)
+  // nullptr if disabled or not supported, the modules use their own code
+  // memory then
+  common::CodeHeap *getJITCodeHeap() { return JITCodeHeap.get(); }
+#endif
+
   void startCPUTracing();
 
   void endCPUTracing();
@@ -288,18 +319,30 @@ public:
       Instance &Inst, uint32_t FuncIdx, const std::vector<TypedValue> &Args,
       std::vector<common::TypedValue> &Results) noexcept;
 
+  /// Interpret the function with the arguments pushed on the top of `Stack`,
+  /// errors are thrown. Also runs the functions left to the interpreter for
+  /// the JIT code calling them.
+  void interpretWasmFunction(Instance &Inst, uint32_t FuncIdx,
+                             const std::vector<TypedValue> &Args,
+                             std::vector<common::TypedValue> &Results,
+                             action::InterpStack &Stack);
+
   /* **************** [End] Runtime Tool Methods  **************** */
 private:
+  friend class ModuleStream;
+
   Runtime(const RuntimeConfig &Configuration)
       : Config(Configuration), Stats(Config.EnableStatistics) {}
 
-  bool initRuntime() { return SymbolPool.initPool(); }
+  bool initRuntime();
 
   void cleanRuntime();
 
   Module *loadModule(WASMSymbol ModName, CodeHolderUniquePtr CodeHolder,
                      const std::string &EntryHint = "");
 
+  Module *addModule(WASMSymbol ModName, ModuleUniquePtr Mod);
+
   void callWasmFunctionInInterpMode(Instance &Inst, uint32_t FuncIdx,
                                     const std::vector<TypedValue> &Args,
                                     std::vector<common::TypedValue> &Results);
@@ -316,6 +359,11 @@ private:
 
   ConstStringPool SymbolPool;
 
+#if defined(ZEN_ENABLE_JIT) && !defined(ZEN_ENABLE_SGX)
+  // Must outlive the modules
+  std::unique_ptr<common::CodeHeap> JITCodeHeap;
+#endif
+
   // supplementary module, libc, wasi, and other user defined native modules
   std::unordered_map<WASMSymbol, HostModuleUniquePtr> HostModulePool;
   // multiple module mode
@@ -305,6 +305,30 @@ public:
     auto Reg = getTempRegNum<Ty>(Index);
     return A64Reg::getRegRef<Ty>(Reg);
   }
+
+public:
+  // local register, holds a promoted local for the whole function. They're
+  // the leading callee-saved registers not reserved above, so the prolog and
+  // epilog save and restore them as preserved registers and calls don't
+  // clobber them.
+
+  // local integer register
+  constexpr static uint32_t NumGpLocalRegs = 3;
+
+  // local floating point register
+  constexpr static uint32_t NumFpLocalRegs = 4;
+
+  // get local integer register number with variable index
+  static A64::GP getGpLocalRegNum(uint32_t Index) {
+    ZEN_ASSERT(Index < NumGpLocalRegs);
+    return getIntPresRegNum(Index);
+  }
+
+  // get local floating point register number with variable index
+  static A64::FP getFpLocalRegNum(uint32_t Index) {
+    ZEN_ASSERT(Index < NumFpLocalRegs);
+    return getFloatPresRegNum(Index);
+  }
 };
 
 } // namespace zen::singlepass
@@ -185,23 +185,35 @@ private:
     bindLabel(NotOverflow);
 #endif
 
-    // save preserved registers
+    // save preserved registers, which hold promoted locals
     uint32_t PresSaveSize = 0;
-    uint32_t IntPresMask = 0;
     for (uint32_t I = 0; I < Layout.getIntPresSavedCount(); ++I) {
       const A64::GP Reg = ABI.getPresRegNum<A64::I64>(I);
       _ str(A64Reg::getRegRef<A64::I64>(Reg),
             asmjit::a64::ptr(ABI.getFrameBaseReg(), -(I + 1) * ABI.GpRegWidth));
       PresSaveSize += ABI.GpRegWidth;
-      IntPresMask |= (1 << Reg);
     }
-    Layout.markAvailRegMask<A64::I64>(IntPresMask);
     ZEN_ASSERT(PresSaveSize == Layout.getIntPresSavedCount() * ABI.GpRegWidth);
+    for (uint32_t I = 0; I < Layout.getFloatPresSavedCount(); ++I) {
+      const A64::FP Reg = ABI.getFloatPresRegNum(I);
+      PresSaveSize += sizeof(double);
+      _ str(A64Reg::getRegRef<A64::F64>(Reg),
+            asmjit::a64::ptr(ABI.getFrameBaseReg(), -PresSaveSize));
+    }
 
     // initialize all locals to zero
     for (uint32_t I = 0; I < Ctx->Func->NumLocals; ++I) {
       auto Local = Layout.getLocal(I + Ctx->FuncType->NumParams);
-      ZEN_ASSERT(Local.isMem());
+      if (Local.isReg()) {
+        auto ZeroReg = A64Reg::getRegRef<A64::I64>(A64::XZR);
+        if (Local.getType() == WASMType::I32 ||
+            Local.getType() == WASMType::I64) {
+          _ mov(A64Reg::getRegRef<A64::I64>(Local.getReg()), ZeroReg);
+        } else {
+          _ fmov(A64Reg::getRegRef<A64::F64>(Local.getReg()), ZeroReg);
+        }
+        continue;
+      }
       if (Local.getType() == WASMType::I32 ||
           Local.getType() == WASMType::F32) {
         storeRegToMem<A64::I32>(GP::XZR, Local.getMem<A64::I32>());
@@ -215,9 +227,8 @@ private:
   } // EmitProlog
 
   // epilog
-  void emitEpilog(Operand Op) {
-    saveGasVal();
-
+  // release the stack cost added in prolog
+  void releaseStackCost() {
 #ifdef ZEN_ENABLE_DWASM
     // update stack cost
     auto StackCostAddr = asmjit::a64::ptr(
@@ -235,6 +246,33 @@ private:
     }
     _ str(StackCostReg, StackCostAddr);
 #endif
+  }
+
+  // restore preserved registers and the frame of caller, including the link
+  // register
+  void emitLeaveFrame() {
+    for (uint32_t I = 0; I < Layout.getIntPresSavedCount(); ++I) {
+      const A64::GP Reg = ABI.getPresRegNum<A64::I64>(I);
+      _ ldr(A64Reg::getRegRef<A64::I64>(Reg),
+            asmjit::a64::ptr(ABI.getFrameBaseReg(), -(I + 1) * ABI.GpRegWidth));
+    }
+    uint32_t PresSaveSize = Layout.getIntPresSavedCount() * ABI.GpRegWidth;
+    for (uint32_t I = 0; I < Layout.getFloatPresSavedCount(); ++I) {
+      const A64::FP Reg = ABI.getFloatPresRegNum(I);
+      PresSaveSize += sizeof(double);
+      _ ldr(A64Reg::getRegRef<A64::F64>(Reg),
+            asmjit::a64::ptr(ABI.getFrameBaseReg(), -PresSaveSize));
+    }
+    // restore stack pointer from frame base
+    _ mov(ABI.getStackPointerReg(), ABI.getFrameBaseReg());
+    // restore stack
+    _ ldp(ABI.getFrameBaseReg(), ABI.getLinkAddressReg(),
+          asmjit::a64::ptr_post(ABI.getStackPointerReg(), 16));
+  }
+
+  void emitEpilog(Operand Op) {
+    saveGasVal();
+    releaseStackCost();
 
     if (Layout.getNumReturns() > 0) {
       ZEN_ASSERT(Layout.getNumReturns() == 1);
@@ -260,17 +298,7 @@ private:
       }
     }
 
-    // restore preserved registers
-    for (uint32_t I = 0; I < Layout.getIntPresSavedCount(); ++I) {
-      const A64::GP Reg = ABI.getPresRegNum<A64::I64>(I);
-      _ ldr(A64Reg::getRegRef<A64::I64>(Reg),
-            asmjit::a64::ptr(ABI.getFrameBaseReg(), -(I + 1) * ABI.GpRegWidth));
-    }
-    // restore stack pointer from frame base
-    _ mov(ABI.getStackPointerReg(), ABI.getFrameBaseReg());
-    // restore stack
-    _ ldp(ABI.getFrameBaseReg(), ABI.getLinkAddressReg(),
-          asmjit::a64::ptr_post(ABI.getStackPointerReg(), 16));
+    emitLeaveFrame();
     _ ret(ABI.getLinkAddressReg());
   } // EmitEpilog
 
@@ -713,6 +741,24 @@ public:
     return Ret;
   }
 
+  // fcvtzs/fcvtzu already saturate out of range values and convert NaN to 0
+  template <WASMType DestType, WASMType SrcType, bool Sext>
+  Operand handleFloatToIntSatImpl(Operand Op) {
+    constexpr auto A64DstType = getA64TypeFromWASMType<DestType>();
+    constexpr auto A64SrcType = getA64TypeFromWASMType<SrcType>();
+
+    auto SrcRegNum = toReg<A64SrcType, ScopedTempReg0>(Op);
+    auto SrcReg = A64Reg::getRegRef<A64SrcType>(SrcRegNum);
+
+    auto DstRegNum = Layout.getScopedTemp<A64DstType, ScopedTempReg1>();
+    auto DstReg = A64Reg::getRegRef<A64DstType>(DstRegNum);
+    ConvertOpImpl<A64DstType, A64SrcType, Sext>::emit(ASM, DstReg, SrcReg);
+
+    auto Ret = getTempOperand(DestType);
+    mov<A64DstType>(Ret, DstRegNum);
+    return Ret;
+  }
+
   // extend from SrcType to DestType in same type kind (integer or
   // floating-point)
   template <WASMType DestType, WASMType SrcType, bool Sext>
@@ -991,37 +1037,24 @@ public:
     Operand IndexRegOp =
         Operand(WASMType::I32, IndexRegNum, Operand::FLAG_NONE);
     bool Exchanged;
+
+    // binary search when the table consists of few runs
+    auto Runs = getBranchTableRuns(LabelIdxs);
+    if (Runs.size() <= MaxBranchTreeRuns) {
+      emitBranchTableTree(
+          Runs, 0, Runs.size(), [&](uint32_t Imm, uint32_t LabelIdx) {
+            cmp<A64::I32, ScopedTempReg2, ScopedTempReg2>(
+                IndexRegOp, Operand(WASMType::I32, Imm), Exchanged);
+            jmpcc<CompareOperator::CO_GE_U, true>(LabelIdx);
+          });
+      return;
+    }
+
     cmp<A64::I32, ScopedTempReg2, ScopedTempReg2>(
         IndexRegOp, Operand(WASMType::I32, Bound), Exchanged);
     // jump to default label if index >= bound
     jmpcc<CompareOperator::CO_GE_U, true>(LabelIdxs[Bound]);
 
-    // for small tables, generate if (index == i) goto i;
-    switch (Bound) {
-    case 4:
-      cmp<A64::I32, ScopedTempReg2, ScopedTempReg2>(
-          IndexRegOp, Operand(WASMType::I32, 3), Exchanged);
-      jmpcc<CompareOperator::CO_EQ, true>(LabelIdxs[3]);
-      // fall through
-    case 3:
-      cmp<A64::I32, ScopedTempReg2, ScopedTempReg2>(
-          IndexRegOp, Operand(WASMType::I32, 2), Exchanged);
-      jmpcc<CompareOperator::CO_EQ, true>(LabelIdxs[2]);
-      // fall through
-    case 2:
-      cmp<A64::I32, ScopedTempReg2, ScopedTempReg2>(
-          IndexRegOp, Operand(WASMType::I32, 1), Exchanged);
-      jmpcc<CompareOperator::CO_EQ, true>(LabelIdxs[1]);
-      // fall through
-    case 1:
-      cmp<A64::I32, ScopedTempReg2, ScopedTempReg2>(
-          IndexRegOp, Operand(WASMType::I32, 0), Exchanged);
-      jmpcc<CompareOperator::CO_EQ, true>(LabelIdxs[0]);
-      return;
-    default:
-      break;
-    }
-
     // jump to entry in jump table
     uint32_t Table = createLabel();
     auto JmpReg = Layout.getScopedTempReg<A64::I64, ScopedTempReg2>();
@@ -1188,6 +1221,16 @@ public:
   // return
   void handleReturnImpl(Operand Op) { emitEpilog(Op); }
 
+  // tail call, the arguments are already in registers, branch to the callee
+  // with the link register of caller
+  void handleReturnCallImpl(uint32_t FuncIdx) {
+    emitLeaveFrame();
+    size_t Offset = _ offset();
+    _ nop();
+    ZEN_ASSERT(_ offset() - Offset == 4);
+    Patcher.addJumpEntry(Offset, _ offset() - Offset, FuncIdx);
+  }
+
   // unreachable
   void handleUnreachableImpl() { emitRuntimeError(ErrorCode::Unreachable); }
 
@@ -1205,7 +1248,9 @@ public:
         .NumParamCells = 1,
         .NumReturns = 1,
         .NumReturnCells = 1,
-        .ReturnTypes = {WASMType::I32},
+        {
+            .ReturnTypesVec = {WASMType::I32},
+        },
         {
             .ParamTypesVec = {WASMType::I32},
         },
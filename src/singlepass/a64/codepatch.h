@@ -25,6 +25,7 @@ class PatchInfo {
 public:
   enum PatchKind {
     PK_CALL = 0, // patch direct call
+    PK_JUMP = 1, // patch direct jump of tail call
   };
 
 private:
@@ -58,6 +59,10 @@ public:
     Entries.push_back(PatchEntry(PK_CALL, Offset, Size, Callee));
   }
 
+  void addJumpEntry(uint32_t Offset, uint32_t Size, uint32_t Callee) {
+    Entries.push_back(PatchEntry(PK_JUMP, Offset, Size, Callee));
+  }
+
   uintptr_t getFunctionAddress() const { return (uintptr_t)Func->JITCodePtr; }
 
 public:
@@ -195,17 +200,24 @@ public:
                                    Callee - Mod->getNumImportFunctions());
   }
 
+  void addJumpEntry(uint32_t Offset, uint32_t Size, uint32_t Callee) {
+    ZEN_ASSERT(PatchInfos.size() > 0);
+    PatchInfos.back().addJumpEntry(Offset, Size,
+                                   Callee - Mod->getNumImportFunctions());
+  }
+
   void finalizeModule() {
+    auto &CodeMPool = Mod->getJITCodeMemPool();
     for (auto It = PatchInfos.begin(), E = PatchInfos.end(); It != E; ++It) {
       uint8_t *Base = (uint8_t *)It->getFunctionAddress();
       ZEN_ASSERT(Base);
       for (auto P = It->begin(), EE = It->end(); P != EE; ++P) {
         ZEN_ASSERT(P->getSize() == 4 || P->getSize() == 16);
         ZEN_ASSERT(P->getArg() < PatchInfos.size());
-        ZEN_ASSERT(P->getKind() == PatchInfo::PK_CALL);
         uint8_t *Target = (uint8_t *)getFunctionAddress(P->getArg());
         int64_t Diff = (int64_t)Target - (int64_t)(Base + P->getOffset());
-        uint32_t *Patch = (uint32_t *)(Base + P->getOffset());
+        uint32_t *Patch =
+            (uint32_t *)CodeMPool.getWritableAddr(Base + P->getOffset());
         ZEN_ASSERT((Diff & 0x3) == 0);             // 4 byte aligned
         ZEN_ASSERT(((uintptr_t)Patch & 0x3) == 0); // 4 byte aligned
 
@@ -216,7 +228,14 @@ public:
         // | 1 | 0 | 0 | 1 | 0 | 1 |        imm26|
         // +---+---+---+---+---+---+-------------+
         namespace EncodingData = asmjit::a64::InstDB::EncodingData;
-        if (-(1 << 27) <= Diff && Diff <= (1 << 27)) {
+        if (P->getKind() == PatchInfo::PK_JUMP) {
+          // Tail calls are only emitted for near callees, B has the same
+          // encoding as BL except the bit 31
+          ZEN_ASSERT(P->getSize() == 4);
+          ZEN_ASSERT(-(1 << 27) <= Diff && Diff <= (1 << 27));
+          uint32_t Imm26 = (Diff >> 2) & ((1 << 26) - 1);
+          *Patch = EncodingData::baseBranchRel[0].opcode | Imm26;
+        } else if (-(1 << 27) <= Diff && Diff <= (1 << 27)) {
           uint32_t Imm26 =
               (Diff >> 2) & ((1 << 26) - 1); // imm26 to be encoded to BL
           *Patch = EncodingData::baseBranchRel[1].opcode | Imm26;
@@ -69,6 +69,12 @@ private:
   }
 
   template <WASMType Type> void layoutLocal(uint32_t &StkSize) {
+    uint32_t Reg = getPromotedReg(Locals.size());
+    if (Reg != A64OnePassABI::InvalidParamReg) {
+      // promoted local needs no stack slot
+      Locals.push_back(LocalInfo(Type, Reg, 0));
+      return;
+    }
     constexpr A64::Type A64Type = getA64TypeFromWASMType<Type>();
     constexpr uint32_t Align = A64TypeAttr<A64Type>::Size;
     ZEN_STATIC_ASSERT((Align & (Align - 1)) == 0);
@@ -84,6 +90,10 @@ public:
     VmState.initFunction();
     OnePassDataLayout<A64OnePassABI>::initFunction(Ctx);
 
+    // promoted locals live in callee-saved registers saved by the prolog
+    GpPresSavedArea = NumPromotedGpLocals * A64OnePassABI::GpRegWidth;
+    FpPresSavedArea = NumPromotedFpLocals * sizeof(double);
+
     ZEN_ASSERT(Locals.empty());
     Locals.reserve(FuncType->NumParams + Func->NumLocals);
 
@@ -182,6 +182,10 @@ public:
   static constexpr DataType F64 = ConcreteCodeGenAttrs::F64;
   static constexpr DataType V128 = ConcreteCodeGenAttrs::V128;
 
+  // Integer constant expressions are evaluated by the bytecode visitor, as
+  // this backend has no later pass to fold them
+  static constexpr bool FoldConstants = true;
+
   static constexpr uint32_t GlobalBaseOffset =
       offsetof(Instance, GlobalVarData);
   static constexpr uint32_t MemoriesOffset = offsetof(Instance, Memories);
@@ -280,6 +284,9 @@ public:
     // Save parameters in reg to stack
     saveParamReg(Type->NumParams);
 
+    // Load promoted parameters to their registers
+    loadPromotedParams(Type->NumParams);
+
     ZEN_ASSERT(Stack.size() == 0);
 
     WASMType RetType = Type->getReturnType();
@@ -463,22 +470,32 @@ public:
 
   void handleBranchTable(Operand Index, Operand StackTop,
                          const std::vector<uint32_t> &Levels) {
+    // Entries targeting the same level share one landing pad, and the table
+    // jumps to the block label directly if there's no result value to copy
     std::vector<uint32_t> Labels;
     Labels.reserve(Levels.size());
-    std::generate_n(std::back_inserter(Labels), Levels.size(),
-                    [this] { return createLabel(); });
+    std::map<uint32_t, uint32_t> LandingPads;
+    for (uint32_t Level : Levels) {
+      const auto &Info = Stack.at(Stack.size() - Level - 1);
+      if (Info.getType() == WASMType::VOID ||
+          Info.getKind() == CtrlBlockKind::LOOP) {
+        Labels.push_back(Info.getLabel());
+        continue;
+      }
+      auto It = LandingPads.find(Level);
+      if (It == LandingPads.end()) {
+        It = LandingPads.emplace(Level, createLabel()).first;
+      }
+      Labels.push_back(It->second);
+    }
 
     self().handleBranchTableImpl(Index, Labels);
 
-    // TODO: no need to emit extra jumps if there's no result value
-    for (size_t I = 0; I < Levels.size(); ++I) {
-      bindLabel(Labels[I]);
-      const auto &Info = Stack.at(Stack.size() - Levels[I] - 1);
-      if (Info.getType() != WASMType::VOID &&
-          Info.getKind() != CtrlBlockKind::LOOP) {
-        makeAssignment<ScopedTempReg0>(Info.getType(), Info.getResult(),
-                                       StackTop);
-      }
+    for (const auto &[Level, Label] : LandingPads) {
+      bindLabel(Label);
+      const auto &Info = Stack.at(Stack.size() - Level - 1);
+      makeAssignment<ScopedTempReg0>(Info.getType(), Info.getResult(),
+                                     StackTop);
       self().branch(Info.getLabel());
     }
   }
@@ -498,6 +515,33 @@ public:
     return self().handleCallIndirectImpl(TypeIdx, Callee, TblIdx, ArgInfo, Arg);
   }
 
+  // Reuse the frame of the current function for the callee when it is an
+  // internal near function taking all arguments in registers. Otherwise the
+  // stack arguments would overwrite the frame of the caller, and host
+  // functions report exceptions by the instance instead of the register
+  // checked by our caller, so call them normally and return.
+  void handleReturnCall(uint32_t FuncIdx, uintptr_t Target, bool IsImport,
+                        bool FarCall, const ArgumentInfo &ArgInfo,
+                        const std::vector<Operand> &Arg) {
+    if (IsImport || FarCall || ArgInfo.getStackSize() > 0) {
+      handleReturn(
+          handleCall(FuncIdx, Target, IsImport, FarCall, ArgInfo, Arg));
+      return;
+    }
+    self().saveGasVal();
+    self().releaseStackCost();
+    uint32_t StackOffset = 0;
+    layoutCallArgs(ArgInfo, Arg, StackOffset);
+    self().handleReturnCallImpl(FuncIdx);
+  }
+
+  // The table may hold host functions, see `handleReturnCall`
+  void handleReturnCallIndirect(uint32_t TypeIdx, Operand Callee,
+                                uint32_t TblIdx, const ArgumentInfo &ArgInfo,
+                                const std::vector<Operand> &Arg) {
+    handleReturn(handleCallIndirect(TypeIdx, Callee, TblIdx, ArgInfo, Arg));
+  }
+
   // ==================== Parametric Instruction Handlers ====================
 
   Operand handleSelect(Operand Cond, Operand LHS, Operand RHS) {
@@ -554,6 +598,81 @@ public:
     return self().handleMemoryGrowImpl(Op);
   }
 
+  void handleMemoryInit(uint32_t DataSegIdx, Operand DestOffset,
+                        Operand SrcOffset, Operand Size) {
+    static TypeEntry SigBuf = {
+        .NumParams = 4,
+        .NumParamCells = 4,
+        .NumReturns = 0,
+        .NumReturnCells = 0,
+        {
+            .ReturnTypesVec = {WASMType::VOID},
+        },
+        {
+            .ParamTypesVec = {WASMType::I32, WASMType::I32, WASMType::I32,
+                              WASMType::I32},
+        },
+        .SmallestTypeIdx = uint32_t(-1),
+    };
+    emitRuntimeCall(uintptr_t(Instance::initMemoryOnJIT), &SigBuf,
+                    {Operand(WASMType::I32, int32_t(DataSegIdx)), DestOffset,
+                     SrcOffset, Size});
+  }
+
+  void handleDataDrop(uint32_t DataSegIdx) {
+    static TypeEntry SigBuf = {
+        .NumParams = 1,
+        .NumParamCells = 1,
+        .NumReturns = 0,
+        .NumReturnCells = 0,
+        {
+            .ReturnTypesVec = {WASMType::VOID},
+        },
+        {
+            .ParamTypesVec = {WASMType::I32},
+        },
+        .SmallestTypeIdx = uint32_t(-1),
+    };
+    emitRuntimeCall(uintptr_t(Instance::dropDataSegmentOnJIT), &SigBuf,
+                    {Operand(WASMType::I32, int32_t(DataSegIdx))});
+  }
+
+  void handleMemoryCopy(Operand DestOffset, Operand SrcOffset, Operand Size) {
+    static TypeEntry SigBuf = {
+        .NumParams = 3,
+        .NumParamCells = 3,
+        .NumReturns = 0,
+        .NumReturnCells = 0,
+        {
+            .ReturnTypesVec = {WASMType::VOID},
+        },
+        {
+            .ParamTypesVec = {WASMType::I32, WASMType::I32, WASMType::I32},
+        },
+        .SmallestTypeIdx = uint32_t(-1),
+    };
+    emitRuntimeCall(uintptr_t(Instance::copyMemoryOnJIT), &SigBuf,
+                    {DestOffset, SrcOffset, Size});
+  }
+
+  void handleMemoryFill(Operand DestOffset, Operand Value, Operand Size) {
+    static TypeEntry SigBuf = {
+        .NumParams = 3,
+        .NumParamCells = 3,
+        .NumReturns = 0,
+        .NumReturnCells = 0,
+        {
+            .ReturnTypesVec = {WASMType::VOID},
+        },
+        {
+            .ParamTypesVec = {WASMType::I32, WASMType::I32, WASMType::I32},
+        },
+        .SmallestTypeIdx = uint32_t(-1),
+    };
+    emitRuntimeCall(uintptr_t(Instance::fillMemoryOnJIT), &SigBuf,
+                    {DestOffset, Value, Size});
+  }
+
   // ==================== Numeric Instruction Handlers ====================
 
   template <WASMType Ty>
@@ -643,6 +762,12 @@ public:
     return self().template handleFloatToIntImpl<DestType, SrcType, Sext>(Op);
   }
 
+  template <WASMType DestType, WASMType SrcType, bool Sext>
+  Operand handleFloatToIntSat(Operand Op) {
+    return self().template handleFloatToIntSatImpl<DestType, SrcType, Sext>(
+        Op);
+  }
+
   // Extend from SrcType (smaller) to DestType (larger) with the same type kind
   template <WASMType DestType, WASMType SrcType, bool Sext>
   Operand handleIntExtend(Operand Op) {
@@ -846,6 +971,51 @@ protected:
 
   void embedLabel(uint32_t Id) { _ embedLabel(asmjit::Label(Id)); }
 
+  // Consecutive br_table entries starting at `Begin` and branching to the
+  // same label, the last run also covers the out of range indices
+  struct BranchTableRun {
+    uint32_t Begin;
+    uint32_t Label;
+  };
+
+  // Use a compare tree(at most 3 compares) instead of the indirect jump
+  // through a jump table when the table consists of few runs
+  static constexpr size_t MaxBranchTreeRuns = 8;
+
+  static std::vector<BranchTableRun>
+  getBranchTableRuns(const std::vector<uint32_t> &LabelIdxs) {
+    std::vector<BranchTableRun> Runs;
+    for (uint32_t I = 0; I < LabelIdxs.size(); ++I) {
+      if (Runs.empty() || Runs.back().Label != LabelIdxs[I]) {
+        Runs.push_back({I, LabelIdxs[I]});
+      }
+    }
+    return Runs;
+  }
+
+  // Binary search the run containing the index in Runs[Lo, Hi),
+  // `BranchAboveEqual(Imm, Label)` jumps to `Label` if index >=(unsigned) Imm
+  template <typename BranchAboveEqualFunc>
+  void emitBranchTableTree(const std::vector<BranchTableRun> &Runs, size_t Lo,
+                           size_t Hi, BranchAboveEqualFunc &&BranchAboveEqual) {
+    ZEN_ASSERT(Lo < Hi);
+    if (Hi - Lo == 1) {
+      self().branch(Runs[Lo].Label);
+      return;
+    }
+    size_t Mid = Lo + (Hi - Lo) / 2;
+    if (Hi - Mid == 1) {
+      BranchAboveEqual(Runs[Mid].Begin, Runs[Mid].Label);
+      emitBranchTableTree(Runs, Lo, Mid, BranchAboveEqual);
+      return;
+    }
+    uint32_t RightLabel = createLabel();
+    BranchAboveEqual(Runs[Mid].Begin, RightLabel);
+    emitBranchTableTree(Runs, Lo, Mid, BranchAboveEqual);
+    bindLabel(RightLabel);
+    emitBranchTableTree(Runs, Mid, Hi, BranchAboveEqual);
+  }
+
   void emitJumpTable(uint32_t Table, const std::vector<uint32_t> &Targets) {
     // align code to pointer boundary
     _ align(asmjit::AlignMode::kCode, sizeof(uintptr_t));
@@ -855,6 +1025,53 @@ protected:
     }
   }
 
+  // Move the arguments to the locations of the callee, and place the instance
+  // in the first parameter register
+  void layoutCallArgs(const ArgumentInfo &ArgInfo,
+                      const std::vector<Operand> &Arg, uint32_t &StackOffset) {
+    // layout argument
+    ZEN_ASSERT(ArgInfo.size() == Arg.size() + 1);
+
+    std::vector<uint32_t> NeedSortedMovs;
+    uint32_t GpRegUsed = 0;
+    uint32_t FpRegUsed = 0;
+    for (uint32_t I = 1; I < ArgInfo.size(); ++I) {
+      const auto &Info = ArgInfo.at(I);
+      if (Info.inReg()) {
+        NeedSortedMovs.push_back(I);
+        continue;
+      }
+
+      Operand Op = Arg[I - 1];
+      ZEN_ASSERT(Op.getType() == Info.getType());
+      copyParam(Info, Op, GpRegUsed, FpRegUsed, StackOffset);
+    }
+
+    // sort movs
+    for (uint32_t I = 0; I < NeedSortedMovs.size(); ++I) {
+      for (uint32_t J = I + 1; J < NeedSortedMovs.size(); ++J) {
+        // should not take this sentence out, because need_sorted_movs
+        // may change
+        const auto &Info = ArgInfo.at(NeedSortedMovs[I]);
+        Operand Op = Arg[NeedSortedMovs[J] - 1];
+        if (Op.isReg() && Op.getReg() == Info.getRegNum()) {
+          std::swap(NeedSortedMovs[I], NeedSortedMovs[J]);
+        }
+      }
+    }
+
+    // copy sorted movs
+    for (uint32_t I : NeedSortedMovs) {
+      const auto &Info = ArgInfo.at(I);
+      Operand Op = Arg[I - 1];
+      ZEN_ASSERT(Op.getType() == Info.getType());
+      copyParam(Info, Op, GpRegUsed, FpRegUsed, StackOffset);
+    }
+
+    // place instance
+    mov<I64>(ABI.template getParamRegNum<I64, 0>(), ABI.getModuleInst());
+  }
+
   template <typename PrepareCallFn, typename GenerateCallFn,
             typename PostCallFn>
   Operand emitCall(const ArgumentInfo &ArgInfo, const std::vector<Operand> &Arg,
@@ -900,47 +1117,7 @@ protected:
     // prepare call
     PreCall();
 
-    // layout argument
-    ZEN_ASSERT(ArgInfo.size() == Arg.size() + 1);
-
-    std::vector<uint32_t> NeedSortedMovs;
-    uint32_t GpRegUsed = 0;
-    uint32_t FpRegUsed = 0;
-    for (uint32_t I = 1; I < ArgInfo.size(); ++I) {
-      const auto &Info = ArgInfo.at(I);
-      if (Info.inReg()) {
-        NeedSortedMovs.push_back(I);
-        continue;
-      }
-
-      Operand Op = Arg[I - 1];
-      ZEN_ASSERT(Op.getType() == Info.getType());
-      copyParam(Info, Op, GpRegUsed, FpRegUsed, StackOffset);
-    }
-
-    // sort movs
-    for (uint32_t I = 0; I < NeedSortedMovs.size(); ++I) {
-      for (uint32_t J = I + 1; J < NeedSortedMovs.size(); ++J) {
-        // should not take this sentence out, because need_sorted_movs
-        // may change
-        const auto &Info = ArgInfo.at(NeedSortedMovs[I]);
-        Operand Op = Arg[NeedSortedMovs[J] - 1];
-        if (Op.isReg() && Op.getReg() == Info.getRegNum()) {
-          std::swap(NeedSortedMovs[I], NeedSortedMovs[J]);
-        }
-      }
-    }
-
-    // copy sorted movs
-    for (uint32_t I : NeedSortedMovs) {
-      const auto &Info = ArgInfo.at(I);
-      Operand Op = Arg[I - 1];
-      ZEN_ASSERT(Op.getType() == Info.getType());
-      copyParam(Info, Op, GpRegUsed, FpRegUsed, StackOffset);
-    }
-
-    // place instance
-    mov<I64>(ABI.template getParamRegNum<I64, 0>(), ABI.getModuleInst());
+    layoutCallArgs(ArgInfo, Arg, StackOffset);
 
     // generare call
     GenCall();
@@ -978,6 +1155,20 @@ protected:
     return RetVal;
   }
 
+  // Call a runtime helper taking the instance as the first argument, which
+  // may charge gas and set the instance exception
+  Operand emitRuntimeCall(uintptr_t Func, TypeEntry *Sig,
+                          const std::vector<Operand> &Args) {
+    ArgumentInfo ArgInfo(Sig);
+    return emitCall(
+        ArgInfo, Args, [this] { self().saveGasVal(); },
+        [this, Func] { self().callAbsolute(Func); },
+        [this] {
+          self().loadGasVal();
+          self().checkCallException(true);
+        });
+  }
+
   // Use vector because branch may refer random parent block
   typedef std::vector<BlockInfo> BlockStack;
   BlockStack Stack; // manage nested block
@@ -1040,6 +1231,35 @@ private:
     Layout.clearParamInReg();
   }
 
+  // load promoted parameters from stack to their registers
+  void loadPromotedParams(uint32_t ParamCnt) {
+    for (uint32_t I = 0; I < ParamCnt; ++I) {
+      uint32_t Reg = Layout.getPromotedReg(I);
+      if (Reg == OnePassABI::InvalidParamReg) {
+        continue;
+      }
+      auto Info = Layout.getLocalInfo(I);
+      Mem Addr(ABI.getFrameBaseReg(), Info.getOffset());
+      switch (Info.getType()) {
+      case WASMType::I32:
+        self().template loadRegFromMem<I32>(Reg, Addr);
+        break;
+      case WASMType::I64:
+        self().template loadRegFromMem<I64>(Reg, Addr);
+        break;
+      case WASMType::F32:
+        self().template loadRegFromMem<F32>(Reg, Addr);
+        break;
+      case WASMType::F64:
+        self().template loadRegFromMem<F64>(Reg, Addr);
+        break;
+      default:
+        ZEN_ABORT();
+      }
+      Layout.setParamInPromotedReg(I);
+    }
+  }
+
   // save/restore tempoorary registers for call
   template <DataType Type, bool Save>
   void saveRestoreTempReg(uint32_t Mask, uint32_t &StackOffset) {
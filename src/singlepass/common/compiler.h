@@ -51,6 +51,14 @@ public:
     return Visitor.compile();
   }
 
+  // The function is left to the interpreter, emit a thunk to the interpreter
+  // bridge instead
+  void compileInterpThunk(asmjit::CodeHolder *Code) {
+    ZEN_ASSERT(Code != nullptr);
+    CodeGenImpl CodeGen(Layout, Patcher, Code, Ctx);
+    CodeGen.emitInterpThunk(Ctx);
+  }
+
 private:
   ABIType ABI;
   DataLayout Layout;
@@ -12,7 +12,9 @@
 //
 // ============================================================================
 
+#include "common/enums.h"
 #include "singlepass/common/definitions.h"
+#include "utils/wasm.h"
 #include <vector>
 
 // ============================================================================
@@ -127,7 +129,7 @@ public:
     LocalInfo(WASMType Type, uint32_t Reg, int32_t Offset)
         : Type(Type), Reg(Reg), Offset(Offset) {
       ZEN_ASSERT(common::to_underlying(Type) < (1 << 4));
-      ZEN_ASSERT(Reg < (1 << 4));
+      ZEN_ASSERT(Reg < ABI::InvalidParamReg);
       ZEN_ASSERT((Offset >= -(1 << 22)) && Offset < (1 << 22));
     }
 
@@ -136,8 +138,14 @@ public:
     int32_t getOffset() const { return Offset; }
     bool inReg() const { return Reg != ABI::InvalidParamReg; }
     void setClearReg() { Reg = ABI::InvalidParamReg; }
+    void setReg(uint32_t R) { Reg = R; }
   }; // LocalInfo
 
+  // a local used once in a loop or 4 times outside loops is worth a register
+  static constexpr uint64_t MinPromotedLocalWeight = 4;
+  // deeper loops don't make a local hotter, avoid overflowing the weight
+  static constexpr uint32_t MaxWeightedLoopDepth = 16;
+
 protected:
   JITCompilerContext *Ctx;       // JIT compile context containing current WASM
                                  // function been jit'ed
@@ -148,20 +156,31 @@ protected:
                                  //   for eval stack
   int32_t StackBudget;           // total stack allocated
   bool ParamInRegister;          // is param still in register
+  // register pinned to each local for the whole function, or
+  // ABI::InvalidParamReg if the local isn't promoted
+  std::vector<uint32_t> PromotedRegs;
+  uint32_t NumPromotedGpLocals; // promoted integer locals
+  uint32_t NumPromotedFpLocals; // promoted floating-point locals
+  // scratch buffers of selectPromotedLocals, kept to reuse the memory
+  std::vector<uint64_t> LocalWeights;
+  std::vector<uint32_t> LocalCandidates;
+  std::vector<bool> BlockIsLoop;
 
 public:
   OnePassDataLayout(ABI &Abi)
       : DataLayout<ABI>(Abi), Ctx(nullptr), GpPresSavedArea(0),
         FpPresSavedArea(0), StackUsed(0), StackBudget(0),
-        ParamInRegister(false) {}
+        ParamInRegister(false), NumPromotedGpLocals(0),
+        NumPromotedFpLocals(0) {}
 
 public:
   void initFunction(JITCompilerContext *JITCtx) {
     Ctx = JITCtx;
-    // save %rbx, %r12, %r13, %r14, %r15
-    // TODO: need to define callee-saved register convention
-    GpPresSavedArea = 0; // ABI::GpRegWidth * ABI::NumGpPresRegs;
-    FpPresSavedArea = 0; // ABI::FpRegWidth * ABI::NumFpPresRegs;
+    // callee-saved registers are only saved when they hold promoted locals,
+    // see the concrete data layouts
+    GpPresSavedArea = 0;
+    FpPresSavedArea = 0;
+    selectPromotedLocals();
   }
 
   void finalizeFunction() {
@@ -178,13 +197,18 @@ public:
 
   WASMType getReturnType(uint32_t Index) {
     ZEN_ASSERT(Index < getNumReturns());
-    return static_cast<WASMType>(Ctx->FuncType->ReturnTypes[Index]);
+    return static_cast<WASMType>(Ctx->FuncType->getReturnTypes()[Index]);
   }
 
   uint32_t getIntPresSavedCount() const {
     return GpPresSavedArea / ABI::GpRegWidth;
   }
 
+  // only the low 64 bits of callee-saved fp registers are saved
+  uint32_t getFloatPresSavedCount() const {
+    return FpPresSavedArea / sizeof(double);
+  }
+
   uint32_t getStackBudget() const { return StackBudget; }
 
   LocalInfo getLocalInfo(uint32_t LocalIdx) {
@@ -197,6 +221,116 @@ public:
     ZEN_ASSERT(Locals[LocalIdx].inReg());
     Locals[LocalIdx].setClearReg();
   }
+
+  uint32_t getPromotedReg(uint32_t LocalIdx) const {
+    ZEN_ASSERT(LocalIdx < PromotedRegs.size());
+    return PromotedRegs[LocalIdx];
+  }
+
+  // pin a promoted param to its register after it's saved to stack
+  void setParamInPromotedReg(uint32_t LocalIdx) {
+    ZEN_ASSERT(LocalIdx < Ctx->FuncType->NumParams);
+    ZEN_ASSERT(!Locals[LocalIdx].inReg());
+    ZEN_ASSERT(PromotedRegs[LocalIdx] != ABI::InvalidParamReg);
+    Locals[LocalIdx].setReg(PromotedRegs[LocalIdx]);
+  }
+
+private:
+  WASMType getLocalType(uint32_t LocalIdx) const {
+    uint32_t NumParams = Ctx->FuncType->NumParams;
+    if (LocalIdx < NumParams) {
+      return Ctx->FuncType->getParamTypes()[LocalIdx];
+    }
+    return Ctx->Func->LocalTypes[LocalIdx - NumParams];
+  }
+
+  // pick the hottest locals whose kind matches `IsInt` and pin them to the
+  // local registers of the ABI, return the number of promoted locals
+  uint32_t promoteHottestLocals(bool IsInt, uint32_t NumRegs) {
+    LocalCandidates.clear();
+    for (uint32_t I = 0; I < LocalWeights.size(); ++I) {
+      WASMType Type = getLocalType(I);
+      bool IsIntLocal = Type == WASMType::I32 || Type == WASMType::I64;
+      if (Type == WASMType::V128 || IsIntLocal != IsInt ||
+          LocalWeights[I] < MinPromotedLocalWeight) {
+        continue;
+      }
+      LocalCandidates.push_back(I);
+    }
+    uint32_t NumPromoted =
+        std::min(NumRegs, static_cast<uint32_t>(LocalCandidates.size()));
+    std::partial_sort(LocalCandidates.begin(),
+                      LocalCandidates.begin() + NumPromoted,
+                      LocalCandidates.end(), [this](uint32_t L, uint32_t R) {
+                        return LocalWeights[L] > LocalWeights[R] ||
+                               (LocalWeights[L] == LocalWeights[R] && L < R);
+                      });
+    for (uint32_t I = 0; I < NumPromoted; ++I) {
+      PromotedRegs[LocalCandidates[I]] = IsInt ? ABI::getGpLocalRegNum(I)
+                                               : ABI::getFpLocalRegNum(I);
+    }
+    return NumPromoted;
+  }
+
+  // Count local.get/local.set/local.tee of each local in a linear scan of the
+  // function body, every enclosing loop multiplies the weight by 8. The
+  // hottest locals are kept in the local registers of the ABI for the whole
+  // function instead of on stack.
+  void selectPromotedLocals() {
+    using namespace common;
+    const CodeEntry *Func = Ctx->Func;
+    uint32_t NumLocals = Ctx->FuncType->NumParams + Func->NumLocals;
+    PromotedRegs.assign(NumLocals, ABI::InvalidParamReg);
+    NumPromotedGpLocals = 0;
+    NumPromotedFpLocals = 0;
+    if (NumLocals == 0 || ABI::NumGpLocalRegs + ABI::NumFpLocalRegs == 0) {
+      return;
+    }
+
+    LocalWeights.assign(NumLocals, 0);
+    BlockIsLoop.clear();
+    uint32_t LoopDepth = 0;
+    const uint8_t *Ip = Func->CodePtr;
+    const uint8_t *End = Ip + Func->CodeSize;
+    while (Ip < End) {
+      uint8_t Opcode = *Ip++;
+      switch (Opcode) {
+      case BLOCK:
+      case IF:
+        BlockIsLoop.push_back(false);
+        break;
+      case LOOP:
+        BlockIsLoop.push_back(true);
+        ++LoopDepth;
+        break;
+      case END:
+        // the last end closes the function body
+        if (!BlockIsLoop.empty()) {
+          if (BlockIsLoop.back()) {
+            --LoopDepth;
+          }
+          BlockIsLoop.pop_back();
+        }
+        break;
+      case GET_LOCAL:
+      case SET_LOCAL:
+      case TEE_LOCAL: {
+        uint32_t LocalIdx;
+        Ip = utils::readLEBNumber(Ip, End, LocalIdx);
+        ZEN_ASSERT(LocalIdx < NumLocals);
+        LocalWeights[LocalIdx] +=
+            uint64_t(1) << (3 * std::min(LoopDepth, MaxWeightedLoopDepth));
+        continue;
+      }
+      default:
+        break;
+      }
+      Ip = utils::skipInstructionImmediates(Opcode, Ip, End);
+    }
+
+    NumPromotedGpLocals = promoteHottestLocals(true, ABI::NumGpLocalRegs);
+    NumPromotedFpLocals = promoteHottestLocals(false, ABI::NumFpLocalRegs);
+  }
 };
 
 } // namespace zen::singlepass
@@ -73,7 +73,15 @@ void JITCompiler::compile(Module *Mod) {
 #endif
     OnePassErrorHandler ErrHandler;
     Holder.setErrorHandler(&ErrHandler);
+#ifdef ZEN_BUILD_TARGET_X86_64
+    if (Mod->isInterpOnlyFunction(FuncIdx)) {
+      Compiler.compileInterpThunk(&Holder);
+    } else {
+      Compiler.compile(&Holder);
+    }
+#else
     Compiler.compile(&Holder);
+#endif
 
     Holder.flatten();
     Holder.resolveUnresolvedLinks();
@@ -108,7 +116,8 @@ void JITCompiler::compile(Module *Mod) {
 #endif
 
     Holder.relocateToBase(reinterpret_cast<uint64_t>(FuncJITCode));
-    Holder.copyFlattenedData(FuncJITCode, Holder.codeSize(),
+    Holder.copyFlattenedData(CodeMemPool.getWritableAddr(FuncJITCode),
+                             Holder.codeSize(),
                              asmjit::CopySectionFlags::kPadSectionBuffer);
   }
 
@@ -116,17 +125,22 @@ void JITCompiler::compile(Module *Mod) {
   Compiler.finalizeModule();
 
 #ifdef ZEN_ENABLE_LINUX_PERF
-  utils::JitDumpWriter DumpWriter;
-  for (uint32_t I = 0; I < NumInternalFunctions; ++I) {
-    uint32_t RealFuncIdx = NumImportFunctions + I;
-    CodeEntry *Func = Mod->getCodeEntry(RealFuncIdx);
-    DumpWriter.writeFunc(Mod->getWasmFuncDebugName(RealFuncIdx),
-                         reinterpret_cast<uint64_t>(Func->JITCodePtr),
-                         CodeSizes[I]);
+  auto &PerfRegistry = utils::PerfSymbolRegistry::getInstance();
+  if (PerfRegistry.isEnabled()) {
+    for (uint32_t I = 0; I < NumInternalFunctions; ++I) {
+      uint32_t RealFuncIdx = NumImportFunctions + I;
+      CodeEntry *Func = Mod->getCodeEntry(RealFuncIdx);
+      PerfRegistry.registerCode(Mod->getWasmFuncDebugName(RealFuncIdx),
+                                Func->JITCodePtr, CodeSizes[I]);
+    }
   }
 #endif
 
-  platform::mprotect(JITCode, CodeSize, PROT_READ | PROT_EXEC);
+  CodeMemPool.protectExecutable(JITCode, CodeSize);
+#if defined(ZEN_BUILD_TARGET_AARCH64)
+  __builtin___clear_cache(static_cast<char *>(JITCode),
+                          static_cast<char *>(JITCode) + CodeSize);
+#endif
   Mod->setJITCodeAndSize(JITCode, CodeSize);
 
   Stats.stopRecord(Timer);
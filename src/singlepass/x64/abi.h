@@ -292,6 +292,28 @@ public:
     auto Reg = getTempRegNum<Ty>(Index);
     return X64Reg::getRegRef<Ty>(Reg);
   }
+
+public:
+  // local register, holds a promoted local for the whole function. Locals
+  // are only promoted to callee-saved registers, so calls don't have to save
+  // them. SysV has no callee-saved xmm register, and rbx and r12-r15 already
+  // hold the VM state, so nothing is promoted on x64.
+
+  // local integer register
+  constexpr static uint32_t NumGpLocalRegs = 0;
+
+  // local floating point register
+  constexpr static uint32_t NumFpLocalRegs = 0;
+
+  // get local integer register number with variable index
+  static X64::GP getGpLocalRegNum([[maybe_unused]] uint32_t Index) {
+    ZEN_ABORT();
+  }
+
+  // get local floating point register number with variable index
+  static X64::FP getFpLocalRegNum([[maybe_unused]] uint32_t Index) {
+    ZEN_ABORT();
+  }
 };
 
 } // namespace zen::singlepass
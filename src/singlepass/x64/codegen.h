@@ -11,6 +11,7 @@
 //
 // ============================================================================
 
+#include "entrypoint/entrypoint.h"
 #include "singlepass/common/codegen.h"
 #include "singlepass/common/definitions.h"
 #include "singlepass/common/valtype.h"
@@ -185,10 +186,8 @@ private:
     loadGasVal();
   } // EmitProlog
 
-  // epilog
-  void emitEpilog(Operand Op) {
-    saveGasVal();
-
+  // release the stack cost added in prolog
+  void releaseStackCost() {
 #ifdef ZEN_ENABLE_DWASM
     // update stack cost
     auto StackCostAddr = asmjit::x86::ptr(ABI.getModuleInstReg(),
@@ -196,6 +195,23 @@ private:
                                           sizeof(uint32_t));
     _ sub(StackCostAddr, Ctx->Func->JITStackCost);
 #endif
+  }
+
+  // restore preserved registers and the frame of caller
+  void emitLeaveFrame() {
+    for (uint32_t I = 0; I < Layout.getIntPresSavedCount(); ++I) {
+      const X64::GP Reg = ABI.getPresRegNum<X64::I64>(I);
+      _ mov(X64Reg::getRegRef<X64::I64>(Reg),
+            asmjit::x86::Mem(ABI.getFrameBaseReg(), -(I + 1) * ABI.GpRegWidth));
+    }
+    _ mov(ABI.getStackPointerReg(), ABI.getFrameBaseReg());
+    _ pop(ABI.getFrameBaseReg());
+  }
+
+  // epilog
+  void emitEpilog(Operand Op) {
+    saveGasVal();
+    releaseStackCost();
 
     if (Layout.getNumReturns() > 0) {
       ZEN_ASSERT(Layout.getNumReturns() == 1);
@@ -221,13 +237,7 @@ private:
         ZEN_ASSERT(false);
       }
     }
-    for (uint32_t I = 0; I < Layout.getIntPresSavedCount(); ++I) {
-      const X64::GP Reg = ABI.getPresRegNum<X64::I64>(I);
-      _ mov(X64Reg::getRegRef<X64::I64>(Reg),
-            asmjit::x86::Mem(ABI.getFrameBaseReg(), -(I + 1) * ABI.GpRegWidth));
-    }
-    _ mov(ABI.getStackPointerReg(), ABI.getFrameBaseReg());
-    _ pop(ABI.getFrameBaseReg());
+    emitLeaveFrame();
     _ ret();
   } // EmitEpilog
 
@@ -284,6 +294,17 @@ public:
   // initialization and finalization
   //
 
+  // emit the thunk of a function left to the interpreter in place of its
+  // code, which jumps to the interpreter bridge with the function index
+  void emitInterpThunk(JITCompilerContext *Ctx) {
+    Patcher.initFunction(Ctx->Func, Ctx->InternalFuncIdx);
+    uint32_t FuncIdx =
+        Ctx->InternalFuncIdx + Ctx->Mod->getNumImportFunctions();
+    _ mov(asmjit::x86::r10d, FuncIdx);
+    _ mov(asmjit::x86::r11, uintptr_t(Instance::callInterpOnJIT));
+    _ jmp(uintptr_t(callInterpFromSinglepassJIT));
+  }
+
   // finalization after compiling a function
   void finalizeFunction() {
     // update RSP adjustment in prolog with the actual frame size
@@ -787,6 +808,13 @@ public:
         Op, std::integral_constant<bool, Sext>());
   }
 
+  template <WASMType DestType, WASMType SrcType, bool Sext>
+  Operand handleFloatToIntSatImpl(Operand Op) {
+    // tag dispatch
+    return handleFloatToIntSatImpl<DestType, SrcType>(
+        Op, std::integral_constant<bool, Sext>());
+  }
+
   // extend from stype to dtype in same type kind (integer or floating-point)
   template <WASMType DestType, WASMType SrcType, bool Sext>
   Operand handleIntExtendImpl(Operand Op) {
@@ -1120,33 +1148,22 @@ public:
     if (!Index.isReg()) {
       _ mov(IndexReg, Index.getMem<X64::I32>());
     }
+    // binary search when the table consists of few runs
+    auto Runs = getBranchTableRuns(LabelIdxs);
+    if (Runs.size() <= MaxBranchTreeRuns) {
+      emitBranchTableTree(Runs, 0, Runs.size(),
+                          [&](uint32_t Imm, uint32_t LabelIdx) {
+                            _ cmp(IndexReg, Imm);
+                            _ jae(asmjit::Label(LabelIdx));
+                          });
+      return;
+    }
+
     // compare index with bound
     _ cmp(IndexReg, Bound);
     // jump to default label if index >= bound
     _ jae(asmjit::Label(LabelIdxs[Bound]));
 
-    // for small tables, generate if (index == i) goto i;
-    switch (Bound) {
-    case 4:
-      _ cmp(IndexReg, 3);
-      _ je(asmjit::Label(LabelIdxs[3]));
-      // fall through
-    case 3:
-      _ cmp(IndexReg, 2);
-      _ je(asmjit::Label(LabelIdxs[2]));
-      // fall through
-    case 2:
-      _ cmp(IndexReg, 1);
-      _ je(asmjit::Label(LabelIdxs[1]));
-      // fall through
-    case 1:
-      _ cmp(IndexReg, 0);
-      _ je(asmjit::Label(LabelIdxs[0]));
-      return;
-    default:
-      break;
-    }
-
     // jump to entry in jump table
     uint32_t Table = createLabel();
     auto JmpReg = Layout.getScopedTempReg<X64::I64, ScopedTempReg2>();
@@ -1289,6 +1306,17 @@ public:
   // return
   void handleReturnImpl(Operand Op) { emitEpilog(Op); }
 
+  // tail call, the arguments are already in registers, jump to the callee
+  // with the return address of caller on the top of stack
+  void handleReturnCallImpl(uint32_t FuncIdx) {
+    emitLeaveFrame();
+    size_t Offset = _ offset();
+    _ dw(0);
+    _ dd(0); // reserve 6 bytes
+    ZEN_ASSERT(_ offset() - Offset == 6);
+    Patcher.addJumpEntry(Offset, _ offset() - Offset, FuncIdx);
+  }
+
   // unreachable
   void handleUnreachableImpl() {
     _ jmp(getExceptLabel(ErrorCode::Unreachable));
@@ -1308,7 +1336,9 @@ public:
         .NumParamCells = 1,
         .NumReturns = 1,
         .NumReturnCells = 1,
-        .ReturnTypes = {WASMType::I32},
+        {
+            .ReturnTypesVec = {WASMType::I32},
+        },
         {
             .ParamTypesVec = {WASMType::I32},
         },
@@ -1840,6 +1870,118 @@ private:
     return Ret;
   }
 
+  // saturating truncate float to signed integer
+  template <WASMType DestType, WASMType SrcType>
+  Operand handleFloatToIntSatImpl(Operand Opnd, std::true_type) {
+    constexpr auto X64DestType = getX64TypeFromWASMType<DestType>();
+    constexpr auto X64SrcType = getX64TypeFromWASMType<SrcType>();
+
+    auto Ret = getTempOperand(DestType);
+    auto RetReg = Ret.isReg()
+                      ? Ret.getRegRef<X64DestType>()
+                      : Layout.getScopedTempReg<X64DestType, ScopedTempReg0>();
+    if (!Opnd.isReg()) {
+      auto RegNum = Layout.getScopedTemp<X64SrcType, ScopedTempReg0>();
+      mov<X64SrcType>(RegNum, Opnd);
+      Opnd = Operand(SrcType, RegNum, Operand::FLAG_NONE);
+    }
+    auto OpndReg = Opnd.getRegRef<X64SrcType>();
+
+    // cvtts*2si returns INT_MIN for NaN and all out of range values
+    ConvertOpImpl<X64DestType, X64SrcType, true>::emit(ASM, RetReg, OpndReg);
+
+    auto Finish = _ newLabel();
+    _ cmp(RetReg, 1);
+    _ jno(Finish);
+
+    auto IsNaN = _ newLabel();
+    ASM.cmp<X64SrcType>(OpndReg, OpndReg);
+    _ jp(IsNaN);
+
+    // negative values keep INT_MIN, positive values saturate to INT_MAX
+    auto TmpFReg = Layout.getScopedTempReg<X64SrcType, ScopedTempReg1>();
+    ASM.xor_<X64SrcType>(TmpFReg, TmpFReg);
+    ASM.cmp<X64SrcType>(TmpFReg, OpndReg);
+    _ jae(Finish);
+    _ mov(RetReg,
+          std::numeric_limits<typename WASMTypeAttr<DestType>::Type>::max());
+    _ jmp(Finish);
+
+    _ bind(IsNaN);
+    _ xor_(RetReg, RetReg);
+
+    _ bind(Finish);
+    if (Ret.isMem()) {
+      ASM.mov<X64DestType>(Ret.getMem<X64DestType>(), RetReg);
+    }
+    return Ret;
+  }
+
+  // saturating truncate float to unsigned integer
+  template <WASMType DestType, WASMType SrcType>
+  Operand handleFloatToIntSatImpl(Operand Op, std::false_type) {
+    constexpr auto X64DestType = getX64TypeFromWASMType<DestType>();
+    constexpr auto X64SrcType = getX64TypeFromWASMType<SrcType>();
+
+    auto Ret = getTempOperand(DestType);
+    auto RetReg = Ret.isReg()
+                      ? Ret.getRegRef<X64DestType>()
+                      : Layout.getScopedTempReg<X64DestType, ScopedTempReg0>();
+    if (!Op.isReg()) {
+      auto RegNum = Layout.getScopedTemp<X64SrcType, ScopedTempReg0>();
+      mov<X64SrcType>(RegNum, Op);
+      Op = Operand(SrcType, RegNum, Operand::FLAG_NONE);
+    }
+    auto OpndReg = Op.getRegRef<X64SrcType>();
+
+    constexpr auto X64IntSrcType =
+        getX64TypeFromWASMType<FloatAttr<SrcType>::IntType>();
+    auto TmpFReg = Layout.getScopedTempReg<X64SrcType, ScopedTempReg1>();
+    auto TmpIReg = Layout.getScopedTempReg<X64IntSrcType, ScopedTempReg1>();
+
+    // NaN, zero and negative values all become 0
+    auto ToZero = _ newLabel();
+    ASM.xor_<X64SrcType>(TmpFReg, TmpFReg);
+    ASM.cmp<X64SrcType>(OpndReg, TmpFReg);
+    _ jbe(ToZero);
+
+    auto IntMax = FloatAttr<SrcType>::template int_max<DestType>();
+    _ mov(TmpIReg, IntMax);
+    ASM.fmov(TmpFReg, TmpIReg);
+
+    auto AboveIntMax = _ newLabel();
+    ASM.cmp<X64SrcType>(OpndReg, TmpFReg);
+    _ jae(AboveIntMax);
+
+    auto Finish = _ newLabel();
+    ConvertOpImpl<X64DestType, X64SrcType, false>::emit(ASM, RetReg, OpndReg);
+    _ jmp(Finish);
+
+    auto ToMax = _ newLabel();
+    _ bind(AboveIntMax);
+    ASM.sub<X64SrcType>(OpndReg, TmpFReg);
+    ConvertOpImpl<X64DestType, X64SrcType, false>::emit(ASM, RetReg, OpndReg);
+    _ cmp(RetReg, 0);
+    _ jl(ToMax);
+    auto TmpIReg2 = Layout.getScopedTempReg<X64DestType, ScopedTempReg2>();
+    _ mov(TmpIReg2, 1UL << (getWASMTypeSize<DestType>() * CHAR_BIT - 1));
+    _ add(RetReg, TmpIReg2);
+    _ jmp(Finish);
+
+    _ bind(ToMax);
+    _ mov(RetReg, -1);
+    _ jmp(Finish);
+
+    _ bind(ToZero);
+    _ xor_(RetReg, RetReg);
+
+    _ bind(Finish);
+    if (!Ret.isReg()) {
+      ASM.mov<X64DestType>(Ret.getMem<X64DestType>(), RetReg);
+    }
+    return Ret;
+  }
+
   // load gas value from 'module_inst' to register
   void loadGasVal() {
     auto InstReg = ABI.getModuleInstReg();
@@ -1,6 +1,7 @@
 // Copyright (C) 2021-2023 the DTVM authors. All Rights Reserved.
 // SPDX-License-Identifier: Apache-2.0
 
+#include "common/code_heap.h"
 #include "common/mem_pool.h"
 
 #include <gtest/gtest.h>
@@ -38,6 +39,91 @@ TEST(Mempool, CodeMemPool) {
   EXPECT_DEATH(Pool.allocate(CodeMemPool::MaxCodeSize), "");
 }
 
+TEST(Mempool, CodeMemPoolWritableAddr) {
+  CodeMemPool Pool;
+  auto *Ptr = static_cast<uint8_t *>(Pool.allocate(32));
+  uint8_t *WritablePtr = Pool.getWritableAddr(Ptr);
+  EXPECT_EQ(Pool.isDualMapped(), WritablePtr != Ptr);
+  EXPECT_EQ(Pool.getWritableAddr(Ptr + 16), WritablePtr + 16);
+
+  WritablePtr[0] = 0xc3;
+  Pool.protectExecutable(Ptr, CodeMemPool::PageSize);
+  EXPECT_EQ(Ptr[0], 0xc3);
+  if (Pool.isDualMapped()) {
+    // Still writable after the code is executable
+    WritablePtr[1] = 0x90;
+    EXPECT_EQ(Ptr[1], 0x90);
+  }
+}
+
+TEST(Mempool, CodeHeap) {
+  auto Heap = CodeHeap::newCodeHeap();
+  if (!Heap) {
+    GTEST_SKIP() << "dual mapping not supported";
+  }
+  constexpr size_t PageSize = CodeMemPool::PageSize;
+  EXPECT_EQ(CodeHeap::getBlockSize(1), PageSize);
+  EXPECT_EQ(CodeHeap::getBlockSize(PageSize * 3), PageSize * 4);
+  EXPECT_EQ(CodeHeap::getBlockSize(PageSize * 65), PageSize * 65);
+
+  CodeMemPool Pool1(Heap.get());
+  CodeMemPool Pool2(Heap.get());
+  EXPECT_TRUE(Pool1.isDualMapped());
+
+  // The pools share the region, each pool is rel32 reachable
+  auto *Ptr1 = static_cast<uint8_t *>(Pool1.allocate(10));
+  auto *Ptr2 = static_cast<uint8_t *>(Pool2.allocate(10));
+  EXPECT_EQ(Pool1.getMemStart(), Pool2.getMemStart());
+  EXPECT_NE(Ptr1, Ptr2);
+  EXPECT_EQ(Pool1.allocate(10), Ptr1 + 16);
+  *Pool1.getWritableAddr(Ptr1) = 0xc3;
+  EXPECT_EQ(*Ptr1, 0xc3);
+
+  // Retired code is only reused once no thread runs JIT code
+  auto *Code = static_cast<uint8_t *>(Pool1.allocate(100, PageSize));
+  {
+    CodeHeap::ExecutionScope Scope;
+    Pool1.retire(Code);
+    EXPECT_EQ(Heap->getUsage().RetiredSize, PageSize);
+    EXPECT_NE(Pool2.allocate(100, PageSize), Code);
+  }
+  EXPECT_EQ(Heap->getUsage().RetiredSize, 0u);
+  EXPECT_EQ(Pool2.allocate(100, PageSize), Code);
+
+  // Threads entering JIT code after the retirement don't block it
+  Code = static_cast<uint8_t *>(Pool1.allocate(100, PageSize));
+  Pool1.retire(Code);
+  {
+    CodeHeap::ExecutionScope Scope;
+    EXPECT_EQ(Pool2.allocate(100, PageSize), Code);
+  }
+
+  size_t UsedSize = Heap->getUsage().UsedSize;
+  {
+    CodeMemPool Pool3(Heap.get());
+    Pool3.allocate(PageSize * 100, PageSize);
+    EXPECT_EQ(Heap->getUsage().UsedSize, UsedSize + PageSize * 100);
+  }
+  EXPECT_EQ(Heap->getUsage().UsedSize, UsedSize);
+  EXPECT_EQ(Heap->getUsage().FreeSize, PageSize * 100);
+
+  // The code of a destroyed pool is retired as well
+  {
+    CodeHeap::ExecutionScope Scope;
+    size_t Pool4Size = 0;
+    {
+      CodeMemPool Pool4(Heap.get());
+      Code = static_cast<uint8_t *>(Pool4.allocate(100, PageSize));
+      Pool4.allocate(10);
+      Pool4Size = Heap->getUsage().UsedSize - UsedSize;
+    }
+    EXPECT_EQ(Heap->getUsage().UsedSize, UsedSize);
+    EXPECT_EQ(Heap->getUsage().RetiredSize, Pool4Size);
+    EXPECT_NE(Pool2.allocate(100, PageSize), Code);
+  }
+  EXPECT_EQ(Heap->getUsage().RetiredSize, 0u);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,938 @@
+// Copyright (C) 2021-2023 the DTVM authors. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "common/work_stealing_pool.h"
+#ifdef ZEN_ENABLE_MULTIPASS_JIT
+#include "compiler/compiler.h"
+#include "compiler/context.h"
+#include "compiler/lazy_profile.h"
+#include <condition_variable>
+#include <unistd.h>
+#endif
+#include "zetaengine.h"
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace zen::test {
+
+using namespace zen;
+using namespace common;
+using namespace runtime;
+
+// (module
+//   (func (export "add") (param i32 i32) (result i32)
+//     local.get 0 local.get 1 i32.add))
+static const uint8_t AddModuleBuffer[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01,
+    0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07,
+    0x07, 0x01, 0x03, 0x61, 0x64, 0x64, 0x00, 0x00, 0x0a, 0x09, 0x01,
+    0x07, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6a, 0x0b,
+};
+
+static RuntimeConfig getTestRuntimeConfig() {
+  RuntimeConfig Config;
+#ifdef ZEN_ENABLE_BUILTIN_WASI
+  Config.DisableWASI = true;
+#endif
+#ifndef ZEN_ENABLE_SINGLEPASS_JIT
+  Config.Mode = RunMode::InterpMode;
+#endif
+  return Config;
+}
+
+TEST(ModuleStream, LoadByteByByte) {
+  auto RT = Runtime::newRuntime(getTestRuntimeConfig());
+  ASSERT_NE(RT, nullptr);
+
+  auto Stream = RT->startModuleStream("add", sizeof(AddModuleBuffer));
+  ASSERT_NE(Stream, nullptr);
+  std::thread Producer([&Stream] {
+    for (size_t I = 0; I < sizeof(AddModuleBuffer); ++I) {
+      EXPECT_TRUE(Stream->append(&AddModuleBuffer[I], 1));
+    }
+  });
+  Producer.join();
+  MayBe<Module *> ModRet = Stream->finish();
+  ASSERT_TRUE(ModRet);
+
+  Isolation *Iso = RT->createManagedIsolation();
+  ASSERT_NE(Iso, nullptr);
+  MayBe<Instance *> InstRet = Iso->createInstance(**ModRet);
+  ASSERT_TRUE(InstRet);
+
+  std::vector<TypedValue> Results;
+  EXPECT_TRUE(RT->callWasmFunction(**InstRet, "add", {"2", "3"}, Results));
+  ASSERT_EQ(Results.size(), 1u);
+  EXPECT_EQ(Results[0].Value.I32, 5);
+}
+
+TEST(ModuleStream, TruncatedStream) {
+  auto RT = Runtime::newRuntime(getTestRuntimeConfig());
+  ASSERT_NE(RT, nullptr);
+
+  auto Stream = RT->startModuleStream("add", sizeof(AddModuleBuffer));
+  ASSERT_NE(Stream, nullptr);
+  EXPECT_TRUE(Stream->append(AddModuleBuffer, sizeof(AddModuleBuffer) - 3));
+  MayBe<Module *> ModRet = Stream->finish();
+  ASSERT_FALSE(ModRet);
+  EXPECT_EQ(ModRet.getError().getCode(), ErrorCode::UnexpectedEnd);
+
+  // The name is released, so the module can be loaded again
+  Stream = RT->startModuleStream("add", sizeof(AddModuleBuffer));
+  ASSERT_NE(Stream, nullptr);
+  EXPECT_FALSE(Stream->append(AddModuleBuffer, sizeof(AddModuleBuffer) + 1));
+  EXPECT_TRUE(Stream->append(AddModuleBuffer, sizeof(AddModuleBuffer)));
+  EXPECT_TRUE(Stream->finish());
+}
+
+static void appendU32(std::vector<uint8_t> &Buf, uint32_t Value) {
+  do {
+    uint8_t Byte = Value & 0x7f;
+    Value >>= 7;
+    Buf.push_back(Value ? (Byte | 0x80) : Byte);
+  } while (Value);
+}
+
+static void appendSection(std::vector<uint8_t> &Buf, uint8_t SecId,
+                          const std::vector<uint8_t> &Content) {
+  Buf.push_back(SecId);
+  appendU32(Buf, Content.size());
+  Buf.insert(Buf.end(), Content.begin(), Content.end());
+}
+
+// Build a module whose functions are `(func nop ... nop)`, large enough to be
+// validated in parallel, `Bodies` overrides the encoded bodies(locals and
+// instructions) of some functions
+static std::vector<uint8_t>
+buildNopModule(uint32_t NumFuncs,
+               const std::vector<std::pair<uint32_t, std::vector<uint8_t>>>
+                   &Bodies = {}) {
+  constexpr uint32_t NumNops = 8192;
+  std::vector<uint8_t> Buf = {0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00};
+  appendSection(Buf, 0x01, {0x01, 0x60, 0x00, 0x00});
+
+  std::vector<uint8_t> FuncSec;
+  appendU32(FuncSec, NumFuncs);
+  FuncSec.insert(FuncSec.end(), NumFuncs, 0x00);
+  appendSection(Buf, 0x03, FuncSec);
+
+  std::vector<uint8_t> CodeSec;
+  appendU32(CodeSec, NumFuncs);
+  for (uint32_t I = 0; I < NumFuncs; ++I) {
+    std::vector<uint8_t> Body(NumNops + 2, 0x01);
+    Body.front() = 0x00;
+    Body.back() = 0x0b;
+    for (const auto &[FuncIdx, CustomBody] : Bodies) {
+      if (FuncIdx == I) {
+        Body = CustomBody;
+      }
+    }
+    appendU32(CodeSec, Body.size());
+    CodeSec.insert(CodeSec.end(), Body.begin(), Body.end());
+  }
+  appendSection(Buf, 0x0a, CodeSec);
+  return Buf;
+}
+
+TEST(ModuleLoader, ParallelValidation) {
+  RuntimeConfig Config = getTestRuntimeConfig();
+  Config.Mode = RunMode::InterpMode;
+  Config.NumValidationThreads = 4;
+  auto RT = Runtime::newRuntime(Config);
+  ASSERT_NE(RT, nullptr);
+
+  std::vector<uint8_t> Buf = buildNopModule(64);
+  MayBe<Module *> ModRet = RT->loadModule("nops", Buf.data(), Buf.size());
+  ASSERT_TRUE(ModRet);
+  EXPECT_EQ((*ModRet)->getNumInternalFunctions(), 64u);
+}
+
+TEST(ModuleLoader, ParallelValidationLowestError) {
+  RuntimeConfig Config = getTestRuntimeConfig();
+  Config.Mode = RunMode::InterpMode;
+  Config.NumValidationThreads = 4;
+  auto RT = Runtime::newRuntime(Config);
+  ASSERT_NE(RT, nullptr);
+
+  // Function 10 uses an unsupported opcode and function 40 calls an unknown
+  // function
+  std::vector<uint8_t> Buf = buildNopModule(
+      64, {{40, {0x00, 0x10, 0xff, 0xff, 0x03, 0x0b}},
+           {10, {0x00, 0xff, 0x0b}}});
+  for (int Round = 0; Round < 8; ++Round) {
+    MayBe<Module *> ModRet =
+        RT->loadModule("bad" + std::to_string(Round), Buf.data(), Buf.size());
+    ASSERT_FALSE(ModRet);
+    EXPECT_EQ(ModRet.getError().getCode(), ErrorCode::UnsupportedOpcode);
+  }
+
+  // Function 20 declares too many locals, which is found before validating
+  // the preceding bodies in parallel, but must not hide their errors
+  Buf = buildNopModule(64, {{20, {0x01, 0xff, 0xff, 0xff, 0xff, 0x0f, 0x7f,
+                                  0x0b}},
+                            {10, {0x00, 0xff, 0x0b}}});
+  MayBe<Module *> ModRet = RT->loadModule("locals", Buf.data(), Buf.size());
+  ASSERT_FALSE(ModRet);
+  EXPECT_EQ(ModRet.getError().getCode(), ErrorCode::UnsupportedOpcode);
+
+  Buf = buildNopModule(64, {{20, {0x01, 0xff, 0xff, 0xff, 0xff, 0x0f, 0x7f,
+                                  0x0b}}});
+  ModRet = RT->loadModule("locals", Buf.data(), Buf.size());
+  ASSERT_FALSE(ModRet);
+  EXPECT_EQ(ModRet.getError().getCode(), ErrorCode::TooManyLocals);
+}
+
+static void appendName(std::vector<uint8_t> &Buf, const std::string &Name) {
+  appendU32(Buf, Name.size());
+  Buf.insert(Buf.end(), Name.begin(), Name.end());
+}
+
+// (module
+//   (func (export "use_gas") (param i64))
+//   (func (export "copy") (param i32 i32 i32)
+//     local.get 0 local.get 1 local.get 2 memory.copy)
+//   (func (export "fill") (param i32 i32 i32)
+//     local.get 0 local.get 1 local.get 2 memory.fill)
+//   (func (export "init") (param i32 i32 i32)
+//     local.get 0 local.get 1 local.get 2 memory.init 0)
+//   (func (export "drop") data.drop 0)
+//   (func (export "load8") (param i32) (result i32)
+//     local.get 0 i32.load8_u)
+//   (func (export "sat_s") (param f32) (result i32)
+//     local.get 0 i32.trunc_sat_f32_s)
+//   (func (export "sat_u") (param f64) (result i64)
+//     local.get 0 i64.trunc_sat_f64_u)
+//   (memory 1)
+//   (data "hello")
+//   (data (i32.const 100) "abc"))
+static std::vector<uint8_t> buildBulkMemoryModule() {
+  std::vector<uint8_t> Buf = {0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00};
+  appendSection(Buf, 0x01,
+                {0x06, 0x60, 0x01, 0x7e, 0x00, 0x60, 0x03, 0x7f, 0x7f, 0x7f,
+                 0x00, 0x60, 0x00, 0x00, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x60,
+                 0x01, 0x7d, 0x01, 0x7f, 0x60, 0x01, 0x7c, 0x01, 0x7e});
+  appendSection(Buf, 0x03, {0x08, 0x00, 0x01, 0x01, 0x01, 0x02, 0x03, 0x04,
+                            0x05});
+  appendSection(Buf, 0x05, {0x01, 0x00, 0x01});
+
+  const char *ExportNames[] = {
+      "use_gas",
+      "copy",
+      "fill",
+      "init",
+      "drop",
+      "load8",
+      "sat_s",
+      "sat_u",
+  };
+  std::vector<uint8_t> ExportSec = {std::size(ExportNames)};
+  for (uint8_t I = 0; I < std::size(ExportNames); ++I) {
+    appendName(ExportSec, ExportNames[I]);
+    ExportSec.push_back(0x00);
+    ExportSec.push_back(I);
+  }
+  appendSection(Buf, 0x07, ExportSec);
+
+  appendSection(Buf, 0x0c, {0x02});
+
+  const std::vector<uint8_t> Bodies[] = {
+      {0x00, 0x0b},
+      {0x00, 0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0xfc, 0x0a, 0x00, 0x00, 0x0b},
+      {0x00, 0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0xfc, 0x0b, 0x00, 0x0b},
+      {0x00, 0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0xfc, 0x08, 0x00, 0x00, 0x0b},
+      {0x00, 0xfc, 0x09, 0x00, 0x0b},
+      {0x00, 0x20, 0x00, 0x2d, 0x00, 0x00, 0x0b},
+      {0x00, 0x20, 0x00, 0xfc, 0x00, 0x0b},
+      {0x00, 0x20, 0x00, 0xfc, 0x07, 0x0b},
+  };
+  std::vector<uint8_t> CodeSec = {std::size(Bodies)};
+  for (const auto &Body : Bodies) {
+    appendU32(CodeSec, Body.size());
+    CodeSec.insert(CodeSec.end(), Body.begin(), Body.end());
+  }
+  appendSection(Buf, 0x0a, CodeSec);
+
+  appendSection(Buf, 0x0b,
+                {0x02, 0x01, 0x05, 'h', 'e', 'l', 'l', 'o', 0x00, 0x41, 0xe4,
+                 0x00, 0x0b, 0x03, 'a', 'b', 'c'});
+  return Buf;
+}
+
+static int32_t loadByte(Runtime &RT, Instance &Inst, uint32_t Addr) {
+  std::vector<TypedValue> Results;
+  EXPECT_TRUE(RT.callWasmFunction(Inst, "load8", {std::to_string(Addr)},
+                                  Results));
+  return Results.empty() ? -1 : Results[0].Value.I32;
+}
+
+static ErrorCode callBulkOp(Runtime &RT, Instance &Inst,
+                            const std::string &Name,
+                            const std::vector<std::string> &Args) {
+  std::vector<TypedValue> Results;
+  if (RT.callWasmFunction(Inst, Name, Args, Results)) {
+    return ErrorCode::NoError;
+  }
+  ErrorCode ErrCode = Inst.getError().getCode();
+  Inst.clearError();
+  return ErrCode;
+}
+
+TEST(SharedModule, ConcurrentInstances) {
+  auto RT = Runtime::newRuntime(getTestRuntimeConfig());
+  ASSERT_NE(RT, nullptr);
+  std::vector<uint8_t> Buf = buildBulkMemoryModule();
+  MayBe<Module *> ModRet = RT->loadModule("shared", Buf.data(), Buf.size());
+  ASSERT_TRUE(ModRet);
+  Module &Mod = **ModRet;
+
+  // Every thread runs its own instances of the module, their memories must
+  // stay apart
+  constexpr uint32_t NumThreads = 8;
+  constexpr uint32_t NumRounds = 20;
+  std::vector<std::thread> Threads;
+  for (uint32_t T = 0; T < NumThreads; ++T) {
+    Threads.emplace_back([&RT, &Mod, T]() {
+      Isolation *Iso = RT->createManagedIsolation();
+      ASSERT_NE(Iso, nullptr);
+      for (uint32_t R = 0; R < NumRounds; ++R) {
+        MayBe<Instance *> InstRet = Iso->createInstance(Mod);
+        ASSERT_TRUE(InstRet);
+        Instance &Inst = **InstRet;
+        EXPECT_EQ(loadByte(*RT, Inst, 100), 'a');
+        std::string Value = std::to_string(T + 1);
+        EXPECT_EQ(callBulkOp(*RT, Inst, "fill", {"0", Value, "16"}),
+                  ErrorCode::NoError);
+        EXPECT_EQ(loadByte(*RT, Inst, 15), static_cast<int32_t>(T + 1));
+        EXPECT_TRUE(Iso->deleteInstance(&Inst));
+      }
+      EXPECT_TRUE(RT->deleteManagedIsolation(Iso));
+    });
+  }
+  for (std::thread &Thread : Threads) {
+    Thread.join();
+  }
+}
+
+TEST(BulkMemory, ChargedWhenMetered) {
+  auto RT = Runtime::newRuntime(getTestRuntimeConfig());
+  ASSERT_NE(RT, nullptr);
+  std::vector<uint8_t> Buf = buildBulkMemoryModule();
+  MayBe<Module *> ModRet = RT->loadModule("bulk_gas", Buf.data(), Buf.size());
+  ASSERT_TRUE(ModRet);
+  // The module has no gas function
+  ASSERT_EQ((*ModRet)->getGasFuncIdx(), -1u);
+  Isolation *Iso = RT->createManagedIsolation();
+  ASSERT_NE(Iso, nullptr);
+
+  MayBe<Instance *> InstRet = Iso->createInstance(**ModRet);
+  ASSERT_TRUE(InstRet);
+  Instance &Inst = **InstRet;
+  EXPECT_FALSE(Inst.isGasMetered());
+  EXPECT_EQ(callBulkOp(*RT, Inst, "fill", {"0", "1", "16"}),
+            ErrorCode::NoError);
+  EXPECT_EQ(Inst.getGas(), 0u);
+
+  MayBe<Instance *> MeteredRet = Iso->createInstance(**ModRet, 100);
+  ASSERT_TRUE(MeteredRet);
+  Instance &Metered = **MeteredRet;
+  EXPECT_TRUE(Metered.isGasMetered());
+  EXPECT_EQ(callBulkOp(*RT, Metered, "fill", {"0", "1", "16"}),
+            ErrorCode::NoError);
+  EXPECT_EQ(Metered.getGas(), 100 - 16 * BulkMemoryGasPerByte);
+  EXPECT_EQ(callBulkOp(*RT, Metered, "copy", {"200", "100", "3"}),
+            ErrorCode::NoError);
+  EXPECT_EQ(Metered.getGas(), 100 - 19 * BulkMemoryGasPerByte);
+  // Running out of gas leaves the memory untouched
+  EXPECT_EQ(callBulkOp(*RT, Metered, "fill", {"32", "2", "100"}),
+            ErrorCode::GasLimitExceeded);
+  EXPECT_EQ(Metered.getGas(), 0u);
+  EXPECT_EQ(loadByte(*RT, Metered, 32), 0);
+  EXPECT_TRUE(RT->deleteManagedIsolation(Iso));
+}
+
+static int32_t sumHostBuffer(Instance *Inst, host::HostBuffer Buf) {
+  int32_t Sum = 0;
+  for (uint32_t I = 0; I < Buf.Len; ++I) {
+    Sum += Buf.Ptr[I];
+  }
+  return Sum;
+}
+
+static void storeHostBytes(Instance *Inst, int32_t Value,
+                           host::HostBytes<4> Dst) {
+  std::memcpy(Dst.Ptr, &Value, sizeof(Value));
+}
+
+static int32_t untypedHostFunc(Instance *Inst, int32_t Offset) {
+  return Offset;
+}
+
+TEST(HostTrampoline, TypedParams) {
+  using host::getHostFuncEntry;
+  static_assert(getHostFuncEntry<untypedHostFunc>() == &untypedHostFunc);
+  auto *Sum = getHostFuncEntry<sumHostBuffer>();
+  static_assert(std::is_same_v<decltype(Sum),
+                               int32_t (*)(Instance *, int32_t, int32_t)>);
+  auto *Store = getHostFuncEntry<storeHostBytes>();
+  static_assert(std::is_same_v<decltype(Store),
+                               void (*)(Instance *, int32_t, int32_t)>);
+
+  auto RT = Runtime::newRuntime(getTestRuntimeConfig());
+  ASSERT_NE(RT, nullptr);
+  std::vector<uint8_t> Buf = buildBulkMemoryModule();
+  MayBe<Module *> ModRet = RT->loadModule("host_tramp", Buf.data(), Buf.size());
+  ASSERT_TRUE(ModRet);
+  Isolation *Iso = RT->createManagedIsolation();
+  ASSERT_NE(Iso, nullptr);
+  MayBe<Instance *> InstRet = Iso->createInstance(**ModRet);
+  ASSERT_TRUE(InstRet);
+  Instance &Inst = **InstRet;
+
+  EXPECT_EQ(Sum(&Inst, 100, 3), 'a' + 'b' + 'c');
+  EXPECT_FALSE(Inst.hasError());
+  EXPECT_EQ(Sum(&Inst, 65536, 0), 0);
+  EXPECT_FALSE(Inst.hasError());
+
+  // The host function isn't called if any range is out of bounds
+  EXPECT_EQ(Sum(&Inst, 65535, 2), 0);
+  EXPECT_EQ(Inst.getError().getCode(), ErrorCode::OutOfBoundsMemory);
+  Inst.clearError();
+  EXPECT_EQ(Sum(&Inst, 100, -1), 0);
+  EXPECT_EQ(Inst.getError().getCode(), ErrorCode::OutOfBoundsMemory);
+  Inst.clearError();
+
+  Store(&Inst, 0x04030201, 65532);
+  EXPECT_FALSE(Inst.hasError());
+  EXPECT_EQ(loadByte(*RT, Inst, 65535), 4);
+  Store(&Inst, 0x7f, 65533);
+  EXPECT_EQ(Inst.getError().getCode(), ErrorCode::OutOfBoundsMemory);
+  Inst.clearError();
+  EXPECT_EQ(loadByte(*RT, Inst, 65533), 2);
+}
+
+// (module
+//   (import "env" "memcpy" (func (param i32 i32 i32) (result i32)))
+//   (import "env" "memcmp" (func (param i32 i32 i32) (result i32)))
+//   (import "env" "strlen" (func (param i32) (result i32)))
+//   (func (export "copy") (param i32 i32 i32) (result i32)
+//     local.get 0 local.get 1 local.get 2 call 0)
+//   (func (export "cmp") (param i32 i32 i32) (result i32)
+//     local.get 0 local.get 1 local.get 2 call 1)
+//   (func (export "len") (param i32) (result i32) local.get 0 call 2)
+//   (func (export "len_tail") (param i32) (result i32)
+//     local.get 0 return_call 2)
+//   (func (export "load8") (param i32) (result i32) local.get 0 i32.load8_u)
+//   (memory 1)
+//   (data (i32.const 0) "hello\00")
+//   (data (i32.const 16) "help"))
+static std::vector<uint8_t> buildIntrinsicModule() {
+  std::vector<uint8_t> Buf = {0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00};
+  appendSection(Buf, 0x01,
+                {0x02, 0x60, 0x03, 0x7f, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x01,
+                 0x7f, 0x01, 0x7f});
+
+  const std::pair<const char *, uint8_t> Imports[] = {
+      {"memcpy", 0}, {"memcmp", 0}, {"strlen", 1}};
+  std::vector<uint8_t> ImportSec = {std::size(Imports)};
+  for (const auto &[Name, TypeIdx] : Imports) {
+    appendName(ImportSec, "env");
+    appendName(ImportSec, Name);
+    ImportSec.push_back(0x00);
+    ImportSec.push_back(TypeIdx);
+  }
+  appendSection(Buf, 0x02, ImportSec);
+  appendSection(Buf, 0x03, {0x05, 0x00, 0x00, 0x01, 0x01, 0x01});
+  appendSection(Buf, 0x05, {0x01, 0x00, 0x01});
+
+  const char *ExportNames[] = {"copy", "cmp", "len", "len_tail", "load8"};
+  std::vector<uint8_t> ExportSec = {std::size(ExportNames)};
+  for (uint8_t I = 0; I < std::size(ExportNames); ++I) {
+    appendName(ExportSec, ExportNames[I]);
+    ExportSec.push_back(0x00);
+    ExportSec.push_back(std::size(Imports) + I);
+  }
+  appendSection(Buf, 0x07, ExportSec);
+
+  const std::vector<uint8_t> Bodies[] = {
+      {0x00, 0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0x10, 0x00, 0x0b},
+      {0x00, 0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0x10, 0x01, 0x0b},
+      {0x00, 0x20, 0x00, 0x10, 0x02, 0x0b},
+      {0x00, 0x20, 0x00, 0x12, 0x02, 0x0b},
+      {0x00, 0x20, 0x00, 0x2d, 0x00, 0x00, 0x0b},
+  };
+  std::vector<uint8_t> CodeSec = {std::size(Bodies)};
+  for (const auto &Body : Bodies) {
+    appendU32(CodeSec, Body.size());
+    CodeSec.insert(CodeSec.end(), Body.begin(), Body.end());
+  }
+  appendSection(Buf, 0x0a, CodeSec);
+
+  appendSection(Buf, 0x0b,
+                {0x02, 0x00, 0x41, 0x00, 0x0b, 0x06, 'h', 'e', 'l', 'l', 'o',
+                 0x00, 0x00, 0x41, 0x10, 0x0b, 0x04, 'h', 'e', 'l', 'p'});
+  return Buf;
+}
+
+static int32_t callIntrinsicFunc(Runtime &RT, Instance &Inst,
+                                 const std::string &Name,
+                                 const std::vector<std::string> &Args,
+                                 ErrorCode &ErrCode) {
+  std::vector<TypedValue> Results;
+  ErrCode = ErrorCode::NoError;
+  if (!RT.callWasmFunction(Inst, Name, Args, Results)) {
+    ErrCode = Inst.getError().getCode();
+    Inst.clearError();
+    return -1;
+  }
+  return Results.empty() ? -1 : Results[0].Value.I32;
+}
+
+TEST(Intrinsic, LibcImports) {
+  RuntimeConfig Config = getTestRuntimeConfig();
+  Config.EnabledIntrinsics = getIntrinsicMask(IntrinsicKind::MEMCPY) |
+                             getIntrinsicMask(IntrinsicKind::MEMCMP) |
+                             getIntrinsicMask(IntrinsicKind::STRLEN);
+  auto RT = Runtime::newRuntime(Config);
+  ASSERT_NE(RT, nullptr);
+  std::vector<uint8_t> Buf = buildIntrinsicModule();
+  MayBe<Module *> ModRet = RT->loadModule("intrinsic", Buf.data(), Buf.size());
+  ASSERT_TRUE(ModRet);
+  Isolation *Iso = RT->createManagedIsolation();
+  ASSERT_NE(Iso, nullptr);
+  MayBe<Instance *> InstRet = Iso->createInstance(**ModRet);
+  ASSERT_TRUE(InstRet);
+  Instance &Inst = **InstRet;
+
+  ErrorCode ErrCode;
+  EXPECT_EQ(callIntrinsicFunc(*RT, Inst, "len", {"0"}, ErrCode), 5);
+  EXPECT_EQ(callIntrinsicFunc(*RT, Inst, "len_tail", {"16"}, ErrCode), 4);
+  EXPECT_EQ(callIntrinsicFunc(*RT, Inst, "cmp", {"0", "16", "3"}, ErrCode), 0);
+  EXPECT_EQ(callIntrinsicFunc(*RT, Inst, "cmp", {"0", "16", "4"}, ErrCode),
+            'l' - 'p');
+  EXPECT_EQ(callIntrinsicFunc(*RT, Inst, "copy", {"32", "0", "6"}, ErrCode),
+            32);
+  EXPECT_EQ(callIntrinsicFunc(*RT, Inst, "len", {"32"}, ErrCode), 5);
+  EXPECT_EQ(loadByte(*RT, Inst, 36), 'o');
+  EXPECT_EQ(ErrCode, ErrorCode::NoError);
+
+  // Ranges are checked like the bulk memory instructions
+  callIntrinsicFunc(*RT, Inst, "copy", {"65535", "0", "2"}, ErrCode);
+  EXPECT_EQ(ErrCode, ErrorCode::OutOfBoundsMemory);
+  callIntrinsicFunc(*RT, Inst, "cmp", {"0", "65535", "2"}, ErrCode);
+  EXPECT_EQ(ErrCode, ErrorCode::OutOfBoundsMemory);
+  callIntrinsicFunc(*RT, Inst, "len", {"65536"}, ErrCode);
+  EXPECT_EQ(ErrCode, ErrorCode::OutOfBoundsMemory);
+  // The terminator must be within the memory
+  callIntrinsicFunc(*RT, Inst, "copy", {"65531", "16", "4"}, ErrCode);
+  EXPECT_EQ(ErrCode, ErrorCode::NoError);
+  callIntrinsicFunc(*RT, Inst, "copy", {"65535", "16", "1"}, ErrCode);
+  EXPECT_EQ(ErrCode, ErrorCode::NoError);
+  callIntrinsicFunc(*RT, Inst, "len", {"65531"}, ErrCode);
+  EXPECT_EQ(ErrCode, ErrorCode::OutOfBoundsMemory);
+}
+
+TEST(Intrinsic, DisabledByConfig) {
+  // Without an "env" host module, the imports only resolve as intrinsics
+  RuntimeConfig Config = getTestRuntimeConfig();
+  Config.EnabledIntrinsics = getIntrinsicMask(IntrinsicKind::MEMCPY) |
+                             getIntrinsicMask(IntrinsicKind::STRLEN);
+  auto RT = Runtime::newRuntime(Config);
+  ASSERT_NE(RT, nullptr);
+  std::vector<uint8_t> Buf = buildIntrinsicModule();
+  MayBe<Module *> ModRet = RT->loadModule("intrinsic", Buf.data(), Buf.size());
+  ASSERT_FALSE(ModRet);
+  EXPECT_EQ(ModRet.getError().getCode(), ErrorCode::UnknownImport);
+}
+
+static void appendV128(std::vector<uint8_t> &Buf,
+                       std::initializer_list<int32_t> I32Lanes) {
+  Buf.insert(Buf.end(), {0xfd, 0x0c}); // v128.const
+  for (int32_t Lane : I32Lanes) {
+    for (uint32_t I = 0; I < 4; ++I) {
+      Buf.push_back(uint32_t(Lane) >> (I * 8));
+    }
+  }
+}
+
+TEST(SIMD, ParallelValidationFlag) {
+  RuntimeConfig Config = getTestRuntimeConfig();
+  Config.Mode = RunMode::InterpMode;
+  Config.NumValidationThreads = 4;
+  auto RT = Runtime::newRuntime(Config);
+  ASSERT_NE(RT, nullptr);
+
+  std::vector<uint8_t> Buf = buildNopModule(64);
+  MayBe<Module *> ModRet = RT->loadModule("nops", Buf.data(), Buf.size());
+  ASSERT_TRUE(ModRet);
+  EXPECT_FALSE((*ModRet)->usesSIMD());
+
+  std::vector<uint8_t> Body = {0x00};
+  appendV128(Body, {1, 2, 3, 4});
+  Body.insert(Body.end(), {0x1a, 0x0b});
+  Buf = buildNopModule(64, {{30, Body}});
+  ModRet = RT->loadModule("simd_nops", Buf.data(), Buf.size());
+  ASSERT_TRUE(ModRet);
+  EXPECT_TRUE((*ModRet)->usesSIMD());
+  // Only the function using v128 values is left to the interpreter by JIT
+  EXPECT_TRUE((*ModRet)->isInterpOnlyFunction(30));
+  EXPECT_EQ((*ModRet)->isInterpOnlyFunction(29), (*ModRet)->isInterpOnly());
+}
+
+TEST(MultiValue, InterpOnlyFunction) {
+  RuntimeConfig Config = getTestRuntimeConfig();
+  Config.Mode = RunMode::InterpMode;
+  auto RT = Runtime::newRuntime(Config);
+  ASSERT_NE(RT, nullptr);
+
+  // (block (type 0)) in function 3
+  std::vector<uint8_t> Body = {0x00, 0x02, 0x00, 0x0b, 0x0b};
+  std::vector<uint8_t> Buf = buildNopModule(4, {{3, Body}});
+  MayBe<Module *> ModRet = RT->loadModule("block_type", Buf.data(), Buf.size());
+  ASSERT_TRUE(ModRet);
+  EXPECT_TRUE((*ModRet)->usesMultiValue());
+  EXPECT_TRUE((*ModRet)->isInterpOnlyFunction(3));
+  EXPECT_EQ((*ModRet)->isInterpOnlyFunction(2), (*ModRet)->isInterpOnly());
+}
+
+// (module
+//   (func (export "dispatch") (param i32) (result i32)
+//     (block (block (block (block
+//       (br_table 0 1 2 3 1 2 (local.get 0)))
+//       (return (i32.const 10)))
+//       (return (i32.const 11)))
+//       (return (i32.const 12)))
+//     (i32.const 13))
+//   (func (export "small") (param i32) (result i32)
+//     (block (block (br_table 0 1 (local.get 0)))
+//       (return (i32.const 20)))
+//     (i32.const 21)))
+static std::vector<uint8_t> buildBrTableModule() {
+  std::vector<uint8_t> Buf = {0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00};
+  appendSection(Buf, 0x01, {0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f});
+  appendSection(Buf, 0x03, {0x02, 0x00, 0x00});
+
+  std::vector<uint8_t> ExportSec = {0x02};
+  appendName(ExportSec, "dispatch");
+  ExportSec.insert(ExportSec.end(), {0x00, 0x00});
+  appendName(ExportSec, "small");
+  ExportSec.insert(ExportSec.end(), {0x00, 0x01});
+  appendSection(Buf, 0x07, ExportSec);
+
+  const std::vector<uint8_t> Bodies[] = {
+      {0x00, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x20,
+       0x00, 0x0e, 0x05, 0x00, 0x01, 0x02, 0x03, 0x01, 0x02, 0x0b,
+       0x41, 0x0a, 0x0f, 0x0b, 0x41, 0x0b, 0x0f, 0x0b, 0x41, 0x0c,
+       0x0f, 0x0b, 0x41, 0x0d, 0x0b},
+      {0x00, 0x02, 0x40, 0x02, 0x40, 0x20, 0x00, 0x0e, 0x01, 0x00, 0x01,
+       0x0b, 0x41, 0x14, 0x0f, 0x0b, 0x41, 0x15, 0x0b},
+  };
+  std::vector<uint8_t> CodeSec = {std::size(Bodies)};
+  for (const auto &Body : Bodies) {
+    appendU32(CodeSec, Body.size());
+    CodeSec.insert(CodeSec.end(), Body.begin(), Body.end());
+  }
+  appendSection(Buf, 0x0a, CodeSec);
+  return Buf;
+}
+
+TEST(BrTable, DecodedTargets) {
+  auto RT = Runtime::newRuntime(getTestRuntimeConfig());
+  ASSERT_NE(RT, nullptr);
+  std::vector<uint8_t> Buf = buildBrTableModule();
+  MayBe<Module *> ModRet = RT->loadModule("br_table", Buf.data(), Buf.size());
+  ASSERT_TRUE(ModRet);
+  // Only the table with enough targets is pre-decoded, the results are
+  // checked by tests/wast/spec_extra/br_table_extra.wast
+  EXPECT_NE((*ModRet)->getCodeEntry(0)->BrTableTargets, nullptr);
+  EXPECT_EQ((*ModRet)->getCodeEntry(1)->BrTableTargets, nullptr);
+}
+
+TEST(WorkStealingPool, RunAllTasks) {
+  std::atomic<uint64_t> Sum = 0;
+  WorkStealingPool<void, uint32_t> Pool(
+      [&Sum](void *, uint32_t Task) { Sum += Task; }, 4);
+  Pool.start();
+  uint64_t Expected = 0;
+  for (uint32_t I = 1; I <= 10000; ++I) {
+    Pool.pushTask(I, I % 7 == 0 ? TaskPriority::Foreground
+                                : TaskPriority::Background);
+    Expected += I;
+  }
+  Pool.waitForTasks();
+  EXPECT_EQ(Sum, Expected);
+}
+
+TEST(WorkStealingPool, ForegroundFirst) {
+  std::mutex BlockMutex;
+  std::vector<uint32_t> Order;
+  WorkStealingPool<void, uint32_t> Pool(
+      [&](void *, uint32_t Task) {
+        std::lock_guard<std::mutex> Lock(BlockMutex);
+        Order.push_back(Task);
+      },
+      1);
+  {
+    // Keep the only thread busy until all tasks are queued
+    std::unique_lock<std::mutex> Lock(BlockMutex);
+    Pool.start();
+    Pool.pushTask(0);
+    while (Pool.getTasksQueued() != 0) {
+      std::this_thread::yield();
+    }
+    Pool.pushTask(1);
+    Pool.pushTask(2);
+    Pool.pushTask(3, TaskPriority::Foreground);
+  }
+  Pool.waitForTasks();
+  EXPECT_EQ(Order, std::vector<uint32_t>({0, 3, 1, 2}));
+}
+
+TEST(WorkStealingPool, OwnerTakesNewestTask) {
+  std::vector<uint32_t> Order;
+  WorkStealingPool<void, uint32_t> *PoolPtr = nullptr;
+  WorkStealingPool<void, uint32_t> Pool(
+      [&](void *, uint32_t Task) {
+        Order.push_back(Task);
+        if (Task == 0) {
+          // Queued in the deque of the only thread
+          PoolPtr->pushTask(1);
+          PoolPtr->pushTask(2);
+          PoolPtr->pushTask(3);
+        }
+      },
+      1);
+  PoolPtr = &Pool;
+  Pool.start();
+  Pool.pushTask(0);
+  Pool.waitForTasks();
+  EXPECT_EQ(Order, std::vector<uint32_t>({0, 3, 2, 1}));
+}
+
+#ifdef ZEN_ENABLE_MULTIPASS_JIT
+TEST(LazyCompileProfile, SaveAndLoad) {
+  char DirTemplate[] = "/tmp/dtvm_profile_XXXXXX";
+  ASSERT_NE(mkdtemp(DirTemplate), nullptr);
+  std::string Dir = DirTemplate;
+  const uint8_t Bytecode[] = {0x00, 0x61, 0x73, 0x6d, 0x01};
+  uint64_t Hash = COMPILER::LazyCompileProfile::hashModule(Bytecode,
+                                                           sizeof(Bytecode));
+
+  COMPILER::LazyCompileProfile First(Hash, 10);
+  EXPECT_FALSE(First.load(Dir));
+  First.recordCall(3);
+  First.recordCall(7);
+  First.recordCall(3);
+  ASSERT_TRUE(First.save(Dir));
+
+  COMPILER::LazyCompileProfile Second(Hash, 10);
+  ASSERT_TRUE(Second.load(Dir));
+  EXPECT_EQ(Second.getPreviousOrder(), std::vector<uint32_t>({3, 7}));
+  EXPECT_TRUE(Second.isPreviouslyCalled(7));
+  EXPECT_FALSE(Second.isPreviouslyCalled(0));
+  // Functions not called this time are kept after the called ones
+  Second.recordCall(5);
+  ASSERT_TRUE(Second.save(Dir));
+
+  COMPILER::LazyCompileProfile Third(Hash, 10);
+  ASSERT_TRUE(Third.load(Dir));
+  EXPECT_EQ(Third.getPreviousOrder(), std::vector<uint32_t>({5, 3, 7}));
+
+  // A profile of another module never matches
+  COMPILER::LazyCompileProfile Mismatch(Hash, 11);
+  EXPECT_FALSE(Mismatch.load(Dir));
+  EXPECT_FALSE(Mismatch.hasPreviousProfile());
+
+  std::remove(Third.getFilePath(Dir).c_str());
+  rmdir(Dir.c_str());
+}
+
+static std::mutex HookMutex;
+static std::condition_variable HookCV;
+static bool HookReleased = false;
+
+TEST(LazyCompileProfile, CallBeforeBackgroundCompile) {
+  char DirTemplate[] = "/tmp/dtvm_profile_XXXXXX";
+  ASSERT_NE(mkdtemp(DirTemplate), nullptr);
+  std::string Dir = DirTemplate;
+
+  RuntimeConfig Config = getTestRuntimeConfig();
+  Config.Mode = RunMode::MultipassMode;
+  Config.EnableMultipassLazy = true;
+  Config.NumMultipassThreads = 1;
+  Config.MultipassProfileDir = Dir;
+  auto RT = Runtime::newRuntime(Config);
+  ASSERT_NE(RT, nullptr);
+
+  // Hold the background compilation until the function has been called
+  HookReleased = false;
+  COMPILER::LazyJITCompiler::BackgroundCompileHook = [](uint32_t) {
+    std::unique_lock<std::mutex> Lock(HookMutex);
+    HookCV.wait(Lock, [] { return HookReleased; });
+  };
+  MayBe<Module *> ModRet =
+      RT->loadModule("add", AddModuleBuffer, sizeof(AddModuleBuffer));
+  ASSERT_TRUE(ModRet);
+  Module *Mod = *ModRet;
+  Isolation *Iso = RT->createManagedIsolation();
+  ASSERT_NE(Iso, nullptr);
+  MayBe<Instance *> InstRet = Iso->createInstance(*Mod);
+  ASSERT_TRUE(InstRet);
+
+  // Runs the fastRA code
+  std::vector<TypedValue> Results;
+  EXPECT_TRUE(RT->callWasmFunction(**InstRet, "add", {"2", "3"}, Results));
+  EXPECT_EQ(Results[0].Value.I32, 5);
+
+  COMPILER::LazyJITCompiler *Compiler = Mod->getLazyJITCompiler();
+  {
+    std::lock_guard<std::mutex> Lock(HookMutex);
+    HookReleased = true;
+  }
+  HookCV.notify_all();
+  Compiler->waitForBackgroundCompilation();
+  COMPILER::LazyJITCompiler::BackgroundCompileHook = nullptr;
+  EXPECT_NE(Compiler->getInstalledCodePtr(0), nullptr);
+
+  Results.clear();
+  EXPECT_TRUE(RT->callWasmFunction(**InstRet, "add", {"4", "5"}, Results));
+  EXPECT_EQ(Results[0].Value.I32, 9);
+
+  // The profile is saved when the module is unloaded
+  Iso->deleteInstance(*InstRet);
+  RT->unloadModule(Mod);
+  uint64_t Hash = COMPILER::LazyCompileProfile::hashModule(
+      AddModuleBuffer, sizeof(AddModuleBuffer));
+  COMPILER::LazyCompileProfile Saved(Hash, 1);
+  EXPECT_TRUE(Saved.load(Dir));
+  std::remove(Saved.getFilePath(Dir).c_str());
+  rmdir(Dir.c_str());
+}
+
+TEST(CompileTarget, ReusedByLaterContexts) {
+  llvm::LLVMTargetMachine *TM = nullptr;
+  {
+    COMPILER::CompileContext Ctx;
+    Ctx.initialize();
+    TM = &Ctx.getTargetMachine();
+  }
+  // The target of the destroyed context is taken from the pool
+  COMPILER::CompileContext Ctx;
+  Ctx.initialize();
+  EXPECT_EQ(&Ctx.getTargetMachine(), TM);
+  // A context alive at the same time gets its own target
+  COMPILER::CompileContext OtherCtx;
+  OtherCtx.initialize();
+  EXPECT_NE(&OtherCtx.getTargetMachine(), TM);
+
+  // The function arena keeps working after a reset
+  void *Ptr = Ctx.MemPool.allocate(64);
+  Ctx.MemPool.deallocate(Ptr);
+  Ctx.MemPool.reset();
+  EXPECT_NE(Ctx.MemPool.allocate(64), nullptr);
+  Ctx.MemPool.reset();
+}
+
+// (module
+//   (func (export "run") (param i32 i32) (result i32)
+//     local.get 0 local.get 1 call 1)
+//   (func (param i32 i32) (result i32)
+//     local.get 0 local.get 1 i32.add))
+static const uint8_t CallAddModuleBuffer[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x03, 0x02, 0x00, 0x00, 0x07, 0x07,
+    0x01, 0x03, 0x72, 0x75, 0x6e, 0x00, 0x00, 0x0a, 0x12, 0x02, 0x08, 0x00,
+    0x20, 0x00, 0x20, 0x01, 0x10, 0x01, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x20,
+    0x01, 0x6a, 0x0b,
+};
+
+static bool HookReleasedFuncs[2] = {false, false};
+
+TEST(LazyJITCompiler, RetiredCallerCallSites) {
+  RuntimeConfig Config = getTestRuntimeConfig();
+  Config.Mode = RunMode::MultipassMode;
+  Config.EnableMultipassLazy = true;
+  Config.NumMultipassThreads = 2;
+  auto RT = Runtime::newRuntime(Config);
+  ASSERT_NE(RT, nullptr);
+  CodeHeap *Heap = RT->getJITCodeHeap();
+  if (!Heap) {
+    GTEST_SKIP() << "no shared code heap";
+  }
+
+  // Hold the background compilation of each function until released
+  HookReleasedFuncs[0] = HookReleasedFuncs[1] = false;
+  COMPILER::LazyJITCompiler::BackgroundCompileHook = [](uint32_t FuncIdx) {
+    std::unique_lock<std::mutex> Lock(HookMutex);
+    HookCV.wait(Lock, [FuncIdx] { return HookReleasedFuncs[FuncIdx]; });
+  };
+  auto ReleaseFunc = [](uint32_t FuncIdx) {
+    {
+      std::lock_guard<std::mutex> Lock(HookMutex);
+      HookReleasedFuncs[FuncIdx] = true;
+    }
+    HookCV.notify_all();
+  };
+  MayBe<Module *> ModRet = RT->loadModule("call_add", CallAddModuleBuffer,
+                                          sizeof(CallAddModuleBuffer));
+  ASSERT_TRUE(ModRet);
+  Module *Mod = *ModRet;
+  Isolation *Iso = RT->createManagedIsolation();
+  ASSERT_NE(Iso, nullptr);
+  MayBe<Instance *> InstRet = Iso->createInstance(*Mod);
+  ASSERT_TRUE(InstRet);
+
+  // Runs the fastRA code of both functions, the call of the caller goes to
+  // the stub of the callee
+  std::vector<TypedValue> Results;
+  EXPECT_TRUE(RT->callWasmFunction(**InstRet, "run", {"2", "3"}, Results));
+  EXPECT_EQ(Results[0].Value.I32, 5);
+  COMPILER::LazyJITCompiler *Compiler = Mod->getLazyJITCompiler();
+  EXPECT_GE(Compiler->getNumPendingCallSites(1), 1u);
+
+  // The caller tiers up, its fastRA code is retired along with its call, only
+  // the call of its background compiled code is left
+  ReleaseFunc(0);
+  while (!Compiler->getInstalledCodePtr(0)) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(Compiler->getNumPendingCallSites(1), 1u);
+
+  // No thread runs JIT code, so the retired code is reclaimed and reused
+  EXPECT_EQ(Heap->getUsage().RetiredSize, 0u);
+  MayBe<Module *> OtherModRet =
+      RT->loadModule("add", AddModuleBuffer, sizeof(AddModuleBuffer));
+  ASSERT_TRUE(OtherModRet);
+  MayBe<Instance *> OtherInstRet = Iso->createInstance(**OtherModRet);
+  ASSERT_TRUE(OtherInstRet);
+  Results.clear();
+  EXPECT_TRUE(
+      RT->callWasmFunction(**OtherInstRet, "add", {"4", "5"}, Results));
+  EXPECT_EQ(Results[0].Value.I32, 9);
+
+  // The callee tiers up, only the call of the installed caller is patched
+  ReleaseFunc(1);
+  Compiler->waitForBackgroundCompilation();
+  (*OtherModRet)->getLazyJITCompiler()->waitForBackgroundCompilation();
+  COMPILER::LazyJITCompiler::BackgroundCompileHook = nullptr;
+  EXPECT_EQ(Compiler->getNumPendingCallSites(1), 0u);
+
+  Results.clear();
+  EXPECT_TRUE(RT->callWasmFunction(**InstRet, "run", {"6", "7"}, Results));
+  EXPECT_EQ(Results[0].Value.I32, 13);
+  Results.clear();
+  EXPECT_TRUE(
+      RT->callWasmFunction(**OtherInstRet, "add", {"8", "9"}, Results));
+  EXPECT_EQ(Results[0].Value.I32, 17);
+
+  Iso->deleteInstance(*OtherInstRet);
+  Iso->deleteInstance(*InstRet);
+  RT->unloadModule(*OtherModRet);
+  RT->unloadModule(Mod);
+}
+#endif // ZEN_ENABLE_MULTIPASS_JIT
+
+} // namespace zen::test
@@ -15,7 +15,11 @@ struct Header {
   uint32_t Magic = 0x4A695444;
   uint32_t Version = 1;
   uint32_t Size;
-  uint32_t ElfMach = EM_X86_64; // TODO
+#if defined(ZEN_BUILD_TARGET_AARCH64)
+  uint32_t ElfMach = EM_AARCH64;
+#else
+  uint32_t ElfMach = EM_X86_64;
+#endif
   uint32_t Pad1 = 0;
   uint32_t Pid;
   uint64_t Timestamp;
@@ -102,6 +106,82 @@ void JitDumpWriter::writeFunc(std::string FuncName, uint64_t FuncAddr,
   fwrite(&CodeLoad, sizeof(RecordCodeLoad), 1, File);
   fwrite(FuncName.c_str(), NameLen + 1, 1, File);
   fwrite(reinterpret_cast<void *>(FuncAddr), CodeSize, 1, File);
+  fflush(File);
+}
+
+PerfSymbolRegistry &PerfSymbolRegistry::getInstance() {
+  static PerfSymbolRegistry Instance;
+  return Instance;
+}
+
+void PerfSymbolRegistry::enable(bool EnablePerfMap, bool EnableJitDump) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  if (EnablePerfMap && !PerfMap) {
+    PerfMap = std::make_unique<PerfMapWriter>();
+  }
+  if (EnableJitDump && !JitDump) {
+    JitDump = std::make_unique<JitDumpWriter>();
+  }
+  Enabled.store(PerfMap || JitDump, std::memory_order_release);
+}
+
+void PerfSymbolRegistry::registerCode(const std::string &Name,
+                                      const void *CodeAddr,
+                                      uint64_t CodeSize) {
+  if (!isEnabled() || CodeSize == 0) {
+    return;
+  }
+  uint64_t Addr = reinterpret_cast<uint64_t>(CodeAddr);
+  std::lock_guard<std::mutex> Lock(Mutex);
+  LiveSymbols[Addr] = {CodeSize, Name};
+  if (JitDump) {
+    JitDump->writeFunc(Name, Addr, CodeSize);
+  }
+  if (!PerfMap) {
+    return;
+  }
+
+  // The perf map can't express unloading, so rewrite it from the live symbols
+  // once an address range that is still described in the file gets reused
+  bool ReuseReleased = false;
+  auto It = ReleasedRanges.upper_bound(Addr);
+  if (It != ReleasedRanges.begin()) {
+    auto Prev = std::prev(It);
+    ReuseReleased = Prev->second > Addr;
+  }
+  if (!ReuseReleased && It != ReleasedRanges.end()) {
+    ReuseReleased = It->first < Addr + CodeSize;
+  }
+  if (ReuseReleased) {
+    PerfMap->truncate();
+    for (const auto &[SymAddr, Sym] : LiveSymbols) {
+      PerfMap->writeLine(SymAddr, Sym.Size, Sym.Name);
+    }
+    ReleasedRanges.clear();
+  } else {
+    PerfMap->writeLine(Addr, CodeSize, Name);
+  }
+  PerfMap->flush();
+}
+
+void PerfSymbolRegistry::releaseCodeRegion(const void *RegionStart,
+                                           const void *RegionEnd) {
+  if (!isEnabled() || RegionStart >= RegionEnd) {
+    return;
+  }
+  uint64_t Start = reinterpret_cast<uint64_t>(RegionStart);
+  uint64_t End = reinterpret_cast<uint64_t>(RegionEnd);
+  std::lock_guard<std::mutex> Lock(Mutex);
+  auto It = LiveSymbols.lower_bound(Start);
+  if (It == LiveSymbols.end() || It->first >= End) {
+    return;
+  }
+  while (It != LiveSymbols.end() && It->first < End) {
+    It = LiveSymbols.erase(It);
+  }
+  if (PerfMap) {
+    ReleasedRanges[Start] = End;
+  }
 }
 
 } // namespace zen::utils
@@ -4,9 +4,15 @@
 #ifndef ZEN_UTILS_PERF_H
 #define ZEN_UTILS_PERF_H
 
+#include <atomic>
+#include <cstdint>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <unistd.h>
 
 namespace zen::utils {
@@ -16,7 +22,8 @@ public:
   PerfMapWriter() {
     char RealFilename[128];
     snprintf(RealFilename, sizeof(RealFilename), FilenameFormat, getpid());
-    File.open(RealFilename);
+    Filename = RealFilename;
+    File.open(Filename);
   }
 
   ~PerfMapWriter() { File.close(); }
@@ -26,9 +33,18 @@ public:
          << FuncName << "\n";
   }
 
+  void flush() { File.flush(); }
+
+  // Discard all written lines, used when stale symbols must be dropped
+  void truncate() {
+    File.close();
+    File.open(Filename, std::ios::out | std::ios::trunc);
+  }
+
 private:
   static constexpr char FilenameFormat[] = "/tmp/perf-%d.map";
 
+  std::string Filename;
   std::ofstream File;
 };
 
@@ -50,6 +66,49 @@ private:
   long CodeIndex = 0;
 };
 
+// Process-wide sink of JIT code symbols for linux perf. The perf map
+// (/tmp/perf-<pid>.map) and the jitdump (jit-<pid>.dump) outputs are opened on
+// the first runtime that enables them, so the feature costs nothing unless it
+// is switched on in RuntimeConfig. All methods are thread-safe because lazy
+// compilation registers code from background threads.
+//
+// Code released by an unloaded module is removed from the live symbol table.
+// The jitdump keeps the full history since its records carry timestamps, while
+// the perf map has no notion of time and is rewritten from the live table when
+// a released address range gets reused, so it never maps an address to a stale
+// function.
+class PerfSymbolRegistry {
+public:
+  static PerfSymbolRegistry &getInstance();
+
+  void enable(bool EnablePerfMap, bool EnableJitDump);
+
+  bool isEnabled() const { return Enabled.load(std::memory_order_acquire); }
+
+  void registerCode(const std::string &Name, const void *CodeAddr,
+                    uint64_t CodeSize);
+
+  // Drop all symbols in [RegionStart, RegionEnd)
+  void releaseCodeRegion(const void *RegionStart, const void *RegionEnd);
+
+private:
+  PerfSymbolRegistry() = default;
+
+  struct CodeSymbol {
+    uint64_t Size;
+    std::string Name;
+  };
+
+  std::atomic<bool> Enabled = false;
+  std::mutex Mutex;
+  std::unique_ptr<PerfMapWriter> PerfMap;
+  std::unique_ptr<JitDumpWriter> JitDump;
+  // code address => symbol
+  std::map<uint64_t, CodeSymbol> LiveSymbols;
+  // released ranges that are still present in the perf map file
+  std::map<uint64_t, uint64_t> ReleasedRanges;
+};
+
 } // namespace zen::utils
 
 #endif // ZEN_UTILS_PERF_H
@@ -67,9 +67,12 @@ public:
     Data[K] = Val;
   }
 
+  // Returns a value-initialized Value if not found, the map is left
+  // unchanged as other readers may hold the lock meanwhile
   Value get(const Key &K) {
     ReadLock RLock(Mutex);
-    return Data[K];
+    auto It = Data.find(K);
+    return It != Data.end() ? It->second : Value();
   }
 
   std::pair<iterator, bool> insert(const Value &Val) {
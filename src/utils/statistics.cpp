@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "utils/statistics.h"
+#include "common/code_heap.h"
 #include "utils/logging.h"
 #include <cstdio>
 #include <ratio>
@@ -24,9 +25,9 @@ void Statistics::stopRecord(StatisticTimer Timer) {
     return;
   }
 
-  ZEN_ASSERT(Timers.find(Timer) != Timers.end());
-  common::LockGuard<common::Mutex> Lock(Mtx);
   auto End = common::SteadyClock::now();
+  common::LockGuard<common::Mutex> Lock(Mtx);
+  ZEN_ASSERT(Timers.find(Timer) != Timers.end());
   auto Start = Timers[Timer].second;
   float TimeCost =
       common::chrono::duration<float, std::milli>(End - Start).count();
@@ -40,8 +41,8 @@ void Statistics::revertRecord(StatisticTimer Timer) {
     return;
   }
 
-  ZEN_ASSERT(Timers.find(Timer) != Timers.end());
   common::LockGuard<common::Mutex> Lock(Mtx);
+  ZEN_ASSERT(Timers.find(Timer) != Timers.end());
   Timers.erase(Timer);
 }
 
@@ -54,6 +55,20 @@ void Statistics::clearAllTimers() {
   Timers.clear();
 }
 
+Statistics::PhaseTimeCosts Statistics::takePhaseTimeCosts() {
+  PhaseTimeCosts TimeCosts = {};
+  if (!Enabled) {
+    return TimeCosts;
+  }
+
+  common::LockGuard<common::Mutex> Lock(Mtx);
+  for (const auto &[Phase, TimeCost] : Records) {
+    TimeCosts[common::to_underlying(Phase)] += TimeCost;
+  }
+  Records.clear();
+  return TimeCosts;
+}
+
 void Statistics::report() const {
   if (!Enabled) {
     return;
@@ -131,6 +146,17 @@ void Statistics::report() const {
 
   ZEN_LOG_INFO("Total:\t\t%.3fms", TotalTimeCost);
 
+#ifndef ZEN_ENABLE_SGX
+  if (CodeHeap) {
+    constexpr float KB = 1024;
+    auto Usage = CodeHeap->getUsage();
+    ZEN_LOG_INFO("Code Heap:\t\t%zu regions, used %.1fKB, free %.1fKB, "
+                 "retired %.1fKB",
+                 Usage.NumRegions, Usage.UsedSize / KB, Usage.FreeSize / KB,
+                 Usage.RetiredSize / KB);
+  }
+#endif
+
   ZEN_LOG_INFO(
       "=================  [End] ZetaEngine Statistics =================");
 }
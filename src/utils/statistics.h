@@ -6,10 +6,15 @@
 
 #include "common/defines.h"
 
+#include <array>
 #include <chrono>
 #include <unordered_map>
 #include <vector>
 
+namespace zen::common {
+class CodeHeap;
+} // namespace zen::common
+
 namespace zen::utils {
 
 enum class StatisticPhase : uint32_t {
@@ -47,8 +52,24 @@ public:
 
   void report() const;
 
+  typedef std::array<float, common::to_underlying(
+                                StatisticPhase::NumStatisticPhases)>
+      PhaseTimeCosts;
+
+  // Sum up the time costs(ms) of each phase recorded so far and drop the
+  // records, benchmark drivers use it to split one runtime call into phases
+  PhaseTimeCosts takePhaseTimeCosts();
+
+#ifndef ZEN_ENABLE_SGX
+  // Report the occupancy of the shared code heap as well
+  void setCodeHeap(common::CodeHeap *Heap) { CodeHeap = Heap; }
+#endif
+
 private:
   const bool Enabled;
+#ifndef ZEN_ENABLE_SGX
+  common::CodeHeap *CodeHeap = nullptr;
+#endif
   common::Mutex Mtx;
   StatisticTimer TimerCounter = 0;
   typedef std::pair<StatisticPhase, TimePoint> TimerPair;
@@ -8,56 +8,47 @@ namespace zen::utils {
 
 constexpr size_t StackMemorySize = 9 * 1024 * 1024; // 9MB > dwasm 8MB
 
-StackMemPool::StackMemPool(size_t ItemSize)
-    : EachStackSize(ItemSize), AvailableCount(MAX_STACK_ITEM_NUM) {
-#ifdef ZEN_ENABLE_CPU_EXCEPTION
-  int DefaultProtMode = PROT_NONE;
-#else
-  int DefaultProtMode = PROT_READ | PROT_WRITE;
-#endif // ZEN_ENABLE_CPU_EXCEPTION
-
-  MemStart = reinterpret_cast<uint8_t *>(platform::mmap(
-      NULL, MaxCodeSize, DefaultProtMode, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0));
-
-  MemEnd = MemStart;
-  MemPageEnd = MemStart;
-}
-StackMemPool::~StackMemPool() { platform::munmap(MemStart, MaxCodeSize); }
-
-void *StackMemPool::allocate(bool AllowReadWrite) {
-  common::UniqueLock<common::Mutex> Lock(Mutex);
 #ifndef ZEN_ENABLE_SGX
-  AvailableCountCV.wait(Lock, [this]() { return AvailableCount > 0; });
+struct StackMemPool::ThreadCache {
+  StackMemPool *Pool = nullptr;
+  size_t NumItems = 0;
+  void *Items[MaxNumThreadCachedItems];
+
+  // Give the cached items back to the pool when the thread exits
+  ~ThreadCache() {
+    for (size_t I = 0; I < NumItems; ++I) {
+      Pool->deallocateShared(Items[I]);
+    }
+  }
+};
+
+StackMemPool::ThreadCache &StackMemPool::getThreadCache() {
+  static thread_local ThreadCache Cache;
+  return Cache;
+}
 #endif // ZEN_ENABLE_SGX
-  --AvailableCount;
 
-  if (!FreeObjects.empty()) {
-    auto *Result = FreeObjects.front();
-    FreeObjects.pop();
-    return Result;
-  }
-  constexpr size_t Align = 16;
-  uint8_t *Ptr = reinterpret_cast<uint8_t *>(
-      ZEN_ALIGN(reinterpret_cast<uintptr_t>(MemEnd), Align));
-  size_t NewSize = reinterpret_cast<uintptr_t>(Ptr) + EachStackSize -
-                   reinterpret_cast<uintptr_t>(MemStart);
-  if (NewSize > MaxCodeSize) {
-    ZEN_ABORT(); // not supported, exit
+StackMemPool::StackMemPool(size_t ItemSize, size_t GuardSize)
+    : EachStackSize(ItemSize), GuardSize(GuardSize) {
+  ZEN_ASSERT(EachStackSize % PageSize == 0);
+  ZEN_ASSERT(GuardSize % PageSize == 0 && GuardSize < EachStackSize);
+}
+
+StackMemPool::~StackMemPool() {
+  for (uint8_t *Segment : Segments) {
+    platform::munmap(Segment, EachStackSize * NumItemsPerSegment);
   }
-  MemEnd = MemStart + NewSize;
-  if (MemEnd > MemPageEnd) {
-    uint8_t *NewMemPageEnd = reinterpret_cast<uint8_t *>(
-        ZEN_ALIGN(reinterpret_cast<uintptr_t>(MemEnd), PageSize));
-#ifdef ZEN_ENABLE_CPU_EXCEPTION
-    // when not in cpu exception mode, the default prot mode is rw
-    if (AllowReadWrite) {
-      platform::mprotect(MemPageEnd, NewMemPageEnd - MemPageEnd,
-                         PROT_READ | PROT_WRITE);
-    }
-#endif // ZEN_ENABLE_CPU_EXCEPTION
-    MemPageEnd = NewMemPageEnd;
+}
+
+void *StackMemPool::allocate() {
+#ifndef ZEN_ENABLE_SGX
+  ThreadCache &Cache = getThreadCache();
+  if (Cache.NumItems > 0) {
+    ZEN_ASSERT(Cache.Pool == this);
+    return Cache.Items[--Cache.NumItems];
   }
-  return Ptr;
+#endif // ZEN_ENABLE_SGX
+  return allocateShared();
 }
 
 void StackMemPool::deallocate(void *Ptr) {
@@ -65,20 +56,58 @@ void StackMemPool::deallocate(void *Ptr) {
     return;
   }
 #ifndef ZEN_ENABLE_SGX
-  common::UniqueLock<common::Mutex> Lock(Mutex);
+  ThreadCache &Cache = getThreadCache();
+  ZEN_ASSERT(!Cache.Pool || Cache.Pool == this);
+  if (Cache.NumItems < MaxNumThreadCachedItems) {
+    Cache.Pool = this;
+    Cache.Items[Cache.NumItems++] = Ptr;
+    return;
+  }
 #endif // ZEN_ENABLE_SGX
-  ZEN_ASSERT(AvailableCount < MAX_STACK_ITEM_NUM);
+  deallocateShared(Ptr);
+}
+
+void *StackMemPool::allocateShared() {
+  common::LockGuard<common::Mutex> Lock(Mutex);
+  // Reuse the most recently freed item, whose pages are likely committed
+  if (!FreeObjects.empty()) {
+    void *Result = FreeObjects.back();
+    FreeObjects.pop_back();
+    return Result;
+  }
 
-  ++AvailableCount;
+  if (MemEnd == SegmentEnd) {
+    size_t SegmentSize = EachStackSize * NumItemsPerSegment;
+    int Flags = MAP_ANONYMOUS | MAP_PRIVATE;
+#ifdef MAP_NORESERVE
+    // Don't account the whole stacks, only the touched pages are committed
+    Flags |= MAP_NORESERVE;
+#endif // MAP_NORESERVE
+    auto *Segment = reinterpret_cast<uint8_t *>(
+        platform::mmap(nullptr, SegmentSize, PROT_NONE, Flags, -1, 0));
+    Segments.push_back(Segment);
+    MemEnd = Segment;
+    SegmentEnd = Segment + SegmentSize;
+  }
+
+  uint8_t *Ptr = MemEnd;
+  MemEnd += EachStackSize;
+  // Only once per item, the guard area stays inaccessible
+  platform::mprotect(Ptr + GuardSize, EachStackSize - GuardSize,
+                     PROT_READ | PROT_WRITE);
+  return Ptr;
+}
 
-  FreeObjects.push(Ptr);
+void StackMemPool::deallocateShared(void *Ptr) {
+  common::LockGuard<common::Mutex> Lock(Mutex);
+  FreeObjects.push_back(Ptr);
 }
 
 static StackMemPool *getVirtualStackPool() {
-  // stack allocate 2 * needed size, the first part used as stack, the second
-  // part used to protect read/write by cpu
+  // stack allocate 2 * needed size, the first part used as the guard to
+  // protect read/write by cpu, the second part used as stack
   // can't be less, even not enable cpu exception
-  static StackMemPool StackPool(StackMemorySize * 2);
+  static StackMemPool StackPool(StackMemorySize * 2, StackMemorySize);
   return &StackPool;
 }
 
@@ -87,11 +116,10 @@ void VirtualStackInfo::allocate() {
     return;
   }
   auto *MemPool = getVirtualStackPool();
-  AllocatedMem = (uint8_t *)MemPool->allocate(true);
+  AllocatedMem = (uint8_t *)MemPool->allocate();
   AllInfo = AllocatedMem + StackMemorySize;
-  // [AllocatedMem, AllInfo) is disabled visiting
+  // [AllocatedMem, AllInfo) is disabled visiting by the pool
   // [AllInfo, StackMemoryTop) is available stack memory
-  platform::mprotect(AllocatedMem, StackMemorySize, PROT_NONE);
 
   // when update sp/rsp register, we need copy old frame to new frame, then
   // the new frame rsp should have enough frame to store
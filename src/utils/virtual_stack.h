@@ -17,36 +17,43 @@ namespace zen::utils {
 using namespace common;
 using namespace runtime;
 
+// Pool of fixed-size virtual stacks. Each item is a guard area that is never
+// accessible followed by the stack, whose pages are only committed when
+// touched. Items are carved out of segments reserved on demand, so the number
+// of stacks in use is unbounded. Freed items are cached by the freeing thread
+// and reused by it without locking, the rest go to a shared free list.
 class StackMemPool {
 public:
-  // The maximum number of VStackItem that can be used simultaneously.
-  static constexpr size_t MAX_STACK_ITEM_NUM = 100;
-
-#ifndef ZEN_ENABLE_OCCLUM
-  static constexpr size_t MaxCodeSize = INT32_MAX;
-#else
-  // for occlum, we need to limit the code size to avoid mmap failure
-  // need enough stack for instance call instance
-  static constexpr size_t MaxCodeSize = 640 * 1024 * 1024; // 640MB
-#endif // ZEN_ENABLE_OCCLUM
   static constexpr size_t PageSize = 4096;
-  StackMemPool(size_t ItemSize);
+  // The number of items reserved at a time
+  static constexpr size_t NumItemsPerSegment = 16;
+  // The maximum number of free items cached by a thread
+  static constexpr size_t MaxNumThreadCachedItems = 4;
+
+  // The first `GuardSize` bytes of each item are the guard area
+  StackMemPool(size_t ItemSize, size_t GuardSize);
   ~StackMemPool();
   NONCOPYABLE(StackMemPool);
-  void *allocate(bool AllowReadWrite);
+  void *allocate();
   void deallocate(void *Ptr);
 
 private:
-  size_t EachStackSize;
-  uint8_t *MemStart;
-  uint8_t *MemEnd;
-  uint8_t *MemPageEnd;
-  std::queue<void *> FreeObjects;
-  common::Mutex Mutex;
 #ifndef ZEN_ENABLE_SGX
-  std::condition_variable AvailableCountCV;
+  struct ThreadCache;
+  static ThreadCache &getThreadCache();
 #endif // ZEN_ENABLE_SGX
-  size_t AvailableCount;
+
+  void *allocateShared();
+  void deallocateShared(void *Ptr);
+
+  const size_t EachStackSize;
+  const size_t GuardSize;
+  std::vector<uint8_t *> Segments;
+  // Next uncarved item of the last segment
+  uint8_t *MemEnd = nullptr;
+  uint8_t *SegmentEnd = nullptr;
+  std::vector<void *> FreeObjects;
+  common::Mutex Mutex;
 };
 
 struct VirtualStackInfo;
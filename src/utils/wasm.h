@@ -132,9 +132,35 @@ const uint8_t *skipLEBNumber(const uint8_t *Ip, const uint8_t *End) {
 
 const uint8_t *skipBlockType(const uint8_t *Ip, const uint8_t *End);
 
+// The loader rewrites br_table with at least `MinDecodedBrTableTargets`
+// targets(excluding the default) to BR_TABLE_DECODED. Its first targets are
+// overwritten by single-byte LEB numbers holding the offset of the decoded
+// targets in CodeEntry::BrTableTargets, so the immediates are still skipped
+// like the ones of br_table.
+constexpr uint32_t MinDecodedBrTableTargets = 4;
+constexpr uint32_t DecodedBrTableOffsetBytes = 5;
+
+inline uint32_t readDecodedBrTableOffset(const uint8_t *Ip) {
+  uint32_t Offset = 0;
+  for (uint32_t I = 0; I < DecodedBrTableOffsetBytes; ++I) {
+    Offset |= static_cast<uint32_t>(Ip[I] & 0x7f) << (7 * I);
+  }
+  return Offset;
+}
+
+// skip the immediates of an instruction whose opcode has been read
+const uint8_t *skipInstructionImmediates(uint8_t Opcode, const uint8_t *Ip,
+                                         const uint8_t *End);
+
 // skip current block for br, br_table, return and unreachable
 const uint8_t *skipCurrentBlock(const uint8_t *Ip, const uint8_t *End);
 
+// skip the sub-opcode and immediates of an instruction following PREFIX_FC
+const uint8_t *skipFCInstruction(const uint8_t *Ip, const uint8_t *End);
+
+// skip the sub-opcode and immediates of an instruction following PREFIX_FD
+const uint8_t *skipFDInstruction(const uint8_t *Ip, const uint8_t *End);
+
 // byte code to string for dump purpose
 const char *getWASMTypeString(common::WASMType Type);
 const char *getOpcodeString(uint8_t Opcode);
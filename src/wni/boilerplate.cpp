@@ -61,8 +61,7 @@ static NativeFuncDesc *loadNativeModule(VNMIEnv *vnmi_env, uint32_t &count) {
   if (funcs[i]._name == VNMI_WASM_SYMBOL_NULL) {                               \
     goto fail;                                                                 \
   }                                                                            \
-  if (!ExtractNativeFuncType<std::remove_pointer_t<decltype(name)>>(           \
-          vnmi_env, funcs[i], name))                                           \
+  if (!ExtractHostFuncType<name>(vnmi_env, funcs[i]))                         \
     goto fail;                                                                 \
   i++;
 
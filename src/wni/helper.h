@@ -6,6 +6,7 @@
 
 #include "common/const_string_pool.h"
 #include "common/defines.h"
+#include "common/errors.h"
 #include "common/type.h"
 #include "runtime/vnmi.h"
 
@@ -140,6 +141,156 @@ bool ExtractNativeFuncType(VNMIEnv *vmni_env, NativeFuncDesc &func, T ptr) {
   return true;
 }
 
+// ==================== Typed Host Parameters ====================
+//
+// Host functions may take the following types instead of raw i32 offsets. The
+// function is then registered through a generated trampoline which takes the
+// offsets from wasm, checks them against the default memory and translates
+// them to native pointers inline, so the host function needs neither
+// VALIDATE_APP_ADDR nor ADDR_APP_TO_NATIVE. On failure the trampoline sets
+// OutOfBoundsMemory and returns without calling the host function.
+
+// `Size` bytes at an i32 offset, e.g. the 32-byte keys of EVM storage
+template <uint32_t Size> struct HostBytes {
+  uint8_t *Ptr;
+};
+
+// Bytes at an i32 offset followed by their i32 length
+struct HostBuffer {
+  uint8_t *Ptr;
+  uint32_t Len;
+};
+
+// `InstanceT` is always `Instance`, it's a template parameter only to delay
+// the member accesses to the host module, where `Instance` is complete
+template <typename InstanceT>
+inline bool translateHostAddr(InstanceT *Inst, uint32_t Offset, uint32_t Size,
+                              uint8_t *&Ptr) {
+  if (!Inst->hasMemory()) {
+    return false;
+  }
+  const auto &MemInst = Inst->getDefaultMemoryInst();
+  if (uint64_t(Offset) + Size > MemInst.MemSize) {
+    return false;
+  }
+  Ptr = MemInst.MemBase + Offset;
+  return true;
+}
+
+template <typename InstanceT>
+inline void __attribute__((always_inline))
+setHostOutOfBounds(InstanceT *Inst) {
+  Inst->setExceptionByHostapi(
+      common::getError(common::ErrorCode::OutOfBoundsMemory));
+}
+
+template <typename T> struct HostParam {
+  using WasmArgsT = std::tuple<T>;
+  static constexpr bool IsTyped = false;
+
+  template <size_t I, typename InstanceT, typename TupleT>
+  static bool convert(InstanceT *, T &Out, const TupleT &In) {
+    Out = std::get<I>(In);
+    return true;
+  }
+};
+
+template <uint32_t Size> struct HostParam<HostBytes<Size>> {
+  using WasmArgsT = std::tuple<int32_t>;
+  static constexpr bool IsTyped = true;
+
+  template <size_t I, typename InstanceT, typename TupleT>
+  static bool convert(InstanceT *Inst, HostBytes<Size> &Out, const TupleT &In) {
+    return translateHostAddr(Inst, std::get<I>(In), Size, Out.Ptr);
+  }
+};
+
+template <> struct HostParam<HostBuffer> {
+  using WasmArgsT = std::tuple<int32_t, int32_t>;
+  static constexpr bool IsTyped = true;
+
+  template <size_t I, typename InstanceT, typename TupleT>
+  static bool convert(InstanceT *Inst, HostBuffer &Out, const TupleT &In) {
+    Out.Len = std::get<I + 1>(In);
+    return translateHostAddr(Inst, std::get<I>(In), Out.Len, Out.Ptr);
+  }
+};
+
+template <typename> struct HostFuncTraits {
+  static constexpr bool IsTyped = false;
+};
+
+template <typename R, typename... A>
+struct HostFuncTraits<R(Instance *, A...)> {
+  using RetT = R;
+  using HostArgsT = std::tuple<A...>;
+  using WasmArgsT = decltype(std::tuple_cat(
+      std::declval<typename HostParam<A>::WasmArgsT>()...));
+  static constexpr bool IsTyped = (HostParam<A>::IsTyped || ...);
+};
+
+template <auto Fn, typename R, typename HostArgsT, typename WasmArgsT>
+struct HostTrampoline;
+
+template <auto Fn, typename R, typename... HostArgs, typename... WasmArgs>
+struct HostTrampoline<Fn, R, std::tuple<HostArgs...>, std::tuple<WasmArgs...>> {
+  using HostArgsT = std::tuple<HostArgs...>;
+  using WasmArgsT = std::tuple<WasmArgs...>;
+
+  static R call(Instance *Inst, WasmArgs... Args) {
+    WasmArgsT In(Args...);
+    HostArgsT Out;
+    if (!convertArgs<0, 0>(Inst, In, Out)) {
+      setHostOutOfBounds(Inst);
+      if constexpr (!std::is_void_v<R>) {
+        return R();
+      } else {
+        return;
+      }
+    }
+    return std::apply(
+        [Inst](HostArgs... HostArgVals) { return Fn(Inst, HostArgVals...); },
+        Out);
+  }
+
+private:
+  // `H` indexes the host parameters, `W` the wasm parameters
+  template <size_t H, size_t W, typename InstanceT>
+  static bool convertArgs(InstanceT *Inst, const WasmArgsT &In,
+                          HostArgsT &Out) {
+    if constexpr (H == sizeof...(HostArgs)) {
+      return true;
+    } else {
+      using ParamT = HostParam<std::tuple_element_t<H, HostArgsT>>;
+      constexpr size_t NextW =
+          W + std::tuple_size_v<typename ParamT::WasmArgsT>;
+      return ParamT::template convert<W>(Inst, std::get<H>(Out), In) &&
+             convertArgs<H + 1, NextW>(Inst, In, Out);
+    }
+  }
+};
+
+// Returns the function to register for `Fn`, the trampoline if `Fn` takes any
+// typed parameter, otherwise `Fn` itself
+template <auto Fn> constexpr auto getHostFuncEntry() {
+  using T = std::remove_pointer_t<decltype(Fn)>;
+  using Traits = HostFuncTraits<T>;
+  if constexpr (Traits::IsTyped) {
+    return &HostTrampoline<Fn, typename Traits::RetT,
+                           typename Traits::HostArgsT,
+                           typename Traits::WasmArgsT>::call;
+  } else {
+    return Fn;
+  }
+}
+
+template <auto Fn>
+bool ExtractHostFuncType(VNMIEnv *vmni_env, NativeFuncDesc &func) {
+  constexpr auto Entry = getHostFuncEntry<Fn>();
+  return ExtractNativeFuncType<std::remove_pointer_t<decltype(Entry)>>(
+      vmni_env, func, Entry);
+}
+
 } // namespace host
 } // namespace zen
 
@@ -10,6 +10,9 @@
 #include "runtime/isolation.h"
 #include "runtime/module.h"
 #include "runtime/runtime.h"
+#ifndef ZEN_ENABLE_SGX
+#include "runtime/module_stream.h"
+#endif
 #include "utils/logging.h"
 #include "wni/helper.h"
 
@@ -0,0 +1,97 @@
+;; Iterates x = a * x + c mod 2^256 on 8 little-endian u32 limbs, `run(n)`
+;; performs 10 * n iterations
+(module
+  (memory 1)
+
+  ;; r = a * b mod 2^256, r must not overlap a or b
+  (func $mul256 (param $a i32) (param $b i32) (param $r i32)
+    (local $i i32)
+    (local $j i32)
+    (local $p i32)
+    (local $t i64)
+    (local $carry i64)
+    (i64.store (local.get $r) (i64.const 0))
+    (i64.store offset=8 (local.get $r) (i64.const 0))
+    (i64.store offset=16 (local.get $r) (i64.const 0))
+    (i64.store offset=24 (local.get $r) (i64.const 0))
+    (loop $outer
+      (local.set $carry (i64.const 0))
+      (local.set $j (i32.const 0))
+      (block $inner_done
+        (loop $inner
+          (br_if $inner_done
+            (i32.ge_u (i32.add (local.get $i) (local.get $j)) (i32.const 8)))
+          (local.set $p
+            (i32.add (local.get $r)
+              (i32.shl (i32.add (local.get $i) (local.get $j))
+                (i32.const 2))))
+          (local.set $t
+            (i64.add
+              (i64.add
+                (i64.mul
+                  (i64.load32_u
+                    (i32.add (local.get $a)
+                      (i32.shl (local.get $i) (i32.const 2))))
+                  (i64.load32_u
+                    (i32.add (local.get $b)
+                      (i32.shl (local.get $j) (i32.const 2)))))
+                (i64.load32_u (local.get $p)))
+              (local.get $carry)))
+          (i64.store32 (local.get $p) (local.get $t))
+          (local.set $carry (i64.shr_u (local.get $t) (i64.const 32)))
+          (local.set $j (i32.add (local.get $j) (i32.const 1)))
+          (br $inner)))
+      (local.set $i (i32.add (local.get $i) (i32.const 1)))
+      (br_if $outer (i32.lt_u (local.get $i) (i32.const 8)))))
+
+  ;; a = a + b mod 2^256
+  (func $add256 (param $a i32) (param $b i32)
+    (local $i i32)
+    (local $p i32)
+    (local $t i64)
+    (loop $limbs
+      (local.set $p (i32.add (local.get $a) (local.get $i)))
+      (local.set $t
+        (i64.add
+          (i64.add (i64.load32_u (local.get $p))
+            (i64.load32_u (i32.add (local.get $b) (local.get $i))))
+          (i64.shr_u (local.get $t) (i64.const 32))))
+      (i64.store32 (local.get $p) (local.get $t))
+      (local.set $i (i32.add (local.get $i) (i32.const 4)))
+      (br_if $limbs (i32.lt_u (local.get $i) (i32.const 32)))))
+
+  (func $copy256 (param $dst i32) (param $src i32)
+    (i64.store (local.get $dst) (i64.load (local.get $src)))
+    (i64.store offset=8 (local.get $dst) (i64.load offset=8 (local.get $src)))
+    (i64.store offset=16 (local.get $dst)
+      (i64.load offset=16 (local.get $src)))
+    (i64.store offset=24 (local.get $dst)
+      (i64.load offset=24 (local.get $src))))
+
+  ;; x at 0, c at 32, the product at 64, a at 96. a = 1 mod 4 and c is odd,
+  ;; so x runs through all the 2^256 values
+  (func (export "run") (param $n i32) (result i64)
+    (local $i i32)
+    (local $count i32)
+    (i64.store (i32.const 0) (i64.const 0x0123456789abcdef))
+    (i64.store (i32.const 8) (i64.const 0x0fedcba987654321))
+    (i64.store (i32.const 16) (i64.const 0x1111111111111111))
+    (i64.store (i32.const 24) (i64.const 0x7777777777777777))
+    (i64.store (i32.const 32) (i64.const 0x9e3779b97f4a7c15))
+    (i64.store (i32.const 40) (i64.const 1))
+    (i64.store (i32.const 96) (i64.const 0x5851f42d4c957f2d))
+    (i64.store (i32.const 104) (i64.const 0x14057b7ef767814f))
+    (i64.store (i32.const 112) (i64.const 0x9e3779b97f4a7c15))
+    (i64.store (i32.const 120) (i64.const 0x0bf58476d1ce4e5b))
+    (local.set $count (i32.mul (local.get $n) (i32.const 10)))
+    (block $done
+      (loop $iterate
+        (br_if $done (i32.ge_u (local.get $i) (local.get $count)))
+        (call $mul256 (i32.const 96) (i32.const 0) (i32.const 64))
+        (call $add256 (i32.const 64) (i32.const 32))
+        (call $copy256 (i32.const 0) (i32.const 64))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $iterate)))
+    (i64.xor
+      (i64.xor (i64.load (i32.const 0)) (i64.load (i32.const 8)))
+      (i64.xor (i64.load (i32.const 16)) (i64.load (i32.const 24))))))
@@ -0,0 +1,80 @@
+;; ERC-20 style transfers between 256 accounts whose balances live in linear
+;; memory, `run(n)` performs 100 * n transfers
+(module
+  (memory 1)
+  (global $seed (mut i32) (i32.const 0))
+
+  ;; xorshift32
+  (func $rand (result i32)
+    (local $x i32)
+    (local.set $x (global.get $seed))
+    (local.set $x
+      (i32.xor (local.get $x) (i32.shl (local.get $x) (i32.const 13))))
+    (local.set $x
+      (i32.xor (local.get $x) (i32.shr_u (local.get $x) (i32.const 17))))
+    (local.set $x
+      (i32.xor (local.get $x) (i32.shl (local.get $x) (i32.const 5))))
+    (global.set $seed (local.get $x))
+    (local.get $x))
+
+  (func $balance_addr (param $account i32) (result i32)
+    (i32.shl (i32.and (local.get $account) (i32.const 255)) (i32.const 3)))
+
+  ;; Returns 0 if the sender can't afford the amount
+  (func $transfer (param $from i32) (param $to i32) (param $amount i64)
+                  (result i32)
+    (local $from_addr i32)
+    (local $to_addr i32)
+    (local $from_balance i64)
+    (local.set $from_addr (call $balance_addr (local.get $from)))
+    (local.set $to_addr (call $balance_addr (local.get $to)))
+    (local.set $from_balance (i64.load (local.get $from_addr)))
+    (if (i64.lt_u (local.get $from_balance) (local.get $amount))
+      (then (return (i32.const 0))))
+    (i64.store (local.get $from_addr)
+      (i64.sub (local.get $from_balance) (local.get $amount)))
+    (i64.store (local.get $to_addr)
+      (i64.add (i64.load (local.get $to_addr)) (local.get $amount)))
+    (i32.const 1))
+
+  (func (export "run") (param $n i32) (result i64)
+    (local $i i32)
+    (local $count i32)
+    (local $succeeded i64)
+    (local $supply i64)
+    (global.set $seed (i32.const 0x2545f491))
+
+    (block $mint_done
+      (loop $mint
+        (br_if $mint_done (i32.ge_u (local.get $i) (i32.const 256)))
+        (i64.store (call $balance_addr (local.get $i)) (i64.const 1000000))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $mint)))
+
+    (local.set $count (i32.mul (local.get $n) (i32.const 100)))
+    (local.set $i (i32.const 0))
+    (block $transfers_done
+      (loop $transfers
+        (br_if $transfers_done (i32.ge_u (local.get $i) (local.get $count)))
+        (local.set $succeeded
+          (i64.add (local.get $succeeded)
+            (i64.extend_i32_u
+              (call $transfer (call $rand) (call $rand)
+                (i64.extend_i32_u
+                  (i32.and (call $rand) (i32.const 0xffff)))))))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $transfers)))
+
+    ;; The total supply must be preserved
+    (local.set $i (i32.const 0))
+    (block $sum_done
+      (loop $sum
+        (br_if $sum_done (i32.ge_u (local.get $i) (i32.const 256)))
+        (local.set $supply
+          (i64.add (local.get $supply)
+            (i64.load (call $balance_addr (local.get $i)))))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $sum)))
+    (if (i64.ne (local.get $supply) (i64.const 256000000))
+      (then (return (i64.const -1))))
+    (local.get $succeeded)))
@@ -0,0 +1,50 @@
+;; Hashes a 4KiB buffer `n` times, byte-wise with FNV-1a and word-wise with a
+;; multiply-rotate mixer
+(module
+  (memory 1)
+
+  (func $fill
+    (local $i i32)
+    (loop $fill
+      (i32.store8 (local.get $i) (i32.mul (local.get $i) (i32.const 31)))
+      (local.set $i (i32.add (local.get $i) (i32.const 1)))
+      (br_if $fill (i32.lt_u (local.get $i) (i32.const 4096)))))
+
+  (func $fnv1a (param $h i64) (result i64)
+    (local $i i32)
+    (loop $bytes
+      (local.set $h
+        (i64.mul
+          (i64.xor (local.get $h) (i64.load8_u (local.get $i)))
+          (i64.const 0x100000001b3)))
+      (local.set $i (i32.add (local.get $i) (i32.const 1)))
+      (br_if $bytes (i32.lt_u (local.get $i) (i32.const 4096))))
+    (local.get $h))
+
+  (func $mix64 (param $h i64) (result i64)
+    (local $i i32)
+    (loop $words
+      (local.set $h
+        (i64.mul
+          (i64.rotl
+            (i64.xor (local.get $h)
+              (i64.mul (i64.load (local.get $i))
+                (i64.const 0x9e3779b97f4a7c15)))
+            (i64.const 31))
+          (i64.const 0xbf58476d1ce4e5b9)))
+      (local.set $i (i32.add (local.get $i) (i32.const 8)))
+      (br_if $words (i32.lt_u (local.get $i) (i32.const 4096))))
+    (local.get $h))
+
+  (func (export "run") (param $n i32) (result i64)
+    (local $i i32)
+    (local $h i64)
+    (call $fill)
+    (local.set $h (i64.const 0xcbf29ce484222325))
+    (block $done
+      (loop $round
+        (br_if $done (i32.ge_u (local.get $i) (local.get $n)))
+        (local.set $h (call $mix64 (call $fnv1a (local.get $h))))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $round)))
+    (local.get $h)))
@@ -0,0 +1,114 @@
+;; Tokenizes a JSON document of token holders `n` times, counting the values
+;; and summing the integers
+(module
+  (memory 1)
+  (data (i32.const 0)
+    "{\"token\":\"DTVM\",\"symbol\":\"DTV\",\"decimals\":18,\"totalSuppl"
+    "y\":1000000000,\"memo\":\"escaped \\\"quotes\\\" and \\\\ backslas"
+    "hes\",\"holders\":[{\"address\":\"0x253c82b723ae31267847726671"
+    "5323c8109bbcae\",\"balance\":104729,\"nonce\":0,\"tags\":[\"hold"
+    "er\",\"tier0\"],\"frozen\":true},{\"address\":\"0x65288e363d487c"
+    "3f4b5f6793ae70b9de57e9147e\",\"balance\":112648,\"nonce\":3,\""
+    "tags\":[\"holder\",\"tier1\"],\"frozen\":false},{\"address\":\"0xa"
+    "fc06854a71b6e0c370459cd235c9144dc37e990\",\"balance\":12056"
+    "7,\"nonce\":6,\"tags\":[\"holder\",\"tier2\"],\"frozen\":false},{\""
+    "address\":\"0x7bef8f460b9fe8c0d1d7fb7166666332e727b5e8\",\"b"
+    "alance\":128486,\"nonce\":9,\"tags\":[\"holder\",\"tier0\"],\"froz"
+    "en\":false},{\"address\":\"0xaf202045f72159d029ad2eb0042a6cb"
+    "91684b28a\",\"balance\":136405,\"nonce\":12,\"tags\":[\"holder\","
+    "\"tier1\"],\"frozen\":false},{\"address\":\"0x4a221f88cbd48c547"
+    "fec7f16d1aa9b7dc879d7f4\",\"balance\":144324,\"nonce\":15,\"ta"
+    "gs\":[\"holder\",\"tier2\"],\"frozen\":true},{\"address\":\"0xb420"
+    "c40872e8506f7a86cdd63453425a100087aa\",\"balance\":152243,\""
+    "nonce\":18,\"tags\":[\"holder\",\"tier0\"],\"frozen\":false},{\"ad"
+    "dress\":\"0x85164f1712ec6b60d27f6397f50a31581cfae81b\",\"bal"
+    "ance\":160162,\"nonce\":21,\"tags\":[\"holder\",\"tier1\"],\"froze"
+    "n\":false},{\"address\":\"0x06b64ee7115d811474dbf0ad147c9356"
+    "85ac4cd5\",\"balance\":168081,\"nonce\":24,\"tags\":[\"holder\",\""
+    "tier2\"],\"frozen\":false},{\"address\":\"0x872f29426512c0dbd1"
+    "33f1b5b0eeecc1e57bf95b\",\"balance\":176000,\"nonce\":27,\"tag"
+    "s\":[\"holder\",\"tier0\"],\"frozen\":false},{\"address\":\"0x609b"
+    "d7fae6ebe4f5013eab5570f89150cc950795\",\"balance\":183919,\""
+    "nonce\":30,\"tags\":[\"holder\",\"tier1\"],\"frozen\":true},{\"add"
+    "ress\":\"0x579ee43f24dd3186b72c85376d5b14fb22e2f4ad\",\"bala"
+    "nce\":191838,\"nonce\":33,\"tags\":[\"holder\",\"tier2\"],\"frozen"
+    "\":false}]}")
+
+  ;; Returns the number of values in the upper half and the sum of the
+  ;; integers in the lower half, -1 if the brackets are unbalanced
+  (func $scan (result i64)
+    (local $p i32)
+    (local $c i32)
+    (local $depth i32)
+    (local $num i64)
+    (local $sum i64)
+    (local $values i64)
+    (block $done
+      (loop $chars
+        (local.set $c (i32.load8_u (local.get $p)))
+        (br_if $done (i32.eqz (local.get $c)))
+        (local.set $p (i32.add (local.get $p) (i32.const 1)))
+
+        ;; '"', skip to the closing quote
+        (if (i32.eq (local.get $c) (i32.const 34))
+          (then
+            (block $string_done
+              (loop $string
+                (local.set $c (i32.load8_u (local.get $p)))
+                (local.set $p (i32.add (local.get $p) (i32.const 1)))
+                (br_if $string_done (i32.eq (local.get $c) (i32.const 34)))
+                ;; A backslash, skip the escaped char
+                (if (i32.eq (local.get $c) (i32.const 92))
+                  (then
+                    (local.set $p (i32.add (local.get $p) (i32.const 1)))))
+                (br $string)))
+            (local.set $values (i64.add (local.get $values) (i64.const 1)))
+            (br $chars)))
+
+        ;; '0' - '9'
+        (if (i32.lt_u (i32.sub (local.get $c) (i32.const 48)) (i32.const 10))
+          (then
+            (local.set $num
+              (i64.extend_i32_u (i32.sub (local.get $c) (i32.const 48))))
+            (block $number_done
+              (loop $digits
+                (local.set $c
+                  (i32.sub (i32.load8_u (local.get $p)) (i32.const 48)))
+                (br_if $number_done (i32.ge_u (local.get $c) (i32.const 10)))
+                (local.set $num
+                  (i64.add (i64.mul (local.get $num) (i64.const 10))
+                    (i64.extend_i32_u (local.get $c))))
+                (local.set $p (i32.add (local.get $p) (i32.const 1)))
+                (br $digits)))
+            (local.set $sum (i64.add (local.get $sum) (local.get $num)))
+            (local.set $values (i64.add (local.get $values) (i64.const 1)))
+            (br $chars)))
+
+        ;; '{' or '['
+        (if (i32.or (i32.eq (local.get $c) (i32.const 123))
+                    (i32.eq (local.get $c) (i32.const 91)))
+          (then
+            (local.set $depth (i32.add (local.get $depth) (i32.const 1)))
+            (local.set $values (i64.add (local.get $values) (i64.const 1)))
+            (br $chars)))
+
+        ;; '}' or ']'
+        (if (i32.or (i32.eq (local.get $c) (i32.const 125))
+                    (i32.eq (local.get $c) (i32.const 93)))
+          (then
+            (local.set $depth (i32.sub (local.get $depth) (i32.const 1)))))
+        (br $chars)))
+    (if (local.get $depth)
+      (then (return (i64.const -1))))
+    (i64.add (i64.shl (local.get $values) (i64.const 32)) (local.get $sum)))
+
+  (func (export "run") (param $n i32) (result i64)
+    (local $i i32)
+    (local $result i64)
+    (block $done
+      (loop $round
+        (br_if $done (i32.ge_u (local.get $i) (local.get $n)))
+        (local.set $result (i64.add (local.get $result) (call $scan)))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $round)))
+    (local.get $result)))
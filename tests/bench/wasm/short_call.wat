@@ -0,0 +1,4 @@
+;; Does no work, so the execution time is the cost of setting up a call
+(module
+  (func (export "run") (param $n i32) (result i64)
+    (i64.extend_i32_u (local.get $n))))
@@ -0,0 +1,93 @@
+;; Shell sorts min(16 * n, 16384) pseudo-random i32s, returns -1 if the result
+;; isn't sorted
+(module
+  (memory 1)
+
+  (func (export "run") (param $n i32) (result i64)
+    (local $count i32)
+    (local $i i32)
+    (local $j i32)
+    (local $gap i32)
+    (local $v i32)
+    (local $x i32)
+    (local $sum i64)
+    (local.set $count (i32.mul (local.get $n) (i32.const 16)))
+    (if (i32.gt_u (local.get $count) (i32.const 16384))
+      (then (local.set $count (i32.const 16384))))
+
+    ;; Fill by xorshift32
+    (local.set $x (i32.const 0x2545f491))
+    (block $fill_done
+      (loop $fill
+        (br_if $fill_done (i32.ge_u (local.get $i) (local.get $count)))
+        (local.set $x
+          (i32.xor (local.get $x) (i32.shl (local.get $x) (i32.const 13))))
+        (local.set $x
+          (i32.xor (local.get $x) (i32.shr_u (local.get $x) (i32.const 17))))
+        (local.set $x
+          (i32.xor (local.get $x) (i32.shl (local.get $x) (i32.const 5))))
+        (i32.store (i32.shl (local.get $i) (i32.const 2)) (local.get $x))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $fill)))
+
+    ;; Gaps 1, 4, 13, 40, ...
+    (local.set $gap (i32.const 1))
+    (block $gap_done
+      (loop $grow
+        (br_if $gap_done
+          (i32.ge_u (local.get $gap)
+            (i32.div_u (local.get $count) (i32.const 3))))
+        (local.set $gap
+          (i32.add (i32.mul (local.get $gap) (i32.const 3)) (i32.const 1)))
+        (br $grow)))
+
+    (block $sort_done
+      (loop $pass
+        (br_if $sort_done (i32.eqz (local.get $gap)))
+        (local.set $i (local.get $gap))
+        (block $pass_done
+          (loop $outer
+            (br_if $pass_done (i32.ge_u (local.get $i) (local.get $count)))
+            (local.set $v (i32.load (i32.shl (local.get $i) (i32.const 2))))
+            (local.set $j (local.get $i))
+            (block $insert_done
+              (loop $inner
+                (br_if $insert_done
+                  (i32.lt_u (local.get $j) (local.get $gap)))
+                (br_if $insert_done
+                  (i32.le_s
+                    (i32.load
+                      (i32.shl (i32.sub (local.get $j) (local.get $gap))
+                        (i32.const 2)))
+                    (local.get $v)))
+                (i32.store (i32.shl (local.get $j) (i32.const 2))
+                  (i32.load
+                    (i32.shl (i32.sub (local.get $j) (local.get $gap))
+                      (i32.const 2))))
+                (local.set $j (i32.sub (local.get $j) (local.get $gap)))
+                (br $inner)))
+            (i32.store (i32.shl (local.get $j) (i32.const 2)) (local.get $v))
+            (local.set $i (i32.add (local.get $i) (i32.const 1)))
+            (br $outer)))
+        (local.set $gap (i32.div_u (local.get $gap) (i32.const 3)))
+        (br $pass)))
+
+    (local.set $i (i32.const 1))
+    (block $check_done
+      (loop $check
+        (br_if $check_done (i32.ge_u (local.get $i) (local.get $count)))
+        (if (i32.gt_s
+              (i32.load
+                (i32.shl (i32.sub (local.get $i) (i32.const 1))
+                  (i32.const 2)))
+              (i32.load (i32.shl (local.get $i) (i32.const 2))))
+          (then (return (i64.const -1))))
+        (local.set $sum
+          (i64.add (local.get $sum)
+            (i64.mul
+              (i64.extend_i32_s
+                (i32.load (i32.shl (local.get $i) (i32.const 2))))
+              (i64.extend_i32_u (local.get $i)))))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $check)))
+    (local.get $sum)))
@@ -0,0 +1,28 @@
+;; case bulk memory operations charge gas per byte. spectest use 10000 as init gas
+
+(module
+  (memory 1)
+  (data (i32.const 100) "abc")
+  (func (export "copy") (param i32 i32 i32)
+    (memory.copy (local.get 0) (local.get 1) (local.get 2)))
+  (func (export "fill") (param i32 i32 i32)
+    (memory.fill (local.get 0) (local.get 1) (local.get 2)))
+  (func (export "load8") (param i32) (result i32)
+    (i32.load8_u (local.get 0)))
+  ;; treaky export func to call func but get gas
+  (func (export "copy$gas") (param i32 i32 i32) (result i64) (i64.const 0))
+  (func (export "fill$gas") (param i32 i32 i32) (result i64) (i64.const 0))
+  (func $__instrumented_use_gas (export "__instrumented_use_gas") (param i64))
+)
+
+(assert_return (invoke "fill$gas" (i32.const 0) (i32.const 7) (i32.const 50)) (i64.const 9950))
+(assert_return (invoke "copy$gas" (i32.const 200) (i32.const 0) (i32.const 0)) (i64.const 10000))
+
+;; out of bounds accesses trap before charging gas
+(assert_trap (invoke "copy" (i32.const 0) (i32.const 65535) (i32.const 2)) "out of bounds memory access")
+(assert_trap (invoke "copy$gas" (i32.const 0) (i32.const 65535) (i32.const 2)) "10000")
+
+;; running out of gas leaves the memory untouched
+(assert_trap (invoke "copy" (i32.const 100) (i32.const 0) (i32.const 10001)) "out of gas")
+(assert_trap (invoke "copy$gas" (i32.const 100) (i32.const 0) (i32.const 10001)) "0")
+(assert_return (invoke "load8" (i32.const 100)) (i32.const 97))
@@ -0,0 +1,98 @@
+;; memory.copy, memory.fill, memory.init and data.drop
+
+(module
+  (memory 1)
+  (data "hello")
+  (data (i32.const 100) "abc")
+
+  (func (export "copy") (param i32 i32 i32)
+    (memory.copy (local.get 0) (local.get 1) (local.get 2)))
+  (func (export "fill") (param i32 i32 i32)
+    (memory.fill (local.get 0) (local.get 1) (local.get 2)))
+  (func (export "init") (param i32 i32 i32)
+    (memory.init 0 (local.get 0) (local.get 1) (local.get 2)))
+  (func (export "drop")
+    (data.drop 0))
+  (func (export "load8") (param i32) (result i32)
+    (i32.load8_u (local.get 0)))
+)
+
+;; Only the active segment is copied when instantiating
+(assert_return (invoke "load8" (i32.const 100)) (i32.const 97))
+(assert_return (invoke "load8" (i32.const 0)) (i32.const 0))
+
+(invoke "init" (i32.const 0) (i32.const 0) (i32.const 5))
+(assert_return (invoke "load8" (i32.const 0)) (i32.const 104))
+(assert_return (invoke "load8" (i32.const 4)) (i32.const 111))
+(assert_return (invoke "load8" (i32.const 5)) (i32.const 0))
+
+;; Part of a segment
+(invoke "init" (i32.const 20) (i32.const 3) (i32.const 2))
+(assert_return (invoke "load8" (i32.const 20)) (i32.const 108))
+(assert_return (invoke "load8" (i32.const 21)) (i32.const 111))
+(assert_return (invoke "load8" (i32.const 22)) (i32.const 0))
+
+;; Overlapping ranges behave like memmove
+(invoke "copy" (i32.const 1) (i32.const 0) (i32.const 5))
+(assert_return (invoke "load8" (i32.const 0)) (i32.const 104))
+(assert_return (invoke "load8" (i32.const 1)) (i32.const 104))
+(assert_return (invoke "load8" (i32.const 2)) (i32.const 101))
+(assert_return (invoke "load8" (i32.const 5)) (i32.const 111))
+(invoke "copy" (i32.const 0) (i32.const 1) (i32.const 5))
+(assert_return (invoke "load8" (i32.const 0)) (i32.const 104))
+(assert_return (invoke "load8" (i32.const 1)) (i32.const 101))
+(assert_return (invoke "load8" (i32.const 4)) (i32.const 111))
+
+;; Only the low byte of the value is stored
+(invoke "fill" (i32.const 10) (i32.const 0x1ff) (i32.const 3))
+(assert_return (invoke "load8" (i32.const 9)) (i32.const 0))
+(assert_return (invoke "load8" (i32.const 10)) (i32.const 255))
+(assert_return (invoke "load8" (i32.const 12)) (i32.const 255))
+(assert_return (invoke "load8" (i32.const 13)) (i32.const 0))
+
+;; The whole range is checked before writing any byte
+(assert_trap (invoke "fill" (i32.const 65530) (i32.const 1) (i32.const 10))
+  "out of bounds memory access")
+(assert_return (invoke "load8" (i32.const 65530)) (i32.const 0))
+(assert_trap (invoke "copy" (i32.const 0) (i32.const 65535) (i32.const 2))
+  "out of bounds memory access")
+(assert_trap (invoke "copy" (i32.const 65535) (i32.const 0) (i32.const 2))
+  "out of bounds memory access")
+(assert_return (invoke "load8" (i32.const 65535)) (i32.const 0))
+(assert_trap (invoke "init" (i32.const 0) (i32.const 3) (i32.const 3))
+  "out of bounds memory access")
+(assert_trap (invoke "init" (i32.const 65534) (i32.const 0) (i32.const 3))
+  "out of bounds memory access")
+(assert_trap (invoke "fill" (i32.const 0) (i32.const 1) (i32.const -1))
+  "out of bounds memory access")
+
+;; Empty ranges at the end of the memory are fine
+(invoke "fill" (i32.const 65536) (i32.const 1) (i32.const 0))
+(invoke "copy" (i32.const 65536) (i32.const 0) (i32.const 0))
+(invoke "copy" (i32.const 0) (i32.const 65536) (i32.const 0))
+(invoke "init" (i32.const 65536) (i32.const 5) (i32.const 0))
+(assert_trap (invoke "fill" (i32.const 65537) (i32.const 1) (i32.const 0))
+  "out of bounds memory access")
+(assert_trap (invoke "init" (i32.const 0) (i32.const 6) (i32.const 0))
+  "out of bounds memory access")
+
+;; A dropped segment behaves as an empty one
+(invoke "drop")
+(invoke "drop")
+(assert_trap (invoke "init" (i32.const 0) (i32.const 0) (i32.const 1))
+  "out of bounds memory access")
+(invoke "init" (i32.const 0) (i32.const 0) (i32.const 0))
+
+;; memory.init requires the data count section
+(assert_malformed
+  (module binary
+    "\00asm" "\01\00\00\00"
+    "\01\04\01\60\00\00"                    ;; type section
+    "\03\02\01\00"                          ;; function section
+    "\05\03\01\00\01"                       ;; memory section
+    "\0a\0e\01\0c\00"                       ;; code section
+    "\41\00\41\00\41\00\fc\08\00\00\0b"     ;; memory.init 0
+    "\0b\04\01\01\01\78"                    ;; data section
+  )
+  "data count section required"
+)
@@ -0,0 +1,82 @@
+;; Multiple function results and type index block types
+
+(module
+  (type $pair (func (param i32 i32) (result i32 i32)))
+  (type $acc (func (param i32 i64) (result i64)))
+
+  (func (export "swap") (param i32 i64) (result i64 i32)
+    (local.get 1) (local.get 0))
+
+  (func $divmod (export "divmod") (param i32 i32) (result i32 i32)
+    (local.get 0) (local.get 1)
+    (block (type $pair)
+      (drop) (drop) (i32.const 7)
+      (i32.div_u (local.get 0) (local.get 1))
+      (i32.rem_u (local.get 0) (local.get 1))
+      (br 0)))
+  (func (export "divmod-packed") (param i32 i32) (result i32)
+    (call $divmod (local.get 0) (local.get 1))
+    (local.set 1) (i32.mul (i32.const 1000)) (i32.add (local.get 1)))
+
+  (func (export "sum-to") (param i32) (result i64) (local i64)
+    (local.get 0) (i64.const 0)
+    (loop (type $acc)
+      (local.set 1) (local.set 0)
+      (if (result i64) (i32.eqz (local.get 0))
+        (then (local.get 1))
+        (else
+          (i32.sub (local.get 0) (i32.const 1))
+          (i64.add (local.get 1) (i64.extend_i32_u (local.get 0)))
+          (br 1)))))
+
+  (func (export "if-pair") (param i32) (result i32 i32)
+    (if (type $pair) (i32.const 1) (i32.const 2) (local.get 0)
+      (then)
+      (else (drop) (drop) (i32.const 3) (i32.const 4))))
+
+  (func $ten (export "ten") (result i32 i32 i32 i32 i32 i32 i32 i32 i32 i32)
+    (i32.const 1) (i32.const 2) (i32.const 3) (i32.const 4) (i32.const 5)
+    (i32.const 6) (i32.const 7) (i32.const 8) (i32.const 9) (i32.const 10))
+  (func (export "sub-ten") (result i32)
+    (call $ten)
+    (i32.sub) (i32.sub) (i32.sub) (i32.sub) (i32.sub)
+    (i32.sub) (i32.sub) (i32.sub) (i32.sub))
+
+  (func (export "mixed") (param f32 i64) (result f64 i32 f32 i64)
+    (f64.promote_f32 (local.get 0))
+    (i32.wrap_i64 (local.get 1))
+    (local.get 0)
+    (local.get 1))
+)
+
+(assert_return (invoke "swap" (i32.const 7) (i64.const 9)) (i64.const 9) (i32.const 7))
+(assert_return (invoke "divmod" (i32.const 47) (i32.const 5)) (i32.const 9) (i32.const 2))
+(assert_return (invoke "divmod-packed" (i32.const 47) (i32.const 5)) (i32.const 9002))
+(assert_return (invoke "sum-to" (i32.const 100000)) (i64.const 5000050000))
+(assert_return (invoke "if-pair" (i32.const 1)) (i32.const 1) (i32.const 2))
+(assert_return (invoke "if-pair" (i32.const 0)) (i32.const 3) (i32.const 4))
+(assert_return (invoke "ten")
+  (i32.const 1) (i32.const 2) (i32.const 3) (i32.const 4) (i32.const 5)
+  (i32.const 6) (i32.const 7) (i32.const 8) (i32.const 9) (i32.const 10))
+;; 1 - (2 - (3 - ... (9 - 10)))
+(assert_return (invoke "sub-ten") (i32.const -5))
+(assert_return (invoke "mixed" (f32.const 1.5) (i64.const 0x100000002))
+  (f64.const 1.5) (i32.const 2) (f32.const 1.5) (i64.const 0x100000002))
+
+;; The block results must match the type
+(assert_invalid
+  (module
+    (type $pair (func (result i32 i32)))
+    (func (result i32) (block (type $pair) (i32.const 1)) (drop)))
+  "type mismatch")
+
+;; (func (block (type 1)))
+(assert_invalid
+  (module binary
+    "\00asm" "\01\00\00\00"
+    "\01\04\01\60\00\00"           ;; type section
+    "\03\02\01\00"                 ;; function section
+    "\0a\07\01\05\00\02\01\0b\0b"  ;; code section
+  )
+  "unknown type"
+)
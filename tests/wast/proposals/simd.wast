@@ -0,0 +1,373 @@
+;; Fixed-width SIMD. The runner only passes scalars, so vectors are built and
+;; inspected inside the functions. Float lanes are passed as their bits to
+;; check that NaN results are canonicalized.
+
+(module
+  (memory 1)
+
+  (func (export "i32x4.add_lane") (param i32 i32) (result i32) (local v128)
+    (local.set 2 (i32x4.splat (local.get 0)))
+    (i32x4.extract_lane 1
+      (i32x4.add
+        (i32x4.replace_lane 1 (local.get 2) (local.get 1))
+        (v128.const i32x4 10 20 30 40))))
+
+  (func (export "v128.select") (param i32) (result i32)
+    (i32x4.extract_lane 2
+      (select
+        (block (result v128) (v128.const i32x4 1 2 3 4))
+        (v128.const i32x4 5 6 7 8)
+        (local.get 0))))
+
+  (func (export "i8x16.shuffle") (param i32) (result i32)
+    (v128.store (local.get 0)
+      (i8x16.shuffle 31 0 30 1 29 2 28 3 27 4 26 5 25 6 24 7
+        (v128.const i8x16 0 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15)
+        (v128.const i8x16 16 17 18 19 20 21 22 23 24 25 26 27 28 29 30 31)))
+    (i32.load (local.get 0)))
+
+  (func (export "i8x16.add_sat_s") (param i32 i32) (result i32)
+    (i8x16.extract_lane_s 3
+      (i8x16.add_sat_s (i8x16.splat (local.get 0)) (i8x16.splat (local.get 1)))))
+
+  (func (export "i32x4.lt_s_mask") (param i32) (result i32)
+    (i32x4.bitmask
+      (i32x4.lt_s (i32x4.splat (local.get 0)) (v128.const i32x4 0 1 2 3))))
+
+  (func (export "i64x2.mul") (param i64 i64) (result i64)
+    (i64x2.extract_lane 1
+      (i64x2.mul (i64x2.splat (local.get 0)) (i64x2.splat (local.get 1)))))
+
+  (func (export "i16x8.narrow_i32x4_s") (param i32) (result i32)
+    (i16x8.extract_lane_s 5
+      (i16x8.narrow_i32x4_s (i32x4.splat (i32.const 0)) (i32x4.splat (local.get 0)))))
+
+  (func (export "f32x4.add") (param i32 i32) (result i32)
+    (i32x4.extract_lane 1
+      (f32x4.add (i32x4.splat (local.get 0)) (i32x4.splat (local.get 1)))))
+  (func (export "f32x4.sub") (param i32 i32) (result i32)
+    (i32x4.extract_lane 1
+      (f32x4.sub (i32x4.splat (local.get 0)) (i32x4.splat (local.get 1)))))
+  (func (export "f32x4.mul") (param i32 i32) (result i32)
+    (i32x4.extract_lane 1
+      (f32x4.mul (i32x4.splat (local.get 0)) (i32x4.splat (local.get 1)))))
+  (func (export "f32x4.div") (param i32 i32) (result i32)
+    (i32x4.extract_lane 1
+      (f32x4.div (i32x4.splat (local.get 0)) (i32x4.splat (local.get 1)))))
+  (func (export "f32x4.min") (param i32 i32) (result i32)
+    (i32x4.extract_lane 1
+      (f32x4.min (i32x4.splat (local.get 0)) (i32x4.splat (local.get 1)))))
+  (func (export "f32x4.max") (param i32 i32) (result i32)
+    (i32x4.extract_lane 1
+      (f32x4.max (i32x4.splat (local.get 0)) (i32x4.splat (local.get 1)))))
+  (func (export "f32x4.pmin") (param i32 i32) (result i32)
+    (i32x4.extract_lane 1
+      (f32x4.pmin (i32x4.splat (local.get 0)) (i32x4.splat (local.get 1)))))
+  (func (export "f32x4.pmax") (param i32 i32) (result i32)
+    (i32x4.extract_lane 1
+      (f32x4.pmax (i32x4.splat (local.get 0)) (i32x4.splat (local.get 1)))))
+  (func (export "f32x4.eq") (param i32 i32) (result i32)
+    (i32x4.extract_lane 3
+      (f32x4.eq (i32x4.splat (local.get 0)) (i32x4.splat (local.get 1)))))
+  (func (export "f32x4.ne") (param i32 i32) (result i32)
+    (i32x4.extract_lane 3
+      (f32x4.ne (i32x4.splat (local.get 0)) (i32x4.splat (local.get 1)))))
+  (func (export "f32x4.lt") (param i32 i32) (result i32)
+    (i32x4.extract_lane 3
+      (f32x4.lt (i32x4.splat (local.get 0)) (i32x4.splat (local.get 1)))))
+  (func (export "f32x4.gt") (param i32 i32) (result i32)
+    (i32x4.extract_lane 3
+      (f32x4.gt (i32x4.splat (local.get 0)) (i32x4.splat (local.get 1)))))
+  (func (export "f32x4.le") (param i32 i32) (result i32)
+    (i32x4.extract_lane 3
+      (f32x4.le (i32x4.splat (local.get 0)) (i32x4.splat (local.get 1)))))
+  (func (export "f32x4.ge") (param i32 i32) (result i32)
+    (i32x4.extract_lane 3
+      (f32x4.ge (i32x4.splat (local.get 0)) (i32x4.splat (local.get 1)))))
+  (func (export "f32x4.abs") (param i32) (result i32)
+    (i32x4.extract_lane 2 (f32x4.abs (i32x4.splat (local.get 0)))))
+  (func (export "f32x4.neg") (param i32) (result i32)
+    (i32x4.extract_lane 2 (f32x4.neg (i32x4.splat (local.get 0)))))
+  (func (export "f32x4.sqrt") (param i32) (result i32)
+    (i32x4.extract_lane 2 (f32x4.sqrt (i32x4.splat (local.get 0)))))
+  (func (export "f32x4.ceil") (param i32) (result i32)
+    (i32x4.extract_lane 2 (f32x4.ceil (i32x4.splat (local.get 0)))))
+  (func (export "f32x4.floor") (param i32) (result i32)
+    (i32x4.extract_lane 2 (f32x4.floor (i32x4.splat (local.get 0)))))
+  (func (export "f32x4.trunc") (param i32) (result i32)
+    (i32x4.extract_lane 2 (f32x4.trunc (i32x4.splat (local.get 0)))))
+  (func (export "f32x4.nearest") (param i32) (result i32)
+    (i32x4.extract_lane 2 (f32x4.nearest (i32x4.splat (local.get 0)))))
+  (func (export "f64x2.add") (param i64 i64) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.add (i64x2.splat (local.get 0)) (i64x2.splat (local.get 1)))))
+  (func (export "f64x2.sub") (param i64 i64) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.sub (i64x2.splat (local.get 0)) (i64x2.splat (local.get 1)))))
+  (func (export "f64x2.mul") (param i64 i64) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.mul (i64x2.splat (local.get 0)) (i64x2.splat (local.get 1)))))
+  (func (export "f64x2.div") (param i64 i64) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.div (i64x2.splat (local.get 0)) (i64x2.splat (local.get 1)))))
+  (func (export "f64x2.min") (param i64 i64) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.min (i64x2.splat (local.get 0)) (i64x2.splat (local.get 1)))))
+  (func (export "f64x2.max") (param i64 i64) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.max (i64x2.splat (local.get 0)) (i64x2.splat (local.get 1)))))
+  (func (export "f64x2.pmin") (param i64 i64) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.pmin (i64x2.splat (local.get 0)) (i64x2.splat (local.get 1)))))
+  (func (export "f64x2.pmax") (param i64 i64) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.pmax (i64x2.splat (local.get 0)) (i64x2.splat (local.get 1)))))
+  (func (export "f64x2.eq") (param i64 i64) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.eq (i64x2.splat (local.get 0)) (i64x2.splat (local.get 1)))))
+  (func (export "f64x2.ne") (param i64 i64) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.ne (i64x2.splat (local.get 0)) (i64x2.splat (local.get 1)))))
+  (func (export "f64x2.lt") (param i64 i64) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.lt (i64x2.splat (local.get 0)) (i64x2.splat (local.get 1)))))
+  (func (export "f64x2.gt") (param i64 i64) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.gt (i64x2.splat (local.get 0)) (i64x2.splat (local.get 1)))))
+  (func (export "f64x2.le") (param i64 i64) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.le (i64x2.splat (local.get 0)) (i64x2.splat (local.get 1)))))
+  (func (export "f64x2.ge") (param i64 i64) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.ge (i64x2.splat (local.get 0)) (i64x2.splat (local.get 1)))))
+  (func (export "f64x2.abs") (param i64) (result i64)
+    (i64x2.extract_lane 0 (f64x2.abs (i64x2.splat (local.get 0)))))
+  (func (export "f64x2.neg") (param i64) (result i64)
+    (i64x2.extract_lane 0 (f64x2.neg (i64x2.splat (local.get 0)))))
+  (func (export "f64x2.sqrt") (param i64) (result i64)
+    (i64x2.extract_lane 0 (f64x2.sqrt (i64x2.splat (local.get 0)))))
+  (func (export "f64x2.ceil") (param i64) (result i64)
+    (i64x2.extract_lane 0 (f64x2.ceil (i64x2.splat (local.get 0)))))
+  (func (export "f64x2.floor") (param i64) (result i64)
+    (i64x2.extract_lane 0 (f64x2.floor (i64x2.splat (local.get 0)))))
+  (func (export "f64x2.trunc") (param i64) (result i64)
+    (i64x2.extract_lane 0 (f64x2.trunc (i64x2.splat (local.get 0)))))
+  (func (export "f64x2.nearest") (param i64) (result i64)
+    (i64x2.extract_lane 0 (f64x2.nearest (i64x2.splat (local.get 0)))))
+
+  (func (export "f32x4.demote_f64x2_zero") (param i64 i32) (result i32)
+    (i32x4.extract_lane 0
+      (i8x16.swizzle
+        (f32x4.demote_f64x2_zero (i64x2.splat (local.get 0)))
+        (i32x4.splat (local.get 1)))))
+  (func (export "f64x2.promote_low_f32x4") (param i32) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.promote_low_f32x4
+        (i32x4.replace_lane 2 (i32x4.splat (local.get 0)) (i32.const 0)))))
+  (func (export "i32x4.trunc_sat_f32x4_s") (param i32) (result i32)
+    (i32x4.extract_lane 3 (i32x4.trunc_sat_f32x4_s (i32x4.splat (local.get 0)))))
+  (func (export "i32x4.trunc_sat_f32x4_u") (param i32) (result i32)
+    (i32x4.extract_lane 3 (i32x4.trunc_sat_f32x4_u (i32x4.splat (local.get 0)))))
+  (func (export "f32x4.convert_i32x4_s") (param i32) (result i32)
+    (i32x4.extract_lane 1 (f32x4.convert_i32x4_s (i32x4.splat (local.get 0)))))
+  (func (export "f32x4.convert_i32x4_u") (param i32) (result i32)
+    (i32x4.extract_lane 1 (f32x4.convert_i32x4_u (i32x4.splat (local.get 0)))))
+  (func (export "i32x4.trunc_sat_f64x2_s_zero") (param i64 i32) (result i32)
+    (i32x4.extract_lane 0
+      (i8x16.swizzle
+        (i32x4.trunc_sat_f64x2_s_zero (i64x2.splat (local.get 0)))
+        (i32x4.splat (local.get 1)))))
+  (func (export "i32x4.trunc_sat_f64x2_u_zero") (param i64 i32) (result i32)
+    (i32x4.extract_lane 0
+      (i8x16.swizzle
+        (i32x4.trunc_sat_f64x2_u_zero (i64x2.splat (local.get 0)))
+        (i32x4.splat (local.get 1)))))
+  (func (export "f64x2.convert_low_i32x4_s") (param i32) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.convert_low_i32x4_s
+        (i32x4.replace_lane 2 (i32x4.splat (local.get 0)) (i32.const 0)))))
+  (func (export "f64x2.convert_low_i32x4_u") (param i32) (result i64)
+    (i64x2.extract_lane 1
+      (f64x2.convert_low_i32x4_u
+        (i32x4.replace_lane 2 (i32x4.splat (local.get 0)) (i32.const 0)))))
+)
+
+;; Integer lanes
+(assert_return (invoke "i32x4.add_lane" (i32.const 1) (i32.const 2)) (i32.const 22))
+;; Lanes wrap around
+(assert_return (invoke "i32x4.add_lane" (i32.const 0) (i32.const 0x7fffffff)) (i32.const 0x80000013))
+(assert_return (invoke "v128.select" (i32.const 1)) (i32.const 3))
+(assert_return (invoke "v128.select" (i32.const 0)) (i32.const 7))
+;; Bytes 31, 0, 30, 1 in little endian
+(assert_return (invoke "i8x16.shuffle" (i32.const 8)) (i32.const 0x011e001f))
+(assert_trap (invoke "i8x16.shuffle" (i32.const 65530)) "out of bounds memory access")
+(assert_return (invoke "i8x16.add_sat_s" (i32.const 100) (i32.const 100)) (i32.const 127))
+(assert_return (invoke "i8x16.add_sat_s" (i32.const -100) (i32.const -100)) (i32.const -128))
+(assert_return (invoke "i8x16.add_sat_s" (i32.const 0x1ff) (i32.const 1)) (i32.const 0))
+(assert_return (invoke "i32x4.lt_s_mask" (i32.const 1)) (i32.const 0xc))
+(assert_return (invoke "i32x4.lt_s_mask" (i32.const -1)) (i32.const 0xf))
+(assert_return (invoke "i32x4.lt_s_mask" (i32.const 3)) (i32.const 0))
+(assert_return (invoke "i64x2.mul" (i64.const 0x100000001) (i64.const 0x100000001)) (i64.const 0x200000001))
+(assert_return (invoke "i16x8.narrow_i32x4_s" (i32.const 40000)) (i32.const 32767))
+(assert_return (invoke "i16x8.narrow_i32x4_s" (i32.const -40000)) (i32.const -32768))
+(assert_return (invoke "i16x8.narrow_i32x4_s" (i32.const -5)) (i32.const -5))
+
+;; f32x4, NaN results are always the positive canonical NaN
+(assert_return (invoke "f32x4.add" (i32.const 0x3f800000) (i32.const 0x40000000)) (i32.const 0x40400000))
+(assert_return (invoke "f32x4.add" (i32.const 0x7fa00001) (i32.const 0x3f800000)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.add" (i32.const 0xffc00000) (i32.const 0x3f800000)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.add" (i32.const 0x7f800000) (i32.const 0xff800000)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.sub" (i32.const 0x40400000) (i32.const 0x3f800000)) (i32.const 0x40000000))
+(assert_return (invoke "f32x4.sub" (i32.const 0x7f800000) (i32.const 0x7f800000)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.mul" (i32.const 0x3fc00000) (i32.const 0x40000000)) (i32.const 0x40400000))
+(assert_return (invoke "f32x4.mul" (i32.const 0) (i32.const 0x7f800000)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.div" (i32.const 0x3f800000) (i32.const 0x40000000)) (i32.const 0x3f000000))
+(assert_return (invoke "f32x4.div" (i32.const 0) (i32.const 0)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.div" (i32.const 0x3f800000) (i32.const 0)) (i32.const 0x7f800000))
+(assert_return (invoke "f32x4.div" (i32.const 0xbf800000) (i32.const 0)) (i32.const 0xff800000))
+(assert_return (invoke "f32x4.div" (i32.const 0x7fa00001) (i32.const 0x3f800000)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.min" (i32.const 0x3f800000) (i32.const 0x40000000)) (i32.const 0x3f800000))
+(assert_return (invoke "f32x4.min" (i32.const 0x80000000) (i32.const 0)) (i32.const 0x80000000))
+(assert_return (invoke "f32x4.min" (i32.const 0) (i32.const 0x80000000)) (i32.const 0x80000000))
+(assert_return (invoke "f32x4.min" (i32.const 0x7fa00001) (i32.const 0x3f800000)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.min" (i32.const 0x3f800000) (i32.const 0xffc00000)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.max" (i32.const 0x3f800000) (i32.const 0x40000000)) (i32.const 0x40000000))
+(assert_return (invoke "f32x4.max" (i32.const 0x80000000) (i32.const 0)) (i32.const 0))
+(assert_return (invoke "f32x4.max" (i32.const 0) (i32.const 0x80000000)) (i32.const 0))
+(assert_return (invoke "f32x4.max" (i32.const 0x3f800000) (i32.const 0x7fa00001)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.pmin" (i32.const 0x3f800000) (i32.const 0x40000000)) (i32.const 0x3f800000))
+(assert_return (invoke "f32x4.pmin" (i32.const 0x80000000) (i32.const 0)) (i32.const 0x80000000))
+(assert_return (invoke "f32x4.pmin" (i32.const 0) (i32.const 0x80000000)) (i32.const 0))
+(assert_return (invoke "f32x4.pmin" (i32.const 0x7fa00001) (i32.const 0x3f800000)) (i32.const 0x7fa00001))
+(assert_return (invoke "f32x4.pmin" (i32.const 0x3f800000) (i32.const 0x7fa00001)) (i32.const 0x3f800000))
+(assert_return (invoke "f32x4.pmax" (i32.const 0x3f800000) (i32.const 0x40000000)) (i32.const 0x40000000))
+(assert_return (invoke "f32x4.pmax" (i32.const 0x80000000) (i32.const 0)) (i32.const 0x80000000))
+(assert_return (invoke "f32x4.pmax" (i32.const 0x7fa00001) (i32.const 0x3f800000)) (i32.const 0x7fa00001))
+(assert_return (invoke "f32x4.pmax" (i32.const 0x3f800000) (i32.const 0x7fa00001)) (i32.const 0x3f800000))
+(assert_return (invoke "f32x4.eq" (i32.const 0x3f800000) (i32.const 0x3f800000)) (i32.const -1))
+(assert_return (invoke "f32x4.eq" (i32.const 0) (i32.const 0x80000000)) (i32.const -1))
+(assert_return (invoke "f32x4.eq" (i32.const 0x7fc00000) (i32.const 0x7fc00000)) (i32.const 0))
+(assert_return (invoke "f32x4.ne" (i32.const 0x7fc00000) (i32.const 0x7fc00000)) (i32.const -1))
+(assert_return (invoke "f32x4.ne" (i32.const 0x3f800000) (i32.const 0x3f800000)) (i32.const 0))
+(assert_return (invoke "f32x4.lt" (i32.const 0x3f800000) (i32.const 0x40000000)) (i32.const -1))
+(assert_return (invoke "f32x4.lt" (i32.const 0x40000000) (i32.const 0x3f800000)) (i32.const 0))
+(assert_return (invoke "f32x4.lt" (i32.const 0x7fc00000) (i32.const 0x3f800000)) (i32.const 0))
+(assert_return (invoke "f32x4.gt" (i32.const 0x40000000) (i32.const 0x3f800000)) (i32.const -1))
+(assert_return (invoke "f32x4.gt" (i32.const 0x3f800000) (i32.const 0x7fc00000)) (i32.const 0))
+(assert_return (invoke "f32x4.le" (i32.const 0x40000000) (i32.const 0x40000000)) (i32.const -1))
+(assert_return (invoke "f32x4.le" (i32.const 0x7fc00000) (i32.const 0x7fc00000)) (i32.const 0))
+(assert_return (invoke "f32x4.ge" (i32.const 0x3f800000) (i32.const 0x40000000)) (i32.const 0))
+(assert_return (invoke "f32x4.ge" (i32.const 0x80000000) (i32.const 0)) (i32.const -1))
+(assert_return (invoke "f32x4.abs" (i32.const 0x80000000)) (i32.const 0))
+(assert_return (invoke "f32x4.abs" (i32.const 0xbf800000)) (i32.const 0x3f800000))
+(assert_return (invoke "f32x4.abs" (i32.const 0xffc00000)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.abs" (i32.const 0xffa00001)) (i32.const 0x7fa00001))
+(assert_return (invoke "f32x4.neg" (i32.const 0x3f800000)) (i32.const 0xbf800000))
+(assert_return (invoke "f32x4.neg" (i32.const 0)) (i32.const 0x80000000))
+(assert_return (invoke "f32x4.neg" (i32.const 0x7fa00001)) (i32.const 0xffa00001))
+(assert_return (invoke "f32x4.sqrt" (i32.const 0x40800000)) (i32.const 0x40000000))
+(assert_return (invoke "f32x4.sqrt" (i32.const 0xbf800000)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.sqrt" (i32.const 0x7fa00001)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.sqrt" (i32.const 0xff800000)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.ceil" (i32.const 0x3fc00000)) (i32.const 0x40000000))
+(assert_return (invoke "f32x4.ceil" (i32.const 0xbf000000)) (i32.const 0x80000000))
+(assert_return (invoke "f32x4.ceil" (i32.const 0x7fa00001)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.floor" (i32.const 0xbfc00000)) (i32.const 0xc0000000))
+(assert_return (invoke "f32x4.floor" (i32.const 0xffc00000)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.trunc" (i32.const 0xbfc00000)) (i32.const 0xbf800000))
+(assert_return (invoke "f32x4.trunc" (i32.const 0x7fa00001)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.nearest" (i32.const 0x40200000)) (i32.const 0x40000000))
+(assert_return (invoke "f32x4.nearest" (i32.const 0xc0200000)) (i32.const 0xc0000000))
+(assert_return (invoke "f32x4.nearest" (i32.const 0x40600000)) (i32.const 0x40800000))
+(assert_return (invoke "f32x4.nearest" (i32.const 0x7fa00001)) (i32.const 0x7fc00000))
+
+;; f64x2
+(assert_return (invoke "f64x2.add" (i64.const 0x3ff0000000000000) (i64.const 0x4000000000000000)) (i64.const 0x4008000000000000))
+(assert_return (invoke "f64x2.add" (i64.const 0x7ff4000000000001) (i64.const 0x3ff0000000000000)) (i64.const 0x7ff8000000000000))
+(assert_return (invoke "f64x2.add" (i64.const 0xfff8000000000000) (i64.const 0x3ff0000000000000)) (i64.const 0x7ff8000000000000))
+(assert_return (invoke "f64x2.sub" (i64.const 0x4008000000000000) (i64.const 0x3ff0000000000000)) (i64.const 0x4000000000000000))
+(assert_return (invoke "f64x2.sub" (i64.const 0x7ff0000000000000) (i64.const 0x7ff0000000000000)) (i64.const 0x7ff8000000000000))
+(assert_return (invoke "f64x2.mul" (i64.const 0) (i64.const 0x7ff0000000000000)) (i64.const 0x7ff8000000000000))
+(assert_return (invoke "f64x2.mul" (i64.const 0x3ff8000000000000) (i64.const 0x4000000000000000)) (i64.const 0x4008000000000000))
+(assert_return (invoke "f64x2.div" (i64.const 0x3ff0000000000000) (i64.const 0x4000000000000000)) (i64.const 0x3fe0000000000000))
+(assert_return (invoke "f64x2.div" (i64.const 0) (i64.const 0)) (i64.const 0x7ff8000000000000))
+(assert_return (invoke "f64x2.div" (i64.const 0xbff0000000000000) (i64.const 0)) (i64.const 0xfff0000000000000))
+(assert_return (invoke "f64x2.min" (i64.const 0x8000000000000000) (i64.const 0)) (i64.const 0x8000000000000000))
+(assert_return (invoke "f64x2.min" (i64.const 0x3ff0000000000000) (i64.const 0x7ff4000000000001)) (i64.const 0x7ff8000000000000))
+(assert_return (invoke "f64x2.max" (i64.const 0) (i64.const 0x8000000000000000)) (i64.const 0))
+(assert_return (invoke "f64x2.max" (i64.const 0xfff8000000000000) (i64.const 0x3ff0000000000000)) (i64.const 0x7ff8000000000000))
+(assert_return (invoke "f64x2.pmin" (i64.const 0x7ff4000000000001) (i64.const 0x3ff0000000000000)) (i64.const 0x7ff4000000000001))
+(assert_return (invoke "f64x2.pmin" (i64.const 0x4000000000000000) (i64.const 0x3ff0000000000000)) (i64.const 0x3ff0000000000000))
+(assert_return (invoke "f64x2.pmax" (i64.const 0x7ff4000000000001) (i64.const 0x3ff0000000000000)) (i64.const 0x7ff4000000000001))
+(assert_return (invoke "f64x2.pmax" (i64.const 0x3ff0000000000000) (i64.const 0x4000000000000000)) (i64.const 0x4000000000000000))
+(assert_return (invoke "f64x2.eq" (i64.const 0x3ff0000000000000) (i64.const 0x3ff0000000000000)) (i64.const -1))
+(assert_return (invoke "f64x2.eq" (i64.const 0x7ff8000000000000) (i64.const 0x7ff8000000000000)) (i64.const 0))
+(assert_return (invoke "f64x2.ne" (i64.const 0x7ff8000000000000) (i64.const 0x3ff0000000000000)) (i64.const -1))
+(assert_return (invoke "f64x2.lt" (i64.const 0x3ff0000000000000) (i64.const 0x4000000000000000)) (i64.const -1))
+(assert_return (invoke "f64x2.gt" (i64.const 0x3ff0000000000000) (i64.const 0x4000000000000000)) (i64.const 0))
+(assert_return (invoke "f64x2.le" (i64.const 0x8000000000000000) (i64.const 0)) (i64.const -1))
+(assert_return (invoke "f64x2.ge" (i64.const 0x7ff8000000000000) (i64.const 0x3ff0000000000000)) (i64.const 0))
+(assert_return (invoke "f64x2.abs" (i64.const 0xfff8000000000000)) (i64.const 0x7ff8000000000000))
+(assert_return (invoke "f64x2.abs" (i64.const 0xbff0000000000000)) (i64.const 0x3ff0000000000000))
+(assert_return (invoke "f64x2.neg" (i64.const 0x3ff0000000000000)) (i64.const 0xbff0000000000000))
+(assert_return (invoke "f64x2.neg" (i64.const 0x7ff4000000000001)) (i64.const 0xfff4000000000001))
+(assert_return (invoke "f64x2.sqrt" (i64.const 0x4010000000000000)) (i64.const 0x4000000000000000))
+(assert_return (invoke "f64x2.sqrt" (i64.const 0xbff0000000000000)) (i64.const 0x7ff8000000000000))
+(assert_return (invoke "f64x2.ceil" (i64.const 0x3ff8000000000000)) (i64.const 0x4000000000000000))
+(assert_return (invoke "f64x2.floor" (i64.const 0xbff8000000000000)) (i64.const 0xc000000000000000))
+(assert_return (invoke "f64x2.trunc" (i64.const 0xbff8000000000000)) (i64.const 0xbff0000000000000))
+(assert_return (invoke "f64x2.trunc" (i64.const 0x7ff4000000000001)) (i64.const 0x7ff8000000000000))
+(assert_return (invoke "f64x2.nearest" (i64.const 0x4004000000000000)) (i64.const 0x4000000000000000))
+(assert_return (invoke "f64x2.nearest" (i64.const 0x400c000000000000)) (i64.const 0x4010000000000000))
+(assert_return (invoke "f64x2.nearest" (i64.const 0xfff8000000000000)) (i64.const 0x7ff8000000000000))
+
+;; Conversions, the lanes which have no source lane are zero
+(assert_return (invoke "f32x4.demote_f64x2_zero" (i64.const 0x3ff0000000000000) (i32.const 50462976)) (i32.const 0x3f800000))
+(assert_return (invoke "f32x4.demote_f64x2_zero" (i64.const 0x7ff4000000000001) (i32.const 50462976)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.demote_f64x2_zero" (i64.const 0xfff8000000000000) (i32.const 117835012)) (i32.const 0x7fc00000))
+(assert_return (invoke "f32x4.demote_f64x2_zero" (i64.const 0x3ff0000000000000) (i32.const 185207048)) (i32.const 0))
+(assert_return (invoke "f32x4.demote_f64x2_zero" (i64.const 0x3ff0000000000000) (i32.const 252579084)) (i32.const 0))
+(assert_return (invoke "f64x2.promote_low_f32x4" (i32.const 0x3fc00000)) (i64.const 0x3ff8000000000000))
+(assert_return (invoke "f64x2.promote_low_f32x4" (i32.const 0x7fa00001)) (i64.const 0x7ff8000000000000))
+(assert_return (invoke "f64x2.promote_low_f32x4" (i32.const 0xffc00000)) (i64.const 0x7ff8000000000000))
+(assert_return (invoke "i32x4.trunc_sat_f32x4_s" (i32.const 0x3fc00000)) (i32.const 1))
+(assert_return (invoke "i32x4.trunc_sat_f32x4_s" (i32.const 0xbfc00000)) (i32.const -1))
+(assert_return (invoke "i32x4.trunc_sat_f32x4_s" (i32.const 0x7fc00000)) (i32.const 0))
+(assert_return (invoke "i32x4.trunc_sat_f32x4_s" (i32.const 0xffc00000)) (i32.const 0))
+(assert_return (invoke "i32x4.trunc_sat_f32x4_s" (i32.const 0x4f000000)) (i32.const 0x7fffffff))
+(assert_return (invoke "i32x4.trunc_sat_f32x4_s" (i32.const 0x7f800000)) (i32.const 0x7fffffff))
+(assert_return (invoke "i32x4.trunc_sat_f32x4_s" (i32.const 0xff800000)) (i32.const 0x80000000))
+(assert_return (invoke "i32x4.trunc_sat_f32x4_u" (i32.const 0x3fc00000)) (i32.const 1))
+(assert_return (invoke "i32x4.trunc_sat_f32x4_u" (i32.const 0xbfc00000)) (i32.const 0))
+(assert_return (invoke "i32x4.trunc_sat_f32x4_u" (i32.const 0x7fc00000)) (i32.const 0))
+(assert_return (invoke "i32x4.trunc_sat_f32x4_u" (i32.const 0x4f7fffff)) (i32.const 0xffffff00))
+(assert_return (invoke "i32x4.trunc_sat_f32x4_u" (i32.const 0x7f800000)) (i32.const 0xffffffff))
+(assert_return (invoke "i32x4.trunc_sat_f32x4_u" (i32.const 0xff800000)) (i32.const 0))
+(assert_return (invoke "f32x4.convert_i32x4_s" (i32.const -1)) (i32.const 0xbf800000))
+(assert_return (invoke "f32x4.convert_i32x4_s" (i32.const 16777217)) (i32.const 0x4b800000))
+(assert_return (invoke "f32x4.convert_i32x4_s" (i32.const 0)) (i32.const 0))
+(assert_return (invoke "f32x4.convert_i32x4_u" (i32.const -1)) (i32.const 0x4f800000))
+(assert_return (invoke "f32x4.convert_i32x4_u" (i32.const 16777217)) (i32.const 0x4b800000))
+(assert_return (invoke "i32x4.trunc_sat_f64x2_s_zero" (i64.const 0x4007333333333333) (i32.const 50462976)) (i32.const 2))
+(assert_return (invoke "i32x4.trunc_sat_f64x2_s_zero" (i64.const 0xc202a05f20000000) (i32.const 117835012)) (i32.const 0x80000000))
+(assert_return (invoke "i32x4.trunc_sat_f64x2_s_zero" (i64.const 0x7ff8000000000000) (i32.const 50462976)) (i32.const 0))
+(assert_return (invoke "i32x4.trunc_sat_f64x2_s_zero" (i64.const 0x7ff0000000000000) (i32.const 50462976)) (i32.const 0x7fffffff))
+(assert_return (invoke "i32x4.trunc_sat_f64x2_s_zero" (i64.const 0x3ff0000000000000) (i32.const 185207048)) (i32.const 0))
+(assert_return (invoke "i32x4.trunc_sat_f64x2_s_zero" (i64.const 0x3ff0000000000000) (i32.const 252579084)) (i32.const 0))
+(assert_return (invoke "i32x4.trunc_sat_f64x2_u_zero" (i64.const 0xbff0000000000000) (i32.const 50462976)) (i32.const 0))
+(assert_return (invoke "i32x4.trunc_sat_f64x2_u_zero" (i64.const 0x41efffffffe00000) (i32.const 117835012)) (i32.const -1))
+(assert_return (invoke "i32x4.trunc_sat_f64x2_u_zero" (i64.const 0x41f0000000000000) (i32.const 50462976)) (i32.const -1))
+(assert_return (invoke "i32x4.trunc_sat_f64x2_u_zero" (i64.const 0x3ff0000000000000) (i32.const 185207048)) (i32.const 0))
+(assert_return (invoke "f64x2.convert_low_i32x4_s" (i32.const -1)) (i64.const 0xbff0000000000000))
+(assert_return (invoke "f64x2.convert_low_i32x4_s" (i32.const 3)) (i64.const 0x4008000000000000))
+(assert_return (invoke "f64x2.convert_low_i32x4_u" (i32.const -1)) (i64.const 0x41efffffffe00000))
+
+;; Lane indices are checked when loading
+(assert_invalid
+  (module (func (result i32) (i32x4.extract_lane 4 (v128.const i32x4 0 0 0 0))))
+  "invalid lane index")
+(assert_invalid
+  (module (func (result v128)
+    (i8x16.shuffle 0 1 2 3 4 5 6 7 8 9 10 11 12 13 14 32
+      (v128.const i32x4 0 0 0 0) (v128.const i32x4 0 0 0 0))))
+  "invalid lane index")
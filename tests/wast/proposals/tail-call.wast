@@ -0,0 +1,67 @@
+;; return_call and return_call_indirect
+
+(module
+  (type $pred (func (param i32) (result i32)))
+  (table funcref (elem $odd-indirect))
+
+  (func $sum (export "sum") (param i32 i64) (result i64)
+    (if (result i64) (i32.eqz (local.get 0))
+      (then (local.get 1))
+      (else
+        (return_call $sum
+          (i32.sub (local.get 0) (i32.const 1))
+          (i64.add (local.get 1) (i64.extend_i32_u (local.get 0)))))))
+
+  (func $even (export "even") (param i32) (result i32)
+    (if (result i32) (i32.eqz (local.get 0))
+      (then (i32.const 1))
+      (else (return_call $odd (i32.sub (local.get 0) (i32.const 1))))))
+  (func $odd (export "odd") (param i32) (result i32)
+    (if (result i32) (i32.eqz (local.get 0))
+      (then (i32.const 0))
+      (else (return_call $even (i32.sub (local.get 0) (i32.const 1))))))
+
+  (func $even-indirect (export "even-indirect") (param i32) (result i32)
+    (if (result i32) (i32.eqz (local.get 0))
+      (then (i32.const 1))
+      (else
+        (return_call_indirect (type $pred)
+          (i32.sub (local.get 0) (i32.const 1)) (i32.const 0)))))
+  (func $odd-indirect (param i32) (result i32)
+    (if (result i32) (i32.eqz (local.get 0))
+      (then (i32.const 0))
+      (else (return_call $even-indirect (i32.sub (local.get 0) (i32.const 1))))))
+
+  (func (export "sum-from") (param i32) (result i64)
+    (return_call $sum (local.get 0) (i64.const 0)))
+  (func (export "call-missing") (result i32)
+    (return_call_indirect (type $pred) (i32.const 0) (i32.const 1)))
+)
+
+(assert_return (invoke "sum" (i32.const 0) (i64.const 7)) (i64.const 7))
+(assert_return (invoke "sum-from" (i32.const 100)) (i64.const 5050))
+
+;; Far deeper than the stack allows if every call kept its frame
+(assert_return (invoke "sum-from" (i32.const 1000000)) (i64.const 500000500000))
+(assert_return (invoke "even" (i32.const 1000000)) (i32.const 1))
+(assert_return (invoke "odd" (i32.const 1000000)) (i32.const 0))
+(assert_return (invoke "even" (i32.const 999999)) (i32.const 0))
+
+;; Indirect tail calls may keep the frames in JIT modes, use a depth which
+;; fits the stack anyway
+(assert_return (invoke "even-indirect" (i32.const 10000)) (i32.const 1))
+(assert_return (invoke "even-indirect" (i32.const 9999)) (i32.const 0))
+(assert_trap (invoke "call-missing") "undefined element")
+
+;; The callee results must match the caller results exactly
+(assert_invalid
+  (module
+    (func (result i32) (return_call 1))
+    (func (result i64) (i64.const 0)))
+  "type mismatch")
+(assert_invalid
+  (module
+    (type $t (func (result i64)))
+    (table 1 funcref)
+    (func (result i32) (return_call_indirect (type $t) (i32.const 0))))
+  "type mismatch")
@@ -0,0 +1,81 @@
+;; Blocks typed by a type index above 63, which is encoded as a multi-byte
+;; LEB and must not be skipped as a one-byte block type
+
+(module
+  (type (func)) (type (func)) (type (func)) (type (func)) (type (func))
+  (type (func)) (type (func)) (type (func)) (type (func)) (type (func))
+  (type (func)) (type (func)) (type (func)) (type (func)) (type (func))
+  (type (func)) (type (func)) (type (func)) (type (func)) (type (func))
+  (type (func)) (type (func)) (type (func)) (type (func)) (type (func))
+  (type (func)) (type (func)) (type (func)) (type (func)) (type (func))
+  (type (func)) (type (func)) (type (func)) (type (func)) (type (func))
+  (type (func)) (type (func)) (type (func)) (type (func)) (type (func))
+  (type (func)) (type (func)) (type (func)) (type (func)) (type (func))
+  (type (func)) (type (func)) (type (func)) (type (func)) (type (func))
+  (type (func)) (type (func)) (type (func)) (type (func)) (type (func))
+  (type (func)) (type (func)) (type (func)) (type (func)) (type (func))
+  (type (func)) (type (func)) (type (func)) (type (func)) (type (func))
+  (type (func)) (type (func)) (type (func)) (type (func)) (type (func))
+  (type $pair (func (param i32) (result i32 i32)))
+  (type $sum (func (param i32 i32) (result i32)))
+
+  (func (export "block-pair") (param i32) (result i32)
+    local.get 0
+    block (type $pair)
+      local.get 0
+      i32.const 3
+      i32.mul
+    end
+    i32.sub)
+
+  (func (export "loop-sum") (param i32) (result i32)
+    (local i32)
+    i32.const 0
+    local.get 0
+    loop $l (type $sum)
+      local.set 1
+      local.get 1
+      i32.add
+      local.get 1
+      i32.const 1
+      i32.sub
+      local.tee 1
+      local.get 1
+      br_if $l
+      drop
+    end)
+
+  (func (export "if-pair") (param i32) (result i32)
+    i32.const 10
+    local.get 0
+    if (type $pair)
+      i32.const 1
+    else
+      i32.const 2
+    end
+    i32.add)
+
+  (func (export "dead-block") (param i32) (result i32)
+    (local i32)
+    block (result i32)
+      local.get 0
+      br 0
+      i32.const 7
+      block (type $pair)
+        local.set 1
+        local.get 1
+        local.get 1
+      end
+      i32.add
+      local.get 0
+      loop (type $sum)
+        i32.add
+      end
+    end)
+)
+
+(assert_return (invoke "block-pair" (i32.const 5)) (i32.const -10))
+(assert_return (invoke "loop-sum" (i32.const 4)) (i32.const 10))
+(assert_return (invoke "if-pair" (i32.const 1)) (i32.const 11))
+(assert_return (invoke "if-pair" (i32.const 0)) (i32.const 12))
+(assert_return (invoke "dead-block" (i32.const 3)) (i32.const 3))
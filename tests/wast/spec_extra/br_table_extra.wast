@@ -0,0 +1,109 @@
+;; br_table with enough targets to be pre-decoded by the loader, next to
+;; small tables which are kept as is
+
+(module
+  (func (export "dispatch") (param i32) (result i32)
+    (block (block (block (block
+      (br_table 0 1 2 3 1 2 (local.get 0)))
+      (return (i32.const 10)))
+      (return (i32.const 11)))
+      (return (i32.const 12)))
+    (i32.const 13))
+
+  (func (export "small") (param i32) (result i32)
+    (block (block (br_table 0 1 (local.get 0)))
+      (return (i32.const 20)))
+    (i32.const 21))
+
+  (func (export "default-only") (param i32) (result i32)
+    (block (br_table 0 (local.get 0)) (return (i32.const 30)))
+    (i32.const 31))
+
+  (func (export "with-value") (param i32) (result i32)
+    (block (result i32)
+      (block (result i32)
+        (block (result i32)
+          (block (result i32)
+            (br_table 3 2 1 0 0 1 (i32.const 40) (local.get 0)))
+          (return (i32.add (i32.const 1))))
+        (return (i32.add (i32.const 2))))
+      (return (i32.add (i32.const 3))))
+    (i32.add (i32.const 4)))
+
+  (func (export "loop-count") (param i32) (result i32)
+    (local i32)
+    (block
+      (loop
+        (local.set 1 (i32.add (local.get 1) (i32.const 1)))
+        (local.set 0 (i32.sub (local.get 0) (i32.const 1)))
+        (br_table 1 0 0 0 0 (local.get 0))))
+    (local.get 1))
+
+  (func (export "wide") (param i32) (result i32)
+    (block (block (block (block (block (block (block (block (block (block (block (block (block (block (block (block (block 
+      (br_table 0 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 (local.get 0)))
+      (return (i32.const 100)))
+      (return (i32.const 101)))
+      (return (i32.const 102)))
+      (return (i32.const 103)))
+      (return (i32.const 104)))
+      (return (i32.const 105)))
+      (return (i32.const 106)))
+      (return (i32.const 107)))
+      (return (i32.const 108)))
+      (return (i32.const 109)))
+      (return (i32.const 110)))
+      (return (i32.const 111)))
+      (return (i32.const 112)))
+      (return (i32.const 113)))
+      (return (i32.const 114)))
+      (return (i32.const 115)))
+    (i32.const 116))
+)
+
+(assert_return (invoke "dispatch" (i32.const 0)) (i32.const 10))
+(assert_return (invoke "dispatch" (i32.const 1)) (i32.const 11))
+(assert_return (invoke "dispatch" (i32.const 2)) (i32.const 12))
+(assert_return (invoke "dispatch" (i32.const 3)) (i32.const 13))
+(assert_return (invoke "dispatch" (i32.const 4)) (i32.const 11))
+(assert_return (invoke "dispatch" (i32.const 5)) (i32.const 12))
+(assert_return (invoke "dispatch" (i32.const 6)) (i32.const 12))
+(assert_return (invoke "dispatch" (i32.const -1)) (i32.const 12))
+(assert_return (invoke "dispatch" (i32.const 0x7fffffff)) (i32.const 12))
+
+(assert_return (invoke "small" (i32.const 0)) (i32.const 20))
+(assert_return (invoke "small" (i32.const 1)) (i32.const 21))
+(assert_return (invoke "small" (i32.const 7)) (i32.const 21))
+
+(assert_return (invoke "default-only" (i32.const 0)) (i32.const 31))
+(assert_return (invoke "default-only" (i32.const -1)) (i32.const 31))
+
+(assert_return (invoke "with-value" (i32.const 0)) (i32.const 44))
+(assert_return (invoke "with-value" (i32.const 1)) (i32.const 43))
+(assert_return (invoke "with-value" (i32.const 2)) (i32.const 42))
+(assert_return (invoke "with-value" (i32.const 3)) (i32.const 41))
+(assert_return (invoke "with-value" (i32.const 4)) (i32.const 41))
+(assert_return (invoke "with-value" (i32.const 5)) (i32.const 42))
+(assert_return (invoke "with-value" (i32.const 100)) (i32.const 42))
+
+;; Only index 0 leaves the loop
+(assert_return (invoke "loop-count" (i32.const 1)) (i32.const 1))
+(assert_return (invoke "loop-count" (i32.const 100)) (i32.const 100))
+(assert_return (invoke "wide" (i32.const 0)) (i32.const 100))
+(assert_return (invoke "wide" (i32.const 1)) (i32.const 101))
+(assert_return (invoke "wide" (i32.const 2)) (i32.const 102))
+(assert_return (invoke "wide" (i32.const 3)) (i32.const 103))
+(assert_return (invoke "wide" (i32.const 4)) (i32.const 104))
+(assert_return (invoke "wide" (i32.const 5)) (i32.const 105))
+(assert_return (invoke "wide" (i32.const 6)) (i32.const 106))
+(assert_return (invoke "wide" (i32.const 7)) (i32.const 107))
+(assert_return (invoke "wide" (i32.const 8)) (i32.const 108))
+(assert_return (invoke "wide" (i32.const 9)) (i32.const 109))
+(assert_return (invoke "wide" (i32.const 10)) (i32.const 110))
+(assert_return (invoke "wide" (i32.const 11)) (i32.const 111))
+(assert_return (invoke "wide" (i32.const 12)) (i32.const 112))
+(assert_return (invoke "wide" (i32.const 13)) (i32.const 113))
+(assert_return (invoke "wide" (i32.const 14)) (i32.const 114))
+(assert_return (invoke "wide" (i32.const 15)) (i32.const 115))
+(assert_return (invoke "wide" (i32.const 16)) (i32.const 116))
+(assert_return (invoke "wide" (i32.const -16)) (i32.const 116))
@@ -72,7 +72,9 @@ if(ZEN_ENABLE_SPEC_TEST)
   set(BUILD_GMOCK OFF)
   set(INSTALL_GTEST OFF)
   FetchContent_MakeAvailable(googletest)
+endif()
 
+if(ZEN_ENABLE_SPEC_TEST OR ZEN_ENABLE_BENCH)
   FetchContent_Declare(
     rapidjson
     URL https://github.com/Tencent/rapidjson/archive/06d58b9e848c650114556a23294d0b6440078c61.zip